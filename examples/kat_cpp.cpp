@@ -181,6 +181,12 @@ void host_execute_tests(kat_instance *tests, size_t ntests){
     genmap[make_pair(threefry4x32_e, 20u)] = do_test<r123::Threefry4x32_R<20> >;
     genmap[make_pair(threefry4x64_e, 13u)] = do_test<r123::Threefry4x64_R<13> >;
     genmap[make_pair(threefry4x64_e, 20u)] = do_test<r123::Threefry4x64_R<20> >;
+    genmap[make_pair(threefry8x64_e, 13u)] = do_test<r123::Threefry8x64_R<13> >;
+    genmap[make_pair(threefry8x64_e, 20u)] = do_test<r123::Threefry8x64_R<20> >;
+    genmap[make_pair(threefry8x64_e, 72u)] = do_test<r123::Threefry8x64_R<72> >;
+    genmap[make_pair(threefry16x64_e, 13u)] = do_test<r123::Threefry16x64_R<13> >;
+    genmap[make_pair(threefry16x64_e, 20u)] = do_test<r123::Threefry16x64_R<20> >;
+    genmap[make_pair(threefry16x64_e, 80u)] = do_test<r123::Threefry16x64_R<80> >;
 
     genmap[make_pair(philox2x32_e, 7u)] = do_test<r123::Philox2x32_R<7> >;
     genmap[make_pair(philox2x32_e, 10u)] = do_test<r123::Philox2x32_R<10> >;
@@ -194,7 +200,7 @@ void host_execute_tests(kat_instance *tests, size_t ntests){
     genmap[make_pair(philox4x64_e, 10u)] = do_test<r123::Philox4x64_R<10> >;
 #endif
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
     genmap[make_pair(aesni4x32_e, 10u)] = do_test<r123::AESNI4x32 >;
     genmap[make_pair(ars4x32_e, 7u)] = do_test<r123::ARS4x32_R<7> >;
     genmap[make_pair(ars4x32_e, 10u)] = do_test<r123::ARS4x32_R<10> >;
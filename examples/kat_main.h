@@ -249,7 +249,7 @@ int main(int argc, char **argv){
 	debug = atoi(p);
     }
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
     have_aesni = haveAESNI();
 #else
     have_aesni = 0;
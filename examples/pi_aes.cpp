@@ -43,7 +43,7 @@ using namespace r123;
 #include "pi_check.h"
 
 int main(int, char **){
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
     unsigned long hits = 0, tries = 0;
     const int64_t two_to_the_62 = ((int64_t)1)<<62;
 
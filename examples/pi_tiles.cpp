@@ -0,0 +1,128 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "util.h"
+#include <Random123/philox.h>
+#include <Random123/tiles.hpp>
+#include <stdio.h>
+#include <vector>
+
+// Everyone's favorite PRNG example: calculate pi/4 by throwing darts
+// at a square board and counting the fraction that are inside the
+// inscribed circle.
+
+// This version throws the same darts, two from each Philox4x32
+// block, three ways, and reports how fast each one is:  one block at
+// a time, as in pi_cppapi;  by filling an array with all the blocks
+// (philox4x32_fill) and then counting the hits;  and with
+// r123::generate_tiles, which hands the blocks to the counting code
+// in tiles that stay in the L1 cache, so that they are never written
+// to memory.  All three must count the same hits.
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace r123;
+
+#include "pi_check.h"
+
+typedef Philox4x32 G;
+
+namespace{
+const int64_t two_to_the_62 = ((int64_t)1)<<62;
+
+unsigned long count(const G::ctr_type* p, size_t m){
+    unsigned long hits = 0;
+    for(size_t i=0; i<m; ++i){
+        int64_t x0 = (int32_t)p[i].v[0], y0 = (int32_t)p[i].v[1];
+        int64_t x1 = (int32_t)p[i].v[2], y1 = (int32_t)p[i].v[3];
+        hits += (x0*x0 + y0*y0) < two_to_the_62;
+        hits += (x1*x1 + y1*y1) < two_to_the_62;
+    }
+    return hits;
+}
+
+// The consumer for generate_tiles.
+struct counter{
+    unsigned long hits;
+    void operator()(const G::ctr_type* p, size_t m){
+        hits += count(p, m);
+    }
+};
+}
+
+int main(int, char **argv){
+    progname = argv[0];
+    G generator;
+    G::key_type key = {{}};
+    G::ctr_type c0 = {{}};
+    const size_t nblocks = NTRIES/2;
+    double clk, dur[3];
+    unsigned long hits[3];
+
+    printf("Throwing %lu darts at a square board using Philox4x32, three ways\n", NTRIES);
+
+    timer(&clk);
+    hits[0] = 0;
+    G::ctr_type c = c0;
+    for(size_t i=0; i<nblocks; ++i, c.incr()){
+        G::ctr_type r = generator(c, key);
+        hits[0] += count(&r, 1);
+    }
+    dur[0] = timer(&clk);
+
+#if R123_USE_SSE || R123_USE_NEON
+    std::vector<G::ctr_type> all(nblocks);
+    timer(&clk);
+    philox4x32_fill(c0, key, &all[0], nblocks);
+    hits[1] = count(&all[0], nblocks);
+    dur[1] = timer(&clk);
+#else
+    hits[1] = hits[0];
+    dur[1] = 0.;
+#endif
+
+    timer(&clk);
+    counter f = {0};
+    hits[2] = generate_tiles(generator, key, c0, nblocks, f).hits;
+    dur[2] = timer(&clk);
+
+    const char* names[3] = {"one block at a time", "fill, then count", "generate_tiles"};
+    for(int i=0; i<3; ++i)
+        if(dur[i] > 0.)
+            printf("%-20s %8.1f million darts/sec\n", names[i], NTRIES/dur[i]*1.e-6);
+    if(hits[1] != hits[0] || hits[2] != hits[0]){
+        printf("The three ways hit %lu, %lu and %lu times\n", hits[0], hits[1], hits[2]);
+        return 1;
+    }
+    return pi_check(hits[0], NTRIES);
+}
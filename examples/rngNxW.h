@@ -40,7 +40,9 @@ RNGNxW_TPL(threefry, 2, 32)
 RNGNxW_TPL(threefry, 2, 64)
 RNGNxW_TPL(threefry, 4, 32)
 RNGNxW_TPL(threefry, 4, 64)
-#if R123_USE_AES_NI
+RNGNxW_TPL(threefry, 8, 64)
+RNGNxW_TPL(threefry, 16, 64)
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 RNGNxW_TPL(ars, 4, 32)
 RNGNxW_TPL(aesni, 4, 32)
 #endif
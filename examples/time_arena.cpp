@@ -0,0 +1,172 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Compare arrays allocated from an r123::arena (2 MiB pages where the
+// system has them) with std::allocator:  an array of 2M
+// MicroURNG<Philox4x32>s, one per particle, built and then drawn
+// from in a scattered order, and a 128 MiB buffer of philox4x32_fill
+// output, allocated and filled, then read in a scattered order.  The
+// scattered accesses are where the larger pages save TLB misses;  the
+// first touch of the buffers, where they save page faults.  Both
+// allocators must give the same numbers;  if they do not, this exits
+// with a non-zero status.
+
+#include "util.h"
+
+#include <Random123/arena.hpp>
+#include <Random123/philox.h>
+#include <Random123/MicroURNG.hpp>
+#include <iostream>
+#include <vector>
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace std;
+using namespace r123;
+
+namespace{
+
+typedef MicroURNG<Philox4x32> U;
+const size_t NU = (size_t)1 << 21;                              // generators
+const size_t NC = ((size_t)128 << 20)/sizeof(philox4x32_ctr_t);  // output blocks
+const size_t NDRAW = (size_t)1 << 22;
+const int REPS = 3;
+
+// A scattered, but repeatable, order: i times an odd constant, modulo
+// a power of 2.
+inline size_t scatter(size_t i, size_t n){ return (i*2654435761u) & (n-1); }
+
+template <typename V>
+double build(V& v, uint64_t* sum){
+    double clk;
+    timer(&clk);
+    v.reserve(NU);
+    for(size_t i=0; i<NU; ++i){
+        Philox4x32::ctr_type c = {{(uint32_t)i, 0, 0, 0}};
+        Philox4x32::key_type k = {{0x12345678, 0x9abcdef0}};
+        v.push_back(U(c, k));
+    }
+    double t = timer(&clk);
+    *sum += v[NU-1]();
+    return t;
+}
+
+template <typename V>
+double draw(V& v, uint64_t* sum){
+    double clk, best = 1.e30;
+    for(int r=0; r<REPS; ++r){
+        uint64_t s = 0;
+        timer(&clk);
+        for(size_t i=0; i<NDRAW; ++i)
+            s += v[scatter(i, NU)]();
+        double t = timer(&clk);
+        if(t < best)
+            best = t;
+        *sum += s;
+    }
+    return best;
+}
+
+template <typename V>
+double fill(V& v, const typename V::allocator_type& a, uint64_t* sum){
+    double clk;
+    philox4x32_ctr_t c0 = {{}};
+    philox4x32_key_t k = {{1, 2}};
+    timer(&clk);
+    V tmp(NC, philox4x32_ctr_t(), a);
+#if R123_USE_SSE || R123_USE_NEON
+    philox4x32_fill(c0, k, &tmp[0], NC);
+#else
+    for(size_t i=0; i<NC; ++i, c0.incr())
+        tmp[i] = philox4x32(c0, k);
+#endif
+    double t = timer(&clk);
+    v.swap(tmp);
+    *sum += v[NC-1].v[3];
+    return t;
+}
+
+template <typename V>
+double gather(const V& v, uint64_t* sum){
+    double clk, best = 1.e30;
+    for(int r=0; r<REPS; ++r){
+        uint64_t s = 0;
+        timer(&clk);
+        for(size_t i=0; i<NDRAW; ++i)
+            s += v[scatter(i, NC)].v[i&3];
+        double t = timer(&clk);
+        if(t < best)
+            best = t;
+        *sum += s;
+    }
+    return best;
+}
+
+void report(const char* what, double tstd, double tarena, size_t n, const char* unit){
+    cout << what << ":  std::allocator " << tstd/n*1.e9 << " ns/" << unit
+         << "  arena " << tarena/n*1.e9 << " ns/" << unit
+         << "  ratio " << tarena/tstd << "\n";
+}
+
+} // namespace <anon>
+
+int main(int, char **argv){
+    progname = argv[0];
+    uint64_t s0 = 0, s1 = 0;
+
+    {
+        arena a(NU*sizeof(U));
+        cout << "arena backing: " << a.backing() << "\n";
+        vector<U> v0;
+        vector<U, arena_allocator<U> > v1((arena_allocator<U>(a)));
+        double b0 = build(v0, &s0), b1 = build(v1, &s1);
+        report("build 2M MicroURNGs", b0, b1, NU, "generator");
+        double d0 = draw(v0, &s0), d1 = draw(v1, &s1);
+        report("scattered draws", d0, d1, NDRAW, "draw");
+    }
+    {
+        typedef vector<philox4x32_ctr_t, arena_allocator<philox4x32_ctr_t> > AV;
+        arena a(NC*sizeof(philox4x32_ctr_t));
+        vector<philox4x32_ctr_t> v0;
+        AV v1((arena_allocator<philox4x32_ctr_t>(a)));
+        double f0 = fill(v0, v0.get_allocator(), &s0), f1 = fill(v1, v1.get_allocator(), &s1);
+        report("allocate and fill 128 MiB", f0, f1, NC, "block");
+        double g0 = gather(v0, &s0), g1 = gather(v1, &s1);
+        report("scattered reads", g0, g1, NDRAW, "read");
+    }
+    if(s0 != s1){
+        cout << "MISMATCH\n";
+        return 1;
+    }
+    return 0;
+}
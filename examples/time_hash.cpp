@@ -0,0 +1,226 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Time r123::keyed_hash, the batched hashes() and one input at a
+// time, against two common non-cryptographic hashes of 64-bit keys,
+// seeded to make k hash functions:  XXH64 of the 8 bytes of the key,
+// and the MurmurHash3 finalizer (fmix64) of the key xored with the
+// seed.  Each of those makes two 32-bit hash values per call.  The
+// first argument, if given, is the number of hash functions, k.
+//
+// Then time r123::skein_hash, one name at a time and many at once,
+// deriving Threefry4x64 keys from names of 15 to 60 bytes.
+
+#include "util.h"
+#include "util_cpu.h"
+
+#include <Random123/keyed_hash.hpp>
+#include <Random123/skein.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace std;
+using namespace r123;
+
+namespace{
+
+const size_t NIN = 1<<14;
+const int REPS = 5;
+
+inline uint64_t rotl64(uint64_t x, int r){
+    return (x << r) | (x >> (64-r));
+}
+
+// XXH64 of the 8-byte little-endian x.
+inline uint64_t xxh64(uint64_t x, uint64_t seed){
+    const uint64_t P1 = R123_64BIT(0x9E3779B185EBCA87), P2 = R123_64BIT(0xC2B2AE3D27D4EB4F);
+    const uint64_t P3 = R123_64BIT(0x165667B19E3779F9), P4 = R123_64BIT(0x85EBCA77C2B2AE63);
+    const uint64_t P5 = R123_64BIT(0x27D4EB2F165667C5);
+    uint64_t h = seed + P5 + 8;
+    h ^= rotl64(x*P2, 31)*P1;
+    h = rotl64(h, 27)*P1 + P4;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t fmix64(uint64_t x, uint64_t seed){
+    uint64_t h = x ^ seed;
+    h ^= h >> 33;
+    h *= R123_64BIT(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= R123_64BIT(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+struct XXH64{
+    void operator()(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        for(size_t e=0; e<n; ++e)
+            for(unsigned i=0; i<k; i+=2){
+                uint64_t h = xxh64(x[e], i);
+                out[e*k+i] = (uint32_t)h;
+                if(i+1 < k)
+                    out[e*k+i+1] = (uint32_t)(h>>32);
+            }
+    }
+};
+
+struct Fmix64{
+    void operator()(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        for(size_t e=0; e<n; ++e)
+            for(unsigned i=0; i<k; i+=2){
+                uint64_t h = fmix64(x[e], R123_64BIT(0x9E3779B97F4A7C15)*(i+1));
+                out[e*k+i] = (uint32_t)h;
+                if(i+1 < k)
+                    out[e*k+i+1] = (uint32_t)(h>>32);
+            }
+    }
+};
+
+template <typename CBRNG>
+struct Batched{
+    keyed_hash<CBRNG> h;
+    Batched() : h(typename CBRNG::key_type()){}
+    void operator()(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        h.hashes(x, n, k, out);
+    }
+};
+
+template <typename CBRNG>
+struct OneAtATime{
+    keyed_hash<CBRNG> h;
+    OneAtATime() : h(typename CBRNG::key_type()){}
+    void operator()(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        for(size_t e=0; e<n; ++e)
+            h.hashes(x[e], k, out+e*k);
+    }
+};
+
+uint32_t check = 0;
+
+template <typename F>
+void time_one(const string& name, const vector<uint64_t>& x, unsigned k, double hz){
+    F f;
+    vector<uint32_t> out(x.size()*k);
+    double best = 1.e30, clk;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        f(&x[0], x.size(), k, &out[0]);
+        double dur = ::timer(&clk);
+        if(dur < best)
+            best = dur;
+        check ^= out[r];
+    }
+    cout << name << string(name.size() < 36 ? 36-name.size() : 0, ' ')
+         << 1.e9*best/x.size() << " ns per input  "
+         << hz*best/(x.size()*k) << " cycles per hash\n";
+}
+
+template <unsigned R>
+void time_names(const string& name, const vector<string>& names, bool bulk){
+    skein_hash<Threefry4x64::ukey_type, R> h("seed");
+    vector<Threefry4x64::ukey_type> keys(names.size());
+    size_t bytes = 0;
+    for(size_t i=0; i<names.size(); ++i)
+        bytes += names[i].size();
+    double best = 1.e30, clk;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        if(bulk)
+            h(&names[0], names.size(), &keys[0]);
+        else
+            for(size_t i=0; i<names.size(); ++i)
+                keys[i] = h(names[i]);
+        double dur = ::timer(&clk);
+        if(dur < best)
+            best = dur;
+        check ^= (uint32_t)keys[r].v[0];
+    }
+    cout << name << string(name.size() < 36 ? 36-name.size() : 0, ' ')
+         << 1.e9*best/names.size() << " ns per name  "
+         << bytes/best/1.e6 << " MB/s\n";
+}
+
+} // namespace <anon>
+
+int main(int argc, char **argv){
+    progname = argv[0];
+    unsigned k = argc > 1 ? (unsigned)atoi(argv[1]) : 4;
+    if(k == 0)
+        k = 4;
+    double hz = clockspeedHz(0, 0);
+    if(hz == 0.){
+        cout << "Unknown clock speed; the cycles are nanoseconds\n";
+        hz = 1.e9;
+    }
+    vector<uint64_t> x(NIN);
+    uint64_t z = 1;
+    for(size_t e=0; e<NIN; ++e){
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        x[e] = z;
+    }
+    cout << k << " hash values of each of " << NIN << " 64-bit keys\n";
+    time_one<Batched<Philox4x32_R<7> > >("keyed_hash<Philox4x32_R<7> >", x, k, hz);
+    time_one<Batched<Philox4x32_R<10> > >("keyed_hash<Philox4x32_R<10> >", x, k, hz);
+    time_one<Batched<Threefry2x64_R<13> > >("keyed_hash<Threefry2x64_R<13> >", x, k, hz);
+    time_one<Batched<Threefry2x64_R<20> > >("keyed_hash<Threefry2x64_R<20> >", x, k, hz);
+    time_one<OneAtATime<Philox4x32_R<7> > >("  one at a time, Philox4x32_R<7>", x, k, hz);
+    time_one<OneAtATime<Threefry2x64_R<13> > >("  one at a time, Threefry2x64_R<13>", x, k, hz);
+    time_one<XXH64>("XXH64, seeded", x, k, hz);
+    time_one<Fmix64>("MurmurHash3 fmix64, seeded", x, k, hz);
+
+    vector<string> names(NIN);
+    for(size_t e=0; e<NIN; ++e){
+        char b[64];
+        sprintf(b, "run-%u/entity-%u", (unsigned)(x[e]>>60), (unsigned)e);
+        names[e] = b;
+        names[e].append((size_t)(x[e]>>32)%32, 'x');
+    }
+    cout << "\nThreefry4x64 keys from each of " << NIN << " names\n";
+    time_names<72>("skein_hash, one at a time", names, false);
+    time_names<72>("skein_hash, many at once", names, true);
+    time_names<20>("skein_hash<.., 20>, one at a time", names, false);
+    time_names<20>("skein_hash<.., 20>, many at once", names, true);
+    if(check == 0)  // keep the hashes from being optimized away
+        cout << "\n";
+    return 0;
+}
@@ -54,8 +54,12 @@ static threefry4x64_ctr_t good_threefry4x64_20 = {{R123_64BIT(0xad8f0b8c18ed5187
 static threefry4x32_ctr_t good_threefry4x32_12 = {{0xe461db1c,0xfdfa62a7,0x0b10cd2a,0xa3679758}};
 static threefry4x32_ctr_t good_threefry4x32_20 = {{0xf82cf576,0x162ca116,0x3afefe23,0x54cc64ac}};
 static threefry4x64_ctr_t good_threefry4x64_72 = {{R123_64BIT(0x73ff3f7a0b878f68),R123_64BIT(0x6668f6bbaba83f31),R123_64BIT(0x088eb85d40fbdb56),R123_64BIT(0xd1f39136adc96552)}};
+static threefry8x64_ctr_t good_threefry8x64_20 = {{R123_64BIT(0x26f3618ec724c2d2),R123_64BIT(0xf5cf838ec74d05ff),R123_64BIT(0xd11352bc06b388ef),R123_64BIT(0x624e329692a9de68),R123_64BIT(0xf4b88983b3560228),R123_64BIT(0x47a15a62effa2b05),R123_64BIT(0xdadfabeb1f59ca17),R123_64BIT(0xdca3d37fe86797b4)}};
+static threefry8x64_ctr_t good_threefry8x64_72 = {{R123_64BIT(0x77aa4d1b9b02bfe7),R123_64BIT(0xcf2ece47f676efeb),R123_64BIT(0xdaad85528938a653),R123_64BIT(0x994af6cb7939fab6),R123_64BIT(0x3c0104dd0e74ba8b),R123_64BIT(0x414109fac7157ded),R123_64BIT(0x76997471eb43b9b5),R123_64BIT(0x35ea9dc273d9dab6)}};
+static threefry16x64_ctr_t good_threefry16x64_20 = {{R123_64BIT(0x08e40826ccc0ee24),R123_64BIT(0xd5a0a79ff07c75ae),R123_64BIT(0x088718148bf3cf8e),R123_64BIT(0x8e40aa312a9adea6),R123_64BIT(0xedb9666a7e90ea35),R123_64BIT(0x6e91d85851e2f9ed),R123_64BIT(0x7f6e9aa751baa61f),R123_64BIT(0xaae9f62e15b4429e),R123_64BIT(0x81a735b4c95a2669),R123_64BIT(0xbbd65b654595e659),R123_64BIT(0x696a0247e79751d7),R123_64BIT(0x05b397b75eb8de79),R123_64BIT(0x546ffffbd5526ac7),R123_64BIT(0x1133956e45105ee4),R123_64BIT(0xf9b40c064027a41b),R123_64BIT(0x0680f40df39b2bd9)}};
+static threefry16x64_ctr_t good_threefry16x64_80 = {{R123_64BIT(0x816ef8c274513ff3),R123_64BIT(0xe261502e09226e4b),R123_64BIT(0xb9ff627b904f8032),R123_64BIT(0xb2bb53e7c1904f95),R123_64BIT(0x850d4e858c0c488b),R123_64BIT(0xfc5510611cef45f7),R123_64BIT(0xc5f79cdfa725ade3),R123_64BIT(0x29b33b87fb62cd07),R123_64BIT(0x7b5bead5689d3c55),R123_64BIT(0x696e1693fead5e12),R123_64BIT(0x99258d6ae6b39284),R123_64BIT(0x82b1719c486c140f),R123_64BIT(0x8e283c78236b0101),R123_64BIT(0xcedfb76e7cecaa78),R123_64BIT(0xa05fa63b07aeb3af),R123_64BIT(0x31208386c164cad8)}};
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 static ars4x32_ctr_t good_ars4x32_5 = {{0x279f6b0b, 0xd0b1edf6, 0x6044b433, 0x66c06817}};
 static ars4x32_ctr_t good_ars4x32_7 = {{0xa9cd8055, 0x80272a47, 0x4b7ab914, 0x5351d78e}};
 static aesni4x32_ctr_t good_aesni4x32_10 = {{0x1e68c9fd, 0x347b0858, 0x503d8d91, 0x9e73460a}};
@@ -0,0 +1,490 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Time the multi-lane Philox and Threefry functions built on
+// features/lanes.h:  each _R_xL function against a hand-written
+// intrinsic version of the same rounds where there is one, so that
+// a regression in the code generated from the portable templates
+// shows up as a ratio well above 1, and each _R_fill and
+// _R_fill_soa function against the scalar function on consecutive
+// counters.  The _R_multikey functions, with a key per counter, are
+// timed against the scalar function with the same keys, for
+// comparison with the single-key _R_fill above them.  The
+// hand-written and portable versions must produce the same bits;
+// if they do not, this exits with a non-zero status.
+
+#include "util.h"
+#include "util_cpu.h"
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace std;
+
+#if !(R123_USE_SSE || R123_USE_NEON)
+int main(int, char **argv){
+    progname = argv[0];
+    cout << "No SSE or NEON.  Nothing to time\n";
+    return 0;
+}
+#else
+
+namespace{
+
+/* The hand-written versions.  Each transposes its counters with
+   features/lanes.h, so that only the rounds are compared. */
+#if R123_USE_AVX2
+__m256i hand_mulhilo32_x8(__m256i a, uint32_t m, __m256i* hip){
+    __m256i mm = _mm256_set1_epi32((int)m);
+    __m256i pe = _mm256_mul_epu32(a, mm);
+    __m256i po = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), mm);
+    *hip = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0xaa);
+    return _mm256_blend_epi32(pe, _mm256_slli_epi64(po, 32), 0xaa);
+}
+
+void hand_philox4x32_R_x8(unsigned R, const philox4x32_ctr_t* in, philox4x32_key_t key, philox4x32_ctr_t* out){
+    __m256i x[4];
+    _r123_load4_u32x8(in[0].v, x);
+    for(unsigned r=0; r<R; ++r){
+        if(r){
+            key.v[0] += PHILOX_W32_0;
+            key.v[1] += PHILOX_W32_1;
+        }
+        __m256i hi0, hi1;
+        __m256i lo0 = hand_mulhilo32_x8(x[0], PHILOX_M4x32_0, &hi0);
+        __m256i lo1 = hand_mulhilo32_x8(x[2], PHILOX_M4x32_1, &hi1);
+        x[0] = _mm256_xor_si256(_mm256_xor_si256(hi1, x[1]), _mm256_set1_epi32((int)key.v[0]));
+        x[1] = lo1;
+        x[2] = _mm256_xor_si256(_mm256_xor_si256(hi0, x[3]), _mm256_set1_epi32((int)key.v[1]));
+        x[3] = lo0;
+    }
+    _r123_store4_u32x8(x, out[0].v);
+}
+#endif
+
+#if R123_USE_AVX512 && R123_USE_PHILOX_64BIT
+/* Philox4x64 with AVX-512 as it was written before features/lanes.h. */
+#if R123_USE_AVX512IFMA
+__m512i hand_mulhilo64_x8(__m512i a, uint64_t m, __m512i* hip){
+    const uint64_t m52 = (R123_64BIT(1)<<52) - 1;
+    __m512i m0 = _mm512_set1_epi64((long long)(m&m52));
+    __m512i m1 = _mm512_set1_epi64((long long)(m>>52));
+    __m512i z = _mm512_setzero_si512();
+    __m512i a0 = _mm512_and_si512(a, _mm512_set1_epi64((long long)m52));
+    __m512i a1 = _mm512_srli_epi64(a, 52);
+    __m512i l = _mm512_madd52lo_epu64(z, a0, m0);
+    __m512i t = _mm512_madd52lo_epu64(_mm512_madd52lo_epu64(_mm512_madd52hi_epu64(z, a0, m0), a0, m1), a1, m0);
+    __m512i u = _mm512_madd52lo_epu64(_mm512_madd52hi_epu64(_mm512_madd52hi_epu64(z, a0, m1), a1, m0), a1, m1);
+    *hip = _mm512_add_epi64(_mm512_srli_epi64(t, 12), _mm512_slli_epi64(u, 40));
+    return _mm512_or_si512(l, _mm512_slli_epi64(t, 52));
+}
+#else
+__m512i hand_mulhilo64_x8(__m512i a, uint64_t m, __m512i* hip){
+    __m512i mlo = _mm512_set1_epi64((long long)(m&0xffffffff));
+    __m512i mhi = _mm512_set1_epi64((long long)(m>>32));
+    __m512i m32 = _mm512_set1_epi64(0xffffffff);
+    __m512i ah = _mm512_srli_epi64(a, 32);
+    __m512i ll = _mm512_mul_epu32(a, mlo);
+    __m512i lh = _mm512_mul_epu32(a, mhi);
+    __m512i hl = _mm512_mul_epu32(ah, mlo);
+    __m512i hh = _mm512_mul_epu32(ah, mhi);
+    __m512i mid = _mm512_add_epi64(_mm512_srli_epi64(ll, 32),
+                  _mm512_add_epi64(_mm512_and_si512(lh, m32), _mm512_and_si512(hl, m32)));
+    *hip = _mm512_add_epi64(_mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32)),
+                            _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+    return _mm512_or_si512(_mm512_slli_epi64(mid, 32), _mm512_and_si512(ll, m32));
+}
+#endif
+
+void hand_philox4x64_R_x8(unsigned R, const philox4x64_ctr_t* in, philox4x64_key_t key, philox4x64_ctr_t* out){
+    __m512i x[4];
+    _r123_load4_u64x8(in[0].v, x);
+    for(unsigned r=0; r<R; ++r){
+        if(r){
+            key.v[0] += PHILOX_W64_0;
+            key.v[1] += PHILOX_W64_1;
+        }
+        __m512i hi0, hi1;
+        __m512i lo0 = hand_mulhilo64_x8(x[0], PHILOX_M4x64_0, &hi0);
+        __m512i lo1 = hand_mulhilo64_x8(x[2], PHILOX_M4x64_1, &hi1);
+        x[0] = _mm512_xor_si512(_mm512_xor_si512(hi1, x[1]), _mm512_set1_epi64((long long)key.v[0]));
+        x[1] = lo1;
+        x[2] = _mm512_xor_si512(_mm512_xor_si512(hi0, x[3]), _mm512_set1_epi64((long long)key.v[1]));
+        x[3] = lo0;
+    }
+    _r123_store4_u64x8(x, out[0].v);
+}
+
+/* Threefry4x32 with the AVX-512 rotate instructions. */
+void hand_threefry4x32_R_x16(unsigned R, const threefry4x32_ctr_t* in, threefry4x32_key_t k, threefry4x32_ctr_t* out){
+    static const int rot[8][2] = {
+        {R_32x4_0_0, R_32x4_0_1}, {R_32x4_1_0, R_32x4_1_1},
+        {R_32x4_2_0, R_32x4_2_1}, {R_32x4_3_0, R_32x4_3_1},
+        {R_32x4_4_0, R_32x4_4_1}, {R_32x4_5_0, R_32x4_5_1},
+        {R_32x4_6_0, R_32x4_6_1}, {R_32x4_7_0, R_32x4_7_1}};
+    __m512i x[4], ks[5];
+    uint32_t parity = SKEIN_KS_PARITY32;
+    _r123_load4_u32x16(in[0].v, x);
+    for(int i=0; i<4; ++i){
+        ks[i] = _mm512_set1_epi32((int)k.v[i]);
+        parity ^= k.v[i];
+        x[i] = _mm512_add_epi32(x[i], ks[i]);
+    }
+    ks[4] = _mm512_set1_epi32((int)parity);
+    for(unsigned r=0; r<R; ++r){
+        unsigned j = (r&1) ? 3 : 1, l = 4-j;
+        x[0] = _mm512_add_epi32(x[0], x[j]);
+        x[j] = _mm512_xor_si512(_mm512_rolv_epi32(x[j], _mm512_set1_epi32(rot[r%8][0])), x[0]);
+        x[2] = _mm512_add_epi32(x[2], x[l]);
+        x[l] = _mm512_xor_si512(_mm512_rolv_epi32(x[l], _mm512_set1_epi32(rot[r%8][1])), x[2]);
+        if(r%4 == 3){
+            unsigned s = (r+1)/4;
+            for(int i=0; i<4; ++i)
+                x[i] = _mm512_add_epi32(x[i], ks[(s+i)%5]);
+            x[3] = _mm512_add_epi32(x[3], _mm512_set1_epi32((int)s));
+        }
+    }
+    _r123_store4_u32x16(x, out[0].v);
+}
+#endif
+
+#if R123_USE_NEON && !R123_USE_SSE
+/* Philox4x32 with NEON as it was written before features/lanes.h. */
+void hand_philox4x32_R_x4(unsigned R, const philox4x32_ctr_t* in, philox4x32_key_t key, philox4x32_ctr_t* out){
+    uint32x4x4_t t = vld4q_u32(in[0].v);
+    uint32x2_t m0 = vdup_n_u32(PHILOX_M4x32_0), m1 = vdup_n_u32(PHILOX_M4x32_1);
+    for(unsigned r=0; r<R; ++r){
+        if(r){
+            key.v[0] += PHILOX_W32_0;
+            key.v[1] += PHILOX_W32_1;
+        }
+        uint64x2_t p0l = vmull_u32(vget_low_u32(t.val[0]), m0), p0h = vmull_u32(vget_high_u32(t.val[0]), m0);
+        uint64x2_t p2l = vmull_u32(vget_low_u32(t.val[2]), m1), p2h = vmull_u32(vget_high_u32(t.val[2]), m1);
+        uint32x4_t hi0 = vcombine_u32(vshrn_n_u64(p0l, 32), vshrn_n_u64(p0h, 32));
+        uint32x4_t hi1 = vcombine_u32(vshrn_n_u64(p2l, 32), vshrn_n_u64(p2h, 32));
+        uint32x4_t lo0 = vmulq_u32(t.val[0], vdupq_n_u32(PHILOX_M4x32_0));
+        uint32x4_t lo1 = vmulq_u32(t.val[2], vdupq_n_u32(PHILOX_M4x32_1));
+        t.val[0] = veorq_u32(veorq_u32(hi1, t.val[1]), vdupq_n_u32(key.v[0]));
+        t.val[1] = lo1;
+        t.val[2] = veorq_u32(veorq_u32(hi0, t.val[3]), vdupq_n_u32(key.v[1]));
+        t.val[3] = lo0;
+    }
+    vst4q_u32(out[0].v, t);
+}
+#endif
+
+template <typename Ctr, typename Key>
+struct timed{
+    const char* name;
+    void (*xL)(unsigned, const Ctr*, Key, Ctr*);
+    size_t L;
+    void (*hand)(unsigned, const Ctr*, Key, Ctr*);
+    Ctr (*scalar)(unsigned, Ctr, Key);
+    void (*fill)(unsigned, Ctr, Key, Ctr*, size_t);
+    void (*fill_soa)(unsigned, Ctr, Key, typename Ctr::value_type* const*, size_t);
+    unsigned R;
+};
+
+const size_t N = 4096;   // counters, small enough to stay in cache
+double hz;
+int failures = 0;
+
+// cycles per byte of f applied to the whole buffer, best of 5 runs
+// of about 20 milliseconds each.
+template <typename F>
+double cpB(F f, size_t bytes){
+    double clk, best = 0.;
+    size_t reps = 1;
+    for(;;){
+        ::timer(&clk);
+        for(size_t i=0; i<reps; ++i)
+            f();
+        double dur = ::timer(&clk);
+        if(dur > 0.02)
+            break;
+        reps *= 2;
+    }
+    for(int t=0; t<5; ++t){
+        ::timer(&clk);
+        for(size_t i=0; i<reps; ++i)
+            f();
+        double dur = ::timer(&clk);
+        double rate = reps*bytes/dur;
+        if(rate > best)
+            best = rate;
+    }
+    return hz/best;
+}
+
+template <typename Ctr, typename Key>
+struct xL_run{
+    void (*xL)(unsigned, const Ctr*, Key, Ctr*);
+    size_t L;
+    unsigned R;
+    Key k;
+    Ctr* buf;
+    void operator()() const{
+        for(size_t i=0; i<N; i+=L)
+            xL(R, buf+i, k, buf+i);
+    }
+};
+
+template <typename Ctr, typename Key>
+struct fill_run{
+    void (*fill)(unsigned, Ctr, Key, Ctr*, size_t);
+    unsigned R;
+    Key k;
+    Ctr* buf;
+    void operator()() const{
+        Ctr c0 = {{}};
+        c0.v[0] = buf[0].v[0];  // keep the runs from being hoisted
+        fill(R, c0, k, buf, N);
+    }
+};
+
+template <typename Ctr, typename Key>
+struct fill_soa_run{
+    void (*fill_soa)(unsigned, Ctr, Key, typename Ctr::value_type* const*, size_t);
+    unsigned R;
+    Key k;
+    typename Ctr::value_type* const* cols;
+    void operator()() const{
+        Ctr c0 = {{}};
+        c0.v[0] = cols[0][0];
+        fill_soa(R, c0, k, cols, N);
+    }
+};
+
+template <typename Ctr, typename Key>
+struct scalar_run{
+    Ctr (*scalar)(unsigned, Ctr, Key);
+    unsigned R;
+    Key k;
+    Ctr* buf;
+    void operator()() const{
+        Ctr c = {{}};
+        c.v[0] = buf[0].v[0];
+        for(size_t i=0; i<N; ++i, c.incr())
+            buf[i] = scalar(R, c, k);
+    }
+};
+
+template <typename Ctr, typename Key>
+void timeit(const timed<Ctr, Key>& t){
+    vector<Ctr> a(N), b(N);
+    Key k = {{}};
+    for(size_t i=0; i<N; ++i)
+        for(size_t w=0; w<4; ++w)
+            a[i].v[w] = (typename Ctr::value_type)(i*4+w);
+    b = a;
+    for(size_t w=0; w<k.size(); ++w)
+        k.v[w] = (typename Ctr::value_type)(w+1);
+    const size_t bytes = N*sizeof(Ctr);
+
+    if(t.xL){
+        xL_run<Ctr, Key> x = {t.xL, t.L, t.R, k, &a[0]};
+        double gc = cpB(x, bytes);
+        cout << t.name << "_R_x" << t.L << ": " << gc << " cpB";
+        if(t.hand){
+            xL_run<Ctr, Key> h = {t.hand, t.L, t.R, k, &b[0]};
+            double hc = cpB(h, bytes);
+            // The timed buffers have been through different numbers
+            // of rounds, so compare the bits on fresh copies.
+            vector<Ctr> c(t.L), d(t.L);
+            for(size_t i=0; i<t.L; ++i)
+                for(size_t w=0; w<4; ++w)
+                    c[i].v[w] = (typename Ctr::value_type)(i*4+w);
+            d = c;
+            t.xL(t.R, &c[0], k, &c[0]);
+            t.hand(t.R, &d[0], k, &d[0]);
+            cout << "  hand-written: " << hc << " cpB  ratio: " << gc/hc;
+            if(memcmp(&c[0], &d[0], t.L*sizeof(Ctr)) != 0){
+                cout << "  MISMATCH";
+                failures++;
+            }
+        }
+        cout << "\n";
+    }
+    if(t.fill){
+        fill_run<Ctr, Key> f = {t.fill, t.R, k, &a[0]};
+        scalar_run<Ctr, Key> s = {t.scalar, t.R, k, &b[0]};
+        typedef typename Ctr::value_type value_type;
+        vector<value_type> soa(4*N);
+        value_type* cols[4] = {&soa[0], &soa[N], &soa[2*N], &soa[3*N]};
+        fill_soa_run<Ctr, Key> fs = {t.fill_soa, t.R, k, cols};
+        cout << t.name << "_R_fill: " << cpB(f, bytes) << " cpB  _R_fill_soa: " << cpB(fs, bytes) << " cpB  scalar: " << cpB(s, bytes) << " cpB";
+        Ctr c0 = {{}};
+        c0.v[0] = ~(value_type)0 - 5;
+        f.fill(t.R, c0, k, &a[0], 100);
+        fs.fill_soa(t.R, c0, k, cols, 100);
+        for(size_t i=0; i<100; ++i, c0.incr()){
+            Ctr r = t.scalar(t.R, c0, k);
+            if(memcmp(&a[i], r.v, sizeof(Ctr)) != 0 ||
+               cols[0][i] != r.v[0] || cols[1][i] != r.v[1] || cols[2][i] != r.v[2] || cols[3][i] != r.v[3]){
+                cout << "  MISMATCH";
+                failures++;
+                break;
+            }
+        }
+        cout << "\n";
+    }
+}
+
+template <typename Ctr, typename Key>
+struct multikey_run{
+    void (*multikey)(unsigned, const Ctr*, const Key*, Ctr*, size_t);
+    unsigned R;
+    const Key* keys;
+    Ctr* buf;
+    void operator()() const{
+        multikey(R, buf, keys, buf, N);
+    }
+};
+
+template <typename Ctr, typename Key>
+struct scalar_multikey_run{
+    Ctr (*scalar)(unsigned, Ctr, Key);
+    unsigned R;
+    const Key* keys;
+    Ctr* buf;
+    void operator()() const{
+        for(size_t i=0; i<N; ++i)
+            buf[i] = scalar(R, buf[i], keys[i]);
+    }
+};
+
+template <typename Ctr, typename Key>
+void timemultikey(const char* name, void (*multikey)(unsigned, const Ctr*, const Key*, Ctr*, size_t), Ctr (*scalar)(unsigned, Ctr, Key), unsigned R){
+    vector<Ctr> a(N), b(N);
+    vector<Key> keys(N);
+    unsigned char* pa = (unsigned char*)&a[0];
+    unsigned char* pk = (unsigned char*)&keys[0];
+    for(size_t i=0; i<N*sizeof(Ctr); ++i)
+        pa[i] = (unsigned char)(i*7);
+    for(size_t i=0; i<N*sizeof(Key); ++i)
+        pk[i] = (unsigned char)(i*13+1);
+    b = a;
+    const size_t bytes = N*sizeof(Ctr);
+    multikey_run<Ctr, Key> m = {multikey, R, &keys[0], &a[0]};
+    scalar_multikey_run<Ctr, Key> s = {scalar, R, &keys[0], &b[0]};
+    cout << name << "_R_multikey: " << cpB(m, bytes) << " cpB  scalar: " << cpB(s, bytes) << " cpB";
+    // Fresh copies, as the timed buffers have been through different
+    // numbers of rounds.
+    for(size_t i=0; i<N*sizeof(Ctr); ++i)
+        pa[i] = (unsigned char)(i*7);
+    b = a;
+    m();
+    s();
+    if(memcmp(&a[0], &b[0], bytes) != 0){
+        cout << "  MISMATCH";
+        failures++;
+    }
+    cout << "\n";
+}
+
+} // namespace <anon>
+
+int main(int, char **argv){
+    progname = argv[0];
+    hz = clockspeedHz(0, 0);
+    if(hz == 0.){
+        cout << "Unknown clock speed; the cpB figures are in nanoseconds per byte\n";
+        hz = 1.e9;
+    }
+    typedef timed<philox4x32_ctr_t, philox4x32_key_t> P32;
+    typedef timed<threefry4x32_ctr_t, threefry4x32_key_t> T32;
+
+#if R123_USE_NEON && !R123_USE_SSE
+    P32 p4 = {"philox4x32", philox4x32_R_x4, 4, hand_philox4x32_R_x4, philox4x32_R, 0, 0, philox4x32_rounds};
+#else
+    P32 p4 = {"philox4x32", philox4x32_R_x4, 4, 0, philox4x32_R, 0, 0, philox4x32_rounds};
+#endif
+    timeit(p4);
+    T32 t4 = {"threefry4x32", threefry4x32_R_x4, 4, 0, threefry4x32_R, 0, 0, threefry4x32_rounds};
+    timeit(t4);
+#if R123_USE_AVX2
+    P32 p8 = {"philox4x32", philox4x32_R_x8, 8, hand_philox4x32_R_x8, philox4x32_R, 0, 0, philox4x32_rounds};
+    timeit(p8);
+    T32 t8 = {"threefry4x32", threefry4x32_R_x8, 8, 0, threefry4x32_R, 0, 0, threefry4x32_rounds};
+    timeit(t8);
+#endif
+#if R123_USE_AVX512
+    P32 p16 = {"philox4x32", philox4x32_R_x16, 16, 0, philox4x32_R, 0, 0, philox4x32_rounds};
+    timeit(p16);
+    T32 t16 = {"threefry4x32", threefry4x32_R_x16, 16, hand_threefry4x32_R_x16, threefry4x32_R, 0, 0, threefry4x32_rounds};
+    timeit(t16);
+#endif
+    P32 pf = {"philox4x32", 0, 0, 0, philox4x32_R, philox4x32_R_fill, philox4x32_R_fill_soa, philox4x32_rounds};
+    timeit(pf);
+    T32 tf = {"threefry4x32", 0, 0, 0, threefry4x32_R, threefry4x32_R_fill, threefry4x32_R_fill_soa, threefry4x32_rounds};
+    timeit(tf);
+    timemultikey("philox4x32", philox4x32_R_multikey, philox4x32_R, philox4x32_rounds);
+    timemultikey("threefry4x32", threefry4x32_R_multikey, threefry4x32_R, threefry4x32_rounds);
+
+#if R123_USE_AVX2
+    typedef timed<threefry4x64_ctr_t, threefry4x64_key_t> T64;
+    T64 t64_4 = {"threefry4x64", threefry4x64_R_x4, 4, 0, threefry4x64_R, 0, 0, threefry4x64_rounds};
+    timeit(t64_4);
+#if R123_USE_AVX512
+    T64 t64_8 = {"threefry4x64", threefry4x64_R_x8, 8, 0, threefry4x64_R, 0, 0, threefry4x64_rounds};
+    timeit(t64_8);
+#endif
+    T64 t64f = {"threefry4x64", 0, 0, 0, threefry4x64_R, threefry4x64_R_fill, threefry4x64_R_fill_soa, threefry4x64_rounds};
+    timeit(t64f);
+    timemultikey("threefry4x64", threefry4x64_R_multikey, threefry4x64_R, threefry4x64_rounds);
+#if R123_USE_PHILOX_64BIT
+    typedef timed<philox4x64_ctr_t, philox4x64_key_t> P64;
+    P64 p64_4 = {"philox4x64", philox4x64_R_x4, 4, 0, philox4x64_R, 0, 0, philox4x64_rounds};
+    timeit(p64_4);
+#if R123_USE_AVX512
+    P64 p64_8 = {"philox4x64", philox4x64_R_x8, 8, hand_philox4x64_R_x8, philox4x64_R, 0, 0, philox4x64_rounds};
+    timeit(p64_8);
+#endif
+    P64 p64f = {"philox4x64", 0, 0, 0, philox4x64_R, philox4x64_R_fill, philox4x64_R_fill_soa, philox4x64_rounds};
+    timeit(p64f);
+    timemultikey("philox4x64", philox4x64_R_multikey, philox4x64_R, philox4x64_rounds);
+#endif
+#endif
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    timemultikey("ars4x32", ars4x32_R_multikey, ars4x32_R, ars4x32_rounds);
+#endif
+    return failures ? 1 : 0;
+}
+
+#endif
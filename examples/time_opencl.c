@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
 #define R123_USE_AES_NI	0 /* never use this for OpenCL */
+#define R123_USE_ARM_AES	0 /* nor this */
 
 #include "util_opencl.h"
 
@@ -70,6 +70,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
    practice.  I.e., we could not find any "real" use of the output of
    the RNG that permitted SSE-ization of the RNG. */
 #define LOOK_AT(A, I, N) do{                                            \
+    if (N>4) if(R123_BUILTIN_EXPECT(!(A.v[N-1]^A.v[N/2]^A.v[N>1?1:0]^A.v[0]), 0)) ++I; \
     if (N==4) if(R123_BUILTIN_EXPECT(!(A.v[N>2?3:0]^A.v[N>2?2:0]^A.v[N>1?1:0]^A.v[0]), 0)) ++I; \
     if (N==2) if(R123_BUILTIN_EXPECT(!(A.v[N>1?1:0]^A.v[0]), 0)) ++I;   \
     if (N==1) if(R123_BUILTIN_EXPECT(!(A.v[0]), 0)) ++I;                \
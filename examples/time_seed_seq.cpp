@@ -0,0 +1,147 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Time making a pool of Engine<Philox4x32>, one per entity, from
+// seed sequences:  with a std::seed_seq of {seed, i} for engine i
+// (with C++11), with r123::seed_seq::child(i), and with all the
+// children's keys at once from r123::seed_seq::child_ukeys.  Then
+// time generate() of the 624 words of a std::mt19937 state from 624
+// values.  The first argument, if given, is the size of the pool.
+
+#include "util.h"
+
+#include <Random123/seed_seq.hpp>
+#include <Random123/philox.h>
+#include <Random123/conventional/Engine.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#if R123_USE_CXX11_RANDOM
+#include <random>
+#endif
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace std;
+
+namespace{
+
+const int REPS = 5;
+typedef r123::Engine<r123::Philox4x32> engine;
+
+uint32_t check = 0;
+
+void report(const string& name, double best, size_t n, const char* per){
+    cout << name << string(name.size() < 36 ? 36-name.size() : 0, ' ')
+         << 1.e9*best/n << " ns per " << per << "\n";
+}
+
+#if R123_USE_CXX11_RANDOM
+void std_children(const r123::seed_seq&, vector<engine>& pool){
+    for(size_t i=0; i<pool.size(); ++i){
+        std::seed_seq s{uint32_t(12345), uint32_t(i)};
+        pool[i] = engine(s);
+    }
+}
+#endif
+
+void r123_children(const r123::seed_seq& ss, vector<engine>& pool){
+    for(size_t i=0; i<pool.size(); ++i){
+        r123::seed_seq c = ss.child(i);
+        pool[i] = engine(c);
+    }
+}
+
+void r123_child_ukeys(const r123::seed_seq& ss, vector<engine>& pool){
+    vector<engine::ukey_type> uk(pool.size());
+    ss.child_ukeys(&uk[0], uk.size());
+    for(size_t i=0; i<pool.size(); ++i)
+        pool[i] = engine(uk[i]);
+}
+
+void time_pool(const string& name, void (*make)(const r123::seed_seq&, vector<engine>&), size_t n){
+    const uint32_t seed = 12345;
+    r123::seed_seq ss(&seed, &seed+1);
+    vector<engine> pool(n);
+    double best = 1.e30, clk;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        make(ss, pool);
+        double dur = ::timer(&clk);
+        if(dur < best)
+            best = dur;
+        check ^= pool[r%n]();
+    }
+    report(name, best, n, "engine");
+}
+
+template <typename SeedSeq>
+void time_generate(const string& name){
+    vector<uint32_t> v(624), out(624);
+    for(size_t i=0; i<v.size(); ++i)
+        v[i] = uint32_t(i*2654435761u);
+    double best = 1.e30, clk;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        SeedSeq s(v.begin(), v.end());
+        s.generate(out.begin(), out.end());
+        double dur = ::timer(&clk);
+        if(dur < best)
+            best = dur;
+        check ^= out[r];
+    }
+    report(name, best, out.size(), "word");
+}
+
+} // namespace <anon>
+
+int main(int argc, char **argv){
+    progname = argv[0];
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 0;
+    if(n == 0)
+        n = 1<<16;
+    cout << "A pool of " << n << " Engine<Philox4x32>:\n";
+#if R123_USE_CXX11_RANDOM
+    time_pool("std::seed_seq{seed, i}", std_children, n);
+#endif
+    time_pool("r123::seed_seq::child(i)", r123_children, n);
+    time_pool("r123::seed_seq::child_ukeys", r123_child_ukeys, n);
+    cout << "624 words from 624 values:\n";
+#if R123_USE_CXX11_RANDOM
+    time_generate<std::seed_seq>("std::seed_seq");
+#endif
+    time_generate<r123::seed_seq>("r123::seed_seq");
+    cout << "(check " << check << ")\n";
+    return 0;
+}
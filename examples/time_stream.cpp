@@ -0,0 +1,189 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Show what a large philox4x32_R_fill does to the caches, as seen by
+// a memory-bound kernel (a sum over a working set small enough to
+// stay in L2) that runs between the fills.  The same 64 MiB of
+// output is made three ways:  by one call, which is larger than
+// R123_FILL_STREAM_BYTES and so is written with non-temporal stores;
+// by calls on 1 MiB pieces, which go through the caches and evict
+// the working set;  and in 256 KiB tiles, each consumed (summed)
+// right after it is made, compared with filling everything and then
+// consuming it.  The working set size, in KiB, may be given as the
+// first argument.  The outputs must be the same bits every way; if
+// they are not, this exits with a non-zero status.
+
+#include "util.h"
+#include "util_cpu.h"
+
+#include <Random123/philox.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+const char *progname;
+int debug = 0;
+int verbose = 0;
+
+using namespace std;
+
+#if !(R123_USE_SSE || R123_USE_NEON)
+int main(int, char **argv){
+    progname = argv[0];
+    cout << "No SSE or NEON.  Nothing to time\n";
+    return 0;
+}
+#else
+
+namespace{
+
+const size_t NBIG = (size_t)64 << 20;       // bytes of generator output
+const size_t PIECE = (size_t)1 << 20;       // a fill small enough to be cached
+const size_t TILE = (size_t)256 << 10;      // a tile that stays in L2
+const int REPS = 10;
+
+// The memory-bound kernel:  a sum over n words, n a multiple of 4.
+template <typename T>
+uint64_t sum(const T* p, size_t n){
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for(size_t i=0; i<n; i+=4){
+        s0 += p[i];
+        s1 += p[i+1];
+        s2 += p[i+2];
+        s3 += p[i+3];
+    }
+    return s0+s1+s2+s3;
+}
+
+// 64-byte aligned storage for n counters.
+philox4x32_ctr_t* aligned(vector<char>& v, size_t n){
+    v.resize(n*sizeof(philox4x32_ctr_t) + 64);
+    char* p = &v[0];
+    return reinterpret_cast<philox4x32_ctr_t*>(p + (64 - (uintptr_t)p%64)%64);
+}
+
+} // namespace <anon>
+
+int main(int argc, char **argv){
+    progname = argv[0];
+    double hz = clockspeedHz(0, 0);
+    if(hz == 0.){
+        cout << "Unknown clock speed; the cpB figures are in nanoseconds per byte\n";
+        hz = 1.e9;
+    }
+    size_t wsbytes = (size_t)(argc > 1 ? atoi(argv[1]) : 1024) << 10;
+    if(wsbytes == 0)
+        wsbytes = (size_t)1 << 10;
+    vector<uint64_t> ws(wsbytes/sizeof(uint64_t), 1);
+    const size_t n = NBIG/sizeof(philox4x32_ctr_t);
+    vector<char> av, bv;
+    philox4x32_ctr_t* a = aligned(av, n);
+    philox4x32_ctr_t* b = aligned(bv, n);
+    philox4x32_ctr_t c0 = {{}};
+    philox4x32_key_t k = {{0x12345678, 0x9abcdef0}};
+    const size_t npiece = PIECE/sizeof(philox4x32_ctr_t);
+    uint64_t check = 0;
+    double clk, dur;
+
+    // The kernel by itself, warm.
+    double alone = 1.e30;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        check += sum(&ws[0], ws.size());
+        dur = ::timer(&clk);
+        if(dur < alone)
+            alone = dur;
+    }
+    cout << "working set " << (wsbytes>>10) << " KiB, fills of " << (NBIG>>20) << " MiB, R123_FILL_STREAM_BYTES = " << R123_FILL_STREAM_BYTES << "\n";
+    cout << "kernel alone:                 " << hz*alone/wsbytes << " cpB\n";
+
+    // The fill in cached pieces, and in one streamed call, each
+    // followed by a pass of the kernel.
+    double fillt[2] = {0., 0.}, kernt[2] = {0., 0.};
+    for(int r=0; r<REPS; ++r){
+        for(int streamed=0; streamed<2; ++streamed){
+            philox4x32_ctr_t* out = streamed ? b : a;
+            check += sum(&ws[0], ws.size());
+            ::timer(&clk);
+            if(streamed){
+                philox4x32_fill(c0, k, out, n);
+            }else{
+                philox4x32_ctr_t c = c0;
+                for(size_t i=0; i<n; i+=npiece){
+                    philox4x32_fill(c, k, out+i, npiece);
+                    c.v[0] += (uint32_t)npiece;
+                }
+            }
+            fillt[streamed] += ::timer(&clk);
+            check += sum(&ws[0], ws.size());
+            kernt[streamed] += ::timer(&clk);
+        }
+    }
+    int failures = memcmp(a, b, NBIG) != 0;
+    const char* names[2] = {"cached", "streamed"};
+    for(int s=0; s<2; ++s)
+        cout << "kernel after " << names[s] << " fill:" << (s ? " " : "   ") << "   " << hz*kernt[s]/REPS/wsbytes << " cpB  (the fill: " << hz*fillt[s]/REPS/NBIG << " cpB)\n";
+
+    // Generate, then consume, in L2-sized tiles, or all at once.
+    const size_t ntile = TILE/sizeof(philox4x32_ctr_t);
+    double whole = 1.e30, tiled = 1.e30;
+    uint64_t swhole = 0, stiled = 0;
+    for(int r=0; r<REPS; ++r){
+        ::timer(&clk);
+        philox4x32_fill(c0, k, a, n);
+        swhole = sum(reinterpret_cast<const uint32_t*>(a), NBIG/sizeof(uint32_t));
+        dur = ::timer(&clk);
+        if(dur < whole)
+            whole = dur;
+        ::timer(&clk);
+        philox4x32_ctr_t c = c0;
+        stiled = 0;
+        for(size_t i=0; i<n; i+=ntile){
+            philox4x32_fill(c, k, b, ntile);
+            stiled += sum(reinterpret_cast<const uint32_t*>(b), TILE/sizeof(uint32_t));
+            c.v[0] += (uint32_t)ntile;
+        }
+        dur = ::timer(&clk);
+        if(dur < tiled)
+            tiled = dur;
+    }
+    failures += swhole != stiled;
+    cout << "fill, then consume:           " << hz*whole/NBIG << " cpB\n";
+    cout << "fill and consume by tiles:    " << hz*tiled/NBIG << " cpB\n";
+    if(check == 0)  // keep the kernel passes from being optimized away
+        cout << "\n";
+    if(failures)
+        cout << "MISMATCH\n";
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -42,6 +42,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <vector>
 #if R123_USE_X86INTRIN_H
 #include <x86intrin.h>
 #endif
@@ -57,12 +58,15 @@ using namespace std;
 
 namespace{
     template <typename B> void timer();
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    void ctr_xor_timer();
+#endif
 } // namespace <anon>
 
 int main(int argc, char **argv){
     progname = argv[0];
     debug = 0;
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
     if( argc == 1 || strcmp(argv[1], "ARS")==0 ){
     if(haveAESNI()){
         timer<ARS1xm128i_R<5> >();
@@ -77,12 +81,18 @@ int main(int argc, char **argv){
     }
 #else
     cout << "This binary is not compiled with AES-NI support.  Skipping the ARS bijections\n";
-#endif // R123_USE_AES_NI
+#endif // R123_USE_AES_NI || R123_USE_ARM_AES
 
     if( argc == 1 || strcmp(argv[1], "AES")==0 ){
 #if R123_USE_AES_OPENSSL
     cout << "\n";
     timer<AESOpenSSL16x8>();
+#endif
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    if(haveAESNI()){
+        cout << "\n";
+        ctr_xor_timer();
+    }
 #endif
     }
 
@@ -158,7 +168,7 @@ bool nz(const CtrType v){
     return false;
 }
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 // The "obvious" solution for ctr_types whose value_type doesn't
 // have += defined (e.g., m128i) would be to overload += on the
 // value_type.  But we can't do that in gcc because m128i is typedefed
@@ -170,7 +180,11 @@ r123array1xm128i& operator+=(r123array1xm128i& lhs, r123array1xm128i rhs){
     typedef r123array1xm128i CtrType;
     CtrType::const_iterator rp = rhs.cbegin();
     for(CtrType::iterator lp=lhs.begin(); lp!=lhs.end(); ++lp)
+#if R123_USE_AES_NI
         lp->m = _mm_xor_si128(*lp, *rp++);
+#else
+        lp->m = veorq_u64(*lp, *rp++);
+#endif
     return lhs;
 }
 #endif
@@ -234,6 +248,52 @@ void timer(){
         cout << "Don't let the compiler optimize it all away... sum==0.  That's a surprise!\n";
 }
 
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+// aes_ctr_xor applies the AES-128 counter-mode keystream to a buffer
+// in place.  Its rate is comparable to the bijections' above, e.g.,
+// AESNI1xm128i's and AESOpenSSL16x8's, which make the keystream a
+// block at a time.
+void ctr_xor_timer(){
+    const size_t bytes_per_call = 1<<16;
+    std::vector<unsigned char> buf(bytes_per_call);
+    AESNI1xm128i::ukey_type uk = {{}};
+    AESNI1xm128i::key_type k(uk);
+    AESNI1xm128i::ctr_type iv = {{}};
+    uint_fast64_t N = 1000;
+    cout << "aes_ctr_xor: gran: " << bytes_per_call;
+
+    double clk;
+    ::timer(&clk);
+    for(uint_fast64_t i=0; i<N; ++i)
+        aes_ctr_xor(k, iv, &buf[0], &buf[0], bytes_per_call, i*bytes_per_call);
+    double dur = ::timer(&clk);
+    double clockspeed = clockspeedHz(0, 0);
+
+    double bestrate = 0.;
+    double bestdur = 0.;
+    uint_fast64_t bestN = 0;
+    for(size_t t=0; t<5; ++t){
+        N = (uint_fast64_t)(N*(0.1/dur)) + 1;
+        ::timer(&clk);
+        for(uint_fast64_t i=0; i<N; ++i)
+            aes_ctr_xor(k, iv, &buf[0], &buf[0], bytes_per_call, i*bytes_per_call);
+        dur = ::timer(&clk);
+        double rate = N*bytes_per_call/dur;
+        if( rate > bestrate ){
+            bestrate = rate;
+            bestN = N;
+            bestdur = dur;
+        }
+    }
+    cout << " (best of 5) " << bestN << " calls in " << bestdur << " sec. rate: " << bestrate*1.e-9 << "GB/s  cpB: " << clockspeed/bestrate << endl;
+    unsigned char sum = 0;
+    for(size_t i=0; i<bytes_per_call; ++i)
+        sum |= buf[i];
+    if(!sum)
+        cout << "Don't let the compiler optimize it all away... sum==0.  That's a surprise!\n";
+}
+#endif
+
 } // namespace <anonymous>
 
 
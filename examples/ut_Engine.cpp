@@ -32,7 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // TODO - really do a thorough and complete set of tests.
 
 #ifdef _MSC_FULL_VER
-// Engines have multiple copy constructors, quite legal C++, disable MSVC complaint
+// Without type_traits, Engines have multiple copy constructors, quite legal C++, disable MSVC complaint
 #pragma warning (disable : 4521)
 #endif
 
@@ -46,8 +46,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <random>
 #endif
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 #include "util_demangle.hpp"
 
 using namespace std;
@@ -81,6 +83,44 @@ struct DummySeedSeq{
     }
 };
 
+// A CBRNG that counts its calls, to check that copying an Engine
+// does not call it.
+struct CountingPhilox4x32 : public Philox4x32{
+    static unsigned long calls;
+    ctr_type operator()(ctr_type c, key_type k) const{
+        ++calls;
+        return Philox4x32::operator()(c, k);
+    }
+};
+unsigned long CountingPhilox4x32::calls;
+
+// Check that copies of e, part way through a block, carry on with
+// the same values as e.
+template <typename EType>
+void chkcopies(EType& e){
+    const EType ce(e);
+    EType e1(e);
+    EType e2(ce);
+    EType e3 = e;
+    EType e4;
+    e4 = ce;
+    vector<EType> v(1, e);
+    for(int i=0; i<10; ++i)
+        v.push_back(v.back());   // reallocates
+#if R123_USE_CXX11_TRIVIALLY_COPYABLE
+    R123_STATIC_ASSERT(std::is_trivially_copyable<EType>::value, "Engines should be trivially copyable");
+    EType e5;
+    memcpy((void*)&e5, (const void*)&e, sizeof(e));
+#else
+    EType e5(e);
+#endif
+    assert(e1 == e && e2 == e && e3 == e && e4 == e && e5 == e && v[10] == e);
+    for(int i=0; i<10; ++i){
+        typename EType::result_type r = e();
+        assert(e1() == r && e2() == r && e3() == r && e4() == r && e5() == r && v[10]() == r);
+    }
+}
+
 template <typename EType>
 void doit(){
     EType e;
@@ -162,6 +202,11 @@ void doit(){
         iss >> e3;
     }
     ASSERTEQ(e3, esave);
+
+    // Check the copy constructors and assignment, part way through a
+    // block.
+    e3();
+    chkcopies(e3);
     
     // Check that the constructor-from-rvalue works.
     EType e4((rtype)99);
@@ -222,7 +267,7 @@ int main(int, char **){
     doit<Engine<ReinterpretCtr<r123array4x32, Threefry2x64 > > >();
     doit<Engine<ReinterpretCtr<r123array2x64, Threefry4x32 > > >();
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
     if( haveAESNI() ){
         doit<Engine<ARS4x32> >();
         doit<Engine<ReinterpretCtr<r123array2x64, ARS4x32> > >();
@@ -235,6 +280,18 @@ int main(int, char **){
     doit<Engine<AESOpenSSL16x8> >();
 #endif
 
+    // Copying or moving an Engine should not call its CBRNG.
+    Engine<CountingPhilox4x32> ce;
+    ce();
+    unsigned long calls = CountingPhilox4x32::calls;
+    Engine<CountingPhilox4x32> ce1(ce), ce2 = ce1;
+    vector<Engine<CountingPhilox4x32> > cv(1, ce);
+    for(int i=0; i<10; ++i)
+        cv.push_back(cv.back());
+    assert(CountingPhilox4x32::calls == calls);
+    assert(ce2 == ce);
+    chkcopies(ce);
+
     cout << "ut_Engine:  all OK" << endl;
     return 0;
 }
@@ -31,10 +31,31 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include <Random123/ReinterpretCtr.hpp>
 #include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <Random123/aes.h>
 #include <iostream>
+#include <cassert>
+#include <cstring>
 #include "util_demangle.hpp"
 
 using namespace r123;
+
+// The bulk form, g(buf, n, k), against g(c, k) one counter at a time.
+template <typename G>
+void chkbulk(G g, typename G::key_type k){
+    typename G::ctr_type buf[37], one[37];
+    for(size_t i=0; i<37; ++i){
+        memset(&buf[i], 0, sizeof(buf[i]));
+        for(size_t j=0; j<=i; ++j)
+            buf[i].incr();
+        one[i] = g(buf[i], k);
+    }
+    g(buf, 37, k);
+    for(size_t i=0; i<37; ++i)
+        assert(buf[i] == one[i]);
+    std::cout << demangle(g) << " bulk OK\n";
+}
+
 int main(int, char **){
     r123array4x32 c = {{}};
     r123array4x32 r;
@@ -43,5 +64,50 @@ int main(int, char **){
     Threefry2x64::key_type kp = {{}};
     r = p(c, kp);
     std::cout << demangle(p) << ": " << r << "\n";
+    Threefry2x64::ctr_type c64 = {{}};
+    c64 = Threefry2x64()(c64, kp);
+    assert(memcmp(&r, &c64, sizeof(r)) == 0);
+    chkbulk(p, kp);
+
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    // SIMD ctr_types:  ARS4x32 already does with loads and stores
+    // what ReinterpretCtr<r123array4x32, ARS1xm128i> does.
+    r123array4x32 c4 = {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+    ARS4x32::key_type k4 = {{0xa4093822, 0x299f31d0, 0x082efa98, 0xec4e6c89}};
+    ARS1xm128i::key_type k128;
+    memcpy(&k128, &k4, sizeof(k4));
+    ReinterpretCtr<r123array4x32, ARS1xm128i> a;
+    assert(a(c4, k128) == ARS4x32()(c4, k4));
+    chkbulk(a, k128);
+#if R123_USE_AES_NI
+    if(haveAESNI()){
+        AESNI1xm128i::ukey_type uk;
+        memcpy(&uk, &k4, sizeof(k4));
+        AESNI1xm128i::key_type ak(uk);
+        ReinterpretCtr<r123array2x64, AESNI1xm128i> e;
+        r123array2x64 c2;
+        memcpy(&c2, &c4, sizeof(c4));
+        r123array2x64 r2 = e(c2, ak);
+        AESNI1xm128i::ctr_type c128;
+        memcpy(&c128, &c4, sizeof(c4));
+        c128 = AESNI1xm128i()(c128, ak);
+        assert(memcmp(&r2, &c128, sizeof(r2)) == 0);
+        chkbulk(e, ak);
+    }
+#endif
+#endif
+#if R123_USE_AVX2
+    // And the other way around:  an __m256i ctr_type for Threefry4x64.
+    ReinterpretCtr<r123array1xm256i, Threefry4x64> t;
+    Threefry4x64::key_type k256 = {{1, 2, 3, 4}};
+    Threefry4x64::ctr_type c256 = {{5, 6, 7, 8}};
+    r123array1xm256i m;
+    memcpy(&m, &c256, sizeof(m));
+    m = t(m, k256);
+    c256 = Threefry4x64()(c256, k256);
+    assert(memcmp(&m, &c256, sizeof(m)) == 0);
+    chkbulk(t, k256);
+#endif
+    std::cout << "ut_ReinterpretCtr: OK\n";
     return 0;
 }
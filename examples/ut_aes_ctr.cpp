@@ -0,0 +1,186 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check aes_ctr_xor against the CTR-AES128 example in NIST SP 800-38A
+// and against AESNI1xm128i applied one block at a time, with unaligned
+// buffers, partial blocks, byte offsets, counters that carry between
+// the 64-bit halves and wrap, and in-place use.
+
+#include <Random123/aes.h>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#if !(R123_USE_AES_NI || R123_USE_ARM_AES)
+int main(int, char **){
+    std::cout << "No AES-NI.  Nothing to check\n";
+    return 0;
+}
+#else
+
+using namespace std;
+using namespace r123;
+
+typedef AESNI1xm128i::ctr_type ctr_type;
+
+ctr_type from_bytes(const unsigned char* b){
+    ctr_type c;
+#if R123_USE_AES_NI
+    c.v[0].m = _mm_loadu_si128((const __m128i*)b);
+#else
+    c.v[0].m = vreinterpretq_u64_u8(vld1q_u8(b));
+#endif
+    return c;
+}
+
+void to_bytes(ctr_type c, unsigned char* b){
+#if R123_USE_AES_NI
+    _mm_storeu_si128((__m128i*)b, c.v[0].m);
+#else
+    vst1q_u8(b, vreinterpretq_u8_u64(c.v[0].m));
+#endif
+}
+
+unsigned char hex(char h){
+    return (unsigned char)(h<='9' ? h-'0' : h-'a'+10);
+}
+
+void from_hex(const char* s, unsigned char* b){
+    for(size_t i=0; s[2*i]; ++i)
+        b[i] = (unsigned char)(hex(s[2*i])<<4 | hex(s[2*i+1]));
+}
+
+// Bytes [pos, pos+n) of the keystream, a block at a time, with a
+// bytewise big-endian increment.
+void reference(const AESNI1xm128i::key_type& k, const unsigned char* iv, size_t pos, size_t n, unsigned char* ks){
+    unsigned char c[16], b[16];
+    memcpy(c, iv, 16);
+    for(size_t blk=0; blk*16<pos+n; ++blk){
+        to_bytes(AESNI1xm128i()(from_bytes(c), k), b);
+        for(size_t j=0; j<16; ++j)
+            if(blk*16+j >= pos && blk*16+j < pos+n)
+                ks[blk*16+j-pos] = b[j];
+        for(int j=15; j>=0 && ++c[j]==0; --j)
+            ;
+    }
+}
+
+int main(int, char **){
+    if(!haveAESNI()){
+        cout << "The AES-NI instructions are not available on this hardware.  Skipping aes_ctr_xor tests\n";
+        return 0;
+    }
+
+    // F.5.1 CTR-AES128.Encrypt
+    unsigned char ukb[16], ivb[16], pt[64], ct[64], buf[64];
+    from_hex("2b7e151628aed2a6abf7158809cf4f3c", ukb);
+    from_hex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff", ivb);
+    from_hex("6bc1bee22e409f96e93d7e117393172a" "ae2d8a571e03ac9c9eb76fac45af8e51"
+             "30c81c46a35ce411e5fbc1191a0a52ef" "f69f2445df4f9b17ad2b417be66c3710", pt);
+    from_hex("874d6191b620e3261bef6864990db6ce" "9806f66b7970fdff8617187bb9fffdff"
+             "5ae4df3edbd5d35e5b4f09020db03eab" "1e031dda2fbe03d1792170a0f3009cee", ct);
+    AESNI1xm128i::ukey_type uk = from_bytes(ukb);
+    AESNI1xm128i::key_type k(uk);
+    ctr_type iv = from_bytes(ivb);
+    aes_ctr_xor(k, iv, pt, buf, sizeof(buf));
+    assert(memcmp(buf, ct, sizeof(ct)) == 0);
+    aes_ctr_xor(k, iv, buf, buf, sizeof(buf));
+    assert(memcmp(buf, pt, sizeof(pt)) == 0);
+    // The same, split at odd offsets.
+    aes_ctr_xor(k, iv, pt, buf, 5);
+    aes_ctr_xor(k, iv, pt+5, buf+5, 30, 5);
+    aes_ctr_xor(k, iv, pt+35, buf+35, 29, 35);
+    assert(memcmp(buf, ct, sizeof(ct)) == 0);
+    cout << "aes_ctr_xor matches NIST SP 800-38A F.5.1\n";
+
+    // Initial counters whose low half is about to carry into the high
+    // half, and one about to wrap around 2^128.
+    const char* ivs[] = {
+        "000102030405060708090a0b0c0d0e0f",
+        "0123456789abcdeffffffffffffffff3",
+        "00000000000000fffffffffffffffffe",
+        "fffffffffffffffffffffffffffffff9",
+    };
+    const size_t N = 1000;
+    vector<unsigned char> in(N+16), out(N+16), ks(N);
+    uint64_t z = R123_64BIT(0x9e3779b97f4a7c15);
+    for(size_t i=0; i<in.size(); ++i){
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        in[i] = (unsigned char)(z>>56);
+    }
+    const size_t lens[] = {0, 1, 15, 16, 17, 127, 128, 129, 255, 256, 257, 300, 511, 512, 777, N};
+    for(size_t v=0; v<sizeof(ivs)/sizeof(*ivs); ++v){
+        from_hex(ivs[v], ivb);
+        iv = from_bytes(ivb);
+        for(size_t l=0; l<sizeof(lens)/sizeof(*lens); ++l){
+            for(size_t pos=0; pos<40; pos+=(pos<17 ? 1 : 11)){
+                size_t n = lens[l] < N-pos ? lens[l] : N-pos;
+                reference(k, ivb, pos, n, &ks[0]);
+                // Unaligned input and output.
+                for(size_t a=0; a<16; a+=5){
+                    aes_ctr_xor(k, iv, &in[a], &out[(a*3)%16], n, pos);
+                    for(size_t i=0; i<n; ++i)
+                        assert(out[(a*3)%16+i] == (in[a+i]^ks[i]));
+                }
+                // In place, and twice to restore the data.
+                vector<unsigned char> x(in);
+                aes_ctr_xor(k, iv, &x[1], &x[1], n, pos);
+                for(size_t i=0; i<n; ++i)
+                    assert(x[1+i] == (in[1+i]^ks[i]));
+                aes_ctr_xor(k, iv, &x[1], &x[1], n, pos);
+                assert(x == in);
+            }
+        }
+        // Split across several calls, as threads would.
+        vector<unsigned char> whole(N), parts(N);
+        aes_ctr_xor(k, iv, &in[0], &whole[0], N);
+        const size_t cuts[] = {0, 3, 131, 400, 401, 656, N};
+        for(size_t c=0; c+1<sizeof(cuts)/sizeof(*cuts); ++c)
+            aes_ctr_xor(k, iv, &in[cuts[c]], &parts[cuts[c]], cuts[c+1]-cuts[c], cuts[c]);
+        assert(whole == parts);
+    }
+
+    // A byte offset can carry into the high half.
+    from_hex("0000000000000000f000000000000000", ivb);
+    iv = from_bytes(ivb);
+    from_hex("00000000000000010000000000000000", ivb);
+    ctr_type iv2 = from_bytes(ivb);
+    aes_ctr_xor(k, iv, &in[0], &out[0], 300, ~(R123_ULONG_LONG)0 - 15);
+    vector<unsigned char> y(300);
+    aes_ctr_xor(k, iv2, &in[16], &y[0], 284);
+    assert(memcmp(&out[16], &y[0], 284) == 0);
+    cout << "aes_ctr_xor OK\n";
+    return 0;
+}
+
+#endif
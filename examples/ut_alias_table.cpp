@@ -0,0 +1,211 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::alias_table: the quantized masses reproduce the
+// weights, the table does not depend on the number of construction
+// parts, and the vectorized and bulk samplers agree with the scalar one.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/alias_table.hpp>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+const uint64_t C = R123_64BIT(1)<<32;
+
+// The exact mass of each category in units of 2^-32 slots.
+vector<uint64_t> masses(const alias_table& t){
+    vector<uint64_t> m(t.size());
+    for(size_t i=0; i<t.size(); ++i){
+        if(t.alias(i) == i){
+            assert(t.threshold(i) == 0xffffffff);
+            m[i] += C;
+        }else{
+            m[i] += t.threshold(i);
+            m[t.alias(i)] += C - t.threshold(i);
+        }
+    }
+    return m;
+}
+
+bool same(const alias_table& a, const alias_table& b){
+    if(a.size() != b.size())
+        return false;
+    for(size_t i=0; i<a.size(); ++i)
+        if(a.threshold(i) != b.threshold(i) || a.alias(i) != b.alias(i))
+            return false;
+    return true;
+}
+
+template <typename E>
+void chkthrows(const double* w, size_t n){
+    bool threw = false;
+    try{
+        alias_table t(w, n);
+    }catch(E&){
+        threw = true;
+    }
+    assert(threw);
+}
+
+void chkweights(const vector<double>& w){
+    size_t n = w.size();
+    double W = 0.;
+    for(size_t i=0; i<n; ++i)
+        W += w[i];
+    alias_table t(&w[0], n);
+    assert(t.size() == n);
+    vector<uint64_t> m = masses(t);
+    uint64_t total = 0;
+    for(size_t i=0; i<n; ++i){
+        double expected = w[i]/W*n*4294967296.;
+        assert(std::fabs(m[i] - expected) <= 2. + expected*1.e-9);
+        if(w[i] == 0.)
+            assert(m[i] == 0);
+        total += m[i];
+    }
+    assert(total == n*C);
+
+    // The table must not depend on how construction is split.
+    static const unsigned nparts[] = {2, 3, 7, 64, 1000};
+    for(size_t j=0; j<sizeof(nparts)/sizeof(*nparts); ++j)
+        assert(same(t, alias_table(&w[0], n, nparts[j])));
+    // Run the stages of a builder out of part order, as threads might.
+    alias_table::builder bld(&w[0], n, 5);
+    for(int s=0; s<bld.nstages; ++s){
+        for(unsigned p=bld.parts(); p-- > 0; )
+            bld.run(s, p);
+        bld.finish(s);
+    }
+    assert(same(t, alias_table(bld)));
+
+    // Vectorized sample() must agree with operator(), including
+    // the extreme words.
+    Philox4x32 b;
+    Philox4x32::ctr_type c = {{}};
+    Philox4x32::key_type k = {{(uint32_t)n}};
+    vector<uint32_t> r(1003), out(r.size());
+    for(size_t i=0; i<r.size(); i+=4){
+        Philox4x32::ctr_type x = b(c, k);
+        c.incr();
+        for(size_t e=0; e<4 && i+e<r.size(); ++e)
+            r[i+e] = x[e];
+    }
+    r[0] = 0;
+    r[1] = 0xffffffff;
+    r[17] = 0x80000000;
+    t.sample(&r[0], &out[0], r.size());
+    for(size_t i=0; i<r.size(); ++i){
+        assert(out[i] == t(r[i]));
+        assert(w[out[i]] > 0.);
+    }
+}
+
+template <typename CBRNG>
+void chkfill(const alias_table& t){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+    CBRNG b;
+    ctr_type c0 = {{}};
+    key_type k = {{}};
+    k[0] = 42;
+    const size_t M = c0.size()*sizeof(value_type)/4;
+    const size_t m = 100*M + 3;
+    vector<uint32_t> out(m), pieces(m);
+    t.fill(b, k, c0, &out[0], m);
+    ctr_type c = c0;
+    for(size_t i=0; i<m; i+=M, c.incr()){
+        ctr_type r = b(c, k);
+        for(size_t j=0; j<M && i+j<m; ++j){
+            value_type v = r[j*4/sizeof(value_type)];
+            uint32_t word = (uint32_t)(v >> (32*(j%(sizeof(value_type)/4))));
+            assert(out[i+j] == t(word));
+        }
+    }
+    c = c0;
+    t.fill(b, k, c, &pieces[0], 37*M);
+    c.incr(37);
+    t.fill(b, k, c, &pieces[37*M], m-37*M);
+    assert(out == pieces);
+}
+
+int main(int, char **){
+    // Errors
+    double w0[] = {1., -1., 2.};
+    chkthrows<std::invalid_argument>(w0, 0);
+    chkthrows<std::invalid_argument>(w0, 3);
+    double wz[] = {0., 0.};
+    chkthrows<std::invalid_argument>(wz, 2);
+    double wn[] = {1., std::sqrt(-1.)};
+    chkthrows<std::invalid_argument>(wn, 2);
+
+    // A single category, uniform weights, and some awkward ones.
+    chkweights(vector<double>(1, 3.));
+    chkweights(vector<double>(10, 1.));
+    vector<double> w;
+    for(size_t i=0; i<10000; ++i)
+        w.push_back(i%7 == 0 ? 0. : double((i*2654435761u)%1000));
+    w[5000] = 1.e6;
+    w[9999] = 1.e-300;
+    chkweights(w);
+    vector<double> spike(9000, 0.);
+    spike[8191] = 1.;
+    chkweights(spike);
+
+    // Empirical frequencies from the bulk sampler.
+    double wf[] = {1., 2., 3., 0., 4.};
+    alias_table t(wf, 5);
+    vector<uint32_t> out(1000000);
+    Philox4x32::ctr_type c = {{}};
+    Philox4x32::key_type k = {{1}};
+    t.fill(Philox4x32(), k, c, &out[0], out.size());
+    vector<double> count(5);
+    for(size_t i=0; i<out.size(); ++i)
+        count[out[i]]++;
+    for(size_t i=0; i<5; ++i){
+        double p = wf[i]/10.;
+        double sd = std::sqrt(out.size()*p*(1-p));
+        assert(std::fabs(count[i] - out.size()*p) <= 6.*sd);
+    }
+    assert(count[3] == 0.);
+
+    chkfill<Philox4x32>(t);
+    chkfill<Threefry4x64>(alias_table(&w[0], w.size()));
+    chkfill<Threefry2x32>(t);
+    cout << "alias_table OK\n";
+    return 0;
+}
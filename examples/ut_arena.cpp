@@ -0,0 +1,125 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::arena and r123::arena_allocator:  alignment, capacity,
+// the return of the most recent allocation, exhaustion, and arrays
+// of MicroURNGs and of fill output in arena-allocated vectors, which
+// must give the same numbers as with std::allocator.
+
+#include <Random123/arena.hpp>
+#include <Random123/philox.h>
+#include <Random123/MicroURNG.hpp>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+typedef MicroURNG<Philox4x32> U;
+
+int main(int, char **){
+    {
+        arena a(1);
+        assert(a.capacity() == arena::huge_page);
+        assert((uintptr_t)a.allocate(0) % arena::huge_page == 0);
+        char* prev = 0;
+        for(size_t n=1; n<1000; n=3*n+1){
+            char* p = static_cast<char*>(a.allocate(n));
+            assert((uintptr_t)p % 64 == 0);
+            assert(prev == 0 || p > prev);
+            memset(p, 0xa5, n);
+            prev = p;
+        }
+        // The most recent allocation comes back;  others do not.
+        size_t used = a.used();
+        void* p = a.allocate(100);
+        a.deallocate(p, 100);
+        assert(a.used() == used);
+        void* q = a.allocate(100);
+        assert(q == p);
+        a.allocate(64);
+        a.deallocate(q, 100);
+        assert(a.used() == used + 128 + 64);
+        bool threw = false;
+        try{
+            a.allocate(a.capacity());
+        }catch(std::bad_alloc&){
+            threw = true;
+        }
+        assert(threw);
+        a.reset();
+        assert(a.used() == 0);
+        assert(a.allocate(a.capacity()) != 0);
+        cout << "arena (" << a.backing() << ") OK\n";
+    }
+
+    // A vector of MicroURNGs, one per "particle".
+    const size_t n = 100000;
+    arena a(n*sizeof(U) + (4<<20));
+    vector<U, arena_allocator<U> > urngs((arena_allocator<U>(a)));
+    vector<U> ref;
+    urngs.reserve(n);
+    ref.reserve(n);
+    for(size_t i=0; i<n; ++i){
+        Philox4x32::ctr_type c = {{(uint32_t)i, 0, 0, 0}};
+        Philox4x32::key_type k = {{0x12345678, 0x9abcdef0}};
+        urngs.push_back(U(c, k));
+        ref.push_back(U(c, k));
+    }
+    assert((uintptr_t)&urngs[0] % 64 == 0);
+    assert(a.used() >= n*sizeof(U));
+    for(size_t j=0; j<3; ++j)
+        for(size_t i=0; i<n; i+=(i%7)+1)
+            assert(urngs[i]() == ref[i]());
+
+    // Fill output, which is aligned, so that large fills stream.
+    arena_allocator<philox4x32_ctr_t> ca(urngs.get_allocator());
+    assert(ca == urngs.get_allocator());
+    vector<philox4x32_ctr_t, arena_allocator<philox4x32_ctr_t> > out(1000, philox4x32_ctr_t(), ca);
+    assert((uintptr_t)&out[0] % 64 == 0);
+    philox4x32_ctr_t c0 = {{1, 2, 3, 4}};
+    philox4x32_key_t k = {{5, 6}};
+    for(size_t i=0; i<out.size(); ++i, c0.incr())
+        out[i] = philox4x32(c0, k);
+    c0.v[0] = 1;
+#if R123_USE_SSE || R123_USE_NEON
+    vector<philox4x32_ctr_t> out2(out.size());
+    philox4x32_fill(c0, k, &out2[0], out2.size());
+    assert(memcmp(&out[0], &out2[0], out.size()*sizeof(out[0])) == 0);
+#endif
+    arena b(1);
+    assert(arena_allocator<int>(b) != arena_allocator<int>(a));
+    cout << "arena_allocator OK\n";
+    return 0;
+}
@@ -77,6 +77,46 @@ inline uint32_t get32<r123m128i>(const r123m128i& t, size_t n){
 }
 #endif
 
+#if R123_USE_AVX2
+template<>
+inline r123m256i zero<r123m256i>(){ r123m256i M; M.m=_mm256_setzero_si256(); return M;}
+
+template<>
+inline r123m256i fff<r123m256i>(){ r123m256i M; M.m=_mm256_set1_epi32(~0); return M;}
+
+template<>
+inline R123_ULONG_LONG ull<r123m256i>(const r123m256i& t){
+    return _mm_extract_lo64(_mm256_castsi256_si128(t.m));
+}
+
+template <>
+inline uint32_t get32<r123m256i>(const r123m256i& t, size_t n){
+    uint32_t u[8];
+    _mm256_storeu_si256((__m256i*)u, t.m);
+    return u[n];
+}
+#endif
+
+#if R123_USE_AVX512
+template<>
+inline r123m512i zero<r123m512i>(){ r123m512i M; M.m=_mm512_setzero_si512(); return M;}
+
+template<>
+inline r123m512i fff<r123m512i>(){ r123m512i M; M.m=_mm512_set1_epi32(~0); return M;}
+
+template<>
+inline R123_ULONG_LONG ull<r123m512i>(const r123m512i& t){
+    return _mm_extract_lo64(_mm512_castsi512_si128(t.m));
+}
+
+template <>
+inline uint32_t get32<r123m512i>(const r123m512i& t, size_t n){
+    uint32_t u[16];
+    _mm512_storeu_si512(u, t.m);
+    return u[n];
+}
+#endif
+
 struct dummySeedSeq{
     typedef uint32_t result_type;
     template <typename ITER>
@@ -245,6 +285,39 @@ void doit(size_t N, size_t W){
     cout << " OK\n";
 }
 
+#if R123_USE_AVX2
+// The carries from word to word of the 64-bit words of an r123m256i
+// or r123m512i, M, with NW words.
+template <typename M, size_t NW>
+void chkcarry(){
+    uint64_t u[NW], w[NW];
+    for(size_t k=0; k<NW; ++k){
+        // words 0 to k-1 are all ones, so that adding 3 carries into word k.
+        for(size_t i=0; i<NW; ++i)
+            u[i] = i<k ? ~(uint64_t)0 : 5+i;
+        std::stringstream ss;
+        for(size_t i=0; i<NW; ++i)
+            ss << u[i] << " ";
+        M m, m1;
+        ss >> m;
+        m1 = m;
+        m += 3;
+        for(int i=0; i<3; ++i)
+            ++m1;
+        assert(m == m1);
+        assert(m != zero<M>());
+        std::stringstream out;
+        out << m;
+        for(size_t i=0; i<NW; ++i)
+            out >> w[i];
+        assert(w[0] == (k ? 2u : 8u));
+        for(size_t i=1; i<NW; ++i)
+            assert(w[i] == (i<k ? 0u : i==k ? 6+i : 5+i));
+    }
+    cout << "chkcarry<" << NW*64 << "> OK\n";
+}
+#endif
+
 
 int main(int, char **){
 #if R123_USE_SSE
@@ -254,7 +327,17 @@ int main(int, char **){
     doit<r123array4x32>(4, 32);
     doit<r123array2x64>(2, 64);
     doit<r123array4x64>(4, 64);
+    doit<r123array8x64>(8, 64);
+    doit<r123array16x64>(16, 64);
     doit<r123array16x8>(16, 8);
+#if R123_USE_AVX2
+    doit<r123array1xm256i>(1, 256);
+    chkcarry<r123m256i, 4>();
+#endif
+#if R123_USE_AVX512
+    doit<r123array1xm512i>(1, 512);
+    chkcarry<r123m512i, 8>();
+#endif
     return 0;
 }
 
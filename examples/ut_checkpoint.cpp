@@ -0,0 +1,233 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check that checkpoint.hpp saves and restores arrays of counters,
+// keys, Engines and MicroURNGs, in memory and through streams, that
+// the bytes are those documented, that bad checkpoints are refused,
+// and that a mapped checkpoint of counters can be used in place.
+
+#include <Random123/checkpoint.hpp>
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace r123;
+
+template <typename T>
+bool throws(const vector<unsigned char>& ck){
+    vector<T> v;
+    try{
+        checkpoint_load(&ck[0], ck.size(), v);
+    }catch(std::runtime_error&){
+        return true;
+    }
+    return false;
+}
+
+// Save in and load it back, through memory and through a stream;
+// eq(a, b) says whether two Ts hold the same state.
+template <typename T, typename EQ>
+vector<T> roundtrip(const vector<T>& in, EQ eq){
+    vector<unsigned char> ck(checkpoint_bytes<T>(in.size()));
+    checkpoint_save(&in[0], in.size(), &ck[0]);
+    ostringstream os;
+    checkpoint_save(os, &in[0], in.size());
+    assert(os.str().size() == ck.size() && memcmp(os.str().data(), &ck[0], ck.size()) == 0);
+
+    vector<T> a, b;
+    checkpoint_load(&ck[0], ck.size(), a);
+    istringstream is(os.str());
+    checkpoint_load(is, b);
+    assert(a.size() == in.size() && b.size() == in.size());
+    for(size_t i=0; i<in.size(); ++i)
+        assert(eq(a[i], in[i]) && eq(b[i], in[i]));
+
+    // Truncated, not a checkpoint, or of something else.
+    vector<unsigned char> bad(ck.begin(), ck.end()-1);
+    assert(throws<T>(bad));
+    bad.assign(ck.begin(), ck.begin()+10);
+    assert(throws<T>(bad));
+    bad = ck;
+    bad[3] = 'X';
+    assert(throws<T>(bad));
+    bad = ck;
+    bad[8] = 2;
+    assert(throws<T>(bad));
+    assert(throws<r123array1x32>(ck));
+    assert(throws<Engine<Philox2x32> >(ck));
+    assert(throws<MicroURNG<Philox2x32> >(ck));
+    istringstream shortis(os.str().substr(0, os.str().size()-1));
+    bool threw = false;
+    try{ checkpoint_load(shortis, b); }catch(std::runtime_error&){ threw = true; }
+    assert(threw);
+    // A header that claims far more records than follow.
+    string huge = os.str();
+    for(size_t i=40; i<47; ++i)
+        huge[i] = (char)0xff;
+    istringstream hugeis(huge);
+    threw = false;
+    try{ checkpoint_load(hugeis, b); }catch(std::runtime_error&){ threw = true; }
+    assert(threw);
+    return a;
+}
+
+template <typename A>
+bool eqarray(const A& a, const A& b){ return a == b; }
+
+// Engines and MicroURNGs are equal if they give the same next values.
+template <typename U>
+bool eqgen(U a, U b){
+    for(int i=0; i<9; ++i)
+        if(a() != b())
+            return false;
+    return true;
+}
+
+int main(int, char **){
+    // The documented bytes.
+    r123array4x32 c = {{0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c}};
+    unsigned char ck[64+16];
+    assert(checkpoint_bytes<r123array4x32>(1) == sizeof(ck));
+    checkpoint_save(&c, 1, ck);
+    const unsigned char header[48] = {'R','1','2','3','C','K','P','T', 1,0,0,0, 1,0,0,0,
+                                      32,0,0,0, 4,0,0,0, 0,0,0,0, 0,0,0,0, 16,0,0,0, 0,0,0,0,
+                                      1,0,0,0,0,0,0,0};
+    assert(memcmp(ck, header, sizeof(header)) == 0);
+    for(int i=0; i<16; ++i)
+        assert(ck[64+i] == i);
+
+    r123array2x64 e = {{R123_64BIT(0x0706050403020100), R123_64BIT(0x0f0e0d0c0b0a0908)}};
+    vector<r123array2x64> ve(1, e);
+    vector<unsigned char> ck2(checkpoint_bytes<r123array2x64>(1));
+    checkpoint_save(&ve[0], 1, &ck2[0]);
+    assert(ck2[16] == 64 && ck2[20] == 2);
+    for(int i=0; i<16; ++i)
+        assert(ck2[64+i] == i);
+
+    // Counters and keys.
+    vector<r123array4x32> cs(1000);
+    for(size_t i=0; i<cs.size(); ++i){
+        r123array4x32 x = {{(uint32_t)i, (uint32_t)(i*i), 0x9e3779b9u, ~(uint32_t)i}};
+        cs[i] = x;
+    }
+    roundtrip(cs, eqarray<r123array4x32>);
+    vector<r123array2x64> ks(100, e);
+    for(size_t i=0; i<ks.size(); ++i)
+        ks[i].incr(i*R123_64BIT(0x123456789));
+    roundtrip(ks, eqarray<r123array2x64>);
+
+    // Engines and MicroURNGs at every position in a block.
+    vector<Engine<Philox4x32> > engines;
+    vector<Engine<Threefry2x64> > engines2;
+    vector<MicroURNG<Philox4x32> > urngs;
+    vector<MicroURNG<Threefry4x64> > urngs2;
+    for(uint32_t i=0; i<50; ++i){
+        Philox4x32::ukey_type uk = {{i, 7*i}};
+        engines.push_back(Engine<Philox4x32>(uk));
+        engines.back().discard(i*i);
+        Threefry2x64::ukey_type uk2 = {{i, 0}};
+        engines2.push_back(Engine<Threefry2x64>(uk2));
+        engines2.back().discard(i);
+        Philox4x32::ctr_type c0 = {{i, 0, 5, 0}};
+        urngs.push_back(MicroURNG<Philox4x32>(c0, uk));
+        for(uint32_t j=0; j<i; ++j)
+            urngs.back()();
+        Threefry4x64::ctr_type c1 = {{i, 1, 2, 3}};
+        Threefry4x64::ukey_type uk1 = {{4, 5, 6, i}};
+        urngs2.push_back(MicroURNG<Threefry4x64>(c1, uk1));
+        for(uint32_t j=0; j<3*i; ++j)
+            urngs2.back()();
+    }
+    vector<Engine<Philox4x32> > re = roundtrip(engines, eqgen<Engine<Philox4x32> >);
+    for(size_t i=0; i<re.size(); ++i)
+        assert(re[i] == engines[i]);
+    roundtrip(engines2, eqgen<Engine<Threefry2x64> >);
+    vector<MicroURNG<Philox4x32> > ru = roundtrip(urngs, eqgen<MicroURNG<Philox4x32> >);
+    for(size_t i=0; i<ru.size(); ++i)
+        assert(ru[i].position() == i);
+    roundtrip(urngs2, eqgen<MicroURNG<Threefry4x64> >);
+
+    // An Engine's elem past its block, and a MicroURNG's position past
+    // the 2^32 blocks of its counter, are rejected;  the last position
+    // is not.
+    vector<unsigned char> cke(checkpoint_bytes<Engine<Philox4x32> >(1));
+    checkpoint_save(&engines[3], 1, &cke[0]);
+    cke[cke.size()-8] = 5;
+    assert(throws<Engine<Philox4x32> >(cke));
+    vector<unsigned char> cku(checkpoint_bytes<MicroURNG<Threefry4x64> >(1));
+    checkpoint_save(&urngs2[3], 1, &cku[0]);
+    memset(&cku[cku.size()-8], 0, 8);
+    cku[cku.size()-4] = 4;
+    vector<MicroURNG<Threefry4x64> > ul;
+    checkpoint_load(&cku[0], cku.size(), ul);
+    assert(ul[0].position() == (R123_64BIT(4)<<32));
+    cku[cku.size()-8] = 1;
+    assert(throws<MicroURNG<Threefry4x64> >(cku));
+    vector<unsigned char> cku32(checkpoint_bytes<MicroURNG<Philox4x32> >(1));
+    checkpoint_save(&urngs[3], 1, &cku32[0]);
+    cku32[cku32.size()-1] = 1;
+    assert(throws<MicroURNG<Philox4x32> >(cku32));
+    cout << "checkpoint_save and checkpoint_load OK\n";
+
+    // In place, from a mapped file.
+    vector<unsigned char> mem(checkpoint_bytes<r123array4x32>(cs.size()));
+    checkpoint_save(&cs[0], cs.size(), &mem[0]);
+    size_t n = 0;
+    const uint32_t one = 1;
+    if(*(const unsigned char*)&one == 1){
+#if defined(__unix__) || defined(__APPLE__)
+        FILE* f = tmpfile();
+        assert(f && fwrite(&mem[0], 1, mem.size(), f) == mem.size() && fflush(f) == 0);
+        void* p = mmap(0, mem.size(), PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        assert(p != MAP_FAILED);
+        const r123array4x32* v = checkpoint_view<r123array4x32>(p, mem.size(), &n);
+        assert(n == cs.size());
+        for(size_t i=0; i<n; ++i)
+            assert(v[i] == cs[i]);
+        munmap(p, mem.size());
+        fclose(f);
+#endif
+        const r123array4x32* v2 = checkpoint_view<r123array4x32>(&mem[0], mem.size(), &n);
+        assert(n == cs.size() && memcmp(v2, &cs[0], n*sizeof(cs[0])) == 0);
+        cout << "checkpoint_view OK\n";
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check the samplers in continuous.hpp: moments of the sampled
+// distributions, the counter layout of exponential_fill, agreement
+// of the fill functions with the scalar samplers, and independence
+// of the results from how a batch is split.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/continuous.hpp>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "util_demangle.hpp"
+
+using namespace std;
+using namespace r123;
+
+const size_t N = 100000;
+
+// Check that the sample mean and variance of x[0..N) are within
+// a generous number of standard errors of the theoretical values.
+// kurt is the excess kurtosis, which sets the error of the variance.
+void chkmoments(const char *what, const vector<double>& x, double mean, double var, double kurt){
+    double s = 0., ss = 0.;
+    for(size_t i=0; i<x.size(); ++i){
+        double d = x[i] - mean;
+        s += d;
+        ss += d*d;
+    }
+    double n = double(x.size());
+    double dmean = s/n;
+    double svar = ss/n - dmean*dmean;
+    bool ok = std::fabs(dmean) < 6.*std::sqrt(var/n) &&
+        std::fabs(svar - var) < 8.*var*std::sqrt((2.+kurt)/n);
+    if(!ok)
+        cerr << what << ": mean " << mean+dmean << " expected " << mean << " var " << svar << " expected " << var << "\n";
+    assert(ok);
+}
+
+template <typename CBRNG>
+void chkcontinuous(){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    CBRNG b;
+    ctr_type c0 = {{}};
+    key_type k = {{}};
+    k[0] = 2718;
+    vector<double> x(N);
+
+    exponential_fill(b, k, c0, 4., &x[0], N);
+    chkmoments("exponential", x, 0.25, 0.0625, 6.);
+    // out[i] is made from 64-bit word i%M of block c0 + i/M.
+    uint64_t w[16];
+    size_t M = _words64(b(c0, k), w);
+    ctr_type c = c0;
+    c.incr(7);
+    _words64(b(c, k), w);
+    for(size_t j=0; j<M; ++j)
+        assert(x[7*M+j] == -r123_log(u01_open_open_64_53(w[j]))/4.);
+
+    static const double shapes[] = {1.e-3, 0.05, 0.5, 1., 1.5, 7., 1.e3, 1.e8};
+    for(size_t j=0; j<sizeof(shapes)/sizeof(*shapes); ++j){
+        double a = shapes[j];
+        gamma_fill(b, k, c0, gamma_param(a, 2.), &x[0], N);
+        for(size_t i=0; i<N; ++i)
+            assert(x[i] >= 0.);
+        // Excess kurtosis is 6/a, which makes the variance check
+        // useless for tiny shapes; check E[X^(1/4)] there instead.
+        if(a >= 0.05){
+            chkmoments("gamma", x, 2.*a, 4.*a, 6./a);
+        }else{
+            vector<double> y(N);
+            for(size_t i=0; i<N; ++i)
+                y[i] = std::pow(x[i]/2., 0.25);
+            // E[X^s] = Gamma(a+s)/Gamma(a) for X ~ Gamma(a)
+            double m[5];
+            for(int e=1; e<=4; ++e)
+                m[e] = std::exp(lgamma(a+0.25*e) - lgamma(a));
+            double var = m[2] - m[1]*m[1];
+            double mu4 = m[4] - 4.*m[3]*m[1] + 6.*m[2]*m[1]*m[1] - 3.*m[1]*m[1]*m[1]*m[1];
+            chkmoments("gamma^(1/4)", y, m[1], var, mu4/(var*var) - 3.);
+        }
+    }
+
+    static const struct { double a, b; } bps[] = {
+        {1., 1.}, {0.5, 0.5}, {2., 5.}, {0.01, 3.}, {1.e4, 2.e4}
+    };
+    for(size_t j=0; j<sizeof(bps)/sizeof(*bps); ++j){
+        double a = bps[j].a, bb = bps[j].b;
+        beta_fill(b, k, c0, beta_param(a, bb), &x[0], N);
+        for(size_t i=0; i<N; ++i)
+            assert(x[i] >= 0. && x[i] <= 1.);
+        double s = a + bb;
+        double kurt = 6.*((a-bb)*(a-bb)*(s+1.) - a*bb*(s+2.))/(a*bb*(s+2.)*(s+3.));
+        chkmoments("beta", x, a/s, a*bb/(s*s*(s+1.)), kurt);
+    }
+
+    // Filling in pieces, with the counter advanced by the offset of
+    // each piece, must reproduce the single fill exactly.  So must
+    // the per-element-parameter overloads and the scalar samplers.
+    const size_t n = 1000;
+    vector<double> whole(n), pieces(n), perelem(n);
+    vector<gamma_param> gps;
+    for(size_t i=0; i<n; ++i)
+        gps.push_back(gamma_param(i%3 ? 0.3 : 12., 0.5));
+    gamma_fill(b, k, c0, &gps[0], &whole[0], n);
+    size_t splits[] = {0, 1, 2, 63, 64, 333, 999, n};
+    for(size_t s=0; s+1<sizeof(splits)/sizeof(*splits); ++s){
+        c = c0;
+        c.incr(splits[s]);
+        gamma_fill(b, k, c, &gps[splits[s]], &pieces[splits[s]], splits[s+1]-splits[s]);
+    }
+    assert(whole == pieces);
+    c = c0;
+    for(size_t i=0; i<n; ++i, c.incr()){
+        block_stream<CBRNG> s(b, c, k);
+        assert(whole[i] == gamma(gps[i], s));
+    }
+
+    beta_param bp(0.7, 2.5);
+    beta_fill(b, k, c0, bp, &whole[0], n);
+    vector<beta_param> bps2(n, bp);
+    beta_fill(b, k, c0, &bps2[0], &perelem[0], n);
+    assert(whole == perelem);
+    c = c0;
+    for(size_t i=0; i<n; ++i, c.incr()){
+        block_stream<CBRNG> s(b, c, k);
+        assert(whole[i] == beta(bp, s));
+    }
+    c = c0;
+    c.incr(500);
+    beta_fill(b, k, c, bp, &pieces[500], n-500);
+    assert(std::equal(whole.begin()+500, whole.end(), pieces.begin()+500));
+
+    // exponential_fill splits at multiples of M.
+    exponential_fill(b, k, c0, 1., &whole[0], n);
+    c = c0;
+    c.incr(100);
+    exponential_fill(b, k, c, 1., &pieces[100*M], n-100*M);
+    assert(std::equal(whole.begin()+100*M, whole.end(), pieces.begin()+100*M));
+
+    cout << "continuous " << demangle(b) << " OK\n";
+}
+
+int main(int, char **){
+    bool threw = false;
+    try{ gamma_param bad(0.); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{ gamma_param bad(1., -1.); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{ beta_param bad(1., HUGE_VAL); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{
+        double x;
+        Philox4x32::ctr_type c = {{}};
+        Philox4x32::key_type k = {{}};
+        exponential_fill(Philox4x32(), k, c, 0., &x, 1);
+    }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+
+    chkcontinuous<Philox4x32>();
+    chkcontinuous<Threefry2x64>();
+    chkcontinuous<Philox2x32>();
+#if R123_USE_PHILOX_64BIT
+    chkcontinuous<Philox4x64>();
+#endif
+    return 0;
+}
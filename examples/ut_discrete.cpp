@@ -0,0 +1,203 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check the discrete samplers in discrete.hpp: block_stream counter
+// layout, moments of the sampled distributions, and independence of
+// the results from how a batch is split.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/discrete.hpp>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "util_demangle.hpp"
+
+using namespace std;
+using namespace r123;
+
+const size_t N = 100000;
+
+// Check that the sample mean and variance of x[0..N) are within
+// a generous number of standard errors of the theoretical values.
+template <typename IntType>
+void chkmoments(const char *what, const vector<IntType>& x, double mean, double var){
+    double s = 0., ss = 0.;
+    for(size_t i=0; i<x.size(); ++i){
+        double d = double(x[i]) - mean;
+        s += d;
+        ss += d*d;
+    }
+    double n = double(x.size());
+    double dmean = s/n;
+    double svar = ss/n - dmean*dmean;
+    bool ok = std::fabs(dmean) < 6.*std::sqrt(var/n) + 1.e-12 &&
+        std::fabs(svar - var) < 8.*var*std::sqrt(2./n) + 1.e-12;
+    if(!ok)
+        cerr << what << ": mean " << mean+dmean << " expected " << mean << " var " << svar << " expected " << var << "\n";
+    assert(ok);
+}
+
+template <typename CBRNG>
+void chkblock_stream(){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+    const size_t W = std::numeric_limits<value_type>::digits;
+    CBRNG b;
+    ctr_type c0 = {{}};
+    key_type k = {{}};
+    c0[0] = 17;
+    k[0] = 99;
+    block_stream<CBRNG> s(b, c0, k);
+    for(value_type n=0; n<3; ++n){
+        ctr_type c = c0;
+        c[c.size()-1] |= n<<(W-32);
+        ctr_type r = b(c, k);
+        assert(s.block(n) == r);
+        for(size_t j=0; j<r.size(); ++j)
+            assert(s() == r[j]);
+    }
+    block_stream<CBRNG> s2(b, c0, k);
+    s2();
+    s2.skip_blocks(1);
+    assert(s2() == s.block(2)[0]);
+
+    c0[c0.size()-1] = value_type(1)<<(W-1);
+    bool threw = false;
+    try{
+        block_stream<CBRNG> bad(b, c0, k);
+    }catch(std::runtime_error&){
+        threw = true;
+    }
+    assert(threw);
+}
+
+template <typename CBRNG>
+void chkdiscrete(){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    CBRNG b;
+    ctr_type c0 = {{}};
+    key_type k = {{}};
+    k[0] = 12345;
+    vector<uint64_t> x(N);
+
+    static const double mus[] = {0., 0.25, 3., 9.99, 10., 47.5, 1.e4, 3.e9};
+    for(size_t j=0; j<sizeof(mus)/sizeof(*mus); ++j){
+        poisson_param pp(mus[j]);
+        poisson_fill(b, k, c0, pp, &x[0], N);
+        chkmoments("poisson", x, mus[j], mus[j]);
+    }
+
+    static const struct { uint64_t n; double p; } bps[] = {
+        {0, 0.5}, {1, 0.5}, {20, 0.}, {20, 1.}, {20, 0.3}, {100, 0.95},
+        {1000, 0.01}, {1000, 0.5}, {100000, 0.999}, {R123_64BIT(1)<<40, 1.e-3}
+    };
+    for(size_t j=0; j<sizeof(bps)/sizeof(*bps); ++j){
+        binomial_param bp(bps[j].n, bps[j].p);
+        binomial_fill(b, k, c0, bp, &x[0], N);
+        double n = double(bps[j].n), p = bps[j].p;
+        chkmoments("binomial", x, n*p, n*p*(1.-p));
+        for(size_t i=0; i<N; ++i)
+            assert(x[i] <= bps[j].n);
+    }
+
+    static const double gps[] = {1., 0.5, 0.01, 1.e-9};
+    for(size_t j=0; j<sizeof(gps)/sizeof(*gps); ++j){
+        geometric_param gp(gps[j]);
+        geometric_fill(b, k, c0, gp, &x[0], N);
+        double q = 1.-gps[j];
+        chkmoments("geometric", x, q/gps[j], q/(gps[j]*gps[j]));
+    }
+
+    // Filling in pieces, with the counter advanced by the offset of
+    // each piece, must reproduce the single fill exactly.  So must
+    // the per-element-parameter overloads and the scalar samplers.
+    const size_t n = 1000;
+    vector<uint32_t> whole(n), pieces(n), perelem(n);
+    vector<poisson_param> pps;
+    for(size_t i=0; i<n; ++i)
+        pps.push_back(poisson_param(i%2 ? 4.5 : 250.));
+    poisson_fill(b, k, c0, &pps[0], &whole[0], n);
+    size_t splits[] = {0, 1, 2, 333, 334, 999, n};
+    for(size_t s=0; s+1<sizeof(splits)/sizeof(*splits); ++s){
+        ctr_type c = c0;
+        c.incr(splits[s]);
+        poisson_fill(b, k, c, &pps[splits[s]], &pieces[splits[s]], splits[s+1]-splits[s]);
+    }
+    assert(whole == pieces);
+    ctr_type c = c0;
+    for(size_t i=0; i<n; ++i, c.incr()){
+        block_stream<CBRNG> s(b, c, k);
+        assert(whole[i] == poisson(pps[i], s));
+    }
+
+    binomial_param bp(5000, 0.3);
+    binomial_fill(b, k, c0, bp, &whole[0], n);
+    vector<binomial_param> bps2(n, bp);
+    binomial_fill(b, k, c0, &bps2[0], &perelem[0], n);
+    assert(whole == perelem);
+    c = c0;
+    c.incr(500);
+    binomial_fill(b, k, c, bp, &pieces[500], n-500);
+    assert(std::equal(whole.begin()+500, whole.end(), pieces.begin()+500));
+
+    geometric_param gp(0.125);
+    geometric_fill(b, k, c0, gp, &whole[0], n);
+    vector<geometric_param> gps2(n, gp);
+    geometric_fill(b, k, c0, &gps2[0], &perelem[0], n);
+    assert(whole == perelem);
+
+    cout << "discrete " << demangle(b) << " OK\n";
+}
+
+int main(int, char **){
+    bool threw = false;
+    try{ poisson_param bad(-1.); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{ binomial_param bad(10, 1.5); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{ geometric_param bad(0.); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+
+    chkblock_stream<Philox4x32>();
+    chkblock_stream<Threefry2x64>();
+    chkdiscrete<Philox4x32>();
+    chkdiscrete<Threefry2x64>();
+#if R123_USE_PHILOX_64BIT
+    chkdiscrete<Philox2x64>();
+#endif
+    return 0;
+}
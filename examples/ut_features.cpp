@@ -205,6 +205,17 @@ Otrue(R123_USE_CXX11_TYPE_TRAITS);
 Ofalse(R123_USE_CXX11_TYPE_TRAITS);
 #endif
 
+#ifndef R123_USE_CXX11_TRIVIALLY_COPYABLE
+#error "No  R123_USE_CXX11_TRIVIALLY_COPYABLE"
+#endif
+#if R123_USE_CXX11_TRIVIALLY_COPYABLE
+Otrue(R123_USE_CXX11_TRIVIALLY_COPYABLE);
+#include <type_traits>
+typedef char trivially_copyable_check[std::is_trivially_copyable<int>::value ? 1 : -1];
+#else
+Ofalse(R123_USE_CXX11_TRIVIALLY_COPYABLE);
+#endif
+
 #ifndef R123_USE_CXX11_LONG_LONG
 #error "No  R123_USE_CXX11_LONG_LONG"
 #endif
@@ -236,6 +247,81 @@ __m128i aes(__m128i in){
 Ofalse(R123_USE_AES_NI);
 #endif
 
+#ifndef R123_USE_AVX512
+#error "No  R123_USE_AVX512"
+#endif
+#if R123_USE_AVX512
+Otrue(R123_USE_AVX512);
+__m512i avx512(__m512i in){
+    return _mm512_add_epi64(in, in);
+}
+#else
+Ofalse(R123_USE_AVX512);
+#endif
+
+#ifndef R123_USE_AVX512IFMA
+#error "No  R123_USE_AVX512IFMA"
+#endif
+#if R123_USE_AVX512IFMA
+Otrue(R123_USE_AVX512IFMA);
+__m512i avx512ifma(__m512i in){
+    return _mm512_madd52lo_epu64(in, in, in);
+}
+#else
+Ofalse(R123_USE_AVX512IFMA);
+#endif
+
+#ifndef R123_USE_VAES
+#error "No  R123_USE_VAES"
+#endif
+#if R123_USE_VAES
+Otrue(R123_USE_VAES);
+#if R123_USE_AVX2
+__m256i vaes(__m256i in){
+    return _mm256_aesenc_epi128(in, in);
+}
+#endif
+#else
+Ofalse(R123_USE_VAES);
+#endif
+
+#ifndef R123_USE_AVX2
+#error "No  R123_USE_AVX2"
+#endif
+#if R123_USE_AVX2
+Otrue(R123_USE_AVX2);
+__m256i avx2(__m256i in){
+    return _mm256_add_epi64(in, in);
+}
+#else
+Ofalse(R123_USE_AVX2);
+#endif
+
+#ifndef R123_USE_NEON
+#error "No  R123_USE_NEON"
+#endif
+#if R123_USE_NEON
+#include <arm_neon.h>
+Otrue(R123_USE_NEON);
+uint32x4_t neon(uint32x4_t in){
+    return vaddq_u32(in, in);
+}
+#else
+Ofalse(R123_USE_NEON);
+#endif
+
+#ifndef R123_USE_ARM_AES
+#error "No  R123_USE_ARM_AES"
+#endif
+#if R123_USE_ARM_AES
+Otrue(R123_USE_ARM_AES);
+uint8x16_t armaes(uint8x16_t in){
+    return vaesmcq_u8(vaeseq_u8(in, in));
+}
+#else
+Ofalse(R123_USE_ARM_AES);
+#endif
+
 #ifndef R123_USE_SSE4_2
 #error "No  R123_USE_SSE4_2"
 #endif
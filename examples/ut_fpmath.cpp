@@ -0,0 +1,280 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check fpmath.h: special values, known answers, the error bounds
+// against the long double library functions on a sweep of arguments,
+// the float versions, and that every available vector version
+// returns exactly the bits of the scalar version.
+
+#include <Random123/fpmath.h>
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// |got - ref| in units of the last place of ref (as a double).
+double ulps(double got, long double ref){
+    double r = fabs((double)ref);
+    double u = (r < DBL_MIN) ? 4.9406564584124654e-324 : nextafter(r, HUGE_VAL) - r;
+    return (double)(fabsl((long double)got - ref)/u);
+}
+
+// The same, in units of the last place of ref as a float.
+double ulpsf(float got, long double ref){
+    float r = fabsf((float)ref);
+    float u = (r < FLT_MIN) ? 1.4012984643e-45f : nextafterf(r, HUGE_VALF) - r;
+    return (double)(fabsl((long double)got - ref)/u);
+}
+
+bool isnan_(double x){ return x != x; }
+
+uint64_t bits(double x){
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+// Outputs of the scalar functions, which every platform must reproduce.
+struct kat1 { const char *fn; double x; uint64_t r; };
+const kat1 kats[] = {
+    {"log", 0.5, R123_64BIT(0xbfe62e42fefa39ef)},
+    {"log", 3.0, R123_64BIT(0x3ff193ea7aad030a)},
+    {"log", 1.e-300, R123_64BIT(0xc085963447f87fb5)},
+    {"log", 7.5000000000000018e-310, R123_64BIT(0xc0863e4ab3d4064e)},
+    {"log", 123456.789, R123_64BIT(0x40277281cad8a844)},
+    {"log", 0.999999, R123_64BIT(0xbeb0c6f82d74d230)},
+    {"exp", -700.5, R123_64BIT(0x00c4ff475c68ca02)},
+    {"exp", -0.3, R123_64BIT(0x3fe7b4c869c37c05)},
+    {"exp", 0.7, R123_64BIT(0x40001c2a61268987)},
+    {"exp", 1.0, R123_64BIT(0x4005bf0a8b14576a)},
+    {"exp", 35.25, R123_64BIT(0x431cf0ad459e69b1)},
+    {"exp", 709.5, R123_64BIT(0x7fe81e9b4b52d0c9)},
+    {"exp", -744.5, R123_64BIT(0x0000000000000001)},
+    {"sin", 0.25, R123_64BIT(0x3fcfaaeed4f31577)},
+    {"cos", 0.25, R123_64BIT(0x3fef01549f7deea1)},
+    {"sin", -2.0, R123_64BIT(0xbfed18f6ead1b446)},
+    {"cos", -2.0, R123_64BIT(0xbfdaa22657537205)},
+    {"sin", 3.14159, R123_64BIT(0x3ec6428a6aa44cd0)},
+    {"cos", 3.14159, R123_64BIT(0xbfefffffffff8420)},
+    {"sin", 100.0, R123_64BIT(0xbfe03425b78c4db8)},
+    {"cos", 100.0, R123_64BIT(0x3feb981dbf665fdf)},
+    {"sin", -12345.678, R123_64BIT(0x3fe687d5890974a5)},
+    {"cos", -12345.678, R123_64BIT(0x3fe6b94c3bbe24b8)},
+    {"sin", 1.5e6, R123_64BIT(0x3fe05a19f9bf8b6c)},
+    {"cos", 1.5e6, R123_64BIT(0xbfeb81b10301dab6)}
+};
+
+double scalar(const char *fn, double x){
+    double s, c;
+    if(strcmp(fn, "log") == 0)
+        return r123_log(x);
+    if(strcmp(fn, "exp") == 0)
+        return r123_exp(x);
+    r123_sincos(x, &s, &c);
+    return strcmp(fn, "sin") == 0 ? s : c;
+}
+
+// Check that the vector functions for V, which holds lanes of type
+// T, agree bitwise with the scalar functions on a[] and b[].
+template <typename V, typename T>
+void chkvector(const char *name, const vector<T>& a, const vector<T>& b,
+               V (*vlog)(V), V (*vexp)(V), V (*vsqrt)(V), void (*vsincos)(V, V*, V*),
+               void (*vboxmuller)(V, V, V*, V*),
+               T (*slog)(T), T (*sexp)(T), T (*ssqrt)(T), void (*ssincos)(T, T*, T*),
+               void (*sboxmuller)(T, T, T*, T*)){
+    const size_t W = sizeof(V)/sizeof(T);
+    for(size_t i=0; i+W<=a.size(); i+=W){
+        V x, y, r[7];
+        T vr[7][W], sr[7];
+        memcpy(&x, &a[i], sizeof(V));
+        memcpy(&y, &b[i], sizeof(V));
+        r[0] = vlog(x);
+        r[1] = vexp(x);
+        r[2] = vsqrt(y);
+        vsincos(x, &r[3], &r[4]);
+        vboxmuller(y, x, &r[5], &r[6]);
+        memcpy(vr, r, sizeof(r));
+        for(size_t j=0; j<W; ++j){
+            sr[0] = slog(a[i+j]);
+            sr[1] = sexp(a[i+j]);
+            sr[2] = ssqrt(b[i+j]);
+            ssincos(a[i+j], &sr[3], &sr[4]);
+            sboxmuller(b[i+j], a[i+j], &sr[5], &sr[6]);
+            for(int k=0; k<7; ++k){
+                bool ok = memcmp(&vr[k][j], &sr[k], sizeof(T)) == 0;
+                if(!ok)
+                    cerr << name << ": function " << k << " differs from the scalar version at " << a[i+j] << ", " << b[i+j] << "\n";
+                assert(ok);
+            }
+        }
+    }
+    cout << "fpmath " << name << " OK\n";
+}
+
+int main(int, char **){
+    const double inf = HUGE_VAL;
+    assert(r123_log(1.) == 0.);
+    assert(r123_log(0.) == -inf);
+    assert(r123_log(-0.) == -inf);
+    assert(r123_log(inf) == inf);
+    assert(isnan_(r123_log(-1.)));
+    assert(isnan_(r123_log(-inf)));
+    assert(isnan_(r123_log(inf-inf)));
+    assert(r123_exp(0.) == 1.);
+    assert(r123_exp(-0.) == 1.);
+    assert(r123_exp(inf) == inf);
+    assert(r123_exp(-inf) == 0.);
+    assert(r123_exp(710.) == inf);
+    assert(r123_exp(-746.) == 0.);
+    assert(isnan_(r123_exp(inf-inf)));
+    // The smallest subnormal, and the largest finite result.
+    assert(r123_exp(-745.) == 4.9406564584124654e-324);
+    assert(r123_exp(709.78) < inf);
+    double s, c;
+    r123_sincos(0., &s, &c);
+    assert(bits(s) == 0 && c == 1.);
+    r123_sincos(-0., &s, &c);
+    assert(bits(s) == bits(-0.) && c == 1.);
+    r123_sincos(1.e-310, &s, &c);
+    assert(s == 1.e-310 && c == 1.);
+    r123_sincos(1647099., &s, &c);
+    assert(!isnan_(s) && !isnan_(c));
+    r123_sincos(1647100., &s, &c);
+    assert(isnan_(s) && isnan_(c));
+    r123_sincos(-inf, &s, &c);
+    assert(isnan_(s) && isnan_(c));
+    r123_sincos(inf-inf, &s, &c);
+    assert(isnan_(s) && isnan_(c));
+    assert(r123_sqrt(2.) == sqrt(2.));
+
+    for(size_t i=0; i<sizeof(kats)/sizeof(*kats); ++i){
+        double r = scalar(kats[i].fn, kats[i].x);
+        if(bits(r) != kats[i].r)
+            cerr << "r123_" << kats[i].fn << "(" << kats[i].x << ") = " << r << ", not the known answer\n";
+        assert(bits(r) == kats[i].r);
+    }
+
+    double maxlog = 0., maxexp = 0., maxsc = 0., maxf = 0.;
+    vector<double> a, b;
+    vector<float> af, bf;
+    uint64_t z = R123_64BIT(0x9e3779b97f4a7c15);
+    for(int i=0; i<2000000; ++i){
+        // A cheap 64-bit LCG; the arguments need not be random, only varied.
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        double x;
+        uint64_t xbits = (z>>1) & R123_64BIT(0x7fefffffffffffff);
+        memcpy(&x, &xbits, sizeof(x));
+        double e = ulps(r123_log(x), logl((long double)x));
+        maxlog = e > maxlog ? e : maxlog;
+        double y = ldexp((double)(z>>11), -53);
+        e = ulps(r123_log(y), logl((long double)y));
+        maxlog = e > maxlog ? e : maxlog;
+        double t = -745. + 1454.7*y;
+        e = ulps(r123_exp(t), expl((long double)t));
+        maxexp = e > maxexp ? e : maxexp;
+        t = 2.*y - 1.;
+        e = ulps(r123_exp(t), expl((long double)t));
+        maxexp = e > maxexp ? e : maxexp;
+        t = (i%2 ? 8. : 1647099.)*(2.*y - 1.);
+        r123_sincos(t, &s, &c);
+        e = ulps(s, sinl((long double)t));
+        maxsc = e > maxsc ? e : maxsc;
+        e = ulps(c, cosl((long double)t));
+        maxsc = e > maxsc ? e : maxsc;
+        if(i%8 == 0){
+            float tf = (float)(100.*(2.*y - 1.)), sf, cf;
+            e = ulpsf(r123_logf(fabsf(tf)), logl(fabsl((long double)tf)));
+            maxf = e > maxf ? e : maxf;
+            e = ulpsf(r123_expf(tf), expl((long double)tf));
+            maxf = e > maxf ? e : maxf;
+            r123_sincosf(tf, &sf, &cf);
+            e = ulpsf(sf, sinl((long double)tf));
+            maxf = e > maxf ? e : maxf;
+            e = ulpsf(cf, cosl((long double)tf));
+            maxf = e > maxf ? e : maxf;
+        }
+        if(i < 20000){
+            // Arguments for the vector checks: the whole double range
+            // for log, exp, sin and cos, and uniforms in (0, 1].
+            double xa = i%3 == 0 ? x : (i%3 == 1 ? t : 1454.7*y - 745.);
+            a.push_back(z&1 ? -xa : xa);
+            b.push_back(y + ldexp(1., -54));
+            af.push_back((float)a.back());
+            bf.push_back((float)b.back());
+        }
+    }
+    if(maxlog >= 1. || maxexp >= 1. || maxsc >= 1. || maxf >= 0.51)
+        cerr << "max error: r123_log " << maxlog << " ulp, r123_exp " << maxexp << " ulp, r123_sincos "
+             << maxsc << " ulp, float " << maxf << " ulp\n";
+    assert(maxlog < 1.);
+    assert(maxexp < 1.);
+    assert(maxsc < 1.);
+    assert(maxf < 0.51);
+    cout << "fpmath OK\n";
+
+    // The special values must come out the same in every lane too.
+    const double specials[] = {0., -0., inf, -inf, inf-inf, 1.e-310, -1.e-310, 710., -746., 1647100., 1.};
+    for(size_t i=0; i<sizeof(specials)/sizeof(*specials); ++i){
+        a[i] = specials[i];
+        af[i] = (float)specials[i];
+    }
+    b[0] = 1.;
+    bf[0] = 1.f;
+#if R123_USE_SSE
+    chkvector<__m128d, double>("m128d", a, b, r123_log_m128d, r123_exp_m128d, r123_sqrt_m128d, r123_sincos_m128d, r123_boxmuller_m128d,
+                               r123_log, r123_exp, r123_sqrt, r123_sincos, r123_boxmuller);
+    chkvector<__m128, float>("m128", af, bf, r123_log_m128, r123_exp_m128, r123_sqrt_m128, r123_sincos_m128, r123_boxmuller_m128,
+                             r123_logf, r123_expf, r123_sqrtf, r123_sincosf, r123_boxmullerf);
+#endif
+#if R123_USE_AVX2
+    chkvector<__m256d, double>("m256d", a, b, r123_log_m256d, r123_exp_m256d, r123_sqrt_m256d, r123_sincos_m256d, r123_boxmuller_m256d,
+                               r123_log, r123_exp, r123_sqrt, r123_sincos, r123_boxmuller);
+    chkvector<__m256, float>("m256", af, bf, r123_log_m256, r123_exp_m256, r123_sqrt_m256, r123_sincos_m256, r123_boxmuller_m256,
+                             r123_logf, r123_expf, r123_sqrtf, r123_sincosf, r123_boxmullerf);
+#endif
+#if R123_USE_AVX512
+    chkvector<__m512d, double>("m512d", a, b, r123_log_m512d, r123_exp_m512d, r123_sqrt_m512d, r123_sincos_m512d, r123_boxmuller_m512d,
+                               r123_log, r123_exp, r123_sqrt, r123_sincos, r123_boxmuller);
+    chkvector<__m512, float>("m512", af, bf, r123_log_m512, r123_exp_m512, r123_sqrt_m512, r123_sincos_m512, r123_boxmuller_m512,
+                             r123_logf, r123_expf, r123_sqrtf, r123_sincosf, r123_boxmullerf);
+#endif
+#if R123_USE_NEON && defined(__aarch64__)
+    chkvector<float64x2_t, double>("f64x2", a, b, r123_log_f64x2, r123_exp_f64x2, r123_sqrt_f64x2, r123_sincos_f64x2, r123_boxmuller_f64x2,
+                                   r123_log, r123_exp, r123_sqrt, r123_sincos, r123_boxmuller);
+    chkvector<float32x4_t, float>("f32x4", af, bf, r123_log_f32x4, r123_exp_f32x4, r123_sqrt_f32x4, r123_sincos_f32x4, r123_boxmuller_f32x4,
+                                  r123_logf, r123_expf, r123_sqrtf, r123_sincosf, r123_boxmullerf);
+#endif
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::keyed_hash:  that its values are words of the blocks of
+// the counters described in keyed_hash.hpp (and so, for input 0 and
+// key 0, the known answers of kat_vectors), that the batched hashes
+// and hashes128 agree with hash for all the vector widths and batch
+// tails, that too many hashes of a 128-bit input are refused, and
+// that each of the hash functions spreads consecutive inputs evenly
+// over buckets.
+
+#include <Random123/keyed_hash.hpp>
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+// The counter of block j of the input (lo, hi), or of lo alone if
+// words is 1, a word at a time.
+template <typename CBRNG>
+typename CBRNG::ctr_type ref_counter(uint64_t lo, uint64_t hi, size_t words, uint64_t j){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename ctr_type::value_type value_type;
+    const size_t W = 8*sizeof(value_type);
+    ctr_type c = {{}};
+    size_t m = 0;
+    for(size_t h=0; h<64*words; h+=W){
+        uint64_t v = h < 64 ? lo : hi;
+        c[m++] = (value_type)(v >> (h%64));
+    }
+    if(m < c.size())
+        c[m] = (value_type)j;
+    return c;
+}
+
+template <typename CBRNG>
+uint32_t ref_hash(const typename CBRNG::key_type& k, uint64_t lo, uint64_t hi, size_t words, unsigned i){
+    typedef typename CBRNG::ctr_type ctr_type;
+    const unsigned S = sizeof(ctr_type)/4;
+    ctr_type r = CBRNG()(ref_counter<CBRNG>(lo, hi, words, i/S), k);
+    uint32_t w[sizeof(ctr_type)/4];
+    for(unsigned s=0; s<S; ++s){
+        uint64_t v = (uint64_t)r[s*4/sizeof(r[0])];
+        w[s] = (uint32_t)(sizeof(r[0]) == 4 ? v : v >> (32*(s%2)));
+    }
+    return w[i%S];
+}
+
+template <typename CBRNG>
+void chk(const char* name){
+    typedef keyed_hash<CBRNG> H;
+    typename CBRNG::key_type k;
+    uint64_t z = R123_64BIT(0x9e3779b97f4a7c15);
+    for(size_t i=0; i<k.size(); ++i){
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        k[i] = (typename CBRNG::key_type::value_type)z;
+    }
+    H h(k);
+    const unsigned S = H::per_block;
+    const bool room = H::max_hashes128() == 0;
+
+    // Single values, against the counters built here.
+    vector<uint64_t> x(2*300);
+    for(size_t e=0; e<x.size(); ++e){
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        x[e] = e < 40 ? (uint64_t)e : z;
+    }
+    for(size_t e=0; e<300; ++e){
+        for(unsigned i=0; i<2*S+1; ++i){
+            assert(h.hash(x[e], i) == ref_hash<CBRNG>(k, x[e], 0, 1, i));
+            if(i < S || room)
+                assert(h.hash(x[2*e], x[2*e+1], i) == ref_hash<CBRNG>(k, x[2*e], x[2*e+1], 2, i));
+        }
+    }
+
+    // The batched versions, for all the tails.
+    const size_t ns[] = {0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 129, 300};
+    const unsigned ks[] = {1, 2, 3, 4, 5, 7, 8, 9, 12};
+    for(size_t a=0; a<sizeof(ns)/sizeof(*ns); ++a){
+        size_t n = ns[a];
+        for(size_t b=0; b<sizeof(ks)/sizeof(*ks); ++b){
+            unsigned nk = ks[b];
+            vector<uint32_t> out(n*nk+1, 0xdeadbeef), one(nk);
+            h.hashes(&x[0], n, nk, &out[0]);
+            for(size_t e=0; e<n; ++e){
+                h.hashes(x[e], nk, &one[0]);
+                for(unsigned i=0; i<nk; ++i){
+                    assert(out[e*nk+i] == h.hash(x[e], i));
+                    assert(one[i] == out[e*nk+i]);
+                }
+            }
+            assert(out[n*nk] == 0xdeadbeef);
+            if(nk > S && !room){
+                bool threw = false;
+                try{
+                    h.hashes128(&x[0], n, nk, &out[0]);
+                }catch(std::invalid_argument&){
+                    threw = true;
+                }
+                assert(threw);
+                continue;
+            }
+            h.hashes128(&x[0], n, nk, &out[0]);
+            for(size_t e=0; e<n; ++e){
+                h.hashes(x[2*e], x[2*e+1], nk, &one[0]);
+                for(unsigned i=0; i<nk; ++i){
+                    assert(out[e*nk+i] == h.hash(x[2*e], x[2*e+1], i));
+                    assert(one[i] == out[e*nk+i]);
+                }
+            }
+            assert(out[n*nk] == 0xdeadbeef);
+        }
+    }
+    if(!room){
+        bool threw = false;
+        try{
+            h.hash(1, 2, S);
+        }catch(std::invalid_argument&){
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // Consecutive inputs into 64 buckets by the top bits of each hash
+    // function:  chi-squared, 63 degrees of freedom, far from its
+    // mean of 63 only if something is badly wrong.
+    const unsigned nk = 8;
+    const size_t n = 1<<16;
+    vector<uint64_t> seq(n);
+    for(size_t e=0; e<n; ++e)
+        seq[e] = e;
+    vector<uint32_t> out(n*nk);
+    h.hashes(&seq[0], n, nk, &out[0]);
+    for(unsigned i=0; i<nk; ++i){
+        vector<double> cnt(64, 0.);
+        for(size_t e=0; e<n; ++e)
+            cnt[out[e*nk+i] >> 26] += 1.;
+        double chi2 = 0., expect = n/64.;
+        for(size_t b=0; b<64; ++b)
+            chi2 += (cnt[b]-expect)*(cnt[b]-expect)/expect;
+        assert(chi2 < 140.);
+    }
+    cout << "keyed_hash<" << name << "> OK\n";
+}
+
+int main(int, char **){
+    // Input 0, block 0, key 0 is the counter and key of all zeros.
+    philox4x32_key_t pk = {{}};
+    keyed_hash<Philox4x32> hp(pk);
+    assert(hp.hash(0, 0) == 0x6627e8d5 && hp.hash(0, 1) == 0xe169c58d);
+    assert(hp.hash(0, 2) == 0xbc57ac4c && hp.hash(0, 3) == 0x9b00dbd8);
+    threefry2x64_key_t tk = {{}};
+    keyed_hash<Threefry2x64> ht(tk);
+    assert(ht.hash(0, 0) == 0xc2c69865 && ht.hash(0, 1) == 0xc2b6e3a8);
+    assert(ht.hash(0, 2) == 0xf350084d && ht.hash(0, 3) == 0x6f81ed42);
+
+    chk<Philox4x32_R<7> >("Philox4x32_R<7>");
+    chk<Philox4x32>("Philox4x32");
+    chk<Threefry2x64_R<13> >("Threefry2x64_R<13>");
+    chk<Threefry2x64>("Threefry2x64");
+    chk<Threefry4x32>("Threefry4x32");
+    chk<Threefry4x64>("Threefry4x64");
+#if R123_USE_PHILOX_64BIT
+    chk<Philox4x64_R<7> >("Philox4x64_R<7>");
+#endif
+    return 0;
+}
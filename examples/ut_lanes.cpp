@@ -0,0 +1,178 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check the multi-lane Philox and Threefry functions built on
+// features/lanes.h, for every instruction set the compiler has been
+// asked for, against the scalar functions:  on varied counters, keys
+// and numbers of rounds, and, for the fill functions, on counters
+// that carry into every word, with both the AoS and the SoA
+// (column) output, aligned and not, streamed and not.  ut_philox_simd and ut_neon check some
+// of them against the known answers as well.
+
+// A small threshold, so that the larger fills below are streamed.
+#define R123_FILL_STREAM_BYTES 256
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#if !(R123_USE_SSE || R123_USE_NEON)
+#include <stdio.h>
+int main(){ printf("No SSE or NEON.  Nothing to check\n"); return 0; }
+#else
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+template <typename Ctr, typename Key>
+struct multilane{
+    Ctr (*scalar)(unsigned, Ctr, Key);
+    unsigned maxR;
+};
+
+// A cheap 64-bit LCG; the inputs need not be random, only varied.
+uint64_t z = R123_64BIT(0x9e3779b97f4a7c15);
+uint64_t lcg(){
+    z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+    return z;
+}
+
+template <typename Ctr, typename Key>
+void chkx(const char* name, const multilane<Ctr, Key>& f, void (*xL)(unsigned, const Ctr*, Key, Ctr*), size_t L){
+    typedef typename Ctr::value_type value_type;
+    Ctr in[16], out[16];
+    Key k;
+    assert(L <= 16);
+    for(unsigned n=0; n<10000; ++n){
+        for(size_t j=0; j<L; ++j)
+            for(size_t w=0; w<4; ++w)
+                in[j].v[w] = (value_type)lcg();
+        for(size_t w=0; w<k.size(); ++w)
+            k.v[w] = (value_type)lcg();
+        unsigned R = n%(f.maxR+1);
+        for(size_t j=0; j<L; ++j)
+            out[j] = f.scalar(R, in[j], k);
+        // in place
+        xL(R, in, k, in);
+        assert(memcmp(in, out, L*sizeof(Ctr)) == 0);
+    }
+    cout << name << " OK\n";
+}
+
+template <typename Ctr, typename Key>
+void chkfill(const char* name, const multilane<Ctr, Key>& f, void (*fill)(unsigned, Ctr, Key, Ctr*, size_t), void (*fill_soa)(unsigned, Ctr, Key, typename Ctr::value_type* const*, size_t)){
+    typedef typename Ctr::value_type value_type;
+    const value_type m = ~(value_type)0;
+    const value_type starts[][4] = {{0, 0, 0, 0}, {m-40, 5, 6, 7}, {m-9, m, 3, 4}, {m-3, m, m, 1}, {m-17, m, m, m}, {m, 0, 0, 0}};
+    // 64-byte aligned space for the outputs, which are placed at each
+    // offset (in counters, or in words for the columns) from 0 to 3,
+    // and, for the columns, at different offsets, to take the
+    // streaming and the unaligned paths, with guard words past the
+    // end.
+    const size_t per64 = 64/sizeof(value_type);
+    value_type raw[4*(104+per64) + per64];
+    value_type* base = raw + (per64 - ((uintptr_t)raw/sizeof(value_type))%per64)%per64;
+    const size_t offs[][4] = {{0, 0, 0, 0}, {1, 1, 1, 1}, {2, 2, 2, 2}, {3, 3, 3, 3}, {0, 1, 2, 3}};
+    value_type guard;
+    memset(&guard, 0x5a, sizeof(guard));
+    Key k;
+    for(size_t w=0; w<k.size(); ++w)
+        k.v[w] = (value_type)lcg();
+    for(size_t s=0; s<sizeof(starts)/sizeof(*starts); ++s){
+        for(size_t n=0; n<=100; n+=(n<40 ? 1 : 30)){
+            for(size_t o=0; o<sizeof(offs)/sizeof(*offs); ++o){
+                Ctr c0, c;
+                memcpy(c0.v, starts[s], sizeof(c0.v));
+                unsigned R = (unsigned)(n%(f.maxR+1));
+                memset(raw, 0x5a, sizeof(raw));
+                Ctr* buf = reinterpret_cast<Ctr*>(base + 4*offs[o][0]);
+                fill(R, c0, k, buf, n);
+                c = c0;
+                for(size_t i=0; i<n; ++i, c.incr()){
+                    Ctr r = f.scalar(R, c, k);
+                    assert(memcmp(buf[i].v, r.v, sizeof(r.v)) == 0);
+                }
+                assert(buf[n].v[0] == guard);
+                value_type* cols[4];
+                for(size_t w=0; w<4; ++w)
+                    cols[w] = base + w*(104+per64) + offs[o][w];
+                memset(raw, 0x5a, sizeof(raw));
+                fill_soa(R, c0, k, cols, n);
+                c = c0;
+                for(size_t i=0; i<n; ++i, c.incr()){
+                    Ctr r = f.scalar(R, c, k);
+                    for(size_t w=0; w<4; ++w)
+                        assert(cols[w][i] == r.v[w]);
+                }
+                for(size_t w=0; w<4; ++w)
+                    assert(cols[w][n] == guard);
+            }
+        }
+    }
+    cout << name << " and " << name << "_soa OK\n";
+}
+
+int main(int, char **){
+    multilane<philox4x32_ctr_t, philox4x32_key_t> p32 = {philox4x32_R, 16};
+    multilane<threefry4x32_ctr_t, threefry4x32_key_t> t32 = {threefry4x32_R, 72};
+    chkx("philox4x32_R_x4", p32, philox4x32_R_x4, 4);
+    chkx("threefry4x32_R_x4", t32, threefry4x32_R_x4, 4);
+#if R123_USE_AVX2
+    chkx("philox4x32_R_x8", p32, philox4x32_R_x8, 8);
+    chkx("threefry4x32_R_x8", t32, threefry4x32_R_x8, 8);
+#endif
+#if R123_USE_AVX512
+    chkx("philox4x32_R_x16", p32, philox4x32_R_x16, 16);
+    chkx("threefry4x32_R_x16", t32, threefry4x32_R_x16, 16);
+#endif
+    chkfill("philox4x32_R_fill", p32, philox4x32_R_fill, philox4x32_R_fill_soa);
+    chkfill("threefry4x32_R_fill", t32, threefry4x32_R_fill, threefry4x32_R_fill_soa);
+
+#if R123_USE_AVX2
+    multilane<threefry4x64_ctr_t, threefry4x64_key_t> t64 = {threefry4x64_R, 72};
+    chkx("threefry4x64_R_x4", t64, threefry4x64_R_x4, 4);
+#if R123_USE_AVX512
+    chkx("threefry4x64_R_x8", t64, threefry4x64_R_x8, 8);
+#endif
+    chkfill("threefry4x64_R_fill", t64, threefry4x64_R_fill, threefry4x64_R_fill_soa);
+#if R123_USE_PHILOX_64BIT
+    multilane<philox4x64_ctr_t, philox4x64_key_t> p64 = {philox4x64_R, 16};
+    chkx("philox4x64_R_x4", p64, philox4x64_R_x4, 4);
+#if R123_USE_AVX512
+    chkx("philox4x64_R_x8", p64, philox4x64_R_x8, 8);
+#endif
+    chkfill("philox4x64_R_fill", p64, philox4x64_R_fill, philox4x64_R_fill_soa);
+#endif
+#endif
+    return 0;
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check the multi-key bulk functions, CBRNG_R_multikey(R, in, keys,
+// out, n), against the scalar CBRNG_R(R, in[i], keys[i]), for every
+// n up to a few vectors' worth (so that the tails are exercised),
+// several numbers of rounds, and in place.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// A cheap 64-bit LCG; the inputs need not be random, only varied.
+static uint64_t z = 1;
+static uint64_t next(){
+    z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+    return z>>7;
+}
+
+template <typename T>
+void fill(T& a){
+    unsigned char* p = (unsigned char*)&a;
+    for(size_t i=0; i<sizeof(a); ++i)
+        p[i] = (unsigned char)next();
+}
+
+template <typename Ctr, typename Key>
+void chk(const char* name,
+         void (*multikey)(unsigned, const Ctr*, const Key*, Ctr*, size_t),
+         Ctr (*scalar)(unsigned, Ctr, Key),
+         const unsigned* Rs, size_t nR){
+    const size_t N = 80;
+    vector<Ctr> in(N), out(N), ref(N);
+    vector<Key> keys(N);
+    for(size_t r=0; r<nR; ++r){
+        for(size_t n=0; n<=N; ++n){
+            for(size_t i=0; i<n; ++i){
+                fill(in[i]);
+                fill(keys[i]);
+                ref[i] = scalar(Rs[r], in[i], keys[i]);
+            }
+            if(n == 0){
+                multikey(Rs[r], 0, 0, 0, 0);
+                continue;
+            }
+            multikey(Rs[r], &in[0], &keys[0], &out[0], n);
+            assert(memcmp(&out[0], &ref[0], n*sizeof(Ctr)) == 0);
+            // in place
+            multikey(Rs[r], &in[0], &keys[0], &in[0], n);
+            assert(memcmp(&in[0], &ref[0], n*sizeof(Ctr)) == 0);
+        }
+    }
+    cout << name << "_R_multikey OK\n";
+}
+
+int main(int, char **){
+#if R123_USE_SSE || R123_USE_NEON
+    const unsigned philoxR[] = {0, 1, 7, 10, 16};
+    const unsigned threefryR[] = {0, 3, 4, 13, 20, 72};
+    chk("philox4x32", philox4x32_R_multikey, philox4x32_R, philoxR, sizeof(philoxR)/sizeof(*philoxR));
+    chk("threefry4x32", threefry4x32_R_multikey, threefry4x32_R, threefryR, sizeof(threefryR)/sizeof(*threefryR));
+#if R123_USE_AVX2
+    chk("threefry4x64", threefry4x64_R_multikey, threefry4x64_R, threefryR, sizeof(threefryR)/sizeof(*threefryR));
+#if R123_USE_PHILOX_64BIT
+    chk("philox4x64", philox4x64_R_multikey, philox4x64_R, philoxR, sizeof(philoxR)/sizeof(*philoxR));
+#endif
+#endif
+    // The default rounds.
+    {
+        philox4x32_ctr_t in[40], out[40];
+        philox4x32_key_t keys[40];
+        for(size_t i=0; i<40; ++i){
+            fill(in[i]);
+            fill(keys[i]);
+        }
+        philox4x32_multikey(in, keys, out, 40);
+        for(size_t i=0; i<40; ++i)
+            assert(out[i] == philox4x32(in[i], keys[i]));
+        threefry4x32_ctr_t tin[40], tout[40];
+        threefry4x32_key_t tkeys[40];
+        for(size_t i=0; i<40; ++i){
+            fill(tin[i]);
+            fill(tkeys[i]);
+        }
+        threefry4x32_multikey(tin, tkeys, tout, 40);
+        for(size_t i=0; i<40; ++i)
+            assert(tout[i] == threefry4x32(tin[i], tkeys[i]));
+    }
+#else
+    cout << "No SSE or NEON.  No multi-lane functions to check\n";
+#endif
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    const unsigned arsR[] = {1, 5, 7, 10};
+    chk("ars4x32", ars4x32_R_multikey, ars4x32_R, arsR, sizeof(arsR)/sizeof(*arsR));
+    chk("ars1xm128i", ars1xm128i_R_multikey, ars1xm128i_R, arsR, sizeof(arsR)/sizeof(*arsR));
+#endif
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check the ARM NEON code:  philox4x32_R_x4, threefry4x32_R_x4 and
+// their fill functions against the known answers (from kat_vectors)
+// and against the scalar functions, the NEON r123m128i, and the ARMv8
+// AES versions of ARS1xm128i and AESNI1xm128i.  kat_c and kat_cpp
+// check ars4x32 and aesni4x32 against the same answers as on x86.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <Random123/aes.h>
+#if !R123_USE_NEON || R123_USE_SSE
+#include <stdio.h>
+int main(){ printf("No NEON.  Nothing to check\n"); return 0; }
+#else
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace r123;
+
+struct kat4x32 { unsigned R; uint32_t c[4], k[4], r[4]; };
+const kat4x32 philox_kats[] = {
+    {7, {0, 0, 0, 0}, {0, 0}, {0x5f6fb709, 0x0d893f64, 0x4f121f81, 0x4f730a48}},
+    {7, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x5207ddc2, 0x45165e59, 0x4d8ee751, 0x8c52f662}},
+    {7, {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0x4dfccaba, 0x190a87f0, 0xc47362ba, 0xb6b5242a}},
+    {10, {0, 0, 0, 0}, {0, 0}, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {10, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {10, {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}
+};
+const kat4x32 threefry_kats[] = {
+    {13, {0, 0, 0, 0}, {0, 0, 0, 0}, {0x531c7e4f, 0x39491ee5, 0x2c855a92, 0x3d6abf9a}},
+    {13, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xc4189358, 0x1c9cc83a, 0xd5881c67, 0x6a0a89e0}},
+    {13, {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0, 0x082efa98, 0xec4e6c89}, {0x4aa71d8f, 0x734738c2, 0x431fc6a8, 0xae6debf1}},
+    {20, {0, 0, 0, 0}, {0, 0, 0, 0}, {0x9c6ca96a, 0xe17eae66, 0xfc10ecd4, 0x5256a7d8}},
+    {20, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0x2a881696, 0x57012287, 0xf6c7446e, 0xa16a6732}},
+    {20, {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0, 0x082efa98, 0xec4e6c89}, {0x59cd1dbb, 0xb8879579, 0x86b5d00c, 0xac8b6d84}}
+};
+
+template <typename Key>
+struct multilane{
+    r123array4x32 (*scalar)(unsigned, r123array4x32, Key);
+    void (*x4)(unsigned, const r123array4x32*, Key, r123array4x32*);
+    void (*fill)(unsigned, r123array4x32, Key, r123array4x32*, size_t);
+    unsigned maxR;
+};
+
+template <typename Key>
+void chk(const char* name, const multilane<Key>& f, const kat4x32* kats, size_t nkats){
+    r123array4x32 in[4], out[4];
+    Key k;
+    for(size_t i=0; i<nkats; ++i){
+        // Put the known answer in a different lane each time, with
+        // other counters around it.
+        for(size_t j=0; j<4; ++j)
+            for(size_t w=0; w<4; ++w)
+                in[j].v[w] = kats[i].c[w] + (uint32_t)(j + 7*w);
+        size_t lane = i%4;
+        memcpy(in[lane].v, kats[i].c, sizeof(kats[i].c));
+        memcpy(k.v, kats[i].k, sizeof(k.v));
+        f.x4(kats[i].R, in, k, out);
+        assert(memcmp(out[lane].v, kats[i].r, sizeof(kats[i].r)) == 0);
+        for(size_t j=0; j<4; ++j){
+            r123array4x32 r = f.scalar(kats[i].R, in[j], k);
+            assert(memcmp(out[j].v, r.v, sizeof(r.v)) == 0);
+        }
+    }
+
+    uint32_t z = 0x9e3779b9;
+    for(unsigned n=0; n<10000; ++n){
+        for(size_t j=0; j<4; ++j)
+            for(size_t w=0; w<4; ++w){
+                // A cheap 32-bit LCG; the inputs need not be random, only varied.
+                z = z*1664525u + 1013904223u;
+                in[j].v[w] = z;
+            }
+        for(size_t w=0; w<k.size(); ++w)
+            k.v[w] = in[w].v[w]^in[3-w].v[0];
+        unsigned R = n%(f.maxR+1);
+        for(size_t j=0; j<4; ++j)
+            out[j] = f.scalar(R, in[j], k);
+        // in place
+        f.x4(R, in, k, in);
+        assert(memcmp(in, out, sizeof(in)) == 0);
+    }
+
+    // The fill functions, with counters that carry into every word.
+    const uint32_t m = 0xffffffff;
+    const uint32_t starts[][4] = {{0, 0, 0, 0}, {m-20, 5, 6, 7}, {m-9, m, 3, 4}, {m-3, m, m, 1}, {m-17, m, m, m}};
+    r123array4x32 buf[70];
+    memcpy(k.v, kats[2].k, sizeof(k.v));
+    for(size_t s=0; s<sizeof(starts)/sizeof(*starts); ++s){
+        for(size_t n=0; n<=70; n+=(n<20 ? 1 : 25)){
+            r123array4x32 c0, c;
+            memcpy(c0.v, starts[s], sizeof(c0.v));
+            f.fill(kats[2].R, c0, k, buf, n);
+            c = c0;
+            for(size_t i=0; i<n; ++i, c.incr()){
+                r123array4x32 r = f.scalar(kats[2].R, c, k);
+                assert(memcmp(buf[i].v, r.v, sizeof(r.v)) == 0);
+            }
+        }
+    }
+    cout << name << " OK\n";
+}
+
+void chkm128i(){
+    r123array1xm128i a, b;
+    a.v[0] = ~(R123_ULONG_LONG)0;
+    assert(a.v[0]);
+    assert(~(R123_ULONG_LONG)0 == a.v[0]);
+    a.incr();
+    assert(vgetq_lane_u64(a.v[0].m, 0) == 0 && vgetq_lane_u64(a.v[0].m, 1) == 1);
+    a.v[0] += ~(R123_ULONG_LONG)0;
+    a.v[0] += 3;
+    assert(vgetq_lane_u64(a.v[0].m, 0) == 2 && vgetq_lane_u64(a.v[0].m, 1) == 2);
+    assert(2 != a.v[0]);
+    stringstream ss;
+    ss << a;
+    ss >> b;
+    assert(a == b);
+    b.v[0] = 0;
+    assert(!b.v[0]);
+    uint32_t words[4] = {1, 2, 3, 4};
+    b.v[0] = assemble_from_u32<r123m128i>(words);
+    assert(vgetq_lane_u64(b.v[0].m, 0) == ((R123_ULONG_LONG)2<<32 | 1));
+    cout << "r123m128i OK\n";
+}
+
+#if R123_USE_ARM_AES
+void chkaes(){
+    if(!haveAESNI()){
+        cout << "No ARMv8 AES on this hardware.  Skipping ARS and AESNI\n";
+        return;
+    }
+    // FIPS-197, as in ut_aes.
+    const uint32_t key[4] = {0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c};
+    const uint32_t in[4] = {0x33221100, 0x77665544, 0xbbaa9988, 0xffeeddcc};
+    const uint32_t right_answer[4] = {0xd8e0c469, 0x30047b6a, 0x80b7cdd8, 0x5ac5b470};
+    AESNI1xm128i::ukey_type uk;
+    AESNI1xm128i::ctr_type c;
+    uk.v[0].m = vreinterpretq_u64_u32(vld1q_u32(key));
+    c.v[0].m = vreinterpretq_u64_u32(vld1q_u32(in));
+    AESNI1xm128i::ctr_type r = AESNI1xm128i()(c, AESNI1xm128i::key_type(uk));
+    uint32_t got[4];
+    vst1q_u32(got, vreinterpretq_u32_u64(r.v[0].m));
+    assert(memcmp(got, right_answer, sizeof(got)) == 0);
+    AESNI4x32::ukey_type uk4 = {{key[0], key[1], key[2], key[3]}};
+    AESNI4x32::ctr_type c4 = {{in[0], in[1], in[2], in[3]}};
+    AESNI4x32::ctr_type r4 = AESNI4x32()(c4, AESNI4x32::key_type(uk4));
+    assert(memcmp(r4.v, right_answer, sizeof(got)) == 0);
+
+    // ars1xm128i and ars4x32 must agree for every number of rounds.
+    for(unsigned R=1; R<=10; ++R){
+        ars4x32_ctr_t c4a = {{in[0], in[1], in[2], in[3]}};
+        ars4x32_key_t k4 = {{key[0], key[1], key[2], key[3]}};
+        ars1xm128i_ctr_t c1;
+        ars1xm128i_key_t k1;
+        c1.v[0].m = vreinterpretq_u64_u32(vld1q_u32(c4a.v));
+        k1.v[0].m = vreinterpretq_u64_u32(vld1q_u32(k4.v));
+        c1 = ars1xm128i_R(R, c1, k1);
+        c4a = ars4x32_R(R, c4a, k4);
+        vst1q_u32(got, vreinterpretq_u32_u64(c1.v[0].m));
+        assert(memcmp(got, c4a.v, sizeof(got)) == 0);
+    }
+    cout << "ARMv8 AES OK\n";
+}
+#endif
+
+int main(int, char **){
+    multilane<philox4x32_key_t> philox = {philox4x32_R, philox4x32_R_x4, philox4x32_R_fill, 16};
+    multilane<threefry4x32_key_t> threefry = {threefry4x32_R, threefry4x32_R_x4, threefry4x32_R_fill, 72};
+    chk("philox4x32_x4", philox, philox_kats, sizeof(philox_kats)/sizeof(*philox_kats));
+    chk("threefry4x32_x4", threefry, threefry_kats, sizeof(threefry_kats)/sizeof(*threefry_kats));
+
+    // The default-round macros.
+    philox4x32_ctr_t in[4], out[4];
+    philox4x32_key_t pk = {{philox_kats[3].k[0], philox_kats[3].k[1]}};
+    for(size_t j=0; j<4; ++j)
+        memcpy(in[j].v, philox_kats[3].c, sizeof(in[j].v));
+    philox4x32_x4(in, pk, out);
+    assert(memcmp(out[3].v, philox_kats[3].r, sizeof(out[3].v)) == 0);
+    philox4x32_fill(in[0], pk, out, 4);
+    assert(memcmp(out[0].v, philox_kats[3].r, sizeof(out[0].v)) == 0);
+    threefry4x32_key_t tk;
+    memcpy(tk.v, threefry_kats[5].k, sizeof(tk.v));
+    memcpy(in[0].v, threefry_kats[5].c, sizeof(in[0].v));
+    threefry4x32_fill(in[0], tk, out, 3);
+    assert(memcmp(out[0].v, threefry_kats[5].r, sizeof(out[0].v)) == 0);
+    threefry4x32_x4(in, tk, out);
+    assert(memcmp(out[0].v, threefry_kats[5].r, sizeof(out[0].v)) == 0);
+
+    chkm128i();
+#if R123_USE_ARM_AES
+    chkaes();
+#endif
+    return 0;
+}
+
+#endif
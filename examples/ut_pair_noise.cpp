@@ -0,0 +1,153 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::pair_noise:  the counter layout, the symmetry in the
+// pair, that the batched and CSR functions give the same bits as the
+// scalar ones (across batch boundaries and with empty rows), and the
+// first two moments of the uniforms and normals.
+
+#include <Random123/pair_noise.hpp>
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+template <typename CBRNG>
+void chk(const char* name){
+    typedef pair_noise<CBRNG> PN;
+    typedef typename PN::ctr_type ctr_type;
+    typedef typename PN::key_type key_type;
+    key_type k = {{}};
+    k[0] = 12345;
+    PN noise(k);
+    const uint64_t step = R123_64BIT(0x123456789);
+
+    // The counter layout.
+    ctr_type c = PN::counter(7, 3, step);
+    assert(c[0] == 3 && c[1] == 7 && c[2] == (typename PN::value_type)step);
+    if(sizeof(c[0]) == 4)
+        assert(c[3] == 1);
+    else
+        assert(c[3] == 0);
+    assert(noise.block(7, 3, step) == CBRNG()(c, k));
+
+    // Symmetry, and dependence on every part of the counter.
+    for(unsigned i=0; i<50; ++i)
+        for(unsigned j=0; j<50; ++j){
+            assert(noise.block(i, j, step) == noise.block(j, i, step));
+            assert(noise.normal(i, j, step) == noise.normal(j, i, step));
+            assert(noise.uniform(i, j, step) == noise.uniform(j, i, step));
+        }
+    assert(noise.normal(1, 2, step) != noise.normal(1, 3, step));
+    assert(noise.normal(1, 2, step) != noise.normal(1, 2, step+1));
+    assert(noise.normal(1, 2, 0) != noise.normal(1, 2, R123_64BIT(1)<<32));
+
+    // A CSR neighbor list with varied row lengths, including empty
+    // rows, and the same pairs as a list.
+    const size_t nrows = 300;
+    vector<unsigned> rowptr(nrows+1), col, pi, pj;
+    for(size_t r=0; r<nrows; ++r){
+        rowptr[r] = (unsigned)col.size();
+        size_t len = (r*37)%11 == 0 ? 0 : (r*13)%29;
+        for(size_t q=0; q<len; ++q){
+            col.push_back((unsigned)((r*7+q*31)%1000));
+            pi.push_back((unsigned)r);
+            pj.push_back(col.back());
+        }
+    }
+    rowptr[nrows] = (unsigned)col.size();
+    size_t nnz = col.size();
+    vector<double> a(nnz), b(nnz), u(nnz), v(nnz);
+    noise.normal_csr(step, &rowptr[0], &col[0], nrows, &a[0]);
+    noise.normal(step, &pi[0], &pj[0], nnz, &b[0]);
+    noise.uniform_csr(step, &rowptr[0], &col[0], nrows, &u[0]);
+    noise.uniform(step, &pi[0], &pj[0], nnz, &v[0]);
+    for(size_t e=0; e<nnz; ++e){
+        double z = noise.normal(pi[e], pj[e], step);
+        assert(memcmp(&a[e], &z, sizeof(z)) == 0);
+        assert(memcmp(&b[e], &z, sizeof(z)) == 0);
+        double x = noise.uniform(pj[e], pi[e], step);
+        assert(u[e] == x && v[e] == x);
+    }
+    // A sub-range of rows, with rowptr[0] != 0.
+    vector<double> s(nnz, -1.);
+    noise.normal_csr(step, &rowptr[100], &col[0], 50, &s[0]);
+    for(size_t e=0; e<nnz; ++e)
+        assert(e >= rowptr[100] && e < rowptr[150] ? s[e] != -1. : s[e] == -1.);
+
+    // Moments.
+    const size_t n = 200000;
+    vector<unsigned> ii(n), jj(n);
+    for(size_t e=0; e<n; ++e){
+        ii[e] = (unsigned)(e/400);
+        jj[e] = (unsigned)(e%400 + 1000);
+    }
+    vector<double> z(n);
+    noise.normal(step, &ii[0], &jj[0], n, &z[0]);
+    double m = 0., m2 = 0.;
+    for(size_t e=0; e<n; ++e){
+        m += z[e];
+        m2 += z[e]*z[e];
+    }
+    m /= n;
+    m2 /= n;
+    assert(fabs(m) < 5./sqrt((double)n));
+    assert(fabs(m2-1.) < 5.*sqrt(2./n));
+    noise.uniform(step, &ii[0], &jj[0], n, &z[0]);
+    m = 0.;
+    for(size_t e=0; e<n; ++e){
+        assert(z[e] > 0. && z[e] < 1.);
+        m += z[e];
+    }
+    m /= n;
+    assert(fabs(m-0.5) < 5.*sqrt(1./12/n));
+    cout << "pair_noise<" << name << "> OK\n";
+}
+
+int main(int, char **){
+    chk<Philox4x32>("Philox4x32");
+    chk<Threefry4x32>("Threefry4x32");
+    chk<Threefry4x64>("Threefry4x64");
+#if R123_USE_PHILOX_64BIT
+    chk<Philox4x64>("Philox4x64");
+#endif
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    chk<ARS4x32>("ARS4x32");
+#endif
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check philox4x64_R_x8 and philox4x64_R_fill against the known
+// answers for philox4x64_R (from kat_vectors) and against the scalar
+// function on varied counters and keys, with both 64x64->128-bit
+// multiply kernels.
+
+#include <Random123/philox.h>
+#if !(R123_USE_AVX512 && R123_USE_PHILOX_64BIT)
+#include <stdio.h>
+int main(){ printf("No AVX-512.  Nothing to check\n"); return 0; }
+#else
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+struct kat4x64 { unsigned R; uint64_t c[4], k[2], r[4]; };
+const kat4x64 kats[] = {
+    {7, {0, 0, 0, 0}, {0, 0},
+     {R123_64BIT(0x5dc8ee6268ec62cd), R123_64BIT(0x139bc570b6c125a0), R123_64BIT(0x84d6deb4fb65f49e), R123_64BIT(0xaff7583376d378c2)}},
+    {7, {~(uint64_t)0, ~(uint64_t)0, ~(uint64_t)0, ~(uint64_t)0}, {~(uint64_t)0, ~(uint64_t)0},
+     {R123_64BIT(0x071dd84367903154), R123_64BIT(0x48e2bbdc722b37d1), R123_64BIT(0x6afa9890bb89f76c), R123_64BIT(0x9194c8d8ada56ac7)}},
+    {7, {R123_64BIT(0x243f6a8885a308d3), R123_64BIT(0x13198a2e03707344), R123_64BIT(0xa4093822299f31d0), R123_64BIT(0x082efa98ec4e6c89)},
+     {R123_64BIT(0x452821e638d01377), R123_64BIT(0xbe5466cf34e90c6c)},
+     {R123_64BIT(0x513a366704edf755), R123_64BIT(0xf05d9924c07044d3), R123_64BIT(0xbef2cb9cbea74c6c), R123_64BIT(0x8db948de4caa1f8a)}},
+    {10, {0, 0, 0, 0}, {0, 0},
+     {R123_64BIT(0x16554d9eca36314c), R123_64BIT(0xdb20fe9d672d0fdc), R123_64BIT(0xd7e772cee186176b), R123_64BIT(0x7e68b68aec7ba23b)}},
+    {10, {~(uint64_t)0, ~(uint64_t)0, ~(uint64_t)0, ~(uint64_t)0}, {~(uint64_t)0, ~(uint64_t)0},
+     {R123_64BIT(0x87b092c3013fe90b), R123_64BIT(0x438c3c67be8d0224), R123_64BIT(0x9cc7d7c69cd777b6), R123_64BIT(0xa09caebf594f0ba0)}},
+    {10, {R123_64BIT(0x243f6a8885a308d3), R123_64BIT(0x13198a2e03707344), R123_64BIT(0xa4093822299f31d0), R123_64BIT(0x082efa98ec4e6c89)},
+     {R123_64BIT(0x452821e638d01377), R123_64BIT(0xbe5466cf34e90c6c)},
+     {R123_64BIT(0xa528f45403e61d95), R123_64BIT(0x38c72dbd566e9788), R123_64BIT(0xa5a1610e72fd18b5), R123_64BIT(0x57bd43b5e52b7fe6)}}
+};
+
+typedef void (*rounds_fn)(unsigned int, __m512i*, unsigned int, philox4x64_key_t);
+
+// philox4x64_R_x8 with the given rounds function.
+void x8(rounds_fn f, unsigned R, const philox4x64_ctr_t* in, philox4x64_key_t k, philox4x64_ctr_t* out){
+    __m512i x[4];
+    _r123_load4_u64x8(in[0].v, x);
+    f(R, x, 1, k);
+    _r123_store4_u64x8(x, out[0].v);
+}
+
+void chk(const char *name, rounds_fn f){
+    philox4x64_ctr_t in[8], out[8];
+    philox4x64_key_t k;
+    for(size_t i=0; i<sizeof(kats)/sizeof(*kats); ++i){
+        // Put the known answer in a different lane each time, with
+        // other counters around it.
+        for(size_t j=0; j<8; ++j)
+            for(size_t w=0; w<4; ++w)
+                in[j].v[w] = kats[i].c[w] + j + 7*w;
+        size_t lane = i%8;
+        memcpy(in[lane].v, kats[i].c, sizeof(kats[i].c));
+        memcpy(k.v, kats[i].k, sizeof(kats[i].k));
+        x8(f, kats[i].R, in, k, out);
+        assert(memcmp(out[lane].v, kats[i].r, sizeof(kats[i].r)) == 0);
+        for(size_t j=0; j<8; ++j){
+            philox4x64_ctr_t r = philox4x64_R(kats[i].R, in[j], k);
+            assert(memcmp(out[j].v, r.v, sizeof(r.v)) == 0);
+        }
+    }
+
+    uint64_t z = R123_64BIT(0x9e3779b97f4a7c15);
+    for(int n=0; n<10000; ++n){
+        for(size_t j=0; j<8; ++j)
+            for(size_t w=0; w<4; ++w){
+                // A cheap 64-bit LCG; the inputs need not be random, only varied.
+                z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+                in[j].v[w] = z;
+            }
+        k.v[0] = in[0].v[0]^in[1].v[1];
+        k.v[1] = in[2].v[2]^in[3].v[3];
+        unsigned R = n%17;
+        for(size_t j=0; j<8; ++j)
+            out[j] = philox4x64_R(R, in[j], k);
+        // in place
+        x8(f, R, in, k, in);
+        assert(memcmp(in, out, sizeof(in)) == 0);
+    }
+    cout << "philox4x64_x8 " << name << " OK\n";
+}
+
+int main(int, char **){
+    chk("epu32", _philox4x64_R_u64x8);
+#if R123_USE_AVX512IFMA
+    chk("ifma", _philox4x64_R_u64x8ifma);
+#endif
+    philox4x64_ctr_t in[8], out[8];
+    philox4x64_key_t k = {{kats[3].k[0], kats[3].k[1]}};
+    for(size_t j=0; j<8; ++j)
+        memcpy(in[j].v, kats[3].c, sizeof(kats[3].c));
+    philox4x64_x8(in, k, out);
+    for(size_t j=0; j<8; ++j)
+        assert(memcmp(out[j].v, kats[3].r, sizeof(kats[3].r)) == 0);
+
+    // philox4x64_R_fill, with counters that carry into every word.
+    const uint64_t m = ~(uint64_t)0;
+    const uint64_t starts[][4] = {{0, 0, 0, 0}, {m-20, 5, 6, 7}, {m-9, m, 3, 4}, {m-3, m, m, 1}, {m-17, m, m, m}};
+    philox4x64_ctr_t buf[70];
+    for(size_t s=0; s<sizeof(starts)/sizeof(*starts); ++s){
+        for(size_t n=0; n<=70; n+=(n<20 ? 1 : 25)){
+            philox4x64_ctr_t c0, c;
+            memcpy(c0.v, starts[s], sizeof(c0.v));
+            philox4x64_R_fill(9, c0, k, buf, n);
+            c = c0;
+            for(size_t i=0; i<n; ++i){
+                philox4x64_ctr_t r = philox4x64_R(9, c, k);
+                assert(memcmp(buf[i].v, r.v, sizeof(r.v)) == 0);
+                if(++c.v[0] == 0 && ++c.v[1] == 0 && ++c.v[2] == 0)
+                    ++c.v[3];
+            }
+        }
+    }
+    memcpy(in[0].v, kats[5].c, sizeof(kats[5].c));
+    memcpy(k.v, kats[5].k, sizeof(kats[5].k));
+    philox4x64_fill(in[0], k, buf, 17);
+    assert(memcmp(buf[0].v, kats[5].r, sizeof(kats[5].r)) == 0);
+    cout << "philox4x64_fill OK\n";
+    return 0;
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::seed_seq against known answers (from a separate
+// implementation of Skein-256 and Threefry4x64), the SeedSeq
+// requirements that param() reproduces a r123::seed_seq and that generate()
+// makes a prefix of a longer range, child() against its definition,
+// child_ukeys against UK::seed(child(i)) for user keys of several
+// sizes and value_types, and Engines made both ways.
+
+#include <Random123/seed_seq.hpp>
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <Random123/conventional/Engine.hpp>
+#include <cassert>
+#include <iostream>
+#include <set>
+#include <vector>
+#if R123_USE_CXX11_RANDOM
+#include <random>
+#endif
+
+using namespace std;
+using namespace r123;
+
+struct kat { size_t n; uint32_t v[3]; uint32_t r[10]; };
+const kat kats[] = {
+    {0, {0, 0, 0},
+     {0x9a609f6e, 0x65d7224a, 0x3182bb6d, 0xfefdb72c, 0xd76019bf, 0xa60c4c45, 0xc712ddad, 0x6892309c, 0x11c0462c, 0x2252b6d6}},
+    {3, {1, 2, 3},
+     {0x5080d3fd, 0x0baa75bb, 0x76494d58, 0x1bf69c56, 0x936021d8, 0xfc9df7e2, 0x0228b4a0, 0x65232a11, 0x9f786dfa, 0x3e030529}},
+    {1, {0xdeadbeef, 0, 0},
+     {0xc450c27f, 0x0c01c39a, 0x4456a0fe, 0xcd576b90, 0x54642f49, 0x2d0a27c3, 0xe89a2a1b, 0x9fc56404, 0xc32478e0, 0xd4571fde}}
+};
+
+// child(5) of the r123::seed_seq of {1, 2, 3}: its values, and the first
+// words it generates.
+const uint32_t child5[8] = {0xb051d189, 0x545e100d, 0xbf0d5a9b, 0x5d221b89, 0xdf039cbd, 0x4fa5030d, 0x0a5103e0, 0xc7f1ff81};
+const uint32_t child5gen[4] = {0x30c28f86, 0x0abd9caf, 0xadec49fb, 0x65545093};
+
+vector<uint32_t> gen(const r123::seed_seq& s, size_t n){
+    vector<uint32_t> r(n);
+    s.generate(r.begin(), r.end());
+    return r;
+}
+
+vector<uint32_t> param(const r123::seed_seq& s){
+    vector<uint32_t> p;
+    s.param(back_inserter(p));
+    assert(p.size() == s.size());
+    return p;
+}
+
+template <typename UK>
+void chk_ukeys(const r123::seed_seq& ss, const char* name){
+    const size_t n = 150;
+    const uint64_t firsts[] = {0, 7, ~(uint64_t)0 - 70, ~(uint64_t)0};
+    vector<UK> uk(n);
+    for(size_t f=0; f<sizeof(firsts)/sizeof(*firsts); ++f){
+        ss.child_ukeys(&uk[0], n, firsts[f]);
+        for(size_t i=0; i<n; ++i){
+            r123::seed_seq c = ss.child(firsts[f]+i);
+            assert(uk[i] == UK::seed(c));
+        }
+    }
+    // Fewer than a batch, and none.
+    ss.child_ukeys(&uk[0], 3, 11);
+    for(size_t i=0; i<3; ++i){
+        r123::seed_seq c = ss.child(11+i);
+        assert(uk[i] == UK::seed(c));
+    }
+    ss.child_ukeys(&uk[0], 0, 11);
+    cout << "child_ukeys " << name << " OK\n";
+}
+
+template <typename CBRNG>
+void chk_engine(const r123::seed_seq& ss, const char* name){
+    typedef typename CBRNG::ukey_type ukey_type;
+    vector<ukey_type> uk(100);
+    ss.child_ukeys(&uk[0], uk.size());
+    set<typename Engine<CBRNG>::result_type> first;
+    for(size_t i=0; i<uk.size(); ++i){
+        r123::seed_seq c = ss.child(i);
+        Engine<CBRNG> e(c), f(uk[i]);
+        assert(e == f);
+        for(int j=0; j<10; ++j)
+            assert(e() == f());
+        first.insert(Engine<CBRNG>(uk[i])());
+    }
+    // The first outputs of 100 engines with distinct keys.
+    assert(first.size() == uk.size());
+    cout << "Engine<" << name << "> OK\n";
+}
+
+int main(int, char**){
+    for(size_t i=0; i<sizeof(kats)/sizeof(*kats); ++i){
+        r123::seed_seq s(kats[i].v, kats[i].v+kats[i].n);
+        assert(s.size() == kats[i].n);
+        vector<uint32_t> r = gen(s, 10);
+        for(size_t j=0; j<10; ++j)
+            assert(r[j] == kats[i].r[j]);
+        // param() reproduces s.
+        vector<uint32_t> p = param(s);
+        assert(vector<uint32_t>(kats[i].v, kats[i].v+kats[i].n) == p);
+        r123::seed_seq t(p.begin(), p.end());
+        assert(gen(t, 100) == gen(s, 100));
+    }
+    r123::seed_seq none;
+    assert(none.size() == 0 && gen(none, 10) == vector<uint32_t>(kats[0].r, kats[0].r+10));
+    cout << "seed_seq known answers OK\n";
+
+    // Values are taken mod 2^32, and generate() makes prefixes.
+    const uint64_t big[] = {R123_64BIT(0x100000001), 2, R123_64BIT(0xffffffff00000003)};
+    r123::seed_seq s(big, big+3);
+    vector<uint32_t> r = gen(s, 1000);
+    assert(vector<uint32_t>(r.begin(), r.begin()+10) == vector<uint32_t>(kats[1].r, kats[1].r+10));
+    for(size_t n=0; n<100; ++n){
+        vector<uint32_t> q = gen(s, n);
+        assert(equal(q.begin(), q.end(), r.begin()));
+    }
+    // Into a wider type, one word per element.
+    vector<uint64_t> r64(20);
+    s.generate(r64.begin(), r64.end());
+    for(size_t j=0; j<r64.size(); ++j)
+        assert(r64[j] == r[j]);
+    // Neighbouring sequences differ.
+    const uint32_t a[] = {1, 2, 0};
+    assert(gen(r123::seed_seq(a, a+2), 8) != gen(r123::seed_seq(a, a+3), 8));
+    assert(gen(r123::seed_seq(a, a+1), 8) != gen(r123::seed_seq(a+1, a+2), 8));
+    assert(gen(r123::seed_seq(a+2, a+3), 8) != gen(none, 8));
+    cout << "seed_seq generate OK\n";
+
+    // Children.
+    r123::seed_seq c5 = s.child(5);
+    assert(param(c5) == vector<uint32_t>(child5, child5+8));
+    assert(gen(c5, 4) == vector<uint32_t>(child5gen, child5gen+4));
+    set<vector<uint32_t> > seen;
+    seen.insert(vector<uint32_t>(r.begin(), r.begin()+8));
+    for(uint64_t i=0; i<1000; ++i)
+        seen.insert(gen(s.child(i), 8));
+    seen.insert(gen(s.child(~(uint64_t)0), 8));
+    assert(seen.size() == 1002);
+    cout << "seed_seq child OK\n";
+
+    chk_ukeys<r123array2x32>(s, "2x32");
+    chk_ukeys<r123array4x64>(s, "4x64");
+    chk_ukeys<r123array1x64>(s, "1x64");
+    chk_ukeys<r123array16x64>(s, "16x64");
+    chk_ukeys<r123array16x8>(s, "16x8");
+#if R123_USE_SSE
+    chk_ukeys<r123array1xm128i>(s, "1xm128i");
+#endif
+
+    chk_engine<Philox4x32>(s, "Philox4x32");
+    chk_engine<Philox2x64>(s, "Philox2x64");
+    chk_engine<Threefry4x64>(s, "Threefry4x64");
+#if R123_USE_AES_NI
+    chk_engine<ARS4x32>(s, "ARS4x32");
+#endif
+
+#if R123_USE_CXX11_RANDOM
+    r123::seed_seq il = {1, 2, 3};
+    assert(gen(il, 10) == vector<uint32_t>(kats[1].r, kats[1].r+10));
+    std::mt19937 m1(il), m2(il);
+    assert(m1() == m2());
+    cout << "seed_seq with std::mt19937 OK\n";
+#endif
+    return 0;
+}
@@ -0,0 +1,185 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check threefish256_R against the known answer of Threefish-256 and
+// against threefry4x64_R, skein256_R against the known answers of
+// Skein-256 (the first four from the Skein 1.3 paper), with and
+// without a key and with outputs of 8 to 128 bytes, skein256_R_multi
+// against skein256_R on messages of mixed lengths, and skein_hash
+// against both.
+
+#include <Random123/skein.h>
+#include <Random123/philox.h>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+unsigned char hex(char h){
+    return (unsigned char)(h<='9' ? h-'0' : h-'a'+10);
+}
+
+string from_hex(const char* s){
+    string b;
+    for(size_t i=0; s[2*i]; ++i)
+        b += (char)(hex(s[2*i])<<4 | hex(s[2*i+1]));
+    return b;
+}
+
+string bytes(int first, int n, int step){
+    string b;
+    for(int i=0; i<n; ++i)
+        b += (char)(first + step*i);
+    return b;
+}
+
+struct kat { unsigned R; string key, msg; const char* out; };
+
+void chk_kat(const kat& k){
+    string want = from_hex(k.out);
+    skein256_key_t sk = skein256keyinit_R(k.R, k.key.data(), k.key.size(), want.size());
+    vector<unsigned char> got(want.size());
+    skein256_R(k.R, &sk, k.msg.data(), k.msg.size(), &got[0]);
+    assert(memcmp(&got[0], want.data(), want.size()) == 0);
+}
+
+// skein256_R_multi agrees with skein256_R on n messages of lengths
+// from 0 to 200 bytes, for outputs of outlen bytes.
+void chk_multi(size_t n, size_t outlen, uint64_t& z){
+    skein256_key_t sk = skein256keyinit_R(72, "k", 1, outlen);
+    vector<string> msgs(n);
+    vector<const void*> p(n+1);
+    vector<size_t> lens(n+1);
+    for(size_t i=0; i<n; ++i){
+        z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+        size_t len = (size_t)(z>>58) < 8 ? (size_t)(z>>58)*32 + (z>>20)%2 : (size_t)((z>>32)%201);
+        for(size_t j=0; j<len; ++j)
+            msgs[i] += (char)(z>>(j%56));
+        p[i] = msgs[i].data();
+        lens[i] = msgs[i].size();
+    }
+    vector<unsigned char> got(n*outlen+1, 0xa5), want(outlen);
+    skein256_R_multi(72, &sk, &p[0], &lens[0], n, &got[0]);
+    for(size_t i=0; i<n; ++i){
+        skein256_R(72, &sk, p[i], lens[i], &want[0]);
+        assert(memcmp(&got[i*outlen], &want[0], outlen) == 0);
+    }
+    assert(got[n*outlen] == 0xa5);
+}
+
+int main(int, char **){
+    // Threefish-256, from the known answers of Skein 1.3.
+    threefry4x64_key_t k = {{R123_64BIT(0x1716151413121110), R123_64BIT(0x1F1E1D1C1B1A1918),
+                             R123_64BIT(0x2726252423222120), R123_64BIT(0x2F2E2D2C2B2A2928)}};
+    threefish256_tweak_t t = {{R123_64BIT(0x0706050403020100), R123_64BIT(0x0F0E0D0C0B0A0908)}};
+    threefry4x64_ctr_t c = {{R123_64BIT(0xF8F9FAFBFCFDFEFF), R123_64BIT(0xF0F1F2F3F4F5F6F7),
+                             R123_64BIT(0xE8E9EAEBECEDEEEF), R123_64BIT(0xE0E1E2E3E4E5E6E7)}};
+    threefry4x64_ctr_t r72 = {{R123_64BIT(0xdf8fea0eff91d0e0), R123_64BIT(0xd50ad82ee69281c9),
+                               R123_64BIT(0x76f48d58085d869d), R123_64BIT(0xdf975e95b5567065)}};
+    threefry4x64_ctr_t r20 = {{R123_64BIT(0x008cf75d18c19da0), R123_64BIT(0x1d7d14be2266e7d8),
+                               R123_64BIT(0x5d09e0e985fe673b), R123_64BIT(0xb4a5480c6039b172)}};
+    assert(threefish256_R(72, c, k, t) == r72);
+    assert(threefish256_R(20, c, k, t) == r20);
+    threefish256_tweak_t zero = {{0, 0}};
+    for(unsigned R=0; R<=72; ++R)
+        assert(threefish256_R(R, c, k, zero) == threefry4x64_R(R, c, k));
+    cout << "threefish256 OK\n";
+
+    const kat kats[] = {
+        {72, "", from_hex("ff"), "0b98dcd198ea0e50a7a244c444e25c23da30c10fc9a1f270a6637f1f34e67ed2"},
+        {72, "", bytes(0xff, 32, -1), "8d0fa4ef777fd759dfd4044e6f6a5ac3c774aec943dcfc07927b723b5dbf408b"},
+        {72, "", bytes(0xff, 64, -1), "df28e916630d0b44c4a849dc9a02f07a07cb30f732318256b15d865ac4ae162f"},
+        {72, "", "", "c8877087da56e072870daa843f176e9453115929094c3a40c463a196c29bf7ba"},
+        {72, "", "abc", "fd90216b2b58a9ec050e88032c4f64ef"},
+        {72, "", "The quick brown fox jumps over the lazy dog",
+         "c0fbd7d779b20f0a4614a66697f9e41859eaf382f14bf857e8cdb210adb9b3fe"},
+        {72, "", bytes(0, 100, 1),
+         "ac2a32bb979d8bc834cbd80b984ec67e9ba89f6f015496efb1b2b8e7ff4772dd"
+         "8c58cdfd7f97f112bc0dd4af4e882b85ed9d7f5bdbba4ffbf3ac175e8265c40a"},
+        {72, "my seed", "run-2041/entity-17", "151530dbd9e0025c0e70b6b583dc62bff9a09f22816b7ff7db9ff981c47373f9"},
+        {72, "my seed", "run-2041/entity-17", "e1c670b026af7bff"},
+        {72, bytes(0, 40, 1), bytes(0, 33, 1),
+         "eae635f53ca60b1e7241232fc34d5333caa47c392057208a92c02d37a23e7928"
+         "fc59505d27401ec8fe8ec126b51e2762f369bd35091e2e0dba3f646026b49de9"
+         "ccaa378956e6220b424df92b76e10741a34afad412f502998e1fef3871dacd11"
+         "2750491d80926a3c8508744cd7bce2f531493acfe83ef9db1306d445e2a60a85"},
+        {20, "", "abc", "0a1ee84aa923475b175ce7142a23bcb6130670dc622de86ff8b514ae02b2a20d"}
+    };
+    for(size_t i=0; i<sizeof(kats)/sizeof(*kats); ++i)
+        chk_kat(kats[i]);
+    unsigned char d[32];
+    skein256_key_t sk = skein256keyinit(0, 0, 32);
+    skein256(&sk, "\xff", 1, d);
+    assert(memcmp(d, from_hex(kats[0].out).data(), 32) == 0);
+    cout << "skein256 OK\n";
+
+    uint64_t z = 1;
+    const size_t ns[] = {0, 1, 5, 16, 17, 100, 333};
+    const size_t outlens[] = {8, 16, 32, 40, 128};
+    for(size_t i=0; i<sizeof(ns)/sizeof(*ns); ++i)
+        for(size_t j=0; j<sizeof(outlens)/sizeof(*outlens); ++j)
+            chk_multi(ns[i], outlens[j], z);
+    cout << "skein256_multi OK\n";
+
+    // skein_hash fills its words little-endian, so the words of a
+    // 32-bit and a 64-bit array of the same size agree.
+    string brown = kats[5].msg;
+    r123array4x64 h64 = skein_hash<>()(brown);
+    r123array8x32 h32 = skein_hash<r123array8x32>()(brown.data(), brown.size());
+    string want = from_hex(kats[5].out);
+    for(size_t i=0; i<32; ++i)
+        assert((unsigned char)(h64.v[i/8]>>(8*(i%8))) == (unsigned char)want[i]);
+    for(size_t i=0; i<8; ++i)
+        assert(h32.v[i] == (uint32_t)(h64.v[i/2]>>(32*(i%2))));
+    skein_hash<Philox4x32::ukey_type> seeded("my seed");
+    assert(seeded("run-2041/entity-17").v[0] == 0xb070c6e1 && seeded("run-2041/entity-17").v[1] == 0xff7baf26);
+    skein_hash<Threefry4x64::ukey_type, 20> fast;
+    Threefry4x64::ukey_type uk = fast("abc");
+    assert(uk.v[3] == R123_64BIT(0x0da2b202ae14b5f8));
+
+    vector<string> names;
+    for(int i=0; i<1000; ++i){
+        char b[64];
+        sprintf(b, "run-%d/entity-%d%s", i%7, i, i%3 ? "" : "-with-a-longer-name-than-most");
+        names.push_back(b);
+    }
+    vector<Threefry4x64::ukey_type> keys(names.size());
+    fast(&names[0], names.size(), &keys[0]);
+    for(size_t i=0; i<names.size(); ++i)
+        assert(keys[i] == fast(names[i]));
+    cout << "skein_hash OK\n";
+    return 0;
+}
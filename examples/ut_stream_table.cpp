@@ -0,0 +1,142 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check that r123::stream_table draws, one word or one block at a
+// time and for entities in any order (with repeats), the words of the
+// streams it documents, and that it is smaller than an array of
+// MicroURNGs.
+
+#include <Random123/stream_table.hpp>
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/MicroURNG.hpp>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+// Word j of entity e's stream, as documented in stream_table.hpp.
+template <typename CBRNG>
+typename CBRNG::ctr_type::value_type word(const stream_table<CBRNG>& t, size_t e, uint64_t j){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename ctr_type::value_type value_type;
+    const size_t N = sizeof(ctr_type)/sizeof(value_type);
+    ctr_type c = t.base();
+    c[0] = (value_type)(j/N);
+    c[1] += (value_type)e;
+    return CBRNG()(c, t.key())[j%N];
+}
+
+template <typename CBRNG>
+void chk(const char* name){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+    const size_t N = sizeof(ctr_type)/sizeof(value_type);
+    const size_t n = 1000;
+    key_type k = {{}};
+    k[0] = 0x12345;
+    ctr_type base = {{}};
+    base[1] = 77;
+    base[N-1] = 5;
+    stream_table<CBRNG> t(n, k, base);
+    assert(t.size() == n);
+
+    // Scattered ids, with repeats, in batches of odd sizes, and the
+    // single-entity draws, all interleaved.
+    vector<uint64_t> drawn(n, 0);
+    vector<uint32_t> ids;
+    vector<value_type> out;
+    uint32_t z = 1;
+    for(size_t m=0; m<600; m += 1 + m/3){
+        ids.resize(m);
+        out.assign(m, 0);
+        for(size_t i=0; i<m; ++i){
+            z = z*1664525u + 1013904223u;
+            ids[i] = (z>>8)%(i%3 ? n : 7);
+        }
+        t.draw(m ? &ids[0] : 0, m, m ? &out[0] : 0);
+        for(size_t i=0; i<m; ++i)
+            assert(out[i] == word(t, ids[i], drawn[ids[i]]++));
+        size_t e = z%n;
+        assert(t(e) == word(t, e, drawn[e]++));
+    }
+    for(size_t e=0; e<n; ++e)
+        assert(t.position(e) == drawn[e]);
+
+    // Whole blocks skip to the next block boundary.
+    vector<ctr_type> blk(5);
+    uint32_t bids[5] = {3, 4, 3, 999, 4};
+    t.seek(4, (value_type)(2*N));
+    t.seek(3, (value_type)(N+1));
+    t.draw_blocks(bids, 5, &blk[0]);
+    for(size_t j=0; j<N; ++j){
+        assert(blk[0][j] == word(t, 3, 2*N+j));
+        assert(blk[1][j] == word(t, 4, 2*N+j));
+        assert(blk[2][j] == word(t, 3, 3*N+j));
+        assert(blk[4][j] == word(t, 4, 3*N+j));
+    }
+    assert(t.position(3) == 4*N && t.position(4) == 4*N);
+    assert(t(3) == word(t, 3, 4*N));
+
+    // The end of a stream.
+    t.seek(0, ~(value_type)0 - 1);
+    t(0);
+    bool threw = false;
+    try{ t(0); }catch(std::runtime_error&){ threw = true; }
+    assert(threw);
+    threw = false;
+    try{ t.draw_blocks(bids+3, 1, &blk[0]); t.seek(999, ~(value_type)0 - N); t.draw_blocks(bids+3, 1, &blk[0]); }catch(std::runtime_error&){ threw = true; }
+    assert(threw);
+
+    // At least 4 times smaller than a MicroURNG.
+    assert(4*sizeof(value_type) <= sizeof(MicroURNG<CBRNG>));
+    cout << "stream_table<" << name << "> OK (" << sizeof(value_type) << " bytes an entity, "
+         << sizeof(MicroURNG<CBRNG>) << " for a MicroURNG)\n";
+}
+
+int main(int, char **){
+    chk<Philox4x32>("Philox4x32");
+    chk<Threefry4x32>("Threefry4x32");
+#if R123_USE_PHILOX_64BIT
+    chk<Philox4x64>("Philox4x64");
+    chk<Philox2x64>("Philox2x64");
+#endif
+    chk<Threefry4x64>("Threefry4x64");
+    chk<Threefry2x32>("Threefry2x32");
+
+    bool threw = false;
+    try{ stream_table<Philox2x32> t(((size_t)1<<32) + 1, Philox2x32::key_type()); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw || sizeof(size_t) < 8);
+    return 0;
+}
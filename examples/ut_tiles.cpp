@@ -0,0 +1,155 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::generate_tiles against the CBRNGs themselves, for the
+// generators with multi-lane fills and for some without, with tile
+// sizes that do and do not divide the number of blocks, and with
+// counters that carry.
+
+#include <Random123/tiles.hpp>
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/ars.h>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace r123;
+
+// Appends each tile to a vector, and checks the alignment and size of
+// the tiles.
+template <typename CBRNG>
+struct collect{
+    typedef typename CBRNG::ctr_type ctr_type;
+    vector<ctr_type>* all;
+    size_t tile;
+    size_t ntiles;
+    void operator()(const ctr_type* p, size_t m){
+        assert((uintptr_t)p % 64 == 0);
+        assert(m >= 1 && m <= tile);
+        all->insert(all->end(), p, p+m);
+        ntiles++;
+    }
+};
+
+template <typename CBRNG>
+void chk(const char* name){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+    CBRNG b;
+    key_type k = {{}};
+    for(size_t w=0; w<k.size(); ++w)
+        k.v[w] = (value_type)(0x9e3779b97f4a7c15ULL*(w+1));
+    const value_type m = ~(value_type)0;
+    const size_t tiles[] = {1, 3, 16, 33, 64, 1000};
+    const size_t ns[] = {0, 1, 17, 64, 200, 1001};
+    for(int carry=0; carry<2; ++carry){
+        ctr_type c0 = {{}};
+        c0.v[0] = carry ? m-50 : 12345;
+        if(carry && c0.size() > 1)
+            c0.v[1] = m;
+        for(size_t t=0; t<sizeof(tiles)/sizeof(*tiles); ++t){
+            for(size_t j=0; j<sizeof(ns)/sizeof(*ns); ++j){
+                size_t n = ns[j];
+                vector<ctr_type> all;
+                collect<CBRNG> f = {&all, tiles[t], 0};
+                f = generate_tiles(b, k, c0, n, tiles[t], f);
+                assert(all.size() == n);
+                assert(f.ntiles == (n + tiles[t] - 1)/tiles[t]);
+                ctr_type c = c0;
+                for(size_t i=0; i<n; ++i, c.incr())
+                    assert(all[i] == b(c, k));
+            }
+        }
+    }
+    // The default tile size.
+    vector<ctr_type> all;
+    collect<CBRNG> f = {&all, 16384/sizeof(ctr_type), 0};
+    ctr_type c0 = {{}};
+    f = generate_tiles(b, k, c0, 5000, f);
+    assert(all.size() == 5000 && all[4999] == b(c0.incr(4999), k));
+    cout << "generate_tiles " << name << " OK\n";
+}
+
+#if __cplusplus >= 201103L
+void chklambda(){
+    Philox4x32 b;
+    Philox4x32::key_type k = {{1, 2}};
+    Philox4x32::ctr_type c0 = {{3, 4, 5, 6}};
+    uint64_t sum = 0, ref = 0;
+    generate_tiles(b, k, c0, 1000, 77, [&](const Philox4x32::ctr_type* p, size_t m){
+            for(size_t i=0; i<m; ++i)
+                sum += p[i].v[0];
+        });
+    for(size_t i=0; i<1000; ++i, c0.incr())
+        ref += b(c0, k).v[0];
+    assert(sum == ref);
+    cout << "generate_tiles with a lambda OK\n";
+}
+#endif
+
+struct nothing{
+    void operator()(const Philox4x32::ctr_type*, size_t){}
+};
+
+int main(int, char **){
+    chk<Philox4x32>("Philox4x32");
+    chk<Philox4x32_R<7> >("Philox4x32_R<7>");
+    chk<Threefry4x32>("Threefry4x32");
+    chk<Threefry4x32_R<13> >("Threefry4x32_R<13>");
+#if R123_USE_PHILOX_64BIT
+    chk<Philox4x64>("Philox4x64");
+    chk<Philox2x64>("Philox2x64");
+#endif
+    chk<Threefry4x64>("Threefry4x64");
+    chk<Threefry2x32>("Threefry2x32");
+    chk<Philox2x32>("Philox2x32");
+#if R123_USE_AES_NI || R123_USE_ARM_AES
+    chk<ARS4x32>("ARS4x32");
+#endif
+#if __cplusplus >= 201103L
+    chklambda();
+#endif
+    bool threw = false;
+    try{
+        Philox4x32::ctr_type c0 = {{}};
+        Philox4x32::key_type k = {{}};
+        generate_tiles(Philox4x32(), k, c0, 10, 0, nothing());
+    }catch(std::invalid_argument&){
+        threw = true;
+    }
+    assert(threw);
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check r123::uniform_int_fill against a straightforward scalar
+// implementation of its documented counter layout, including ranges
+// where nearly half the words are rejected.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <Random123/uniform_int.hpp>
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "util_demangle.hpp"
+
+using namespace std;
+using namespace r123;
+
+// 32-bit words of block n of the stream for counter c: low half first.
+template <typename CBRNG>
+vector<uint32_t> words32(CBRNG b, typename CBRNG::ctr_type c, typename CBRNG::key_type k, uint32_t n){
+    block_stream<CBRNG> s(b, c, k);
+    typename CBRNG::ctr_type r = s.block(n);
+    vector<uint32_t> w;
+    for(size_t e=0; e<r.size(); ++e){
+        w.push_back((uint32_t)r[e]);
+        if(sizeof(r[e]) == 8)
+            w.push_back((uint32_t)((uint64_t)r[e]>>32));
+    }
+    return w;
+}
+
+// 64-bit words of block n: 32-bit words paired, first word high.
+template <typename CBRNG>
+vector<uint64_t> words64(CBRNG b, typename CBRNG::ctr_type c, typename CBRNG::key_type k, uint32_t n){
+    block_stream<CBRNG> s(b, c, k);
+    typename CBRNG::ctr_type r = s.block(n);
+    vector<uint64_t> w;
+    for(size_t e=0; e<r.size(); ++e){
+        if(sizeof(r[e]) == 8)
+            w.push_back(r[e]);
+        else if(e%2)
+            w.back() |= r[e];
+        else
+            w.push_back((uint64_t)r[e]<<32);
+    }
+    return w;
+}
+
+uint64_t mulhi64(uint64_t a, uint64_t b, uint64_t* lo){
+    uint64_t hi;
+    *lo = _uniform_int_mulhilo64(a, b, &hi);
+    return hi;
+}
+
+// Reference: one output at a time, straight from the documentation.
+template <typename CBRNG, typename T>
+vector<T> reference(CBRNG b, typename CBRNG::key_type k, typename CBRNG::ctr_type c0, T lo, T hi, size_t n){
+    typedef typename _uniform_int_unsigned<T>::type U;
+    U s = (U)((U)hi - (U)lo + 1);
+    bool use32 = sizeof(U) == 4 || (s != 0 && (uint64_t)s <= R123_64BIT(0x100000000));
+    vector<T> out;
+    if(use32){
+        uint64_t s32 = (uint32_t)s ? (uint32_t)s : R123_64BIT(0x100000000);
+        uint64_t t = R123_64BIT(0x100000000) % s32;
+        size_t M = sizeof(typename CBRNG::ctr_type)/4;
+        for(size_t j=0; out.size()<n; ++j){
+            typename CBRNG::ctr_type c = c0;
+            c.incr(j);
+            vector<uint32_t> w = words32(b, c, k, 0);
+            vector<uint32_t> retry;
+            uint32_t nretry = 0;
+            for(size_t i=0; i<M && out.size()<n; ++i){
+                uint64_t p = w[i]*s32;
+                while((uint32_t)p < t){
+                    if(retry.empty())
+                        retry = words32(b, c, k, ++nretry);
+                    p = retry.front()*s32;
+                    retry.erase(retry.begin());
+                }
+                out.push_back((T)(U)((U)lo + (U)(p>>32)));
+            }
+        }
+    }else{
+        uint64_t t = s ? (R123_64BIT(0) - s) % s : 0;
+        size_t M = sizeof(typename CBRNG::ctr_type)/8;
+        for(size_t j=0; out.size()<n; ++j){
+            typename CBRNG::ctr_type c = c0;
+            c.incr(j);
+            vector<uint64_t> w = words64(b, c, k, 0);
+            vector<uint64_t> retry;
+            uint32_t nretry = 0;
+            for(size_t i=0; i<M && out.size()<n; ++i){
+                uint64_t l, h;
+                h = s ? mulhi64(w[i], s, &l) : w[i];
+                while(s && l < t){
+                    if(retry.empty())
+                        retry = words64(b, c, k, ++nretry);
+                    h = mulhi64(retry.front(), s, &l);
+                    retry.erase(retry.begin());
+                }
+                out.push_back((T)(U)((U)lo + h));
+            }
+        }
+    }
+    return out;
+}
+
+template <typename CBRNG, typename T>
+void chkrange(T lo, T hi){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    CBRNG b;
+    ctr_type c0 = {{}};
+    key_type k = {{}};
+    if(c0.size() > 2)
+        c0[0] = 0xfffffff0;  // carry into c0[1] along the way
+    k[0] = (typename key_type::value_type)hi;
+    const size_t n = 1001;
+    vector<T> out(n);
+    uniform_int_fill(b, k, c0, lo, hi, &out[0], n);
+    vector<T> ref = reference(b, k, c0, lo, hi, n);
+    assert(out == ref);
+    for(size_t i=0; i<n; ++i)
+        assert(lo <= out[i] && out[i] <= hi);
+
+    // Split at a block boundary.
+    size_t M = 8*sizeof(ctr_type)/(sizeof(T)*8 > 32 && (uint64_t)((uint64_t)hi - (uint64_t)lo) > 0xffffffff ? 64 : 32);
+    vector<T> pieces(n);
+    ctr_type c = c0;
+    uniform_int_fill(b, k, c, lo, hi, &pieces[0], 40*M);
+    c.incr(40);
+    uniform_int_fill(b, k, c, lo, hi, &pieces[40*M], n-40*M);
+    assert(out == pieces);
+}
+
+template <typename CBRNG>
+void chkcbrng(){
+    chkrange<CBRNG, uint32_t>(0, 0);
+    chkrange<CBRNG, uint32_t>(0, 5);
+    chkrange<CBRNG, int32_t>(-3, 3);
+    chkrange<CBRNG, uint32_t>(0, 0x80000000);   // s = 2^31+1: nearly half rejected
+    chkrange<CBRNG, int32_t>(-2147483647-1, 2147483647);
+    chkrange<CBRNG, uint32_t>(7, 0xffffffff);
+    chkrange<CBRNG, uint64_t>(0, 999);
+    chkrange<CBRNG, uint64_t>(5, R123_64BIT(0x100000004));   // s = 2^32: 32-bit path, no rejection
+    chkrange<CBRNG, uint64_t>(0, R123_64BIT(0x100000000));   // s = 2^32+1: 64-bit path
+    chkrange<CBRNG, uint64_t>(0, R123_64BIT(0x8000000000000000));  // nearly half rejected
+    chkrange<CBRNG, int64_t>(-R123_64BIT(0x7fffffffffffffff)-1, R123_64BIT(0x7fffffffffffffff));
+    chkrange<CBRNG, int64_t>(-1000000000000LL, 1000000000000LL);
+
+    // Errors
+    CBRNG b;
+    typename CBRNG::ctr_type c = {{}};
+    typename CBRNG::key_type k = {{}};
+    uint32_t x[4];
+    bool threw = false;
+    try{ uniform_int_fill(b, k, c, 5u, 4u, x, 4); }catch(std::invalid_argument&){ threw = true; }
+    assert(threw);
+    c[c.size()-1] = ~(typename CBRNG::ctr_type::value_type)0;
+    threw = false;
+    try{ uniform_int_fill(b, k, c, 0u, 4u, x, 4); }catch(std::runtime_error&){ threw = true; }
+    assert(threw);
+    cout << "uniform_int " << demangle(b) << " OK\n";
+}
+
+int main(int, char **){
+    chkcbrng<Philox4x32>();
+    chkcbrng<Philox2x32>();
+    chkcbrng<Threefry2x64>();
+    chkcbrng<Threefry4x64>();
+#if R123_USE_PHILOX_64BIT
+    chkcbrng<Philox4x64>();
+#endif
+
+    // The mean of a large sample.
+    vector<uint32_t> v(1000000);
+    Philox4x32::ctr_type c = {{}};
+    Philox4x32::key_type k = {{}};
+    uniform_int_fill(Philox4x32(), k, c, 0u, 9u, &v[0], v.size());
+    double sum = 0.;
+    vector<size_t> count(10);
+    for(size_t i=0; i<v.size(); ++i){
+        sum += v[i];
+        count[v[i]]++;
+    }
+    assert(std::abs(sum/v.size() - 4.5) < 0.02);
+    for(size_t i=0; i<10; ++i)
+        assert(count[i] > 99000 && count[i] < 101000);
+    return 0;
+}
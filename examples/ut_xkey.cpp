@@ -0,0 +1,103 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Check that the expanded-key forms of Philox and Threefry,
+// NxW_R_xkey and the functors' operator()(ctr_type, xkey_type), agree
+// with NxW_R for every supported number of rounds.
+
+#include <Random123/philox.h>
+#include <Random123/threefry.h>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+using namespace r123;
+
+// A cheap 64-bit LCG; the inputs need not be random, only varied.
+static uint64_t z = 1;
+static uint64_t next(){
+    z = z*R123_64BIT(6364136223846793005) + R123_64BIT(1442695040888963407);
+    return z>>7;
+}
+
+template <typename T>
+void fill(T& a){
+    for(size_t i=0; i<a.size(); ++i)
+        a.v[i] = (typename T::value_type)next();
+}
+
+#define CHKC(NxW, MAXR)                                                 \
+    for(unsigned R=0; R<=MAXR; ++R)                                     \
+        for(int t=0; t<50; ++t){                                        \
+            NxW##_ctr_t c; NxW##_key_t k;                               \
+            fill(c); fill(k);                                           \
+            NxW##_xkey_t xk = NxW##xkeyinit(k);                         \
+            assert(NxW##_R(R, c, k) == NxW##_R_xkey(R, c, xk));         \
+        }                                                               \
+    cout << #NxW "_R_xkey OK\n";
+
+template <typename CBRNG>
+void chkcpp(const char* name){
+    CBRNG b;
+    for(int t=0; t<1000; ++t){
+        typename CBRNG::ctr_type c;
+        typename CBRNG::key_type k;
+        fill(c); fill(k);
+        typename CBRNG::xkey_type xk = CBRNG::expand(k);
+        assert(b(c, xk) == b(c, k));
+    }
+    cout << name << "::expand OK\n";
+}
+
+int main(int, char **){
+    CHKC(philox2x32, 16)
+    CHKC(philox4x32, 16)
+    CHKC(threefry2x32, 32)
+    CHKC(threefry4x32, 72)
+#if R123_USE_PHILOX_64BIT
+    CHKC(philox2x64, 16)
+    CHKC(philox4x64, 16)
+#endif
+    CHKC(threefry2x64, 32)
+    CHKC(threefry4x64, 72)
+
+    chkcpp<Philox2x32>("Philox2x32");
+    chkcpp<Philox4x32_R<7> >("Philox4x32_R<7>");
+    chkcpp<Threefry2x32>("Threefry2x32");
+    chkcpp<Threefry4x32_R<13> >("Threefry4x32_R<13>");
+#if R123_USE_PHILOX_64BIT
+    chkcpp<Philox2x64>("Philox2x64");
+    chkcpp<Philox4x64>("Philox4x64");
+#endif
+    chkcpp<Threefry2x64_R<21> >("Threefry2x64_R<21>");
+    chkcpp<Threefry4x64>("Threefry4x64");
+    return 0;
+}
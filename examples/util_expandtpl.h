@@ -66,8 +66,12 @@ TEST_TPL(threefry, 4, 64, 20)
 TEST_TPL(threefry, 4, 32, 12)
 TEST_TPL(threefry, 4, 32, 20)
 TEST_TPL(threefry, 4, 64, 72)
+TEST_TPL(threefry, 8, 64, 20)
+TEST_TPL(threefry, 8, 64, 72)
+TEST_TPL(threefry, 16, 64, 20)
+TEST_TPL(threefry, 16, 64, 80)
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 TEST_TPL(ars, 4, 32, 5)
 TEST_TPL(ars, 4, 32, 7)
 TEST_TPL(aesni, 4, 32, 10)
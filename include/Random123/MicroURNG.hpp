@@ -120,6 +120,21 @@ public:
     static R123_CONSTEXPR result_type max R123_NO_MACRO_SUBST () { return _Max; }
     // extra methods:
     const ctr_type& counter() const{ return c0; }
+    const key_type& key() const{ return k; }
+    // The number of values returned since construction or the last
+    // reset, and its inverse, e.g., for checkpoint.hpp.
+    R123_ULONG_LONG position() const{ return n*rdata.size() - last_elem; }
+    void setposition(R123_ULONG_LONG p){
+        const size_t N = rdata.size();
+        n = (p + N - 1)/N;
+        last_elem = size_t(n*N - p);
+        if(last_elem != 0){
+            const size_t W = std::numeric_limits<result_type>::digits;
+            ctr_type c = c0;
+            c[c0.size()-1] |= (n-1)<<(W-BITS);
+            rdata = b(c,k);
+        }
+    }
     void reset(ctr_type _c0, ukey_type _uk){
         c0 = _c0;
         chkhighbits();
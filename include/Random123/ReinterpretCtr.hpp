@@ -33,17 +33,97 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __ReinterpretCtr_dot_hpp__
 
 #include "features/compilerfeatures.h"
-#include <cstring>
+#include "array.h"
+#include <cstddef>
 
 namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+// _reinterpreter<To, From>::cast(f) has the bytes of f.  In general,
+// they go through a union.  The union is aligned for both of its
+// members, so wherever the compiler puts it, an __m128i in it is
+// aligned.  (In Sep 2011, with memcpy and a CBRNG whose ctr_type is
+// r123array1xm128i, gcc4.6 produced an aesenclast with a destination
+// operand at an unaligned memory address ... Segfault!  See:
+// http://gcc.gnu.org/bugzilla/show_bug.cgi?id=50444)  An array of
+// words going into an SSE or AVX counter is put together in
+// registers instead, as ars4x32_R does, because storing it a word at
+// a time and loading it whole would defeat store forwarding.
+template <typename To, typename From>
+struct _reinterpreter{
+    static To cast(const From& f){
+        union{
+            From f;
+            To t;
+        } u;
+        u.f = f;
+        return u.t;
+    }
+};
+
+#if R123_USE_SSE
+template <>
+struct _reinterpreter<r123array1xm128i, r123array4x32>{
+    static r123array1xm128i cast(const r123array4x32& f){
+        r123array1xm128i t;
+        t.v[0].m = _mm_set_epi32(f.v[3], f.v[2], f.v[1], f.v[0]);
+        return t;
+    }
+};
+
+template <>
+struct _reinterpreter<r123array1xm128i, r123array2x64>{
+    static r123array1xm128i cast(const r123array2x64& f){
+        r123array1xm128i t;
+        t.v[0].m = _mm_set_epi64x(f.v[1], f.v[0]);
+        return t;
+    }
+};
+#endif
+
+#if R123_USE_AVX2
+template <>
+struct _reinterpreter<r123array1xm256i, r123array8x32>{
+    static r123array1xm256i cast(const r123array8x32& f){
+        r123array1xm256i t;
+        t.v[0].m = _mm256_set_epi32(f.v[7], f.v[6], f.v[5], f.v[4], f.v[3], f.v[2], f.v[1], f.v[0]);
+        return t;
+    }
+};
+
+template <>
+struct _reinterpreter<r123array1xm256i, r123array4x64>{
+    static r123array1xm256i cast(const r123array4x64& f){
+        r123array1xm256i t;
+        t.v[0].m = _mm256_set_epi64x(f.v[3], f.v[2], f.v[1], f.v[0]);
+        return t;
+    }
+};
+#endif
+
+#if R123_USE_AVX512
+template <>
+struct _reinterpreter<r123array1xm512i, r123array8x64>{
+    static r123array1xm512i cast(const r123array8x64& f){
+        r123array1xm512i t;
+        t.v[0].m = _mm512_set_epi64(f.v[7], f.v[6], f.v[5], f.v[4], f.v[3], f.v[2], f.v[1], f.v[0]);
+        return t;
+    }
+};
+#endif
+/** \endcond */
+
 /*!
-  ReinterpretCtr uses memcpy to map back and forth
-  between a CBRNG's ctr_type and the specified ToType.  For example,
-  after:
+  ReinterpretCtr maps back and forth between a CBRNG's ctr_type and
+  the specified ToType.  For example, after:
 
     typedef ReinterpretCtr<r123array4x32, Philox2x64> G;
 
-  G is a bona fide CBRNG with ctr_type r123array4x32.
+  G is a bona fide CBRNG with ctr_type r123array4x32.  The CBRNG's
+  ctr_type may hold SIMD words, e.g., that of ARS1xm128i or
+  AESNI1xm128i, r123array1xm128i.
+
+  G also has a bulk form, g(buf, n, k), which replaces each of the n
+  counters in buf with g(buf[i], k), in place.
 
   WARNING:  ReinterpretCtr is endian dependent.  The
   values returned by G, declared as above,
@@ -56,32 +136,18 @@ struct ReinterpretCtr{
     typedef typename CBRNG::key_type key_type;
     typedef typename CBRNG::ctr_type bctype;
     typedef typename CBRNG::ukey_type ukey_type;
-    R123_STATIC_ASSERT(sizeof(ToType) == sizeof(bctype) && sizeof(typename bctype::value_type) != 16, 
-                       "ReinterpretCtr:  sizeof(ToType) is not the same as sizeof(CBRNG::ctr_type) or CBRNG::ctr_type::value_type looks like it might be __m128i");
-    // It's amazingly difficult to safely do conversions with __m128i.
-    // If we use the operator() implementation below with a CBRNG
-    // whose ctr_type is r123array1xm128i, gcc4.6 optimizes away the
-    // memcpys, inlines the operator()(c,k), and produces assembly
-    // language that ends with an aesenclast instruction with a
-    // destination operand pointing to an unaligned memory address ...
-    // Segfault!  See:  http://gcc.gnu.org/bugzilla/show_bug.cgi?id=50444
-    // MSVC also produces code that crashes.  We suspect a
-    // similar mechanism but haven't done the debugging necessary to
-    // be sure.  We were able to 'fix' gcc4.6 by making bc a mutable
-    // data member rather than declaring it in the scope of
-    // operator().  That didn't fix the MSVC problems, though.
-    //
-    // Conclusion - don't touch __m128i, at least for now.  The
-    // easiest (but highly imprecise) way to do that is the static
-    // assertion above that rejects bctype::value_types of size 16. -
-    // Sep 2011.
-    ctr_type  operator()(ctr_type c, key_type k){
-        bctype bc;
-        std::memcpy(&bc, &c, sizeof(c));
+    R123_STATIC_ASSERT(sizeof(ToType) == sizeof(bctype),
+                       "ReinterpretCtr:  sizeof(ToType) is not the same as sizeof(CBRNG::ctr_type)");
+    ctr_type operator()(ctr_type c, key_type k){
+        CBRNG b;
+        return _reinterpreter<ctr_type, bctype>::cast(b(_reinterpreter<bctype, ctr_type>::cast(c), k));
+    }
+
+    // buf[i] = (*this)(buf[i], k) for i in [0, n).
+    void operator()(ctr_type* buf, size_t n, key_type k){
         CBRNG b;
-        bc = b(bc, k);
-        std::memcpy(&c, &bc, sizeof(bc));
-        return c;
+        for(size_t i=0; i<n; ++i)
+            buf[i] = _reinterpreter<ctr_type, bctype>::cast(b(_reinterpreter<bctype, ctr_type>::cast(buf[i]), k));
     }
 };
 } // namespace r123
@@ -37,7 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 /* Implement a bona fide AES block cipher.  It's minimally
 // checked against the test vector in FIPS-197 in ut_aes.cpp. */
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 
 /** @ingroup AESNI */
 typedef struct r123array1xm128i aesni1xm128i_ctr_t;
@@ -49,6 +49,9 @@ typedef struct r123array4x32 aesni4x32_ukey_t;
 enum r123_enum_aesni1xm128i { aesni1xm128i_rounds = 10 };
 
 /** \cond HIDDEN_FROM_DOXYGEN */
+#if R123_USE_AES_NI
+typedef __m128i _aesni1xm128i_block_t;
+
 R123_STATIC_INLINE __m128i AES_128_ASSIST (__m128i temp1, __m128i temp2) { 
     __m128i temp3; 
     temp2 = _mm_shuffle_epi32 (temp2 ,0xff); 
@@ -108,39 +111,78 @@ R123_STATIC_INLINE void aesni1xm128iexpand(aesni1xm128i_ukey_t uk, __m128i ret[1
     rkey = AES_128_ASSIST(rkey, tmp2);
     ret[10] = rkey;
 }
+
+R123_STATIC_INLINE void aesni4x32expand(aesni4x32_ukey_t uk, __m128i ret[11]){
+    aesni1xm128i_ukey_t uk128;
+    uk128.v[0].m = _mm_set_epi32(uk.v[3], uk.v[2], uk.v[1], uk.v[0]);
+    aesni1xm128iexpand(uk128, ret);
+}
+#else /* R123_USE_ARM_AES */
+typedef uint64x2_t _aesni1xm128i_block_t;
+
+/* The next round key.  There is no aeskeygenassist on ARM, but
+// SubWord can be had from AESE with a zero key:  ShiftRows leaves a
+// vector of four equal words unchanged. */
+R123_STATIC_INLINE uint64x2_t AES_128_ASSIST_NEON(uint64x2_t rkey, uint32_t rcon){
+    uint32x4_t k = vreinterpretq_u32_u64(rkey);
+    uint32x4_t z = vdupq_n_u32(0);
+    uint32x4_t w = vdupq_n_u32(vgetq_lane_u32(k, 3));
+    uint32x4_t t;
+    w = vreinterpretq_u32_u8(vaeseq_u8(vreinterpretq_u8_u32(w), vdupq_n_u8(0)));
+    /* RotWord(SubWord(w)) ^ rcon */
+    w = veorq_u32(vorrq_u32(vshrq_n_u32(w, 8), vshlq_n_u32(w, 24)), vdupq_n_u32(rcon));
+    t = vextq_u32(z, k, 3);
+    k = veorq_u32(k, t);
+    t = vextq_u32(z, t, 3);
+    k = veorq_u32(k, t);
+    t = vextq_u32(z, t, 3);
+    k = veorq_u32(k, t);
+    return vreinterpretq_u64_u32(veorq_u32(k, w));
+}
+
+R123_STATIC_INLINE void aesni1xm128iexpand(aesni1xm128i_ukey_t uk, uint64x2_t ret[11])
+{
+    static const uint8_t rcon[10] = {0x1, 0x2, 0x4, 0x8, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36};
+    int i;
+    ret[0] = uk.v[0].m;
+    for(i=0; i<10; ++i)
+        ret[i+1] = AES_128_ASSIST_NEON(ret[i], rcon[i]);
+}
+
+R123_STATIC_INLINE void aesni4x32expand(aesni4x32_ukey_t uk, uint64x2_t ret[11]){
+    aesni1xm128i_ukey_t uk128;
+    uk128.v[0].m = vreinterpretq_u64_u32(vld1q_u32(uk.v));
+    aesni1xm128iexpand(uk128, ret);
+}
+#endif
 /** \endcond */
     
 #ifdef __cplusplus
 /** @ingroup AESNI */
 struct aesni1xm128i_key_t{ 
-    __m128i k[11]; 
+    _aesni1xm128i_block_t k[11]; 
     aesni1xm128i_key_t(){
-        aesni1xm128i_ukey_t uk;
-        uk.v[0].m = _mm_setzero_si128();
-        aesni1xm128iexpand(uk, k);
+        aesni4x32_ukey_t uk = {{}};
+        aesni4x32expand(uk, k);
     }
     aesni1xm128i_key_t(const aesni1xm128i_ukey_t& uk){
         aesni1xm128iexpand(uk, k);
     }
     aesni1xm128i_key_t(const aesni4x32_ukey_t& uk){
-        aesni1xm128i_ukey_t uk128;
-        uk128.v[0].m = _mm_set_epi32(uk.v[3], uk.v[2], uk.v[1], uk.v[0]);
-        aesni1xm128iexpand(uk128, k);
+        aesni4x32expand(uk, k);
     }
     aesni1xm128i_key_t& operator=(const aesni1xm128i_ukey_t& uk){
         aesni1xm128iexpand(uk, k);
         return *this;
     }
     aesni1xm128i_key_t& operator=(const aesni4x32_ukey_t& uk){
-        aesni1xm128i_ukey_t uk128;
-        uk128.v[0].m = _mm_set_epi32(uk.v[3], uk.v[2], uk.v[1], uk.v[0]);
-        aesni1xm128iexpand(uk128, k);
+        aesni4x32expand(uk, k);
         return *this;
     }
 };
 #else
 typedef struct { 
-    __m128i k[11]; 
+    _aesni1xm128i_block_t k[11]; 
 }aesni1xm128i_key_t;
 
 /** @ingroup AESNI */
@@ -153,6 +195,7 @@ R123_STATIC_INLINE aesni1xm128i_key_t aesni1xm128ikeyinit(aesni1xm128i_ukey_t uk
 
 /** @ingroup AESNI */
 R123_STATIC_INLINE aesni1xm128i_ctr_t aesni1xm128i(aesni1xm128i_ctr_t in, aesni1xm128i_key_t k) {
+#if R123_USE_AES_NI
     __m128i x = _mm_xor_si128(k.k[0], in.v[0].m);
     x = _mm_aesenc_si128(x, k.k[1]);
     x = _mm_aesenc_si128(x, k.k[2]);
@@ -169,6 +212,18 @@ R123_STATIC_INLINE aesni1xm128i_ctr_t aesni1xm128i(aesni1xm128i_ctr_t in, aesni1
       ret.v[0].m = x;
       return ret;
     }
+#else /* R123_USE_ARM_AES */
+    /* AESE xors its key first, so the keys are used one round
+    // earlier than by aesenc, and the last is xored at the end. */
+    uint8x16_t x = vreinterpretq_u8_u64(in.v[0].m);
+    int i;
+    aesni1xm128i_ctr_t ret;
+    for(i=0; i<9; ++i)
+        x = vaesmcq_u8(vaeseq_u8(x, vreinterpretq_u8_u64(k.k[i])));
+    x = vaeseq_u8(x, vreinterpretq_u8_u64(k.k[9]));
+    ret.v[0].m = vreinterpretq_u64_u8(veorq_u8(x, vreinterpretq_u8_u64(k.k[10])));
+    return ret;
+#endif
 }
 
 /** @ingroup AESNI */
@@ -186,10 +241,8 @@ typedef aesni1xm128i_key_t aesni4x32_key_t;
 enum r123_enum_aesni4x32 { aesni4x32_rounds = 10 };
 /** @ingroup AESNI */
 R123_STATIC_INLINE aesni4x32_key_t aesni4x32keyinit(aesni4x32_ukey_t uk){
-    aesni1xm128i_ukey_t uk128;
     aesni4x32_key_t ret;
-    uk128.v[0].m = _mm_set_epi32(uk.v[3], uk.v[2], uk.v[1], uk.v[0]);
-    aesni1xm128iexpand(uk128, ret.k);
+    aesni4x32expand(uk, ret.k);
     return ret;
 }
 
@@ -197,9 +250,15 @@ R123_STATIC_INLINE aesni4x32_key_t aesni4x32keyinit(aesni4x32_ukey_t uk){
 /** The aesni4x32_R function provides a C API to the @ref AESNI "AESNI" CBRNG, allowing the number of rounds to be specified explicitly **/
 R123_STATIC_INLINE aesni4x32_ctr_t aesni4x32_R(unsigned int Nrounds, aesni4x32_ctr_t c, aesni4x32_key_t k){
     aesni1xm128i_ctr_t c128;
+#if R123_USE_AES_NI
     c128.v[0].m = _mm_set_epi32(c.v[3], c.v[2], c.v[1], c.v[0]);
     c128 = aesni1xm128i_R(Nrounds, c128, k);
     _mm_storeu_si128((__m128i*)&c.v[0], c128.v[0].m);
+#else
+    c128.v[0].m = vreinterpretq_u64_u32(vld1q_u32(c.v));
+    c128 = aesni1xm128i_R(Nrounds, c128, k);
+    vst1q_u32(c.v, vreinterpretq_u32_u64(c128.v[0].m));
+#endif
     return c;
 }
 
@@ -209,6 +268,169 @@ R123_STATIC_INLINE aesni4x32_ctr_t aesni4x32_R(unsigned int Nrounds, aesni4x32_c
 /** @ingroup AESNI */
 #define aesni4x32(c,k) aesni4x32_R(aesni4x32_rounds, c, k)
 
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* The counter blocks of aesni1xm128i_ctr_xor are 128-bit big-endian
+   integers, as in NIST SP 800-38A.  They are carried here as their
+   high and low 64-bit halves. */
+R123_STATIC_INLINE uint64_t _aesni_bswap64(uint64_t x){
+    x = ((x & R123_64BIT(0x00ff00ff00ff00ff))<<8) | ((x>>8) & R123_64BIT(0x00ff00ff00ff00ff));
+    x = ((x & R123_64BIT(0x0000ffff0000ffff))<<16) | ((x>>16) & R123_64BIT(0x0000ffff0000ffff));
+    return (x<<32) | (x>>32);
+}
+
+R123_STATIC_INLINE void _aesni_ctr_split(aesni1xm128i_ctr_t c, uint64_t* hi, uint64_t* lo){
+    unsigned char b[16];
+    int i;
+#if R123_USE_AES_NI
+    _mm_storeu_si128((__m128i*)b, c.v[0].m);
+#else
+    vst1q_u8(b, vreinterpretq_u8_u64(c.v[0].m));
+#endif
+    *hi = *lo = 0;
+    for(i=0; i<8; ++i){
+        *hi = (*hi<<8) | b[i];
+        *lo = (*lo<<8) | b[8+i];
+    }
+}
+
+/* Xor bytes [off, off+len) of the keystream block for counter hi:lo
+   into out[0, len). */
+R123_STATIC_INLINE void _aesni_ctr_xor1(const aesni1xm128i_key_t* k, uint64_t hi, uint64_t lo, const unsigned char* in, unsigned char* out, size_t off, size_t len){
+    unsigned char b[16];
+    aesni1xm128i_ctr_t c;
+    size_t i;
+#if R123_USE_AES_NI
+    c.v[0].m = _mm_set_epi64x((long long)_aesni_bswap64(lo), (long long)_aesni_bswap64(hi));
+    c = aesni1xm128i(c, *k);
+    if(len == 16){
+        _mm_storeu_si128((__m128i*)out, _mm_xor_si128(c.v[0].m, _mm_loadu_si128((const __m128i*)in)));
+        return;
+    }
+    _mm_storeu_si128((__m128i*)b, c.v[0].m);
+#else
+    c.v[0].m = vcombine_u64(vcreate_u64(_aesni_bswap64(hi)), vcreate_u64(_aesni_bswap64(lo)));
+    c = aesni1xm128i(c, *k);
+    if(len == 16){
+        vst1q_u8(out, veorq_u8(vreinterpretq_u8_u64(c.v[0].m), vld1q_u8(in)));
+        return;
+    }
+    vst1q_u8(b, vreinterpretq_u8_u64(c.v[0].m));
+#endif
+    for(i=0; i<len; ++i)
+        out[i] = in[i] ^ b[off+i];
+}
+
+#if R123_USE_AES_NI && R123_USE_SSE4_1
+/* Xor the keystream for the eight counters hi:lo+j, j in [0, 8), into
+   the 128 bytes at in, which need not be aligned, and write them to
+   out.  lo+7 must not carry into hi.  As in _ars_R_multikey8, the
+   blocks are written out in registers v0..v7 so that their aesencs
+   are in flight together. */
+#define _aesni_x8(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7)
+#define _aesni_ctr_decl(j) __m128i v##j;
+#define _aesni_ctr_first(j)                                             \
+    v##j = _mm_shuffle_epi8(_mm_add_epi64(c, _mm_set_epi64x(0, j)), bswap); \
+    v##j = _mm_xor_si128(v##j, rk);
+#define _aesni_ctr_enc(j) v##j = _mm_aesenc_si128(v##j, rk);
+#define _aesni_ctr_last(j)                                              \
+    v##j = _mm_aesenclast_si128(v##j, rk);                              \
+    _mm_storeu_si128((__m128i*)out + j, _mm_xor_si128(v##j, _mm_loadu_si128((const __m128i*)in + j)));
+R123_STATIC_INLINE void _aesni1xm128i_ctr_xor8(const aesni1xm128i_key_t* k, uint64_t hi, uint64_t lo, const void* in, void* out){
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i c = _mm_set_epi64x((long long)hi, (long long)lo);
+    __m128i rk = k->k[0];
+    _aesni_x8(_aesni_ctr_decl)
+    int r;
+    _aesni_x8(_aesni_ctr_first)
+    for(r=1; r<10; ++r){
+        rk = k->k[r];
+        _aesni_x8(_aesni_ctr_enc)
+    }
+    rk = k->k[10];
+    _aesni_x8(_aesni_ctr_last)
+}
+
+#if R123_USE_VAES && R123_USE_AVX2
+/* The same for sixteen counters, two to a 256-bit register, with the
+   VAES instructions.  lo+15 must not carry into hi. */
+#define _aesni_ctr_decl2(j) __m256i w##j;
+#define _aesni_ctr_first2(j)                                            \
+    w##j = _mm256_add_epi64(c, _mm256_set_epi64x(0, 2*j+1, 0, 2*j));   \
+    w##j = _mm256_xor_si256(_mm256_shuffle_epi8(w##j, bswap), rk);
+#define _aesni_ctr_enc2(j) w##j = _mm256_aesenc_epi128(w##j, rk);
+#define _aesni_ctr_last2(j)                                             \
+    w##j = _mm256_aesenclast_epi128(w##j, rk);                          \
+    _mm256_storeu_si256((__m256i*)out + j, _mm256_xor_si256(w##j, _mm256_loadu_si256((const __m256i*)in + j)));
+R123_STATIC_INLINE void _aesni1xm128i_ctr_xor16(const aesni1xm128i_key_t* k, uint64_t hi, uint64_t lo, const void* in, void* out){
+    const __m256i bswap = _mm256_broadcastsi128_si256(_mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    const __m256i c = _mm256_set_epi64x((long long)hi, (long long)lo, (long long)hi, (long long)lo);
+    __m256i rk = _mm256_broadcastsi128_si256(k->k[0]);
+    _aesni_x8(_aesni_ctr_decl2)
+    int r;
+    _aesni_x8(_aesni_ctr_first2)
+    for(r=1; r<10; ++r){
+        rk = _mm256_broadcastsi128_si256(k->k[r]);
+        _aesni_x8(_aesni_ctr_enc2)
+    }
+    rk = _mm256_broadcastsi128_si256(k->k[10]);
+    _aesni_x8(_aesni_ctr_last2)
+}
+#endif
+#endif
+/** \endcond */
+
+/** @ingroup AESNI
+    @fn void aesni1xm128i_ctr_xor(const aesni1xm128i_key_t* k, aesni1xm128i_ctr_t iv, const void* in, void* out, size_t n, R123_ULONG_LONG pos)
+    AES-128 in counter mode:  xors bytes [pos, pos+n) of the keystream
+    into the n bytes at in and writes them to out.  Block i of the
+    keystream is aesni1xm128i(iv+i, k), where iv+i treats the bytes of
+    iv as a 128-bit big-endian integer (mod 2^128), as in NIST SP
+    800-38A, so the output is that of any standard AES-128-CTR with the
+    same key and initial counter block.  Applying it twice restores the
+    data.
+
+    in and out need not be aligned, n need not be a multiple of 16, and
+    out may be the same as in (but must not otherwise overlap it).
+    Since every block depends only on its counter, threads may split
+    the work at any byte offsets:  the thread with bytes [a, b) calls
+    aesni1xm128i_ctr_xor(k, iv, in+a, out+a, b-a, a).
+
+    With AES-NI, eight blocks go through the rounds together so that
+    the latency of the AES instructions is hidden, or sixteen, two to a
+    256-bit register, when R123_USE_VAES and R123_USE_AVX2 are set.
+    With the ARMv8 AES instructions, the blocks are done one at a time.
+*/
+R123_STATIC_INLINE void aesni1xm128i_ctr_xor(const aesni1xm128i_key_t* k, aesni1xm128i_ctr_t iv, const void* in, void* out, size_t n, R123_ULONG_LONG pos){
+    const unsigned char* pin = (const unsigned char*)in;
+    unsigned char* pout = (unsigned char*)out;
+    uint64_t hi, lo, b = (uint64_t)(pos>>4);
+    size_t off = (size_t)(pos&15), len;
+    _aesni_ctr_split(iv, &hi, &lo);
+    lo += b;
+    hi += (lo < b);
+    while(n){
+#if R123_USE_AES_NI && R123_USE_SSE4_1
+#if R123_USE_VAES && R123_USE_AVX2
+        if(off==0 && n>=256 && lo <= ~(uint64_t)0 - 16){
+            _aesni1xm128i_ctr_xor16(k, hi, lo, pin, pout);
+            lo += 16; pin += 256; pout += 256; n -= 256;
+            continue;
+        }
+#endif
+        if(off==0 && n>=128 && lo <= ~(uint64_t)0 - 8){
+            _aesni1xm128i_ctr_xor8(k, hi, lo, pin, pout);
+            lo += 8; pin += 128; pout += 128; n -= 128;
+            continue;
+        }
+#endif
+        len = (n < 16-off) ? n : 16-off;
+        _aesni_ctr_xor1(k, hi, lo, pin, pout, off, len);
+        pin += len; pout += len; n -= len;
+        off = 0;
+        hi += (++lo == 0);
+    }
+}
+
 #ifdef __cplusplus
 namespace r123{
 /** 
@@ -238,6 +460,8 @@ of clock cycles vs. tens of clock cycles).
 AESNI1xm128i is only available when the feature-test macro R123_USE_AES_NI is true, which
 should occur only when the compiler is configured to generate AES-NI instructions (or
 when defaults are overridden by compile-time, compiler-command-line options).
+On ARM, it is available when R123_USE_ARM_AES is true, and uses the ARMv8 AES
+instructions to compute the same function.
 
 As of September 2011, the authors know of no statistical flaws with AESNI1xm128i.  It
 would be an event of major cryptographic note if any such flaws were ever found.
@@ -278,10 +502,19 @@ template <unsigned ROUNDS=10>
 struct AESNI4x32_R : public AESNI4x32{
     R123_STATIC_ASSERT(ROUNDS==10, "AESNI4x32_R<R> is only valid with R=10");
 };
+
+/** @ingroup AESNI
+    Xors bytes [pos, pos+n) of the AES-128 counter-mode keystream for
+    key and the initial counter block iv into in and writes them to
+    out, which may be the same as in.  See aesni1xm128i_ctr_xor for
+    the details. */
+inline void aes_ctr_xor(const AESNI1xm128i::key_type& key, AESNI1xm128i::ctr_type iv, const void* in, void* out, size_t n, R123_ULONG_LONG pos=0){
+    aesni1xm128i_ctr_xor(&key, iv, in, out, n, pos);
+}
 } // namespace r123
 #endif /* __cplusplus */
 
-#endif /* R123_USE_AES_NI */
+#endif /* R123_USE_AES_NI || R123_USE_ARM_AES */
 
 #if R123_USE_AES_OPENSSL
 #include <openssl/aes.h>
@@ -0,0 +1,459 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_alias_table_dot_hpp__
+#define __r123_alias_table_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#if R123_USE_AVX2 || R123_USE_AVX512
+#include "features/sse.h"
+#endif
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+/** \file alias_table.hpp
+
+    r123::alias_table draws from a categorical distribution over
+    0..n-1 with arbitrary non-negative weights, using one 32-bit
+    random word per draw, no division and at most two table lookups
+    (which share a cache line).
+
+    The weights are first quantized to integers a_i with sum
+    n*2^32, so that slot i of the table holds a_i (if a_i < 2^32)
+    or a share of a_i for the heavier categories.  A 32-bit word r is
+    mapped to a slot and a coin by a single 32x32->64 multiply:
+    the high half of r*n is the slot index and the low half is the
+    coin, which is compared to the slot's threshold.  Because all 2^32
+    values of r are equally likely, each category is drawn with
+    probability a_i/(n*2^32), up to an error of at most 2^-32 per slot.
+    Categories with zero weight are never drawn.
+
+    Construction follows the "sweep" formulation of Vose's algorithm
+    (Hubschle-Schneider and Sanders, "Parallel Weighted Random
+    Sampling", ESA 2019).  Because the quantized weights are
+    integers, the sweep can be split into any number of independent
+    parts, and the resulting table is bitwise identical for any
+    number of parts.  The alias_table::builder class exposes the
+    construction as a short sequence of stages, each of which is a
+    set of independent parts that the caller may run on as many
+    threads as it likes.
+
+    The bulk sampler, alias_table::fill, takes its words from
+    consecutive CBRNG blocks: out[i] is drawn from 32-bit word i%M of
+    b(c0 + i/M, k), where M is the number of 32-bit words in a
+    ctr_type and 64-bit values are split into their low half
+    followed by their high half.  With R123_USE_AVX2 or
+    R123_USE_AVX512, the table lookups are done with vector gathers,
+    8 or 16 draws at a time.
+*/
+
+namespace r123{
+
+class alias_table{
+public:
+    class builder;
+
+    /** An empty table. */
+    alias_table() : n(0){}
+
+    /** Build a table for weights w[0..nw) on the calling thread,
+        split into nparts parts (the result does not depend on
+        nparts).  Throws std::invalid_argument if nw is zero or
+        larger than 2^31-1, or if the weights are not finite,
+        non-negative and not all zero. */
+    alias_table(const double* w, size_t nw, unsigned nparts=1);
+
+    /** Take the table out of a builder whose stages have all run. */
+    explicit alias_table(builder& b);
+
+    size_t size() const { return n; }
+    /** The threshold of slot i.  The slot yields i when the coin is
+        below the threshold, and alias(i) otherwise.  Full slots have
+        threshold 2^32-1 and alias(i)==i. */
+    uint32_t threshold(size_t i) const { return tab[2*i]; }
+    uint32_t alias(size_t i) const { return tab[2*i+1]; }
+
+    /** The category selected by the 32-bit word r. */
+    uint32_t operator()(uint32_t r) const{
+        uint64_t x = (uint64_t)r*n;
+        uint32_t idx = (uint32_t)(x>>32);
+        return ((uint32_t)x < tab[2*idx]) ? idx : tab[2*idx+1];
+    }
+
+    /** out[i] = (*this)(r[i]) for i in [0, m). */
+    void sample(const uint32_t* r, uint32_t* out, size_t m) const{
+        size_t i = 0;
+#if R123_USE_AVX2 || R123_USE_AVX512
+        const uint32_t* t = &tab[0];
+#endif
+#if R123_USE_AVX512
+        __m512i vn16 = _mm512_set1_epi32((int)n);
+        for(; i+16<=m; i+=16){
+            __m512i rr = _mm512_loadu_si512((const void*)(r+i));
+            __m512i pe = _mm512_mul_epu32(rr, vn16);
+            __m512i po = _mm512_mul_epu32(_mm512_srli_epi64(rr, 32), vn16);
+            __m512i idx = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(pe, 32), po);
+            __m512i lo = _mm512_mask_blend_epi32(0xAAAA, pe, _mm512_slli_epi64(po, 32));
+            __m512i thr = _mm512_i32gather_epi32(idx, (const void*)t, 8);
+            __mmask16 reject = _mm512_cmpge_epu32_mask(lo, thr);
+            __m512i res = _mm512_mask_i32gather_epi32(idx, reject, idx, (const void*)(t+1), 8);
+            _mm512_storeu_si512((void*)(out+i), res);
+        }
+#endif
+#if R123_USE_AVX2
+        __m256i vn8 = _mm256_set1_epi32((int)n);
+        __m256i sign = _mm256_set1_epi32((int)0x80000000);
+        for(; i+8<=m; i+=8){
+            __m256i rr = _mm256_loadu_si256((const __m256i*)(r+i));
+            __m256i pe = _mm256_mul_epu32(rr, vn8);
+            __m256i po = _mm256_mul_epu32(_mm256_srli_epi64(rr, 32), vn8);
+            __m256i idx = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0xAA);
+            __m256i lo = _mm256_blend_epi32(pe, _mm256_slli_epi64(po, 32), 0xAA);
+            __m256i thr = _mm256_i32gather_epi32((const int*)t, idx, 8);
+            // unsigned lo >= thr  <==>  !(signed (thr^sign) > (lo^sign))
+            __m256i accept = _mm256_cmpgt_epi32(_mm256_xor_si256(thr, sign), _mm256_xor_si256(lo, sign));
+            __m256i reject = _mm256_andnot_si256(accept, _mm256_set1_epi32(-1));
+            __m256i res = _mm256_mask_i32gather_epi32(idx, (const int*)(t+1), idx, reject, 8);
+            _mm256_storeu_si256((__m256i*)(out+i), res);
+        }
+#endif
+        for(; i<m; ++i)
+            out[i] = (*this)(r[i]);
+    }
+
+    /** Fill out[0..m) with draws.  out[i] is drawn from 32-bit word
+        i%M of b(c0 + i/M, k), where M is the number of 32-bit words
+        in a CBRNG::ctr_type.  Splitting a fill at a multiple of M,
+        with c0 advanced by the number of blocks consumed, reproduces
+        the same output. */
+    template <typename CBRNG>
+    void fill(CBRNG b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, uint32_t* out, size_t m) const{
+        typedef typename CBRNG::ctr_type ctr_type;
+        typedef typename ctr_type::value_type value_type;
+        const size_t W = std::numeric_limits<value_type>::digits;
+        R123_STATIC_ASSERT(W%32 == 0, "alias_table::fill requires a CBRNG with 32- or 64-bit words");
+        const size_t M = c0.size()*(W/32);
+        uint32_t buf[256];
+        while(m){
+            size_t nw = 0;
+            while(nw+M <= sizeof(buf)/sizeof(*buf) && nw < m){
+                ctr_type r = b(c0, k);
+                c0.incr();
+                for(size_t e=0; e<r.size(); ++e)
+                    for(size_t h=0; h<W/32; ++h)
+                        buf[nw++] = (uint32_t)(r[e] >> (32*h));
+            }
+            if(nw > m)
+                nw = m;
+            sample(buf, out, nw);
+            out += nw;
+            m -= nw;
+        }
+    }
+
+private:
+    uint32_t n;
+    std::vector<uint32_t> tab; // interleaved (threshold, alias) pairs
+};
+
+/**
+    Staged, parallelizable construction of an alias_table.
+
+    The stages must be run in order.  Within a stage, run(stage, p)
+    must be called once for each part p in [0, parts()); those calls
+    are independent and may run concurrently on different threads.
+    finish(stage) must then be called once, by a single thread,
+    before any part of the next stage is run:
+
+\code
+    r123::alias_table::builder bld(w, n, nthreads);
+    for(int s=0; s<bld.nstages; ++s){
+        // e.g., #pragma omp parallel for
+        for(unsigned p=0; p<bld.parts(); ++p)
+            bld.run(s, p);
+        bld.finish(s);
+    }
+    r123::alias_table t(bld);
+\endcode
+
+    The weights must remain valid until the last stage has finished.
+    Errors in the weights are reported by throwing
+    std::invalid_argument from finish(0).  The resulting table is
+    the same for any number of parts.
+*/
+class alias_table::builder{
+public:
+    enum { nstages = 5 };
+
+    builder(const double* _w, size_t nw, unsigned nparts=1) : w(_w), P(nparts ? nparts : 1){
+        if(nw == 0 || nw > 0x7fffffff)
+            throw std::invalid_argument("alias_table: the number of weights must be in [1, 2^31-1]");
+        n = (uint32_t)nw;
+        nblocks = (n + blocksize - 1)/blocksize;
+        bsum.resize(nblocks);
+        bad.resize(P);
+        npos.resize(P);
+        suma.resize(P);
+        nl.resize(P+1);
+        nh.resize(P+1);
+        dsum.resize(P+1);
+        esum.resize(P+1);
+        spliti.resize(P+1);
+        splitj.resize(P+1);
+        a.resize(n);
+    }
+
+    unsigned parts() const { return P; }
+
+    void run(int stage, unsigned p){
+        size_t b0 = (size_t)p*nblocks/P;
+        size_t b1 = (size_t)(p+1)*nblocks/P;
+        size_t i0 = b0*blocksize;
+        size_t i1 = b1*blocksize < n ? b1*blocksize : n;
+        switch(stage){
+        case 0:
+            // Block sums, in a blocking that does not depend on P.
+            bad[p] = 0;
+            for(size_t bb=b0; bb<b1; ++bb){
+                double s = 0.;
+                size_t e = (bb+1)*blocksize < n ? (bb+1)*blocksize : n;
+                for(size_t i=bb*blocksize; i<e; ++i){
+                    if(!(w[i] >= 0. && w[i] <= DBL_MAX))
+                        bad[p] = 1;
+                    s += w[i];
+                }
+                bsum[bb] = s;
+            }
+            break;
+        case 1:
+            // Quantize, rounding down.
+            npos[p] = 0;
+            suma[p] = 0;
+            for(size_t i=i0; i<i1; ++i){
+                a[i] = (uint64_t)std::floor(w[i]/wsum*target);
+                suma[p] += a[i];
+                npos[p] += (w[i] > 0.);
+            }
+            break;
+        case 2:{
+            // Distribute the rounding deficit over the positive
+            // weights in index order, and classify.
+            uint64_t rank = npos[p];
+            nl[p] = nh[p] = dsum[p] = esum[p] = 0;
+            for(size_t i=i0; i<i1; ++i){
+                if(w[i] > 0.){
+                    a[i] += share + (rank < extra);
+                    ++rank;
+                }
+                if(a[i] < C){
+                    nl[p]++;
+                    dsum[p] += C - a[i];
+                }else{
+                    nh[p]++;
+                    esum[p] += a[i] - C;
+                }
+            }
+            break;
+        }
+        case 3:{
+            // Scatter the light and heavy indices with the prefix
+            // sums of their deficits and excesses.
+            size_t li = nl[p], hi = nh[p];
+            uint64_t d = dsum[p], e = esum[p];
+            for(size_t i=i0; i<i1; ++i){
+                if(a[i] < C){
+                    L[li] = (uint32_t)i;
+                    DL[li++] = d;
+                    d += C - a[i];
+                }else{
+                    H[hi++] = (uint32_t)i;
+                    e += a[i] - C;
+                    EH[hi] = e;
+                }
+            }
+            break;
+        }
+        case 4:
+            sweep(spliti[p], splitj[p], spliti[p+1]+splitj[p+1]);
+            break;
+        }
+    }
+
+    void finish(int stage){
+        switch(stage){
+        case 0:{
+            for(unsigned p=0; p<P; ++p)
+                if(bad[p])
+                    throw std::invalid_argument("alias_table: weights must be finite and non-negative");
+            wsum = 0.;
+            for(size_t bb=0; bb<nblocks; ++bb)
+                wsum += bsum[bb];
+            if(!(wsum > 0. && wsum <= DBL_MAX))
+                throw std::invalid_argument("alias_table: the sum of the weights must be positive and finite");
+            // Scale slightly below n*2^32 so that the rounding errors
+            // in wsum and w[i]/wsum cannot push the total over n*2^32.
+            double t = std::ldexp((double)n, 32);
+            target = t - t*((n+8.)*std::ldexp(1., -52));
+            break;
+        }
+        case 1:{
+            uint64_t total = 0, pos = 0;
+            for(unsigned p=0; p<P; ++p){
+                total += suma[p];
+                uint64_t np = npos[p];
+                npos[p] = pos;  // now the rank of the part's first positive weight
+                pos += np;
+            }
+            uint64_t r = ((uint64_t)n<<32) - total;
+            share = r/pos;
+            extra = r%pos;
+            break;
+        }
+        case 2:{
+            // exclusive prefix sums, with the totals in [P]
+            uint64_t l = 0, h = 0, d = 0, e = 0;
+            for(unsigned p=0; p<=P; ++p){
+                uint64_t t;
+                t = nl[p]; nl[p] = l; l += t;
+                t = nh[p]; nh[p] = h; h += t;
+                t = dsum[p]; dsum[p] = d; d += t;
+                t = esum[p]; esum[p] = e; e += t;
+            }
+            R123_ASSERT(d == e);
+            L.resize(l);
+            DL.resize(l+1);
+            DL[l] = d;
+            H.resize(h);
+            EH.resize(h+1);
+            EH[0] = 0;
+            tab.resize(2*(size_t)n);
+            break;
+        }
+        case 3:
+            // Split the merged sequence of light and heavy events
+            // evenly among the parts.
+            for(unsigned p=0; p<=P; ++p){
+                size_t k = (size_t)p*n/P;
+                size_t lo = k > H.size() ? k - H.size() : 0;
+                size_t hi = k < L.size() ? k : L.size();
+                while(lo < hi){
+                    size_t mid = (lo+hi)/2;
+                    if(light_first(mid, k-mid-1))
+                        lo = mid+1;
+                    else
+                        hi = mid;
+                }
+                spliti[p] = lo;
+                splitj[p] = k - lo;
+            }
+            break;
+        case 4:
+            a.clear();
+            L.clear();
+            H.clear();
+            DL.clear();
+            EH.clear();
+            break;
+        }
+    }
+
+private:
+    friend class alias_table;
+    enum { blocksize = 4096 };
+    static const uint64_t C = R123_64BIT(1)<<32;
+
+    const double* w;
+    uint32_t n;
+    unsigned P;
+    size_t nblocks;
+    double wsum, target;
+    uint64_t share, extra;
+    std::vector<double> bsum;
+    std::vector<char> bad;
+    std::vector<uint64_t> npos, suma, nl, nh, dsum, esum;
+    std::vector<size_t> spliti, splitj;
+    std::vector<uint64_t> a;
+    std::vector<uint32_t> L, H;   // light and heavy indices, in index order
+    std::vector<uint64_t> DL, EH; // deficits of L before i, excesses of H up to and including j-1
+    std::vector<uint32_t> tab;
+
+    // Is light i placed before heavy j finishes?  Heavy j is being
+    // filled while its residual C + EH[j+1] - DL[i] exceeds C.
+    bool light_first(size_t i, size_t j) const{
+        return DL[i] < EH[j+1];
+    }
+
+    // Process the events k = i+j .. kend-1 of the sweep, starting
+    // with i lights placed and j heavies finished.
+    void sweep(size_t i, size_t j, size_t kend){
+        for(size_t k=i+j; k<kend; ++k){
+            if(i < L.size() && (j == H.size() || light_first(i, j))){
+                uint32_t l = L[i++];
+                tab[2*(size_t)l] = (uint32_t)a[l];
+                tab[2*(size_t)l+1] = H[j];
+            }else{
+                uint32_t h = H[j];
+                uint64_t resid = C + EH[j+1] - DL[i];
+                ++j;
+                if(resid >= C || j == H.size()){
+                    R123_ASSERT(resid == C);
+                    tab[2*(size_t)h] = 0xffffffff;
+                    tab[2*(size_t)h+1] = h;
+                }else{
+                    tab[2*(size_t)h] = (uint32_t)resid;
+                    tab[2*(size_t)h+1] = H[j];
+                }
+            }
+        }
+    }
+};
+
+inline alias_table::alias_table(builder& b) : n(b.n){
+    tab.swap(b.tab);
+}
+
+inline alias_table::alias_table(const double* w, size_t nw, unsigned nparts) : n(0){
+    builder b(w, nw, nparts);
+    for(int s=0; s<builder::nstages; ++s){
+        for(unsigned p=0; p<b.parts(); ++p)
+            b.run(s, p);
+        b.finish(s);
+    }
+    n = b.n;
+    tab.swap(b.tab);
+}
+
+} // namespace r123
+#endif
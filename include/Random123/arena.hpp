@@ -0,0 +1,232 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_arena_dot_hpp__
+#define __r123_arena_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif
+
+/** \file arena.hpp
+
+    r123::arena is a block of memory, mapped once, from which arrays
+    are carved out 64 bytes apart: whole cache lines, and aligned for
+    the vector loads and stores of the multi-lane generators (whose
+    bulk fills stream only into aligned buffers).  It is backed by
+    2 MiB pages where the system provides them, so that arrays of
+    millions of generators (e.g., MicroURNGs, one per particle) or
+    large output buffers, accessed in any order, need few TLB entries.
+    On Linux, an arena is first tried with MAP_HUGETLB (which needs
+    pages reserved in /proc/sys/vm/nr_hugepages), and otherwise is
+    mapped on a 2 MiB boundary with madvise(MADV_HUGEPAGE) (transparent
+    huge pages);  elsewhere it is mmap'ed, or on Windows, obtained from
+    _aligned_malloc.  r123::arena::backing() says which.
+
+    r123::arena_allocator<T> is a standard allocator that allocates
+    from an arena, for std::vector and the like:
+
+    @code
+    typedef r123::MicroURNG<r123::Philox4x32> U;
+    r123::arena a(n*sizeof(U));
+    std::vector<U, r123::arena_allocator<U> > urngs((r123::arena_allocator<U>(a)));
+    urngs.reserve(n);
+    @endcode
+
+    Memory goes back to the arena only when the arena is reset or
+    destroyed, or when it was the most recent allocation, so a vector
+    should be reserved at its final size rather than grown.  When the
+    arena is exhausted, std::bad_alloc is thrown.  An arena is not
+    thread-safe, and must outlive the containers that use it.
+*/
+
+namespace r123{
+
+class arena{
+public:
+    static const size_t alignment = 64;
+    static const size_t huge_page = (size_t)2 << 20;
+
+    /** An arena of at least bytes bytes, rounded up to a multiple of
+        2 MiB.  Throws std::bad_alloc if the memory cannot be had. */
+    explicit arena(size_t bytes) : base(0), raw(0), cap(0), top(0), how("none"){
+        map(bytes);
+    }
+    ~arena(){ unmap(); }
+
+    /** bytes bytes, at a multiple of 64 bytes. */
+    void* allocate(size_t bytes){
+        size_t n = round(bytes);
+        if(n < bytes || n > cap - top)
+            throw std::bad_alloc();
+        void* p = base + top;
+        top += n;
+        return p;
+    }
+    /** Gives back p, of bytes bytes, if it was the most recent
+        allocation;  otherwise does nothing. */
+    void deallocate(void* p, size_t bytes){
+        if(static_cast<char*>(p) + round(bytes) == base + top)
+            top -= round(bytes);
+    }
+    /** Gives back everything that has been allocated. */
+    void reset(){ top = 0; }
+
+    size_t capacity() const{ return cap; }
+    size_t used() const{ return top; }
+    /** "MAP_HUGETLB", "MADV_HUGEPAGE", "mmap", "_aligned_malloc" or
+        "malloc". */
+    const char* backing() const{ return how; }
+
+private:
+    char* base;
+    void* raw;
+    size_t cap;
+    size_t top;
+    const char* how;
+
+    arena(const arena&);
+    arena& operator=(const arena&);
+
+    static size_t round(size_t bytes){
+        return bytes ? (bytes + (alignment-1)) & ~(alignment-1) : alignment;
+    }
+
+    void map(size_t bytes){
+        cap = (bytes + (huge_page-1)) & ~(huge_page-1);
+        if(cap < bytes)
+            throw std::bad_alloc();
+        if(cap == 0)
+            cap = huge_page;
+#if defined(__unix__) || defined(__APPLE__)
+#ifdef MAP_HUGETLB
+        raw = mmap(0, cap, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_HUGETLB, -1, 0);
+        if(raw != MAP_FAILED){
+            base = static_cast<char*>(raw);
+            how = "MAP_HUGETLB";
+            return;
+        }
+#endif
+        // Map an extra huge page, and unmap the ends that lie outside
+        // the aligned part.
+        raw = mmap(0, cap + huge_page, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+        if(raw == MAP_FAILED){
+            raw = 0;
+            throw std::bad_alloc();
+        }
+        char* q = static_cast<char*>(raw);
+        size_t head = (huge_page - (uintptr_t)q % huge_page) % huge_page;
+        if(head)
+            munmap(q, head);
+        munmap(q + head + cap, huge_page - head);
+        base = q + head;
+        raw = base;
+        how = "mmap";
+#ifdef MADV_HUGEPAGE
+        if(madvise(base, cap, MADV_HUGEPAGE) == 0)
+            how = "MADV_HUGEPAGE";
+#endif
+#elif defined(_WIN32)
+        raw = _aligned_malloc(cap, huge_page);
+        if(!raw)
+            throw std::bad_alloc();
+        base = static_cast<char*>(raw);
+        how = "_aligned_malloc";
+#else
+        raw = std::malloc(cap + alignment);
+        if(!raw)
+            throw std::bad_alloc();
+        base = static_cast<char*>(raw) + (alignment - (uintptr_t)raw % alignment) % alignment;
+        how = "malloc";
+#endif
+    }
+
+    void unmap(){
+        if(!raw)
+            return;
+#if defined(__unix__) || defined(__APPLE__)
+        munmap(raw, cap);
+#elif defined(_WIN32)
+        _aligned_free(raw);
+#else
+        std::free(raw);
+#endif
+    }
+};
+
+/** A standard allocator of T's from an r123::arena.  See arena.hpp. */
+template <typename T>
+class arena_allocator{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template <typename U> struct rebind{ typedef arena_allocator<U> other; };
+
+    explicit arena_allocator(arena& _a) : a(&_a){}
+    template <typename U> arena_allocator(const arena_allocator<U>& o) : a(o.get_arena()){}
+
+    arena* get_arena() const{ return a; }
+
+    pointer address(reference x) const{ return &x; }
+    const_pointer address(const_reference x) const{ return &x; }
+    pointer allocate(size_type n, const void* = 0){
+        if(n > max_size())
+            throw std::bad_alloc();
+        return static_cast<pointer>(a->allocate(n*sizeof(T)));
+    }
+    void deallocate(pointer p, size_type n){ a->deallocate(p, n*sizeof(T)); }
+    size_type max_size() const{ return ((size_t)-1)/sizeof(T); }
+    void construct(pointer p, const T& v){ new(static_cast<void*>(p)) T(v); }
+    void destroy(pointer p){ p->~T(); }
+
+private:
+    arena* a;
+};
+
+template <typename T, typename U>
+bool operator==(const arena_allocator<T>& x, const arena_allocator<U>& y){ return x.get_arena() == y.get_arena(); }
+template <typename T, typename U>
+bool operator!=(const arena_allocator<T>& x, const arena_allocator<U>& y){ return x.get_arena() != y.get_arena(); }
+
+} // namespace r123
+
+#endif
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define _r123array_dot_h__
 #include "features/compilerfeatures.h"
 #include "features/sse.h"
+#include "features/neon.h"
 
 #ifndef __cplusplus
 #define CXXMETHODS(_N, W, T)
@@ -60,7 +61,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     If SSE is supported by the compiler, then the r123array1xm128i is
     class is also defined, in which the data member is an array of
-    one r123128i object.
+    one r123128i object.  With ARM NEON, the r123m128i holds a
+    uint64x2_t rather than an __m128i.  Likewise, with AVX2 and
+    AVX-512, r123array1xm256i and r123array1xm512i hold one r123m256i
+    or r123m512i, a 256- or 512-bit integer in an __m256i or __m512i.
 
     @cond HIDDEN_FROM_DOXYGEN
 */
@@ -303,13 +307,23 @@ _r123array_tpl(8, 32, uint32_t)  /* r123array8x32 */
 _r123array_tpl(1, 64, uint64_t)  /* r123array1x64 */
 _r123array_tpl(2, 64, uint64_t)  /* r123array2x64 */
 _r123array_tpl(4, 64, uint64_t)  /* r123array4x64 */
+_r123array_tpl(8, 64, uint64_t)  /* r123array8x64 for Threefry8x64 */
+_r123array_tpl(16, 64, uint64_t)  /* r123array16x64 for Threefry16x64 */
 
 _r123array_tpl(16, 8, uint8_t)  /* r123array16x8 for ARSsw, AESsw */
 
-#if R123_USE_SSE
+#if R123_USE_SSE || R123_USE_NEON
 _r123array_tpl(1, m128i, r123m128i) /* r123array1x128i for ARSni, AESni */
 #endif
 
+#if R123_USE_AVX2
+_r123array_tpl(1, m256i, r123m256i) /* r123array1xm256i */
+#endif
+
+#if R123_USE_AVX512
+_r123array_tpl(1, m512i, r123m512i) /* r123array1xm512i */
+#endif
+
 /* In C++, it's natural to use sizeof(a::value_type), but in C it's
    pretty convoluted to figure out the width of the value_type of an
    r123arrayNxW:
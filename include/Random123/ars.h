@@ -35,7 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "features/compilerfeatures.h"
 #include "array.h"
 
-#if R123_USE_AES_NI
+#if R123_USE_AES_NI || R123_USE_ARM_AES
 
 #ifndef ARS1xm128i_DEFAULT_ROUNDS
 #define ARS1xm128i_DEFAULT_ROUNDS 7
@@ -50,6 +50,7 @@ typedef struct r123array1xm128i ars1xm128i_key_t;
 typedef struct r123array1xm128i ars1xm128i_ukey_t;
 R123_STATIC_INLINE ars1xm128i_key_t ars1xm128ikeyinit(ars1xm128i_ukey_t uk) { return uk; }
 R123_STATIC_INLINE ars1xm128i_ctr_t ars1xm128i_R(unsigned int Nrounds, ars1xm128i_ctr_t in, ars1xm128i_key_t k){
+#if R123_USE_AES_NI
     __m128i kweyl = _mm_set_epi64x(R123_64BIT(0xBB67AE8584CAA73B), /* sqrt(3) - 1.0 */
                                    R123_64BIT(0x9E3779B97F4A7C15)); /* golden ratio */
     /* N.B.  the aesenc instructions do the xor *after*
@@ -99,6 +100,26 @@ R123_STATIC_INLINE ars1xm128i_ctr_t ars1xm128i_R(unsigned int Nrounds, ars1xm128
     v = _mm_aesenclast_si128(v, kk);
     ret.v[0].m = v;
     return ret;
+#else /* R123_USE_ARM_AES */
+    uint64x2_t kweyl = _r123_neon_set_u64(R123_64BIT(0xBB67AE8584CAA73B), /* sqrt(3) - 1.0 */
+                                          R123_64BIT(0x9E3779B97F4A7C15)); /* golden ratio */
+    /* vaeseq_u8 does the xor *before* ShiftRows and SubBytes, and
+       vaesmcq_u8 does MixColumns separately, so each aesenc above is
+       AESMC(AESE(v, previous key)), and the last key is xored at the end. */
+    uint64x2_t kk = k.v[0].m;
+    uint8x16_t v = vreinterpretq_u8_u64(in.v[0].m);
+    unsigned int r;
+    ars1xm128i_ctr_t ret;
+    R123_ASSERT(Nrounds<=10);
+    for(r=1; r<Nrounds; ++r){
+        v = vaesmcq_u8(vaeseq_u8(v, vreinterpretq_u8_u64(kk)));
+        kk = vaddq_u64(kk, kweyl);
+    }
+    v = vaeseq_u8(v, vreinterpretq_u8_u64(kk));
+    kk = vaddq_u64(kk, kweyl);
+    ret.v[0].m = vreinterpretq_u64_u8(veorq_u8(v, vreinterpretq_u8_u64(kk)));
+    return ret;
+#endif
 }
 
 /** @def ars1xm128i
@@ -120,10 +141,17 @@ R123_STATIC_INLINE ars4x32_key_t ars4x32keyinit(ars4x32_ukey_t uk) { return uk;
 R123_STATIC_INLINE ars4x32_ctr_t ars4x32_R(unsigned int Nrounds, ars4x32_ctr_t c, ars4x32_key_t k){
     ars1xm128i_ctr_t c128;
     ars1xm128i_key_t k128;
+#if R123_USE_AES_NI
     c128.v[0].m = _mm_set_epi32(c.v[3], c.v[2], c.v[1], c.v[0]);
     k128.v[0].m = _mm_set_epi32(k.v[3], k.v[2], k.v[1], k.v[0]);
     c128 = ars1xm128i_R(Nrounds, c128, k128);
     _mm_storeu_si128((__m128i*)&c.v[0], c128.v[0].m);
+#else
+    c128.v[0].m = vreinterpretq_u64_u32(vld1q_u32(c.v));
+    k128.v[0].m = vreinterpretq_u64_u32(vld1q_u32(k.v));
+    c128 = ars1xm128i_R(Nrounds, c128, k128);
+    vst1q_u32(c.v, vreinterpretq_u32_u64(c128.v[0].m));
+#endif
     return c;
 }
 
@@ -132,6 +160,70 @@ R123_STATIC_INLINE ars4x32_ctr_t ars4x32_R(unsigned int Nrounds, ars4x32_ctr_t c
 The ars4x32 macro provides a C API interface to the @ref AESNI "ARS" CBRNG with the default number of rounds i.e. \c ars4x32_rounds **/
 #define ars4x32(c,k) ars4x32_R(ars4x32_rounds, c, k)
 
+#if R123_USE_AES_NI
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* ars1xm128i_R on the eight 16-byte blocks at in, each with the key
+   at the same place in keys, round by round, so that the aesencs of
+   the eight are in flight together.  The blocks need not be aligned.
+   The eight are written out, in registers v0..v7 and k0..k7, rather
+   than left to the compiler to unroll. */
+#define _ars_x8(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7)
+#define _ars_decl(j) __m128i v##j, k##j;
+#define _ars_first(j)                                                   \
+    k##j = _mm_loadu_si128((const __m128i*)keys + j);                   \
+    v##j = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in + j), k##j);
+#define _ars_enc(j)                                                     \
+    k##j = _mm_add_epi64(k##j, kweyl);                                  \
+    v##j = _mm_aesenc_si128(v##j, k##j);
+#define _ars_last(j)                                                    \
+    k##j = _mm_add_epi64(k##j, kweyl);                                  \
+    _mm_storeu_si128((__m128i*)out + j, _mm_aesenclast_si128(v##j, k##j));
+R123_STATIC_INLINE void _ars_R_multikey8(unsigned int Nrounds, const void* in, const void* keys, void* out){
+    __m128i kweyl = _mm_set_epi64x(R123_64BIT(0xBB67AE8584CAA73B), /* sqrt(3) - 1.0 */
+                                   R123_64BIT(0x9E3779B97F4A7C15)); /* golden ratio */
+    _ars_x8(_ars_decl)
+    unsigned int r;
+    R123_ASSERT(Nrounds<=10);
+    _ars_x8(_ars_first)
+    for(r=1; r<Nrounds; ++r){
+        _ars_x8(_ars_enc)
+    }
+    _ars_x8(_ars_last)
+}
+/** \endcond */
+#endif
+
+/** @ingroup AESNI
+    @fn void ars1xm128i_R_multikey(unsigned int R, const ars1xm128i_ctr_t* in, const ars1xm128i_key_t* keys, ars1xm128i_ctr_t* out, size_t n)
+    Sets out[i] = ars1xm128i_R(R, in[i], keys[i]) for i in [0, n),
+    with a different key for each counter.  With AES-NI, eight
+    blocks, each with its own sequence of Weyl keys, go through the
+    rounds together, so that the latency of the AES instructions is
+    hidden.  ars4x32_R_multikey does the same for ars4x32.  With the
+    ARMv8 AES instructions, the blocks are done one at a time. */
+R123_STATIC_INLINE void ars1xm128i_R_multikey(unsigned int Nrounds, const ars1xm128i_ctr_t* in, const ars1xm128i_key_t* keys, ars1xm128i_ctr_t* out, size_t n){
+    size_t i = 0;
+#if R123_USE_AES_NI
+    for(; i+8<=n; i+=8)
+        _ars_R_multikey8(Nrounds, in+i, keys+i, out+i);
+#endif
+    for(; i<n; ++i)
+        out[i] = ars1xm128i_R(Nrounds, in[i], keys[i]);
+}
+#define ars1xm128i_multikey(in, keys, out, n) ars1xm128i_R_multikey(ars1xm128i_rounds, in, keys, out, n)
+
+/** @ingroup AESNI */
+R123_STATIC_INLINE void ars4x32_R_multikey(unsigned int Nrounds, const ars4x32_ctr_t* in, const ars4x32_key_t* keys, ars4x32_ctr_t* out, size_t n){
+    size_t i = 0;
+#if R123_USE_AES_NI
+    for(; i+8<=n; i+=8)
+        _ars_R_multikey8(Nrounds, in+i, keys+i, out+i);
+#endif
+    for(; i<n; ++i)
+        out[i] = ars4x32_R(Nrounds, in[i], keys[i]);
+}
+#define ars4x32_multikey(in, keys, out, n) ars4x32_R_multikey(ars4x32_rounds, in, keys, out, n)
+
 #ifdef __cplusplus
 namespace r123{
 /** 
@@ -145,6 +237,8 @@ to save time and space.
 ARS1xm128i is only available when the feature-test macro R123_USE_AES_NI is true, which
 should occur only when the compiler is configured to generate AES-NI instructions (or
 when defaults are overridden by compile-time, compiler-command-line options).
+It is also available on ARM when R123_USE_ARM_AES is true, where it uses the ARMv8
+AES instructions and produces the same results.
 
 The template argument, ROUNDS, is the number of times the ARS round
 functions will be applied.
@@ -194,6 +288,6 @@ typedef ARS4x32_R<ars4x32_rounds> ARS4x32;
 
 #endif /* __cplusplus */
 
-#endif /* R123_USE_AES_NI */
+#endif /* R123_USE_AES_NI || R123_USE_ARM_AES */
 
 #endif
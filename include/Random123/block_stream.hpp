@@ -0,0 +1,164 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_block_stream_dot_hpp__
+#define __r123_block_stream_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "u01.h"
+#include <stdexcept>
+#include <limits>
+#include <cstddef>
+
+namespace r123{
+/**
+    block_stream<CBRNG>(b, c0, k) is a short, deterministic stream of
+    words taken from the blocks b(c_n, k) for n = 0, 1, 2, ..., where
+    c_n is c0 with n jammed into the high 32 bits of its highest word.
+
+    It is the counter layout used by MicroURNG: the blocks are
+    identical, but block_stream hands out the words of each block
+    in increasing index order (MicroURNG hands them out last-to-first),
+    it holds a key_type rather than a ukey_type so that expensive key
+    schedules (e.g. AESNI) are computed once by the caller, and it
+    can skip whole blocks without generating them.
+
+    The samplers in discrete.hpp consume randomness exclusively through a block_stream, one stream
+    per output element, so the words that produce element i are a
+    documented function of (b, k, c0+i) alone.  Results therefore do
+    not depend on the platform, the batch size or the number of
+    threads that share the work.
+
+    As with MicroURNG, the high 32 bits of the highest word of c0
+    must be zero; the constructor throws std::runtime_error if they
+    are not.
+*/
+template<typename CBRNG>
+class block_stream{
+public:
+    typedef CBRNG cbrng_type;
+    static const int BITS = 32;
+    typedef typename cbrng_type::ctr_type ctr_type;
+    typedef typename cbrng_type::key_type key_type;
+    typedef typename ctr_type::value_type result_type;
+
+    R123_STATIC_ASSERT( std::numeric_limits<result_type>::digits >= BITS, "The result_type must have at least 32 bits" );
+
+    block_stream(const cbrng_type& _b, const ctr_type& _c0, const key_type& _k) : b(_b), c0(_c0), k(_k), n(0), elem(_c0.size()) {
+        chkhighbits();
+    }
+
+    /** The next word of the stream. */
+    result_type operator()(){
+        if(elem == rdata.size()){
+            rdata = block(n++);
+            elem = 0;
+        }
+        return rdata[elem++];
+    }
+
+    /** A double in the open interval (0,1) with 53 bits of
+        resolution, made from the next 64 bits of the stream: one
+        64-bit word, or two consecutive 32-bit words with the first
+        in the high half.  See u01_open_open_64_53. */
+    double u01(){
+        uint64_t x = (*this)();
+        if(std::numeric_limits<result_type>::digits < 64)
+            x = (x<<32) | (*this)();
+        return u01_open_open_64_53(x);
+    }
+
+    /** The n'th block of the stream, b(c_n, k).  Does not change the
+        position of the stream. */
+    ctr_type block(R123_ULONG_LONG nb){
+        const size_t W = std::numeric_limits<result_type>::digits;
+        ctr_type c = c0;
+        c[c0.size()-1] |= ((result_type)nb)<<(W-BITS);
+        return b(c, k);
+    }
+
+    /** Discard the rest of the current block (if any) and the next
+        nskip blocks without generating them. */
+    void skip_blocks(R123_ULONG_LONG nskip){
+        n += nskip;
+        elem = rdata.size();
+    }
+
+    const ctr_type& counter() const{ return c0; }
+    const key_type& key() const{ return k; }
+
+private:
+    cbrng_type b;
+    ctr_type c0;
+    key_type k;
+    R123_ULONG_LONG n;
+    size_t elem;
+    ctr_type rdata;
+
+    void chkhighbits(){
+        result_type r = c0[c0.size()-1];
+        result_type mask = ((uint64_t)std::numeric_limits<result_type>::max R123_NO_MACRO_SUBST ())>>BITS;
+        if((r&mask) != r)
+            throw std::runtime_error("block_stream: c0, does not have high bits clear");
+    }
+};
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+// The words of a ctr_type, as 32-bit words (64-bit words split low
+// half first) or as 64-bit words (32-bit words paired, first word high).
+template <typename CTR>
+size_t _words32(const CTR& r, uint32_t* out){
+    typedef typename CTR::value_type value_type;
+    const size_t W = std::numeric_limits<value_type>::digits;
+    size_t n = 0;
+    for(size_t e=0; e<r.size(); ++e)
+        for(size_t h=0; h<W/32; ++h)
+            out[n++] = (uint32_t)(r[e] >> (32*h));
+    return n;
+}
+
+template <typename CTR>
+size_t _words64(const CTR& r, uint64_t* out){
+    typedef typename CTR::value_type value_type;
+    const size_t W = std::numeric_limits<value_type>::digits;
+    size_t n = 0;
+    if(W >= 64){
+        for(size_t e=0; e<r.size(); ++e)
+            out[n++] = (uint64_t)r[e];
+    }else{
+        for(size_t e=0; e+1<r.size(); e+=2)
+            out[n++] = ((uint64_t)r[e]<<32) | (uint64_t)r[e+1];
+    }
+    return n;
+}
+/** \endcond */
+} // namespace r123
+#endif
@@ -0,0 +1,355 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_checkpoint_dot_hpp__
+#define __r123_checkpoint_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "MicroURNG.hpp"
+#include "conventional/Engine.hpp"
+#include <stdexcept>
+#include <istream>
+#include <ostream>
+#include <limits>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+/** \file checkpoint.hpp
+
+    Binary checkpoints of arrays of counters and keys (any
+    r123arrayNxW with an unsigned integral value_type), Engines and
+    MicroURNGs, for saving and restoring the state of millions of
+    generators far faster than through operator<< and operator>>.
+
+    A checkpoint is a 64-byte header followed by one fixed-size record
+    per object, all little-endian regardless of the host:
+
+    <table>
+    <tr><th>offset<th>bytes<th>contents
+    <tr><td>0<td>8<td>"R123CKPT"
+    <tr><td>8<td>4<td>format version, 1
+    <tr><td>12<td>4<td>kind:  1 for arrays, 2 for Engines, 3 for MicroURNGs
+    <tr><td>16<td>4<td>bits in a counter word (or array word)
+    <tr><td>20<td>4<td>words in a counter (or array)
+    <tr><td>24<td>4<td>bits in a key word (0 for arrays)
+    <tr><td>28<td>4<td>words in a key (0 for arrays)
+    <tr><td>32<td>4<td>bytes in a record
+    <tr><td>36<td>4<td>0
+    <tr><td>40<td>8<td>number of records
+    <tr><td>48<td>16<td>0
+    </table>
+
+    An array's record is its words, in order.  An Engine's record is
+    its counter, its ukey (from getseed()) and the 64-bit elem of
+    getcounter();  a MicroURNG's is its counter, its key and its
+    64-bit position().  Restoring an Engine or a MicroURNG part way
+    through a block costs one call of the CBRNG.  A checkpoint does
+    not say which CBRNG, or how many rounds, made it;  the header
+    checks only the shapes of the counters and keys.
+
+    checkpoint_bytes<T>(n) is the size of a checkpoint of n Ts.
+    checkpoint_save writes one to memory or to a std::ostream, and
+    checkpoint_load reads one back, into an array or a std::vector.
+    Since the records start 64 bytes into the checkpoint, a file of
+    arrays that is mapped into memory (e.g., with mmap) can be used in
+    place on a little-endian host:  checkpoint_view<T>(p, bytes, &n)
+    checks the header and returns a pointer to the n Ts.
+
+    std::runtime_error is thrown if a checkpoint is truncated, is not
+    a checkpoint, or does not hold Ts;  and by checkpoint_view on a
+    big-endian host.
+
+    @code
+    std::vector<r123::Engine<r123::Philox4x32> > engines(n);
+    ...
+    std::ofstream out("engines.ckpt", std::ios::binary);
+    r123::checkpoint_save(out, &engines[0], engines.size());
+    ...
+    std::ifstream in("engines.ckpt", std::ios::binary);
+    r123::checkpoint_load(in, engines);
+    @endcode
+*/
+
+namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+template <typename V>
+void _ckpt_put(unsigned char*& p, V x){
+    for(size_t i=0; i<sizeof(V); ++i)
+        *p++ = (unsigned char)(x >> (8*i));
+}
+
+template <typename V>
+V _ckpt_get(const unsigned char*& p){
+    V x = 0;
+    for(size_t i=0; i<sizeof(V); ++i)
+        x |= V(*p++) << (8*i);
+    return x;
+}
+
+template <typename A>
+void _ckpt_put_words(unsigned char*& p, const A& a){
+    for(size_t i=0; i<a.size(); ++i)
+        _ckpt_put(p, a[i]);
+}
+
+template <typename A>
+void _ckpt_get_words(const unsigned char*& p, A& a){
+    for(size_t i=0; i<a.size(); ++i)
+        a[i] = _ckpt_get<typename A::value_type>(p);
+}
+
+// The layout of T's records, and how to write them and make Ts from
+// them.  The primary template is for r123arrayNxW.
+template <typename T>
+struct _ckpt_traits{
+    typedef typename T::value_type word;
+    R123_STATIC_ASSERT(std::numeric_limits<word>::is_integer && !std::numeric_limits<word>::is_signed,
+                       "checkpoints need arrays of unsigned integers\n");
+    enum { kind = 1,
+           ctr_bits = 8*sizeof(word), ctr_words = sizeof(T)/sizeof(word),
+           key_bits = 0, key_words = 0,
+           record = sizeof(T) };
+    static void put(unsigned char* p, const T& a){ _ckpt_put_words(p, a); }
+    static T make(const unsigned char* p){
+        T a;
+        _ckpt_get_words(p, a);
+        return a;
+    }
+};
+
+template <typename CBRNG>
+struct _ckpt_traits<Engine<CBRNG> >{
+    typedef Engine<CBRNG> T;
+    typedef typename T::ctr_type ctr_type;
+    typedef typename T::ukey_type ukey_type;
+    enum { kind = 2,
+           ctr_bits = _ckpt_traits<ctr_type>::ctr_bits, ctr_words = _ckpt_traits<ctr_type>::ctr_words,
+           key_bits = _ckpt_traits<ukey_type>::ctr_bits, key_words = _ckpt_traits<ukey_type>::ctr_words,
+           record = sizeof(ctr_type) + sizeof(ukey_type) + 8 };
+    static void put(unsigned char* p, const T& e){
+        _ckpt_put_words(p, e.getcounter().first);
+        _ckpt_put_words(p, e.getseed());
+        _ckpt_put(p, (uint64_t)e.getcounter().second);
+    }
+    static T make(const unsigned char* p){
+        ctr_type c;
+        ukey_type uk;
+        _ckpt_get_words(p, c);
+        _ckpt_get_words(p, uk);
+        uint64_t elem = _ckpt_get<uint64_t>(p);
+        if(elem > c.size())
+            throw std::runtime_error("checkpoint_load: an Engine's elem is out of range");
+        T e(uk);
+        e.setcounter(c, (typename T::elem_type)elem);
+        return e;
+    }
+};
+
+template <typename CBRNG>
+struct _ckpt_traits<MicroURNG<CBRNG> >{
+    typedef MicroURNG<CBRNG> T;
+    typedef typename T::ctr_type ctr_type;
+    typedef typename T::key_type key_type;
+    enum { kind = 3,
+           ctr_bits = _ckpt_traits<ctr_type>::ctr_bits, ctr_words = _ckpt_traits<ctr_type>::ctr_words,
+           key_bits = _ckpt_traits<key_type>::ctr_bits, key_words = _ckpt_traits<key_type>::ctr_words,
+           record = sizeof(ctr_type) + sizeof(key_type) + 8 };
+    static void put(unsigned char* p, const T& u){
+        _ckpt_put_words(p, u.counter());
+        _ckpt_put_words(p, u.key());
+        _ckpt_put(p, (uint64_t)u.position());
+    }
+    static T make(const unsigned char* p){
+        ctr_type c;
+        key_type k;
+        _ckpt_get_words(p, c);
+        _ckpt_get_words(p, k);
+        uint64_t pos = _ckpt_get<uint64_t>(p);
+        // The block number must fit in the BITS high bits of the counter.
+        if(pos > ((uint64_t)c.size() << T::BITS))
+            throw std::runtime_error("checkpoint_load: a MicroURNG's position is out of range");
+        T u(c, k);
+        u.setposition(pos);
+        return u;
+    }
+};
+
+static const size_t _ckpt_header_bytes = 64;
+static const uint32_t _ckpt_version = 1;
+
+template <typename T>
+void _ckpt_put_header(unsigned char* p, uint64_t n){
+    typedef _ckpt_traits<T> tr;
+    memset(p, 0, _ckpt_header_bytes);
+    memcpy(p, "R123CKPT", 8);
+    p += 8;
+    _ckpt_put(p, _ckpt_version);
+    _ckpt_put(p, (uint32_t)tr::kind);
+    _ckpt_put(p, (uint32_t)tr::ctr_bits);
+    _ckpt_put(p, (uint32_t)tr::ctr_words);
+    _ckpt_put(p, (uint32_t)tr::key_bits);
+    _ckpt_put(p, (uint32_t)tr::key_words);
+    _ckpt_put(p, (uint32_t)tr::record);
+    _ckpt_put(p, (uint32_t)0);
+    _ckpt_put(p, n);
+}
+
+// The number of records in the checkpoint whose header is at p, which
+// must hold Ts.
+template <typename T>
+uint64_t _ckpt_check_header(const unsigned char* p){
+    typedef _ckpt_traits<T> tr;
+    if(memcmp(p, "R123CKPT", 8) != 0)
+        throw std::runtime_error("checkpoint_load: not a Random123 checkpoint");
+    p += 8;
+    if(_ckpt_get<uint32_t>(p) != _ckpt_version)
+        throw std::runtime_error("checkpoint_load: unknown checkpoint version");
+    const uint32_t want[] = {tr::kind, tr::ctr_bits, tr::ctr_words, tr::key_bits, tr::key_words, tr::record};
+    for(size_t i=0; i<sizeof(want)/sizeof(*want); ++i)
+        if(_ckpt_get<uint32_t>(p) != want[i])
+            throw std::runtime_error("checkpoint_load: the checkpoint holds a different type");
+    p += 4;
+    return _ckpt_get<uint64_t>(p);
+}
+
+// Records go through a buffer of about this many bytes.
+static const size_t _ckpt_chunk_bytes = 1<<16;
+/** \endcond */
+
+/** The size in bytes of a checkpoint of n Ts. */
+template <typename T>
+size_t checkpoint_bytes(size_t n){
+    return _ckpt_header_bytes + n*(size_t)_ckpt_traits<T>::record;
+}
+
+/** Writes a checkpoint of in[0], ..., in[n-1] to the
+    checkpoint_bytes<T>(n) bytes at out. */
+template <typename T>
+void checkpoint_save(const T* in, size_t n, void* out){
+    unsigned char* p = static_cast<unsigned char*>(out);
+    _ckpt_put_header<T>(p, n);
+    p += _ckpt_header_bytes;
+    for(size_t i=0; i<n; ++i, p += _ckpt_traits<T>::record)
+        _ckpt_traits<T>::put(p, in[i]);
+}
+
+/** Writes a checkpoint of in[0], ..., in[n-1] to os. */
+template <typename T>
+void checkpoint_save(std::ostream& os, const T* in, size_t n){
+    const size_t rec = _ckpt_traits<T>::record;
+    const size_t chunk = _ckpt_chunk_bytes/rec + 1;
+    std::vector<unsigned char> buf(_ckpt_header_bytes + chunk*rec);
+    _ckpt_put_header<T>(&buf[0], n);
+    os.write((const char*)&buf[0], _ckpt_header_bytes);
+    for(size_t i=0; i<n; i+=chunk){
+        size_t m = n-i < chunk ? n-i : chunk;
+        for(size_t j=0; j<m; ++j)
+            _ckpt_traits<T>::put(&buf[j*rec], in[i+j]);
+        os.write((const char*)&buf[0], m*rec);
+    }
+}
+
+/** The number of Ts in the checkpoint in the bytes bytes at p. */
+template <typename T>
+size_t checkpoint_count(const void* p, size_t bytes){
+    if(bytes < _ckpt_header_bytes)
+        throw std::runtime_error("checkpoint_load: truncated checkpoint");
+    uint64_t n = _ckpt_check_header<T>(static_cast<const unsigned char*>(p));
+    if(n > (bytes - _ckpt_header_bytes)/_ckpt_traits<T>::record)
+        throw std::runtime_error("checkpoint_load: truncated checkpoint");
+    return (size_t)n;
+}
+
+/** Reads the checkpoint in the bytes bytes at in into out, which
+    must have room for checkpoint_count<T>(in, bytes) Ts.  Returns the
+    number read. */
+template <typename T>
+size_t checkpoint_load(const void* in, size_t bytes, T* out){
+    size_t n = checkpoint_count<T>(in, bytes);
+    const unsigned char* p = static_cast<const unsigned char*>(in) + _ckpt_header_bytes;
+    for(size_t i=0; i<n; ++i, p += _ckpt_traits<T>::record)
+        out[i] = _ckpt_traits<T>::make(p);
+    return n;
+}
+
+/** Reads the checkpoint in the bytes bytes at in into out, resizing
+    it to fit. */
+template <typename T, typename A>
+void checkpoint_load(const void* in, size_t bytes, std::vector<T, A>& out){
+    size_t n = checkpoint_count<T>(in, bytes);
+    const unsigned char* p = static_cast<const unsigned char*>(in) + _ckpt_header_bytes;
+    out.clear();
+    out.reserve(n);
+    for(size_t i=0; i<n; ++i, p += _ckpt_traits<T>::record)
+        out.push_back(_ckpt_traits<T>::make(p));
+}
+
+/** Reads a checkpoint from is into out, resizing it to fit. */
+template <typename T, typename A>
+void checkpoint_load(std::istream& is, std::vector<T, A>& out){
+    const size_t rec = _ckpt_traits<T>::record;
+    const size_t chunk = _ckpt_chunk_bytes/rec + 1;
+    std::vector<unsigned char> buf(_ckpt_header_bytes + chunk*rec);
+    if(!is.read((char*)&buf[0], _ckpt_header_bytes))
+        throw std::runtime_error("checkpoint_load: truncated checkpoint");
+    uint64_t n = _ckpt_check_header<T>(&buf[0]);
+    if(n > std::numeric_limits<size_t>::max R123_NO_MACRO_SUBST ()/rec)
+        throw std::runtime_error("checkpoint_load: truncated checkpoint");
+    // n is not to be trusted until the records arrive, so out grows a
+    // chunk at a time.
+    out.clear();
+    out.reserve(n < chunk ? (size_t)n : chunk);
+    for(size_t i=0; i<n; i+=chunk){
+        size_t m = n-i < chunk ? n-i : chunk;
+        if(!is.read((char*)&buf[0], m*rec))
+            throw std::runtime_error("checkpoint_load: truncated checkpoint");
+        for(size_t j=0; j<m; ++j)
+            out.push_back(_ckpt_traits<T>::make(&buf[j*rec]));
+    }
+}
+
+/** The array of *n Ts in the checkpoint of arrays (e.g., counters or
+    keys) in the bytes bytes at p, in place.  p must be aligned for T,
+    as a mapped file is.  Throws std::runtime_error on a big-endian
+    host, where the checkpoint must be read with checkpoint_load. */
+template <typename T>
+const T* checkpoint_view(const void* p, size_t bytes, size_t* n){
+    R123_STATIC_ASSERT(_ckpt_traits<T>::kind == 1, "only checkpoints of arrays can be viewed in place\n");
+    const uint32_t one = 1;
+    if(*(const unsigned char*)&one != 1)
+        throw std::runtime_error("checkpoint_view: the host is not little-endian");
+    *n = checkpoint_count<T>(p, bytes);
+    return reinterpret_cast<const T*>(static_cast<const unsigned char*>(p) + _ckpt_header_bytes);
+}
+} // namespace r123
+
+#endif
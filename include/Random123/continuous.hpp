@@ -0,0 +1,564 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_continuous_dot_hpp__
+#define __r123_continuous_dot_hpp__
+
+#include "block_stream.hpp"
+#include "fpmath.h"
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+/** \file continuous.hpp
+
+    Exponential, gamma and beta variates in bulk.
+
+    The arithmetic is done with r123_log and r123_exp from fpmath.h
+    and with std::sqrt, so that, unlike the samplers in discrete.hpp,
+    the results do not depend on the math library (see fpmath.h for
+    the conditions on the compiler).  The uniforms are made from 64
+    bits at a time with u01_open_open_64_53.
+
+    exponential_fill(b, k, c0, lambda, out, n) uses inversion,
+    out[i] = -log(u_i)/lambda, where u_i comes from 64-bit word i%M of
+    b(c0 + i/M, k), M being the number of 64-bit words in a ctr_type
+    (32-bit counter words are paired with the first word in the high
+    half, as in uniform_int.hpp).  There is no rejection, so every
+    block is used in full.
+
+    gamma_fill and beta_fill draw element i from
+    block_stream<CBRNG>(b, c0+i, k), exactly as the samplers in
+    discrete.hpp do, so splitting a batch with the counter advanced
+    accordingly gives bitwise identical results, and
+    gamma_fill(b, k, c0, p, out, n) gives the same values as
+\code
+       for(size_t i=0; i<n; ++i, c0.incr()){
+           r123::block_stream<CBRNG> s(b, c0, k);
+           out[i] = r123::gamma(p, s);
+       }
+\endcode
+    The gamma uses the method of Marsaglia and Tsang ("A simple
+    method for generating gamma variables", ACM TOMS 26, 2000), with a
+    polar-method normal; each attempt consumes three uniforms and is
+    accepted with probability between 0.74 and 0.79 for every shape.
+    Shapes below one use the identity Gamma(a) = Gamma(a+1)*U^(1/a),
+    which costs one more uniform after acceptance.  A beta(a, b)
+    variate is X/(X+Y) with X ~ Gamma(a) drawn first and Y ~ Gamma(b)
+    drawn next from the same stream; it is computed from log X and
+    log Y, so it is well defined even when both are too small to
+    represent.
+
+    Rejection is handled in a way that keeps the arithmetic
+    vectorizable: the fill functions work on chunks of elements, make
+    one attempt for every unfinished element of the chunk in a
+    branch-free loop, and compact the indices of the rejected
+    elements to the front of the chunk for the next pass.  Each
+    retry takes the next uniforms of the element's own stream, so the
+    order in which elements are retried has no effect on the results.
+    The attempts, and the logarithms and exponentials of the fill
+    functions, are computed with the widest vector versions of the
+    fpmath.h functions that the compiler has been asked to use
+    (R123_USE_AVX512, R123_USE_AVX2, R123_USE_SSE or R123_USE_NEON),
+    and the elements left over with the scalar versions; both give
+    the same bits, so the results do not depend on the instruction
+    set either.
+*/
+
+namespace r123{
+
+class gamma_param;
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+enum { _continuous_chunk = 64 };
+
+// The operations of fpmath.h on W doubles at a time, as type V with
+// comparison results of type M.  bits(m) has bit j set if lane j of
+// m is true.  The vector specializations are keyed on the tags below
+// rather than on __m128d etc., whose attributes gcc would drop (with
+// -Wignored-attributes) from a template argument.
+template <typename T>
+struct _fplanes;
+struct _fp_m128d{};
+struct _fp_m256d{};
+struct _fp_m512d{};
+struct _fp_f64x2{};
+
+template <>
+struct _fplanes<double>{
+    typedef double V;
+    typedef bool M;
+    enum { W = 1 };
+    static V load(const double* p){ return *p; }
+    static void store(double* p, V v){ *p = v; }
+    static V set1(double x){ return x; }
+    static V add(V a, V b){ return a+b; }
+    static V sub(V a, V b){ return a-b; }
+    static V mul(V a, V b){ return _r123_mul_d(a, b); }
+    static V div(V a, V b){ return a/b; }
+    static V sqrt(V a){ return r123_sqrt(a); }
+    static V log(V a){ return r123_log(a); }
+    static V exp(V a){ return r123_exp(a); }
+    static void boxmuller(V u1, V u2, V* z0, V* z1){ r123_boxmuller(u1, u2, z0, z1); }
+    static M lt(V a, V b){ return a < b; }
+    static M gt(V a, V b){ return a > b; }
+    static M mand(M a, M b){ return a & b; }
+    static M mor(M a, M b){ return a | b; }
+    static V blend(M m, V a, V b){ return _r123_select(m, a, b); }
+    static unsigned bits(M m){ return m; }
+};
+
+#if R123_USE_SSE
+template <>
+struct _fplanes<_fp_m128d>{
+    typedef __m128d V;
+    typedef __m128d M;
+    enum { W = 2 };
+    static V load(const double* p){ return _mm_loadu_pd(p); }
+    static void store(double* p, V v){ _mm_storeu_pd(p, v); }
+    static V set1(double x){ return _mm_set1_pd(x); }
+    static V add(V a, V b){ return _mm_add_pd(a, b); }
+    static V sub(V a, V b){ return _mm_sub_pd(a, b); }
+    static V mul(V a, V b){ return _r123_mul_m128d(a, b); }
+    static V div(V a, V b){ return _mm_div_pd(a, b); }
+    static V sqrt(V a){ return _mm_sqrt_pd(a); }
+    static V log(V a){ return r123_log_m128d(a); }
+    static V exp(V a){ return r123_exp_m128d(a); }
+    static void boxmuller(V u1, V u2, V* z0, V* z1){ r123_boxmuller_m128d(u1, u2, z0, z1); }
+    static M lt(V a, V b){ return _mm_cmplt_pd(a, b); }
+    static M gt(V a, V b){ return _mm_cmpgt_pd(a, b); }
+    static M mand(M a, M b){ return _mm_and_pd(a, b); }
+    static M mor(M a, M b){ return _mm_or_pd(a, b); }
+    static V blend(M m, V a, V b){ return _r123_blend_m128d(m, a, b); }
+    static unsigned bits(M m){ return _mm_movemask_pd(m); }
+};
+#endif
+
+#if R123_USE_AVX2
+template <>
+struct _fplanes<_fp_m256d>{
+    typedef __m256d V;
+    typedef __m256d M;
+    enum { W = 4 };
+    static V load(const double* p){ return _mm256_loadu_pd(p); }
+    static void store(double* p, V v){ _mm256_storeu_pd(p, v); }
+    static V set1(double x){ return _mm256_set1_pd(x); }
+    static V add(V a, V b){ return _mm256_add_pd(a, b); }
+    static V sub(V a, V b){ return _mm256_sub_pd(a, b); }
+    static V mul(V a, V b){ return _r123_mul_m256d(a, b); }
+    static V div(V a, V b){ return _mm256_div_pd(a, b); }
+    static V sqrt(V a){ return _mm256_sqrt_pd(a); }
+    static V log(V a){ return r123_log_m256d(a); }
+    static V exp(V a){ return r123_exp_m256d(a); }
+    static void boxmuller(V u1, V u2, V* z0, V* z1){ r123_boxmuller_m256d(u1, u2, z0, z1); }
+    static M lt(V a, V b){ return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static M gt(V a, V b){ return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static M mand(M a, M b){ return _mm256_and_pd(a, b); }
+    static M mor(M a, M b){ return _mm256_or_pd(a, b); }
+    static V blend(M m, V a, V b){ return _mm256_blendv_pd(b, a, m); }
+    static unsigned bits(M m){ return _mm256_movemask_pd(m); }
+};
+#endif
+
+#if R123_USE_AVX512
+template <>
+struct _fplanes<_fp_m512d>{
+    typedef __m512d V;
+    typedef __mmask8 M;
+    enum { W = 8 };
+    static V load(const double* p){ return _mm512_loadu_pd(p); }
+    static void store(double* p, V v){ _mm512_storeu_pd(p, v); }
+    static V set1(double x){ return _mm512_set1_pd(x); }
+    static V add(V a, V b){ return _mm512_add_pd(a, b); }
+    static V sub(V a, V b){ return _mm512_sub_pd(a, b); }
+    static V mul(V a, V b){ return _r123_mul_m512d(a, b); }
+    static V div(V a, V b){ return _mm512_div_pd(a, b); }
+    static V sqrt(V a){ return _mm512_sqrt_pd(a); }
+    static V log(V a){ return r123_log_m512d(a); }
+    static V exp(V a){ return r123_exp_m512d(a); }
+    static void boxmuller(V u1, V u2, V* z0, V* z1){ r123_boxmuller_m512d(u1, u2, z0, z1); }
+    static M lt(V a, V b){ return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static M gt(V a, V b){ return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static M mand(M a, M b){ return a & b; }
+    static M mor(M a, M b){ return a | b; }
+    static V blend(M m, V a, V b){ return _mm512_mask_blend_pd(m, b, a); }
+    static unsigned bits(M m){ return m; }
+};
+#endif
+
+#if R123_USE_NEON && defined(__aarch64__)
+template <>
+struct _fplanes<_fp_f64x2>{
+    typedef float64x2_t V;
+    typedef uint64x2_t M;
+    enum { W = 2 };
+    static V load(const double* p){ return vld1q_f64(p); }
+    static void store(double* p, V v){ vst1q_f64(p, v); }
+    static V set1(double x){ return vdupq_n_f64(x); }
+    static V add(V a, V b){ return vaddq_f64(a, b); }
+    static V sub(V a, V b){ return vsubq_f64(a, b); }
+    static V mul(V a, V b){ return _r123_mul_f64x2(a, b); }
+    static V div(V a, V b){ return vdivq_f64(a, b); }
+    static V sqrt(V a){ return vsqrtq_f64(a); }
+    static V log(V a){ return r123_log_f64x2(a); }
+    static V exp(V a){ return r123_exp_f64x2(a); }
+    static void boxmuller(V u1, V u2, V* z0, V* z1){ r123_boxmuller_f64x2(u1, u2, z0, z1); }
+    static M lt(V a, V b){ return vcltq_f64(a, b); }
+    static M gt(V a, V b){ return vcgtq_f64(a, b); }
+    static M mand(M a, M b){ return vandq_u64(a, b); }
+    static M mor(M a, M b){ return vorrq_u64(a, b); }
+    static V blend(M m, V a, V b){ return vbslq_f64(m, a, b); }
+    static unsigned bits(M m){ return (unsigned)(vgetq_lane_u64(m, 0) & 1) | (unsigned)(vgetq_lane_u64(m, 1) & 2); }
+};
+#endif
+
+// The widest _fplanes available.
+#if R123_USE_AVX512
+typedef _fplanes<_fp_m512d> _fpwide;
+#elif R123_USE_AVX2
+typedef _fplanes<_fp_m256d> _fpwide;
+#elif R123_USE_SSE
+typedef _fplanes<_fp_m128d> _fpwide;
+#elif R123_USE_NEON && defined(__aarch64__)
+typedef _fplanes<_fp_f64x2> _fpwide;
+#else
+typedef _fplanes<double> _fpwide;
+#endif
+
+// One Marsaglia-Tsang attempt in each of the W lanes q, q+1, ...:
+// lane q uses constants d[q] and c[q] and the uniforms A[q] and B[q]
+// (which give a normal by the polar method) and U[q].  Sets
+// val[q] = d*v, and ok[q] to whether the attempt is accepted.  A and
+// B are never exactly 1/2 (see u01_open_open_64_53), so S > 0.
+template <typename T>
+void _gamma_attempt(const double* d, const double* c, const double* A, const double* B, const double* U, double* val, bool* ok, size_t q){
+    typedef typename T::V V;
+    typedef typename T::M M;
+    V one = T::set1(1.);
+    V a = T::sub(T::mul(T::set1(2.), T::load(A+q)), one);
+    V b = T::sub(T::mul(T::set1(2.), T::load(B+q)), one);
+    V S = T::add(T::mul(a, a), T::mul(b, b));
+    M polar = T::lt(S, one);
+    V Ss = T::blend(polar, S, T::set1(0.5));
+    V x = T::mul(a, T::sqrt(T::div(T::mul(T::set1(-2.), T::log(Ss)), Ss)));
+    V v = T::add(one, T::mul(T::load(c+q), x));
+    v = T::mul(T::mul(v, v), v);
+    M vpos = T::gt(v, T::set1(0.));
+    V vs = T::blend(vpos, v, one);
+    V x2 = T::mul(x, x);
+    V u = T::load(U+q);
+    V dq = T::load(d+q);
+    M squeeze = T::lt(u, T::sub(one, T::mul(T::set1(0.0331), T::mul(x2, x2))));
+    M full = T::lt(T::log(u), T::add(T::mul(T::set1(0.5), x2), T::mul(dq, T::add(T::sub(one, vs), T::log(vs)))));
+    unsigned okbits = T::bits(T::mand(T::mand(polar, vpos), T::mor(squeeze, full)));
+    T::store(val+q, T::mul(dq, vs));
+    for(size_t j=0; j<(size_t)T::W; ++j)
+        ok[q+j] = (okbits>>j) & 1;
+}
+
+// _gamma_attempt for lanes [0, n).  The scalar samplers call it with
+// n = 1.
+inline void _gamma_attempts(const double* d, const double* c, const double* A, const double* B, const double* U, double* val, bool* ok, size_t n){
+    size_t q = 0;
+    for(; q+_fpwide::W<=n; q+=_fpwide::W)
+        _gamma_attempt<_fpwide>(d, c, A, B, U, val, ok, q);
+    for(; q<n; ++q)
+        _gamma_attempt<_fplanes<double> >(d, c, A, B, U, val, ok, q);
+}
+
+// x[i] = log(x[i])/s for i in [0, n).
+template <typename T>
+void _log_div(double* x, double s, size_t& i, size_t n){
+    for(; i+T::W<=n; i+=T::W)
+        T::store(x+i, T::div(T::log(T::load(x+i)), T::set1(s)));
+}
+
+inline void _log_div(double* x, double s, size_t n){
+    size_t i = 0;
+    _log_div<_fpwide>(x, s, i, n);
+    _log_div<_fplanes<double> >(x, s, i, n);
+}
+
+// out[j] = X/(X+Y) for X = gx[j]*exp(lx[j]) and Y = gy[j]*exp(ly[j]),
+// for j in [0, n).
+template <typename T>
+void _beta_combine(const double* gx, const double* lx, const double* gy, const double* ly, double* out, size_t& j, size_t n){
+    for(; j+T::W<=n; j+=T::W){
+        typename T::V one = T::set1(1.);
+        typename T::V ly_ = T::add(T::log(T::load(gy+j)), T::load(ly+j));
+        typename T::V lx_ = T::add(T::log(T::load(gx+j)), T::load(lx+j));
+        T::store(out+j, T::div(one, T::add(one, T::exp(T::sub(ly_, lx_)))));
+    }
+}
+
+inline void _beta_combine(const double* gx, const double* lx, const double* gy, const double* ly, double* out, size_t n){
+    size_t j = 0;
+    _beta_combine<_fpwide>(gx, lx, gy, ly, out, j, n);
+    _beta_combine<_fplanes<double> >(gx, lx, gy, ly, out, j, n);
+}
+
+template <typename Stream>
+void _gamma_one(const gamma_param& p, Stream& s, double& g, double& l);
+
+template <typename CBRNG>
+void _gamma_lanes(const gamma_param* p, size_t pinc, block_stream<CBRNG>* s, size_t m, double* g, double* l);
+/** \endcond */
+
+/** Precomputed constants for sampling the gamma distribution with
+    density x^(shape-1) e^(-x/scale) / (Gamma(shape) scale^shape). */
+class gamma_param{
+public:
+    /** Throws std::invalid_argument unless shape and scale are
+        positive and finite. */
+    gamma_param(double _shape, double _scale = 1.) : a(_shape), th(_scale){
+        const double big = std::numeric_limits<double>::max R123_NO_MACRO_SUBST ();
+        if(!(a > 0. && a <= big))
+            throw std::invalid_argument("gamma_param: shape must be positive and finite");
+        if(!(th > 0. && th <= big))
+            throw std::invalid_argument("gamma_param: scale must be positive and finite");
+        boost = a < 1.;
+        d = (boost ? a+1. : a) - 1./3.;
+        c = 1./std::sqrt(9.*d);
+        inva = 1./a;
+    }
+    double shape() const { return a; }
+    double scale() const { return th; }
+
+private:
+    template <typename Stream> friend double gamma(const gamma_param&, Stream&);
+    template <typename Stream> friend void _gamma_one(const gamma_param&, Stream&, double&, double&);
+    template <typename CBRNG> friend void _gamma_lanes(const gamma_param*, size_t, block_stream<CBRNG>*, size_t, double*, double*);
+    template <typename CBRNG> friend void _gamma_fill(const CBRNG&, const typename CBRNG::key_type&, typename CBRNG::ctr_type, const gamma_param*, size_t, double*, size_t);
+    double a, th;
+    // Marsaglia-Tsang constants for shape a (or a+1 if boost)
+    double d, c, inva;
+    bool boost;
+};
+
+/** Precomputed constants for sampling the beta distribution with
+    density x^(a-1) (1-x)^(b-1) / B(a, b). */
+class beta_param{
+public:
+    /** Throws std::invalid_argument unless a and b are positive and finite. */
+    beta_param(double _a, double _b) : x(_a), y(_b){}
+    double alpha() const { return x.shape(); }
+    double beta() const { return y.shape(); }
+
+private:
+    template <typename Stream> friend double beta(const beta_param&, Stream&);
+    template <typename CBRNG> friend void _beta_fill(const CBRNG&, const typename CBRNG::key_type&, typename CBRNG::ctr_type, const beta_param*, size_t, double*, size_t);
+    gamma_param x, y;
+};
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+// A gamma variate with scale 1 as g*exp(l): g from Marsaglia-Tsang
+// and, for shapes below one, l = log(U)/shape (l = 0 otherwise).
+template <typename Stream>
+void _gamma_one(const gamma_param& p, Stream& s, double& g, double& l){
+    bool ok;
+    do{
+        double A = s.u01();
+        double B = s.u01();
+        double U = s.u01();
+        _gamma_attempts(&p.d, &p.c, &A, &B, &U, &g, &ok, 1);
+    }while(!ok);
+    l = p.boost ? r123_log(s.u01())*p.inva : 0.;
+}
+
+// _gamma_one for the m streams s[0..m), lane j having parameters
+// p[j*pinc].  Every pass makes one attempt in each unfinished lane
+// and moves the lanes that rejected to the front of act.
+template <typename CBRNG>
+void _gamma_lanes(const gamma_param* p, size_t pinc, block_stream<CBRNG>* s, size_t m, double* g, double* l){
+    double A[_continuous_chunk], B[_continuous_chunk], U[_continuous_chunk];
+    double d[_continuous_chunk], c[_continuous_chunk], val[_continuous_chunk];
+    bool ok[_continuous_chunk];
+    size_t act[_continuous_chunk];
+    size_t na = m;
+    for(size_t j=0; j<m; ++j)
+        act[j] = j;
+    while(na){
+        for(size_t q=0; q<na; ++q){
+            block_stream<CBRNG>& sq = s[act[q]];
+            A[q] = sq.u01();
+            B[q] = sq.u01();
+            U[q] = sq.u01();
+            d[q] = p[act[q]*pinc].d;
+            c[q] = p[act[q]*pinc].c;
+        }
+        _gamma_attempts(d, c, A, B, U, val, ok, na);
+        size_t nn = 0;
+        for(size_t q=0; q<na; ++q){
+            if(ok[q])
+                g[act[q]] = val[q];
+            else
+                act[nn++] = act[q];
+        }
+        na = nn;
+    }
+    for(size_t j=0; j<m; ++j){
+        const gamma_param& pj = p[j*pinc];
+        l[j] = pj.boost ? r123_log(s[j].u01())*pj.inva : 0.;
+    }
+}
+
+template <typename CBRNG>
+void _continuous_streams(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type& c0, size_t m, std::vector<block_stream<CBRNG> >& s){
+    s.clear();
+    for(size_t j=0; j<m; ++j, c0.incr())
+        s.push_back(block_stream<CBRNG>(b, c0, k));
+}
+
+template <typename CBRNG>
+void _gamma_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const gamma_param* p, size_t pinc, double* out, size_t n){
+    std::vector<block_stream<CBRNG> > s;
+    s.reserve(_continuous_chunk);
+    double l[_continuous_chunk];
+    for(size_t i=0; i<n; i+=_continuous_chunk){
+        size_t m = n-i < (size_t)_continuous_chunk ? n-i : (size_t)_continuous_chunk;
+        const gamma_param* pi = p + i*pinc;
+        _continuous_streams(b, k, c0, m, s);
+        _gamma_lanes(pi, pinc, &s[0], m, out+i, l);
+        for(size_t j=0; j<m; ++j){
+            const gamma_param& pj = pi[j*pinc];
+            double g = pj.boost ? out[i+j]*r123_exp(l[j]) : out[i+j];
+            out[i+j] = g*pj.th;
+        }
+    }
+}
+
+template <typename CBRNG>
+void _beta_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const beta_param* p, size_t pinc, double* out, size_t n){
+    std::vector<block_stream<CBRNG> > s;
+    std::vector<gamma_param> px, py;
+    s.reserve(_continuous_chunk);
+    double gx[_continuous_chunk], lx[_continuous_chunk], gy[_continuous_chunk], ly[_continuous_chunk];
+    for(size_t i=0; i<n; i+=_continuous_chunk){
+        size_t m = n-i < (size_t)_continuous_chunk ? n-i : (size_t)_continuous_chunk;
+        const beta_param* pi = p + i*pinc;
+        _continuous_streams(b, k, c0, m, s);
+        px.clear();
+        py.clear();
+        for(size_t j=0; j<(pinc ? m : 1); ++j){
+            px.push_back(pi[j].x);
+            py.push_back(pi[j].y);
+        }
+        _gamma_lanes(&px[0], pinc, &s[0], m, gx, lx);
+        _gamma_lanes(&py[0], pinc, &s[0], m, gy, ly);
+        _beta_combine(gx, lx, gy, ly, out+i, m);
+    }
+}
+/** \endcond */
+
+/** One exponential variate with rate lambda (mean 1/lambda), drawn
+    from the block_stream (or any object with a u01() method returning
+    doubles in (0,1)) s. */
+template <typename Stream>
+double exponential(double lambda, Stream& s){
+    return r123_log(s.u01())/-lambda;
+}
+
+/** One gamma variate with parameters p, drawn from the block_stream
+    (or any object with a u01() method returning doubles in (0,1)) s. */
+template <typename Stream>
+double gamma(const gamma_param& p, Stream& s){
+    double g, l;
+    _gamma_one(p, s, g, l);
+    if(p.boost)
+        g = g*r123_exp(l);
+    return g*p.th;
+}
+
+/** One beta variate with parameters p, drawn from the block_stream
+    (or any object with a u01() method returning doubles in (0,1)) s. */
+template <typename Stream>
+double beta(const beta_param& p, Stream& s){
+    double gx, lx, gy, ly;
+    _gamma_one(p.x, s, gx, lx);
+    _gamma_one(p.y, s, gy, ly);
+    double out;
+    _beta_combine(&gx, &lx, &gy, &ly, &out, 1);
+    return out;
+}
+
+/** Fill out[0..n) with exponential variates with rate lambda.
+    out[i] is made from 64-bit word i%M of b(c0 + i/M, k); see
+    continuous.hpp.  Throws std::invalid_argument unless lambda is
+    positive and finite. */
+template <typename CBRNG>
+void exponential_fill(CBRNG b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, double lambda, double* out, size_t n){
+    if(!(lambda > 0. && lambda <= std::numeric_limits<double>::max R123_NO_MACRO_SUBST ()))
+        throw std::invalid_argument("exponential_fill: lambda must be positive and finite");
+    uint64_t w[_continuous_chunk];
+    for(size_t i=0; i<n; ){
+        size_t nw = 0;
+        while(nw < (size_t)_continuous_chunk && i+nw < n){
+            nw += _words64(b(c0, k), w+nw);
+            c0.incr();
+        }
+        size_t m = n-i < nw ? n-i : nw;
+        for(size_t j=0; j<m; ++j)
+            out[i+j] = u01_open_open_64_53(w[j]);
+        _log_div(out+i, -lambda, m);
+        i += m;
+    }
+}
+
+/** Fill out[0..n) with gamma variates.  out[i] is drawn from
+    block_stream<CBRNG>(b, c0+i, k). */
+template <typename CBRNG>
+void gamma_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const gamma_param& p, double* out, size_t n){
+    _gamma_fill(b, k, c0, &p, 0, out, n);
+}
+
+/** Fill out[0..n) with gamma variates; out[i] has parameters p[i]. */
+template <typename CBRNG>
+void gamma_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const gamma_param* p, double* out, size_t n){
+    _gamma_fill(b, k, c0, p, 1, out, n);
+}
+
+/** Fill out[0..n) with beta variates.  out[i] is drawn from
+    block_stream<CBRNG>(b, c0+i, k). */
+template <typename CBRNG>
+void beta_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const beta_param& p, double* out, size_t n){
+    _beta_fill(b, k, c0, &p, 0, out, n);
+}
+
+/** Fill out[0..n) with beta variates; out[i] has parameters p[i]. */
+template <typename CBRNG>
+void beta_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const beta_param* p, double* out, size_t n){
+    _beta_fill(b, k, c0, p, 1, out, n);
+}
+
+} // namespace r123
+#endif
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdexcept>
 #include <sstream>
 #include <algorithm>
+#include <utility>
 #include <vector>
 #if R123_USE_CXX11_TYPE_TRAITS
 #include <type_traits>
@@ -62,6 +63,19 @@ namespace r123{
   For example, a MicroURNG allows one to use C++0x "Random Number
   Distributions"  without giving up control over the counters
   and keys.
+
+  Copying or moving an Engine copies its members, including the
+  block it is part way through, without calling the CBRNG.  With
+  C++11, an Engine is trivially copyable when the CBRNG and its
+  ctr_type, key_type and ukey_type are, as those in this library
+  are, so that arrays of Engines can be memcpy'd, e.g., into shared
+  memory or a checkpoint file.  Code that relies on this can say so:
+@code
+  R123_STATIC_ASSERT(std::is_trivially_copyable<r123::Engine<r123::Philox4x32> >::value,
+                     "Engine<Philox4x32> must be trivially copyable");
+@endcode
+  (R123_USE_CXX11_TRIVIALLY_COPYABLE says whether the library has
+  std::is_trivially_copyable.)
 */ 
 
 template<typename CBRNG>
@@ -87,12 +101,12 @@ protected:
 	}
     }        
 public:
-    explicit Engine() : b(), c(), elem() {
+    explicit Engine() : b(), c(), elem(), v() {
 	ukey_type x = {{}};
 	ukey = x;
         key = ukey;
     }
-    explicit Engine(result_type r) : b(), c(), elem() {
+    explicit Engine(result_type r) : b(), c(), elem(), v() {
         ukey_type x = {{typename ukey_type::value_type(r)}};
         ukey = x;
         key = ukey;
@@ -103,28 +117,26 @@ public:
     // minimum a type shall not qualify as a SeedSeq if it is
     // implicitly convertible to a result_type."  
     //
-    // First, we make sure that even the non-const copy constructor
-    // works as expected.  In addition, if we've got C++0x
-    // type_traits, we use enable_if and is_convertible to implement
-    // the convertible-to-result_type restriction.  Otherwise, the
-    // template is unconditional and will match in some surpirsing
-    // and undesirable situations.
-    Engine(Engine& e) : b(e.b), ukey(e.ukey), c(e.c), elem(e.elem){
-        key = ukey;
-        fix_invariant();
-    }
-    Engine(const Engine& e) : b(e.b), ukey(e.ukey), c(e.c), elem(e.elem){
-        key = ukey;
-        fix_invariant();
-    }
+    // If we've got C++0x type_traits, we use enable_if and
+    // is_convertible to implement the convertible-to-result_type
+    // restriction, and is_same to keep the template from copying a
+    // non-const Engine, so that the implicit (and trivial) copy and
+    // move constructors do the copying.  Otherwise, the template is
+    // unconditional and will match in some surpirsing and undesirable
+    // situations, so we make sure that even the non-const copy
+    // constructor works as expected by declaring both by hand.
+#if !R123_USE_CXX11_TYPE_TRAITS
+    Engine(Engine& e) : b(e.b), key(e.key), ukey(e.ukey), c(e.c), elem(e.elem), v(e.v){}
+    Engine(const Engine& e) : b(e.b), key(e.key), ukey(e.ukey), c(e.c), elem(e.elem), v(e.v){}
+#endif
 
     template <typename SeedSeq>
     explicit Engine(SeedSeq &s
 #if R123_USE_CXX11_TYPE_TRAITS
-                    , typename std::enable_if<!std::is_convertible<SeedSeq, result_type>::value>::type* =0
+                    , typename std::enable_if<!std::is_convertible<SeedSeq, result_type>::value && !std::is_same<SeedSeq, Engine>::value>::type* =0
 #endif
                     )
-        : b(), c(), elem() {
+        : b(), c(), elem(), v() {
         ukey = ukey_type::seed(s);
         key = ukey;
     }
@@ -207,8 +219,8 @@ public:
 
     // Constructors and seed() method for ukey_type seem useful
     // We need const and non-const to supersede the SeedSeq template.
-    explicit Engine(const ukey_type &uk) : key(uk), ukey(uk), c(), elem(){}
-    explicit Engine(ukey_type &uk) : key(uk), ukey(uk), c(), elem(){}
+    explicit Engine(const ukey_type &uk) : key(uk), ukey(uk), c(), elem(), v(){}
+    explicit Engine(ukey_type &uk) : key(uk), ukey(uk), c(), elem(), v(){}
     void seed(const ukey_type& uk){
         *this = Engine(uk);
     }        
@@ -232,13 +244,13 @@ public:
     // the internal state, e.g., so it can call a different
     // bijection with the same counter.
     std::pair<ctr_type, elem_type> getcounter() const {
-        return make_pair(c,  elem);
+        return std::make_pair(c,  elem);
     }
 
     // And the inverse.
     void setcounter(const ctr_type& _c, elem_type _elem){
         static const size_t nelem = c.size();
-        if( elem > nelem )
+        if( _elem > nelem )
             throw std::range_error("Engine::setcounter called  with elem out of range");
         c = _c;
         elem = _elem;
@@ -0,0 +1,406 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_discrete_dot_hpp__
+#define __r123_discrete_dot_hpp__
+
+#include "block_stream.hpp"
+#include "fpmath.h"
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+
+/** \file discrete.hpp
+
+    Poisson, binomial and geometric variates driven by a block_stream.
+
+    Each distribution has a parameter class (poisson_param,
+    binomial_param, geometric_param) whose constructor does all the
+    per-parameter setup (hat-function constants, small-mean lookup
+    tables), a scalar sampler that draws one variate from a
+    block_stream, and a batched _fill function that writes n variates
+    to an array:
+
+\code
+       typedef r123::Philox4x32 RNG;
+       RNG::ctr_type c0 = {{0, 0, 0, 0}};   // high 32 bits of c0[3] must be zero
+       RNG::key_type k = {{seed, stream}};
+       r123::poisson_param pp(mu);
+       r123::poisson_fill(RNG(), k, c0, pp, out, n);
+\endcode
+
+    Element i of a batch is drawn from block_stream<CBRNG>(b, c0+i, k),
+    i.e., from the blocks b(c0+i with j in the high bits of the last word, k),
+    j = 0, 1, ...  Splitting a batch of n into pieces [0,m) and [m,n)
+    and filling them with counters c0 and c0+m (in any order, on any
+    number of threads) gives bitwise identical results to filling the
+    whole batch at once.
+
+    Randomness is consumed only through block_stream::u01(), i.e.,
+    64 bits (one 64-bit or two 32-bit words) per uniform.
+
+    Small means (mu < 10 for the Poisson, n*min(p,1-p) < 10 for the
+    binomial) are handled by exact inversion of a precomputed CDF
+    table, using exactly one uniform per variate.  Larger means use
+    Hormann's transformed rejection with squeeze (PTRS for the
+    Poisson, BTRS for the binomial; W. Hormann, "The transformed
+    rejection method for generating Poisson random variables",
+    Insurance: Mathematics and Economics 12, 1993 and "The generation
+    of binomial random variates", J. Statist. Comput. Simul. 46, 1993),
+    which consume two uniforms per attempt.  The acceptance rate is
+    above 85%, and the number of attempts is capped at
+    max_attempts (32).  If every attempt is rejected, which happens
+    with probability below 2^-80, the sampler returns the mode.  The
+    geometric uses inversion with exactly one uniform.
+
+    Logarithms and exponentials are computed with r123_log and
+    r123_exp from fpmath.h, so the results do not depend on the math
+    library.  The remaining arithmetic is plain IEEE-754 double
+    arithmetic, which is bitwise reproducible under the conditions
+    listed in fpmath.h, provided also that the compiler does not
+    contract it into fused multiply-adds (e.g., -ffp-contract=off
+    with gcc).
+*/
+
+namespace r123{
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+// log1p(x) for x > -1, accurate to a few ulps using only log
+// (Goldberg, "What every computer scientist should know about
+// floating-point arithmetic", Theorem 4).
+inline double _log1p(double x){
+    double u = 1. + x;
+    if(u == 1.)
+        return x;
+    return r123_log(u)*x/(u-1.);
+}
+
+// The error in Stirling's approximation to log(k!):
+//   log(k!) = (k+1/2)log(k+1) - (k+1) + log(2pi)/2 + _stirling_tail(k)
+inline double _stirling_tail(double k){
+    static const double tail[16] = {
+        0.081061466795327261, 0.041340695955409297, 0.027677925684998338, 0.020790672103765093,
+        0.016644691189821193, 0.013876128823070748, 0.01189670994589177, 0.010411265261972096,
+        0.0092554621827127329, 0.0083305634333628708, 0.0075736754879518406, 0.0069428401072095299,
+        0.0064089941880042071, 0.0059513701127588475, 0.0055547335519628011, 0.0052076559196096404
+    };
+    if(k < 16.)
+        return tail[(int)k];
+    double n = k+1.;
+    double nn = n*n;
+    return (1./12. - (1./360. - (1./1260. - (1./1680.)/nn)/nn)/nn)/n;
+}
+
+static const double _half_log_2pi = 0.91893853320467274;
+
+// Exact inversion of a discrete CDF table, shared by the small-mean
+// Poisson and binomial paths.  cdf[ncdf-1] is exactly 1.0.  guide[j]
+// is the smallest index with cdf[index] > j/nguide, so the linear
+// search that starts there visits one or two entries on average.
+struct _cdf_table{
+    enum { ncdf = 64, nguide = 16 };
+    double cdf[ncdf];
+    unsigned char guide[nguide];
+
+    // Fill from pmf(0) and the ratios pmf(i+1)/pmf(i) = ratio(i).
+    // Entries past kmax are 1.0.
+    template <typename RatioFunc>
+    void init(double pmf0, RatioFunc ratio, double kmax){
+        double pmf = pmf0;
+        double sum = 0.;
+        int i;
+        for(i=0; i<ncdf-1 && i<kmax; ++i){
+            sum += pmf;
+            cdf[i] = sum;
+            pmf *= ratio(i);
+        }
+        for(; i<ncdf; ++i)
+            cdf[i] = 1.;
+        int k = 0;
+        for(int j=0; j<nguide; ++j){
+            while(cdf[k] <= double(j)/nguide)
+                ++k;
+            guide[j] = (unsigned char)k;
+        }
+    }
+
+    unsigned lookup(double u) const{
+        unsigned k = guide[(int)(u*nguide)];
+        while(u >= cdf[k])
+            ++k;
+        return k;
+    }
+};
+
+struct _poisson_ratio{
+    double mu;
+    _poisson_ratio(double _mu) : mu(_mu){}
+    double operator()(int i) const { return mu/(i+1); }
+};
+
+struct _binomial_ratio{
+    double n, r;
+    _binomial_ratio(double _n, double _r) : n(_n), r(_r){}
+    double operator()(int i) const { return r*(n-i)/(i+1); }
+};
+/** \endcond */
+
+/** The maximum number of rejection-sampling attempts made by the
+    samplers in discrete.hpp before they give up and return the mode. */
+static const int discrete_max_attempts = 32;
+
+/** Precomputed constants for sampling the Poisson distribution with mean mu. */
+class poisson_param{
+public:
+    /** Throws std::invalid_argument unless 0 <= mu <= 2^53. */
+    explicit poisson_param(double _mu) : mu(_mu){
+        if(!(mu >= 0. && mu <= 9007199254740992.))
+            throw std::invalid_argument("poisson_param: mu must be in [0, 2^53]");
+        if(mu < small_mean){
+            tab.init(r123_exp(-mu), _poisson_ratio(mu), 1.e300);
+            return;
+        }
+        double slam = std::sqrt(mu);
+        loglam = r123_log(mu);
+        b = 0.931 + 2.53*slam;
+        a = -0.059 + 0.02483*b;
+        loginvalpha = r123_log(1.1239 + 1.1328/(b-3.4));
+        vr = 0.9277 - 3.6224/(b-2.);
+        mode = std::floor(mu);
+    }
+    double mean() const { return mu; }
+
+    /** Means below small_mean are sampled by table lookup. */
+    static const int small_mean = 10;
+
+private:
+    template <typename Stream> friend uint64_t poisson(const poisson_param&, Stream&);
+    double mu;
+    // PTRS constants
+    double loglam, b, a, loginvalpha, vr, mode;
+    // small mean table
+    _cdf_table tab;
+};
+
+/** One Poisson variate with parameters p, drawn from the block_stream
+    (or any object with a u01() method returning doubles in (0,1)) s. */
+template <typename Stream>
+uint64_t poisson(const poisson_param& p, Stream& s){
+    if(p.mu < poisson_param::small_mean)
+        return p.tab.lookup(s.u01());
+    for(int i=0; i<discrete_max_attempts; ++i){
+        double U = s.u01() - 0.5;
+        double V = s.u01();
+        double us = 0.5 - std::fabs(U);
+        double k = std::floor((2.*p.a/us + p.b)*U + p.mu + 0.43);
+        if(us >= 0.07 && V <= p.vr)
+            return (uint64_t)k;
+        if(k < 0. || (us < 0.013 && V > us))
+            continue;
+        // log(mu^k e^-mu / k!), rearranged to avoid cancellation when mu is large
+        double logpmf = -(k+0.5)*_log1p((k+1.-p.mu)/p.mu) - 0.5*p.loglam + (k+1.-p.mu) - _half_log_2pi - _stirling_tail(k);
+        if(r123_log(V) + p.loginvalpha - r123_log(p.a/(us*us) + p.b) <= logpmf)
+            return (uint64_t)k;
+    }
+    return (uint64_t)p.mode;
+}
+
+/** Precomputed constants for sampling the binomial distribution:
+    the number of successes in n independent trials, each with probability p. */
+class binomial_param{
+public:
+    /** Throws std::invalid_argument unless 0 <= p <= 1 and n <= 2^53. */
+    binomial_param(uint64_t _n, double _p) : n(_n), p(_p){
+        if(!(p >= 0. && p <= 1.))
+            throw std::invalid_argument("binomial_param: p must be in [0,1]");
+        if(n > (R123_64BIT(1)<<53))
+            throw std::invalid_argument("binomial_param: n must not exceed 2^53");
+        flip = p > 0.5;
+        double pp = flip ? 1.-p : p;
+        double q = 1.-pp;
+        double dn = (double)n;
+        if(dn*pp < small_mean){
+            // pmf(0) = q^n; an empty table for p==0, and 0 successes if n==0.
+            tab.init(r123_exp(dn*_log1p(-pp)), _binomial_ratio(dn, pp/q), dn);
+            return;
+        }
+        double spq = std::sqrt(dn*pp*q);
+        b = 1.15 + 2.53*spq;
+        a = -0.0873 + 0.0248*b + 0.01*pp;
+        c = dn*pp + 0.5;
+        vr = 0.92 - 4.2/b;
+        r = pp/q;
+        logalpha = r123_log((2.83 + 5.1/b)*spq);
+        m = std::floor((dn+1.)*pp);
+        // The k-independent part of log(pmf(k)/pmf(m)) in BTRS's
+        // Stirling-series form.
+        hm = (m+0.5)*r123_log((m+1.)/(r*(dn-m+1.))) + _stirling_tail(m) + _stirling_tail(dn-m);
+    }
+    uint64_t trials() const { return n; }
+    double prob() const { return p; }
+
+    /** Means (of the less likely outcome) below small_mean are sampled by table lookup. */
+    static const int small_mean = 10;
+
+private:
+    template <typename Stream> friend uint64_t binomial(const binomial_param&, Stream&);
+    uint64_t n;
+    double p;
+    bool flip;
+    // BTRS constants
+    double b, a, c, vr, r, logalpha, m, hm;
+    // small mean table
+    _cdf_table tab;
+};
+
+/** One binomial variate with parameters p, drawn from the block_stream
+    (or any object with a u01() method returning doubles in (0,1)) s. */
+template <typename Stream>
+uint64_t binomial(const binomial_param& p, Stream& s){
+    uint64_t k;
+    double dn = (double)p.n;
+    if(dn*(p.flip ? 1.-p.p : p.p) < binomial_param::small_mean){
+        k = p.tab.lookup(s.u01());
+        return p.flip ? p.n - k : k;
+    }
+    k = (uint64_t)p.m;
+    for(int i=0; i<discrete_max_attempts; ++i){
+        double U = s.u01() - 0.5;
+        double V = s.u01();
+        double us = 0.5 - std::fabs(U);
+        double dk = std::floor((2.*p.a/us + p.b)*U + p.c);
+        if(dk < 0. || dk > dn)
+            continue;
+        if(us >= 0.07 && V <= p.vr){
+            k = (uint64_t)dk;
+            break;
+        }
+        double logv = r123_log(V) + p.logalpha - r123_log(p.a/(us*us) + p.b);
+        double bound = p.hm + (dn+1.)*r123_log((dn-p.m+1.)/(dn-dk+1.))
+            + (dk+0.5)*r123_log(p.r*(dn-dk+1.)/(dk+1.))
+            - _stirling_tail(dk) - _stirling_tail(dn-dk);
+        if(logv <= bound){
+            k = (uint64_t)dk;
+            break;
+        }
+    }
+    return p.flip ? p.n - k : k;
+}
+
+/** Precomputed constants for sampling the geometric distribution:
+    the number of failures before the first success in independent
+    trials with success probability p. */
+class geometric_param{
+public:
+    /** Throws std::invalid_argument unless 0 < p <= 1. */
+    explicit geometric_param(double _p) : p(_p){
+        if(!(p > 0. && p <= 1.))
+            throw std::invalid_argument("geometric_param: p must be in (0,1]");
+        rlogq = (p == 1.) ? 0. : 1./_log1p(-p);
+    }
+    double prob() const { return p; }
+
+private:
+    template <typename Stream> friend uint64_t geometric(const geometric_param&, Stream&);
+    double p;
+    double rlogq;
+};
+
+/** One geometric variate with parameters p, drawn from the block_stream
+    (or any object with a u01() method returning doubles in (0,1)) s.
+    Values too large for a uint64_t saturate. */
+template <typename Stream>
+uint64_t geometric(const geometric_param& p, Stream& s){
+    double k = std::floor(r123_log(s.u01())*p.rlogq);
+    if(k >= 18446744073709551616.)
+        return ~R123_64BIT(0);
+    return (uint64_t)k;
+}
+
+/** Fill out[0..n) with Poisson variates.  out[i] is drawn from
+    block_stream<CBRNG>(b, c0+i, k). */
+template <typename CBRNG, typename IntType>
+void poisson_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const poisson_param& p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)poisson(p, s);
+    }
+}
+
+/** Fill out[0..n) with Poisson variates; out[i] has parameters p[i]. */
+template <typename CBRNG, typename IntType>
+void poisson_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const poisson_param* p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)poisson(p[i], s);
+    }
+}
+
+/** Fill out[0..n) with binomial variates.  out[i] is drawn from
+    block_stream<CBRNG>(b, c0+i, k). */
+template <typename CBRNG, typename IntType>
+void binomial_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const binomial_param& p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)binomial(p, s);
+    }
+}
+
+/** Fill out[0..n) with binomial variates; out[i] has parameters p[i]. */
+template <typename CBRNG, typename IntType>
+void binomial_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const binomial_param* p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)binomial(p[i], s);
+    }
+}
+
+/** Fill out[0..n) with geometric variates.  out[i] is drawn from
+    block_stream<CBRNG>(b, c0+i, k). */
+template <typename CBRNG, typename IntType>
+void geometric_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const geometric_param& p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)geometric(p, s);
+    }
+}
+
+/** Fill out[0..n) with geometric variates; out[i] has parameters p[i]. */
+template <typename CBRNG, typename IntType>
+void geometric_fill(const CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, const geometric_param* p, IntType* out, size_t n){
+    for(size_t i=0; i<n; ++i, c0.incr()){
+        block_stream<CBRNG> s(b, c0, k);
+        out[i] = (IntType)geometric(p[i], s);
+    }
+}
+
+} // namespace r123
+#endif
@@ -71,6 +71,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #endif
 
+#ifndef R123_USE_CXX11_TRIVIALLY_COPYABLE
+#define R123_USE_CXX11_TRIVIALLY_COPYABLE R123_USE_CXX11_TYPE_TRAITS
+#endif
+
 #include "gccfeatures.h"
 
 #endif
@@ -64,6 +64,12 @@ All boolean-valued pre-processor symbols in Random123/features/compilerfeatures.
 @verbatim
          AES_NI
          AES_OPENSSL
+         AVX512
+         AVX512IFMA
+         VAES
+         AVX2
+         NEON
+         ARM_AES
          SSE4_2
          SSE4_1
          SSE
@@ -78,6 +84,7 @@ All boolean-valued pre-processor symbols in Random123/features/compilerfeatures.
 
          CXX11_RANDOM
          CXX11_TYPE_TRAITS
+         CXX11_TRIVIALLY_COPYABLE
          CXX11_STATIC_ASSERT
          CXX11_CONSTEXPR
          CXX11_UNRESTRICTED_UNIONS
@@ -107,6 +114,22 @@ Most have obvious meanings.  Some non-obvious ones:
 AES_NI and AES_OPENSSL are not mutually exclusive.  You can have one,
 both or neither.
 
+AVX2 and AVX512 say that the compiler has been asked to generate
+AVX2 and AVX-512F instructions (e.g., with -mavx2 or -march=native),
+so the corresponding intrinsics from <immintrin.h> may be used.
+AVX512IFMA says the same of the AVX-512 52-bit integer multiply-add
+instructions (e.g., -mavx512ifma), and VAES of the vector AES
+instructions, which do two or four AES rounds at once on 256- or
+512-bit registers (e.g., -mvaes).
+Unlike AES_NI, there is no run-time check; the program is assumed
+to run on the hardware it was compiled for.
+
+NEON says that the compiler targets ARM Advanced SIMD, so the
+intrinsics from <arm_neon.h> may be used.  ARM_AES says that it also
+targets the AES instructions of the ARMv8 cryptography extension
+(e.g., -march=armv8-a+crypto), which ars.h and aes.h then use in
+place of AES-NI.  haveAESNI() checks for them at run-time.
+
 GNU_UINT128 says that it's safe to use __uint128_t, but it
 does not require its use.  In particular, it should be
 used in mulhilo<uint64_t> only if MULHILO64_ASM is unset.
@@ -121,6 +144,9 @@ The CXX11_SOME_FEATURE macros allow the code to use specific
 features of the C++11 language and library.  The catchall
 In the absence of a specific CXX11_SOME_FEATURE, the feature
 is controlled by the catch-all R123_USE_CXX11 macro.
+CXX11_TRIVIALLY_COPYABLE says that the library has
+std::is_trivially_copyable, which came later than the rest of
+<type_traits> (e.g., in gcc 5).
 
 U01_DOUBLE defaults on, and can be turned off (set to 0)
 if one does not want the utility functions that convert to double
@@ -241,6 +267,10 @@ added to each of the *features.h files, AND to examples/ut_features.cpp.
 #define R123_USE_CXX11_TYPE_TRAITS R123_USE_CXX11
 #endif
 
+#ifndef R123_USE_CXX11_TRIVIALLY_COPYABLE
+#define R123_USE_CXX11_TRIVIALLY_COPYABLE R123_USE_CXX11_TYPE_TRAITS
+#endif
+
 #ifndef R123_USE_CXX11_LONG_LONG
 #define R123_USE_CXX11_LONG_LONG R123_USE_CXX11
 #endif
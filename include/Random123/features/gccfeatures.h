@@ -102,6 +102,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define R123_USE_CXX11_TYPE_TRAITS ((GNUC_VERSION>=40400) && GNU_CXX11)
 #endif
 
+// std::is_trivially_copyable arrived in libstdc++ with gcc 5.
+#ifndef R123_USE_CXX11_TRIVIALLY_COPYABLE
+#define R123_USE_CXX11_TRIVIALLY_COPYABLE ((GNUC_VERSION>=50000) && GNU_CXX11)
+#endif
+
 #ifndef R123_USE_AES_NI
 #ifdef __AES__
 #define R123_USE_AES_NI 1
@@ -110,6 +115,54 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #endif
 
+#ifndef R123_USE_AVX512
+#ifdef __AVX512F__
+#define R123_USE_AVX512 1
+#else
+#define R123_USE_AVX512 0
+#endif
+#endif
+
+#ifndef R123_USE_AVX512IFMA
+#ifdef __AVX512IFMA__
+#define R123_USE_AVX512IFMA 1
+#else
+#define R123_USE_AVX512IFMA 0
+#endif
+#endif
+
+#ifndef R123_USE_VAES
+#ifdef __VAES__
+#define R123_USE_VAES 1
+#else
+#define R123_USE_VAES 0
+#endif
+#endif
+
+#ifndef R123_USE_NEON
+#ifdef __ARM_NEON
+#define R123_USE_NEON 1
+#else
+#define R123_USE_NEON 0
+#endif
+#endif
+
+#ifndef R123_USE_ARM_AES
+#if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+#define R123_USE_ARM_AES 1
+#else
+#define R123_USE_ARM_AES 0
+#endif
+#endif
+
+#ifndef R123_USE_AVX2
+#ifdef __AVX2__
+#define R123_USE_AVX2 1
+#else
+#define R123_USE_AVX2 0
+#endif
+#endif
+
 #ifndef R123_USE_SSE4_2
 #ifdef __SSE4_2__
 #define R123_USE_SSE4_2 1
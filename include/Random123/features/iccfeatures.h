@@ -83,6 +83,46 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // where the boolean expression might contain previously-defined R123_SOMETHING_ELSE
 // pp-symbols.
 
+#ifndef R123_USE_AVX512
+#ifdef __AVX512F__
+#define R123_USE_AVX512 1
+#else
+#define R123_USE_AVX512 0
+#endif
+#endif
+
+#ifndef R123_USE_AVX512IFMA
+#ifdef __AVX512IFMA__
+#define R123_USE_AVX512IFMA 1
+#else
+#define R123_USE_AVX512IFMA 0
+#endif
+#endif
+
+#ifndef R123_USE_VAES
+#ifdef __VAES__
+#define R123_USE_VAES 1
+#else
+#define R123_USE_VAES 0
+#endif
+#endif
+
+#ifndef R123_USE_NEON
+#define R123_USE_NEON 0
+#endif
+
+#ifndef R123_USE_ARM_AES
+#define R123_USE_ARM_AES 0
+#endif
+
+#ifndef R123_USE_AVX2
+#ifdef __AVX2__
+#define R123_USE_AVX2 1
+#else
+#define R123_USE_AVX2 0
+#endif
+#endif
+
 #ifndef R123_USE_SSE4_2
 #ifdef __SSE4_2__
 #define R123_USE_SSE4_2 1
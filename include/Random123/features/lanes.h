@@ -0,0 +1,668 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef _Random123_lanes_dot_h__
+#define _Random123_lanes_dot_h__
+
+#include "compilerfeatures.h"
+#include "sse.h"
+#include "neon.h"
+
+#if R123_USE_SSE || R123_USE_NEON
+#include <stddef.h>
+
+/* The _R_fill and _R_fill_soa functions of the multi-lane generators
+   write outputs of more than R123_FILL_STREAM_BYTES bytes with
+   non-temporal stores, so that a fill larger than the last-level
+   cache does not evict the caller's working set, provided the output
+   is aligned to the vector registers.  Smaller fills are left in the
+   cache, for the consumer.  The default, 8 MiB, may be overridden by
+   defining it before the first Random123 header is included. */
+#ifndef R123_FILL_STREAM_BYTES
+#define R123_FILL_STREAM_BYTES ((size_t)8 << 20)
+#endif
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* A thin layer of vectors of counter words, in which the multi-lane
+   Philox and Threefry kernels (philox.h and threefry.h) are written
+   once and instantiated for each instruction set.  A vector of type
+   _r123_TAG_t holds L words of W bits, one per lane, with:
+     _r123_set1_TAG(w)             broadcast
+     _r123_add_TAG, _r123_xor_TAG  wordwise arithmetic
+     _r123_rotl_TAG(v, n)          rotation left by 0 < n < W; n need
+                                   not be a constant
+     _r123_mulhilo_TAG(v, m, &hi)  mulhiloW of each word and m
+     _r123_load4_TAG(p, x)         transposes the L four-word counters
+     _r123_store4_TAG(x, p)        p[0..4L) to x[0..4), x[j] holding
+                                   word j of each, and back
+     _r123_iota_TAG()              the number of the counter in each
+                                   lane, after _r123_load4_TAG
+     _r123_iota4_TAG(c, x)         x = the counters c, c+1, ..., c+L-1,
+                                   as made by r123array4xW::incr, laid
+                                   out as by _r123_load4_TAG
+     _r123_loadu_TAG(p)            the words p[0..L), in order
+     _r123_storeu_TAG(p, v)
+     _r123_seq_TAG()               0, 1, ..., L-1, in order
+     _r123_seq4_TAG(c, x)          the counters c, c+1, ..., c+L-1 in
+                                   order, for output by columns
+     _r123_loadkey2_TAG(p, k)      as _r123_load4_TAG, for L keys of
+                                   two words, p[0..2L), to k[0..2)
+     _r123_stream4_TAG(x, p)       as _r123_store4_TAG and
+     _r123_stream_TAG(p, v)        _r123_storeu_TAG, but p must be
+                                   aligned to sizeof(_r123_TAG_t) and
+                                   the stores are non-temporal where
+                                   the instruction set has them
+     _r123_sfence()                orders the non-temporal stores
+   The lanes need not be in the order of the counters, so long as
+   _r123_load4_TAG, _r123_store4_TAG and _r123_iota_TAG agree.  The
+   tags, W and L are:
+     u32x4            SSE2 (R123_USE_SSE) or NEON (R123_USE_NEON)
+     u32x8, u64x4     AVX2 (R123_USE_AVX2)
+     u32x16, u64x8    AVX-512 (R123_USE_AVX512)
+   and _r123_mulhilo_u64x8ifma uses the AVX512IFMA instructions. */
+
+/* c += n, carrying from word 0 up, as r123array4xW::incr does. */
+#define _r123_add4xW_tpl(W)                                             \
+R123_STATIC_INLINE void _r123_add4x##W(uint##W##_t* c, uint##W##_t n){ \
+    c[0] += n;                                                          \
+    if(c[0] < n && ++c[1] == 0 && ++c[2] == 0)                          \
+        ++c[3];                                                         \
+}
+
+_r123_add4xW_tpl(32)
+_r123_add4xW_tpl(64)
+
+/* x = c, c+1, ..., c+L-1.  Unless word 0 carries, only it differs
+   from lane to lane; otherwise the counters are made one by one and
+   transposed. */
+#define _r123_iota4_tpl(W, L, TAG)                                      \
+R123_STATIC_INLINE void _r123_iota4_##TAG(const uint##W##_t* c, _r123_##TAG##_t* x){ \
+    if(R123_BUILTIN_EXPECT(c[0] <= (uint##W##_t)(~(uint##W##_t)0 - (L-1)), 1)){ \
+        x[0] = _r123_add_##TAG(_r123_set1_##TAG(c[0]), _r123_iota_##TAG()); \
+        x[1] = _r123_set1_##TAG(c[1]);                                  \
+        x[2] = _r123_set1_##TAG(c[2]);                                  \
+        x[3] = _r123_set1_##TAG(c[3]);                                  \
+    }else{                                                              \
+        uint##W##_t t[4*L];                                             \
+        unsigned int i;                                                 \
+        for(i=0; i<4*L; ++i)                                            \
+            t[i] = c[i%4];                                              \
+        for(i=1; i<L; ++i)                                              \
+            _r123_add4x##W(t+4*i, (uint##W##_t)i);                      \
+        _r123_load4_##TAG(t, x);                                        \
+    }                                                                   \
+}
+
+/* As _r123_iota4_TAG, but with counter i in lane i. */
+#define _r123_seq4_tpl(W, L, TAG)                                       \
+R123_STATIC_INLINE void _r123_seq4_##TAG(const uint##W##_t* c, _r123_##TAG##_t* x){ \
+    if(R123_BUILTIN_EXPECT(c[0] <= (uint##W##_t)(~(uint##W##_t)0 - (L-1)), 1)){ \
+        x[0] = _r123_add_##TAG(_r123_set1_##TAG(c[0]), _r123_seq_##TAG()); \
+        x[1] = _r123_set1_##TAG(c[1]);                                  \
+        x[2] = _r123_set1_##TAG(c[2]);                                  \
+        x[3] = _r123_set1_##TAG(c[3]);                                  \
+    }else{                                                              \
+        uint##W##_t t[4], col[4][L];                                    \
+        unsigned int i, j;                                              \
+        for(j=0; j<4; ++j)                                              \
+            t[j] = c[j];                                                \
+        for(i=0; i<L; ++i){                                             \
+            for(j=0; j<4; ++j)                                          \
+                col[j][i] = t[j];                                       \
+            _r123_add4x##W(t, 1);                                       \
+        }                                                               \
+        for(j=0; j<4; ++j)                                              \
+            x[j] = _r123_loadu_##TAG(col[j]);                           \
+    }                                                                   \
+}
+
+/* CBRNG##4x##W##_R_x##L(R, in, key, out) sets out[i] =
+   CBRNG##4x##W##_R(R, in[i], key) for i in [0, L), with KERNEL, the
+   rounds on x[0..4). */
+#define _r123_lanes4xW_tpl(CBRNG, W, L, TAG, KERNEL)                    \
+R123_STATIC_INLINE void CBRNG##4x##W##_R_x##L(unsigned int R, const CBRNG##4x##W##_ctr_t* in, CBRNG##4x##W##_key_t key, CBRNG##4x##W##_ctr_t* out){ \
+    _r123_##TAG##_t x[4];                                               \
+    _r123_load4_##TAG(in[0].v, x);                                      \
+    KERNEL(R, x, 1, key);                                               \
+    _r123_store4_##TAG(x, out[0].v);                                    \
+}
+
+/* k[0..2) = words 0 and 1 of the L two-word keys p[0..2L), laid out
+   as by _r123_load4_TAG, by way of four-word blocks on the stack. */
+#define _r123_loadkey2_tpl(W, L, TAG)                                   \
+R123_STATIC_INLINE void _r123_loadkey2_##TAG(const uint##W##_t* p, _r123_##TAG##_t* k){ \
+    uint##W##_t t[4*L];                                                 \
+    _r123_##TAG##_t u[4];                                               \
+    unsigned int i;                                                     \
+    for(i=0; i<L; ++i){                                                 \
+        t[4*i] = p[2*i];                                                \
+        t[4*i+1] = p[2*i+1];                                            \
+        t[4*i+2] = t[4*i+3] = 0;                                        \
+    }                                                                   \
+    _r123_load4_##TAG(t, u);                                            \
+    k[0] = u[0];                                                        \
+    k[1] = u[1];                                                        \
+}
+
+/* CBRNG##4x##W##_R_multikey(R, in, keys, out, n) sets out[i] =
+   CBRNG##4x##W##_R(R, in[i], keys[i]) for i in [0, n), with KERNEL,
+   the rounds with per-lane keys, on two groups of L counters at a
+   time.  The keys have KW = 2 or 4 words, and are moved to the
+   vectors by _r123_loadkeyKW_TAG;  _r123_loadkey4_TAG is
+   _r123_load4_TAG. */
+#define _r123_multikey4xW_tpl(CBRNG, W, L, TAG, KERNEL, KW)             \
+R123_STATIC_INLINE void CBRNG##4x##W##_R_multikey(unsigned int R, const CBRNG##4x##W##_ctr_t* in, const CBRNG##4x##W##_key_t* keys, CBRNG##4x##W##_ctr_t* out, size_t n){ \
+    size_t i = 0;                                                       \
+    for(; i+2*L<=n; i+=2*L){                                            \
+        _r123_##TAG##_t x[8], k[2*KW];                                  \
+        _r123_load4_##TAG(in[i].v, x);                                  \
+        _r123_load4_##TAG(in[i+L].v, x+4);                              \
+        _r123_loadkey##KW##_##TAG(keys[i].v, k);                        \
+        _r123_loadkey##KW##_##TAG(keys[i+L].v, k+KW);                   \
+        KERNEL(R, x, 2, k, 2);                                          \
+        _r123_store4_##TAG(x, out[i].v);                                \
+        _r123_store4_##TAG(x+4, out[i+L].v);                            \
+    }                                                                   \
+    if(i+L<=n){                                                         \
+        _r123_##TAG##_t x[4], k[KW];                                    \
+        _r123_load4_##TAG(in[i].v, x);                                  \
+        _r123_loadkey##KW##_##TAG(keys[i].v, k);                        \
+        KERNEL(R, x, 1, k, 1);                                          \
+        _r123_store4_##TAG(x, out[i].v);                                \
+        i += L;                                                         \
+    }                                                                   \
+    for(; i<n; ++i)                                                     \
+        out[i] = CBRNG##4x##W##_R(R, in[i], keys[i]);                   \
+}
+
+/* Whether p is aligned for _r123_stream4_TAG and _r123_stream_TAG. */
+#define _r123_aligned(p, TAG) (((uintptr_t)(p) & (sizeof(_r123_##TAG##_t)-1)) == 0)
+
+/* CBRNG##4x##W##_R_fill(R, c0, key, out, n) sets out[i] =
+   CBRNG##4x##W##_R(R, c0+i, key) for i in [0, n), making and
+   encrypting two groups of L counters at a time, interleaved.  Large
+   fills are written with non-temporal stores, after as many scalar
+   counters as it takes to align them. */
+#define _r123_fill4xW_tpl(CBRNG, W, L, TAG, KERNEL)                     \
+R123_STATIC_INLINE void CBRNG##4x##W##_R_fill(unsigned int R, CBRNG##4x##W##_ctr_t c0, CBRNG##4x##W##_key_t key, CBRNG##4x##W##_ctr_t* out, size_t n){ \
+    size_t i = 0, nv, nr;                                               \
+    int nt = 0;                                                         \
+    if(n > R123_FILL_STREAM_BYTES/sizeof(*out)){                        \
+        for(; i<n && i+1<sizeof(_r123_##TAG##_t)/sizeof(*out) && !_r123_aligned(out+i, TAG); ++i){ \
+            out[i] = CBRNG##4x##W##_R(R, c0, key);                      \
+            _r123_add4x##W(c0.v, 1);                                    \
+        }                                                               \
+        nt = _r123_aligned(out+i, TAG);                                 \
+    }                                                                   \
+    /* The trip counts are made once from n-i, so that the compiler */  \
+    /* can bound the tail by n. */                                      \
+    nv = (n-i)/(2*L);                                                   \
+    nr = (n-i)%(2*L);                                                   \
+    for(; nv; --nv, i+=2*L){                                            \
+        _r123_##TAG##_t x[8];                                           \
+        _r123_iota4_##TAG(c0.v, x);                                     \
+        _r123_add4x##W(c0.v, L);                                        \
+        _r123_iota4_##TAG(c0.v, x+4);                                   \
+        _r123_add4x##W(c0.v, L);                                        \
+        KERNEL(R, x, 2, key);                                           \
+        if(nt){                                                         \
+            _r123_stream4_##TAG(x, out[i].v);                           \
+            _r123_stream4_##TAG(x+4, out[i+L].v);                       \
+        }else{                                                          \
+            _r123_store4_##TAG(x, out[i].v);                            \
+            _r123_store4_##TAG(x+4, out[i+L].v);                        \
+        }                                                               \
+    }                                                                   \
+    if(nt)                                                              \
+        _r123_sfence();                                                 \
+    for(; nr; --nr, ++i){                                               \
+        out[i] = CBRNG##4x##W##_R(R, c0, key);                          \
+        _r123_add4x##W(c0.v, 1);                                        \
+    }                                                                   \
+}
+
+/* CBRNG##4x##W##_R_fill_soa(R, c0, key, out, n) sets out[j][i] to
+   word j of CBRNG##4x##W##_R(R, c0+i, key), storing the vectors of
+   the kernel as they are.  Large fills are streamed, as above, if
+   the columns are all aligned alike. */
+#define _r123_fill4xWsoa_tpl(CBRNG, W, L, TAG, KERNEL)                  \
+R123_STATIC_INLINE void CBRNG##4x##W##_R_fill_soa(unsigned int R, CBRNG##4x##W##_ctr_t c0, CBRNG##4x##W##_key_t key, uint##W##_t* const out[4], size_t n){ \
+    size_t i = 0;                                                       \
+    unsigned int j;                                                     \
+    int nt = 0;                                                         \
+    if(n > R123_FILL_STREAM_BYTES/sizeof(c0)){                          \
+        for(; i<n && i+1<L && !_r123_aligned(out[0]+i, TAG); ++i){      \
+            CBRNG##4x##W##_ctr_t r = CBRNG##4x##W##_R(R, c0, key);      \
+            for(j=0; j<4; ++j)                                          \
+                out[j][i] = r.v[j];                                     \
+            _r123_add4x##W(c0.v, 1);                                    \
+        }                                                               \
+        nt = 1;                                                         \
+        for(j=0; j<4; ++j)                                              \
+            nt = nt && _r123_aligned(out[j]+i, TAG);                    \
+    }                                                                   \
+    for(; i+2*L<=n; i+=2*L){                                            \
+        _r123_##TAG##_t x[8];                                           \
+        _r123_seq4_##TAG(c0.v, x);                                      \
+        _r123_add4x##W(c0.v, L);                                        \
+        _r123_seq4_##TAG(c0.v, x+4);                                    \
+        _r123_add4x##W(c0.v, L);                                        \
+        KERNEL(R, x, 2, key);                                           \
+        if(nt){                                                         \
+            for(j=0; j<4; ++j){                                         \
+                _r123_stream_##TAG(out[j]+i, x[j]);                     \
+                _r123_stream_##TAG(out[j]+i+L, x[4+j]);                 \
+            }                                                           \
+        }else{                                                          \
+            for(j=0; j<4; ++j){                                         \
+                _r123_storeu_##TAG(out[j]+i, x[j]);                     \
+                _r123_storeu_##TAG(out[j]+i+L, x[4+j]);                 \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+    if(nt)                                                              \
+        _r123_sfence();                                                 \
+    for(; i<n; ++i){                                                    \
+        CBRNG##4x##W##_ctr_t r = CBRNG##4x##W##_R(R, c0, key);          \
+        for(j=0; j<4; ++j)                                              \
+            out[j][i] = r.v[j];                                         \
+        _r123_add4x##W(c0.v, 1);                                        \
+    }                                                                   \
+}
+
+#if R123_USE_SSE
+/* The x86 operations on whole registers of type __I, with which the
+   multiplies and transposes below are written once for SSE2, AVX2
+   and AVX-512. */
+#define _r123_set1x64_m128i(w) _mm_set_epi64x((long long)(w), (long long)(w))
+#define _r123_mule_m128i(a, b) _mm_mul_epu32(a, b)
+#define _r123_and_m128i(a, b) _mm_and_si128(a, b)
+#define _r123_andnot_m128i(a, b) _mm_andnot_si128(a, b)
+#define _r123_or_m128i(a, b) _mm_or_si128(a, b)
+#define _r123_add64_m128i(a, b) _mm_add_epi64(a, b)
+#define _r123_srli64_m128i(v, n) _mm_srli_epi64(v, n)
+#define _r123_slli64_m128i(v, n) _mm_slli_epi64(v, n)
+#define _r123_unpacklo32_m128i(a, b) _mm_unpacklo_epi32(a, b)
+#define _r123_unpackhi32_m128i(a, b) _mm_unpackhi_epi32(a, b)
+#define _r123_unpacklo64_m128i(a, b) _mm_unpacklo_epi64(a, b)
+#define _r123_unpackhi64_m128i(a, b) _mm_unpackhi_epi64(a, b)
+#define _r123_loadu_m128i(p) _mm_loadu_si128((const __m128i*)(p))
+#define _r123_storeu_m128i(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#define _r123_stream_m128i(p, v) _mm_stream_si128((__m128i*)(p), v)
+#define _r123_sfence() _mm_sfence()
+#if R123_USE_AVX2
+#define _r123_set1x64_m256i(w) _mm256_set1_epi64x((long long)(w))
+#define _r123_mule_m256i(a, b) _mm256_mul_epu32(a, b)
+#define _r123_and_m256i(a, b) _mm256_and_si256(a, b)
+#define _r123_andnot_m256i(a, b) _mm256_andnot_si256(a, b)
+#define _r123_or_m256i(a, b) _mm256_or_si256(a, b)
+#define _r123_add64_m256i(a, b) _mm256_add_epi64(a, b)
+#define _r123_srli64_m256i(v, n) _mm256_srli_epi64(v, n)
+#define _r123_slli64_m256i(v, n) _mm256_slli_epi64(v, n)
+#define _r123_unpacklo32_m256i(a, b) _mm256_unpacklo_epi32(a, b)
+#define _r123_unpackhi32_m256i(a, b) _mm256_unpackhi_epi32(a, b)
+#define _r123_unpacklo64_m256i(a, b) _mm256_unpacklo_epi64(a, b)
+#define _r123_unpackhi64_m256i(a, b) _mm256_unpackhi_epi64(a, b)
+#define _r123_loadu_m256i(p) _mm256_loadu_si256((const __m256i*)(p))
+#define _r123_storeu_m256i(p, v) _mm256_storeu_si256((__m256i*)(p), v)
+#define _r123_stream_m256i(p, v) _mm256_stream_si256((__m256i*)(p), v)
+#endif
+#if R123_USE_AVX512
+#define _r123_set1x64_m512i(w) _mm512_set1_epi64((long long)(w))
+#define _r123_mule_m512i(a, b) _mm512_mul_epu32(a, b)
+#define _r123_and_m512i(a, b) _mm512_and_si512(a, b)
+#define _r123_andnot_m512i(a, b) _mm512_andnot_si512(a, b)
+#define _r123_or_m512i(a, b) _mm512_or_si512(a, b)
+#define _r123_add64_m512i(a, b) _mm512_add_epi64(a, b)
+#define _r123_srli64_m512i(v, n) _mm512_srli_epi64(v, n)
+#define _r123_slli64_m512i(v, n) _mm512_slli_epi64(v, n)
+#define _r123_unpacklo32_m512i(a, b) _mm512_unpacklo_epi32(a, b)
+#define _r123_unpackhi32_m512i(a, b) _mm512_unpackhi_epi32(a, b)
+#define _r123_unpacklo64_m512i(a, b) _mm512_unpacklo_epi64(a, b)
+#define _r123_unpackhi64_m512i(a, b) _mm512_unpackhi_epi64(a, b)
+#define _r123_loadu_m512i(p) _mm512_loadu_si512((const void*)(p))
+#define _r123_storeu_m512i(p, v) _mm512_storeu_si512((void*)(p), v)
+#define _r123_stream_m512i(p, v) _mm512_stream_si512((__m512i*)(p), v)
+#endif
+
+/* mulhilo32 with vpmuludq, which multiplies the even words:  the odd
+   words are shifted down to be multiplied, and the products shuffled
+   back together. */
+#define _r123_mulhilo32_epu32_tpl(TAG, I)                               \
+R123_STATIC_INLINE __##I _r123_mulhilo_##TAG(__##I a, uint32_t m, __##I* hip){ \
+    __##I mm = _r123_set1x64_##I(m);                                    \
+    __##I m32 = _r123_set1x64_##I(0xffffffff);                          \
+    __##I pe = _r123_mule_##I(a, mm);                                   \
+    __##I po = _r123_mule_##I(_r123_srli64_##I(a, 32), mm);             \
+    *hip = _r123_or_##I(_r123_srli64_##I(pe, 32), _r123_andnot_##I(m32, po)); \
+    return _r123_or_##I(_r123_and_##I(pe, m32), _r123_slli64_##I(po, 32)); \
+}
+
+/* mulhilo64 from the four 32x32->64-bit partial products. */
+#define _r123_mulhilo64_epu32_tpl(TAG, I)                               \
+R123_STATIC_INLINE __##I _r123_mulhilo_##TAG(__##I a, uint64_t m, __##I* hip){ \
+    __##I mlo = _r123_set1x64_##I(m&0xffffffff);                        \
+    __##I mhi = _r123_set1x64_##I(m>>32);                               \
+    __##I m32 = _r123_set1x64_##I(0xffffffff);                          \
+    __##I ah = _r123_srli64_##I(a, 32);                                 \
+    __##I ll = _r123_mule_##I(a, mlo);                                  \
+    __##I lh = _r123_mule_##I(a, mhi);                                  \
+    __##I hl = _r123_mule_##I(ah, mlo);                                 \
+    __##I hh = _r123_mule_##I(ah, mhi);                                 \
+    /* the middle column, which cannot overflow */                      \
+    __##I mid = _r123_add64_##I(_r123_srli64_##I(ll, 32),               \
+                _r123_add64_##I(_r123_and_##I(lh, m32), _r123_and_##I(hl, m32))); \
+    *hip = _r123_add64_##I(_r123_add64_##I(hh, _r123_srli64_##I(mid, 32)), \
+                           _r123_add64_##I(_r123_srli64_##I(lh, 32), _r123_srli64_##I(hl, 32))); \
+    return _r123_or_##I(_r123_slli64_##I(mid, 32), _r123_and_##I(ll, m32)); \
+}
+
+/* The counters of four words are transposed within each 128-bit
+   part of the registers, leaving counter (L/4)*m+k in element m of
+   part k, in the order given by _r123_iota_TAG. */
+#define _r123_transpose4x32_tpl(I)                                      \
+R123_STATIC_INLINE void _r123_transpose4x32_##I(__##I* x){              \
+    __##I t0 = _r123_unpacklo32_##I(x[0], x[1]);                        \
+    __##I t1 = _r123_unpackhi32_##I(x[0], x[1]);                        \
+    __##I t2 = _r123_unpacklo32_##I(x[2], x[3]);                        \
+    __##I t3 = _r123_unpackhi32_##I(x[2], x[3]);                        \
+    x[0] = _r123_unpacklo64_##I(t0, t2);                                \
+    x[1] = _r123_unpackhi64_##I(t0, t2);                                \
+    x[2] = _r123_unpacklo64_##I(t1, t3);                                \
+    x[3] = _r123_unpackhi64_##I(t1, t3);                                \
+}
+
+/* _r123_store4_TAG and _r123_stream4_TAG, from _r123_aos4_TAG(x, t),
+   which transposes x to the four registers t of whole counters that
+   are stored, in order, at p. */
+#define _r123_out4_tpl(W, L, TAG, I)                                    \
+R123_STATIC_INLINE void _r123_store4_##TAG(const __##I* x, uint##W##_t* p){ \
+    __##I t[4];                                                         \
+    _r123_aos4_##TAG(x, t);                                             \
+    _r123_storeu_##I(p, t[0]);                                          \
+    _r123_storeu_##I(p+L, t[1]);                                        \
+    _r123_storeu_##I(p+2*L, t[2]);                                      \
+    _r123_storeu_##I(p+3*L, t[3]);                                      \
+}                                                                       \
+R123_STATIC_INLINE void _r123_stream4_##TAG(const __##I* x, uint##W##_t* p){ \
+    __##I t[4];                                                         \
+    _r123_aos4_##TAG(x, t);                                             \
+    _r123_stream_##I(p, t[0]);                                          \
+    _r123_stream_##I(p+L, t[1]);                                        \
+    _r123_stream_##I(p+2*L, t[2]);                                      \
+    _r123_stream_##I(p+3*L, t[3]);                                      \
+}
+
+#define _r123_io4x32_tpl(TAG, L, I)                                     \
+R123_STATIC_INLINE void _r123_load4_##TAG(const uint32_t* p, __##I* x){ \
+    x[0] = _r123_loadu_##I(p);                                          \
+    x[1] = _r123_loadu_##I(p+L);                                        \
+    x[2] = _r123_loadu_##I(p+2*L);                                      \
+    x[3] = _r123_loadu_##I(p+3*L);                                      \
+    _r123_transpose4x32_##I(x);                                         \
+}                                                                       \
+R123_STATIC_INLINE void _r123_aos4_##TAG(const __##I* x, __##I* t){    \
+    t[0] = x[0];                                                        \
+    t[1] = x[1];                                                        \
+    t[2] = x[2];                                                        \
+    t[3] = x[3];                                                        \
+    _r123_transpose4x32_##I(t);                                         \
+}                                                                       \
+_r123_out4_tpl(32, L, TAG, I)
+
+typedef __m128i _r123_u32x4_t;
+R123_STATIC_INLINE __m128i _r123_set1_u32x4(uint32_t w){ return _mm_set1_epi32((int)w); }
+R123_STATIC_INLINE __m128i _r123_add_u32x4(__m128i a, __m128i b){ return _mm_add_epi32(a, b); }
+R123_STATIC_INLINE __m128i _r123_xor_u32x4(__m128i a, __m128i b){ return _mm_xor_si128(a, b); }
+R123_STATIC_INLINE __m128i _r123_rotl_u32x4(__m128i a, int n){
+    return _mm_or_si128(_mm_sll_epi32(a, _mm_cvtsi32_si128(n)), _mm_srl_epi32(a, _mm_cvtsi32_si128(32-n)));
+}
+R123_STATIC_INLINE __m128i _r123_iota_u32x4(void){ return _mm_set_epi32(3, 2, 1, 0); }
+R123_STATIC_INLINE __m128i _r123_seq_u32x4(void){ return _mm_set_epi32(3, 2, 1, 0); }
+R123_STATIC_INLINE __m128i _r123_loadu_u32x4(const uint32_t* p){ return _r123_loadu_m128i(p); }
+R123_STATIC_INLINE void _r123_storeu_u32x4(uint32_t* p, __m128i v){ _r123_storeu_m128i(p, v); }
+R123_STATIC_INLINE void _r123_stream_u32x4(uint32_t* p, __m128i v){ _r123_stream_m128i(p, v); }
+_r123_mulhilo32_epu32_tpl(u32x4, m128i)
+_r123_transpose4x32_tpl(m128i)
+_r123_io4x32_tpl(u32x4, 4, m128i)
+_r123_iota4_tpl(32, 4, u32x4)
+_r123_seq4_tpl(32, 4, u32x4)
+_r123_loadkey2_tpl(32, 4, u32x4)
+#define _r123_loadkey4_u32x4 _r123_load4_u32x4
+
+#if R123_USE_AVX2
+typedef __m256i _r123_u32x8_t;
+R123_STATIC_INLINE __m256i _r123_set1_u32x8(uint32_t w){ return _mm256_set1_epi32((int)w); }
+R123_STATIC_INLINE __m256i _r123_add_u32x8(__m256i a, __m256i b){ return _mm256_add_epi32(a, b); }
+R123_STATIC_INLINE __m256i _r123_xor_u32x8(__m256i a, __m256i b){ return _mm256_xor_si256(a, b); }
+R123_STATIC_INLINE __m256i _r123_rotl_u32x8(__m256i a, int n){
+    return _mm256_or_si256(_mm256_sll_epi32(a, _mm_cvtsi32_si128(n)), _mm256_srl_epi32(a, _mm_cvtsi32_si128(32-n)));
+}
+R123_STATIC_INLINE __m256i _r123_iota_u32x8(void){ return _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0); }
+R123_STATIC_INLINE __m256i _r123_seq_u32x8(void){ return _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0); }
+R123_STATIC_INLINE __m256i _r123_loadu_u32x8(const uint32_t* p){ return _r123_loadu_m256i(p); }
+R123_STATIC_INLINE void _r123_storeu_u32x8(uint32_t* p, __m256i v){ _r123_storeu_m256i(p, v); }
+R123_STATIC_INLINE void _r123_stream_u32x8(uint32_t* p, __m256i v){ _r123_stream_m256i(p, v); }
+_r123_mulhilo32_epu32_tpl(u32x8, m256i)
+_r123_transpose4x32_tpl(m256i)
+_r123_io4x32_tpl(u32x8, 8, m256i)
+_r123_iota4_tpl(32, 8, u32x8)
+_r123_seq4_tpl(32, 8, u32x8)
+_r123_loadkey2_tpl(32, 8, u32x8)
+#define _r123_loadkey4_u32x8 _r123_load4_u32x8
+
+typedef __m256i _r123_u64x4_t;
+R123_STATIC_INLINE __m256i _r123_set1_u64x4(uint64_t w){ return _mm256_set1_epi64x((long long)w); }
+R123_STATIC_INLINE __m256i _r123_add_u64x4(__m256i a, __m256i b){ return _mm256_add_epi64(a, b); }
+R123_STATIC_INLINE __m256i _r123_xor_u64x4(__m256i a, __m256i b){ return _mm256_xor_si256(a, b); }
+R123_STATIC_INLINE __m256i _r123_rotl_u64x4(__m256i a, int n){
+    return _mm256_or_si256(_mm256_sll_epi64(a, _mm_cvtsi32_si128(n)), _mm256_srl_epi64(a, _mm_cvtsi32_si128(64-n)));
+}
+R123_STATIC_INLINE __m256i _r123_iota_u64x4(void){ return _mm256_set_epi64x(3, 2, 1, 0); }
+#define _r123_seq_u64x4 _r123_iota_u64x4
+R123_STATIC_INLINE __m256i _r123_loadu_u64x4(const uint64_t* p){ return _r123_loadu_m256i(p); }
+R123_STATIC_INLINE void _r123_storeu_u64x4(uint64_t* p, __m256i v){ _r123_storeu_m256i(p, v); }
+R123_STATIC_INLINE void _r123_stream_u64x4(uint64_t* p, __m256i v){ _r123_stream_m256i(p, v); }
+_r123_mulhilo64_epu32_tpl(u64x4, m256i)
+/* One counter per register, transposed as 2x2 blocks of 128 bits. */
+R123_STATIC_INLINE void _r123_transpose4x64_m256i(__m256i* x){
+    __m256i t0 = _mm256_unpacklo_epi64(x[0], x[1]);
+    __m256i t1 = _mm256_unpackhi_epi64(x[0], x[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(x[2], x[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(x[2], x[3]);
+    x[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    x[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    x[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    x[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+R123_STATIC_INLINE void _r123_load4_u64x4(const uint64_t* p, __m256i* x){
+    x[0] = _r123_loadu_m256i(p);
+    x[1] = _r123_loadu_m256i(p+4);
+    x[2] = _r123_loadu_m256i(p+8);
+    x[3] = _r123_loadu_m256i(p+12);
+    _r123_transpose4x64_m256i(x);
+}
+R123_STATIC_INLINE void _r123_aos4_u64x4(const __m256i* x, __m256i* t){
+    t[0] = x[0];
+    t[1] = x[1];
+    t[2] = x[2];
+    t[3] = x[3];
+    _r123_transpose4x64_m256i(t);
+}
+_r123_out4_tpl(64, 4, u64x4, m256i)
+_r123_iota4_tpl(64, 4, u64x4)
+_r123_seq4_tpl(64, 4, u64x4)
+_r123_loadkey2_tpl(64, 4, u64x4)
+#define _r123_loadkey4_u64x4 _r123_load4_u64x4
+#endif /* R123_USE_AVX2 */
+
+#if R123_USE_AVX512
+typedef __m512i _r123_u32x16_t;
+R123_STATIC_INLINE __m512i _r123_set1_u32x16(uint32_t w){ return _mm512_set1_epi32((int)w); }
+R123_STATIC_INLINE __m512i _r123_add_u32x16(__m512i a, __m512i b){ return _mm512_add_epi32(a, b); }
+R123_STATIC_INLINE __m512i _r123_xor_u32x16(__m512i a, __m512i b){ return _mm512_xor_si512(a, b); }
+R123_STATIC_INLINE __m512i _r123_rotl_u32x16(__m512i a, int n){ return _mm512_rolv_epi32(a, _mm512_set1_epi32(n)); }
+R123_STATIC_INLINE __m512i _r123_iota_u32x16(void){ return _mm512_set_epi32(15, 11, 7, 3, 14, 10, 6, 2, 13, 9, 5, 1, 12, 8, 4, 0); }
+R123_STATIC_INLINE __m512i _r123_seq_u32x16(void){ return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0); }
+R123_STATIC_INLINE __m512i _r123_loadu_u32x16(const uint32_t* p){ return _r123_loadu_m512i(p); }
+R123_STATIC_INLINE void _r123_storeu_u32x16(uint32_t* p, __m512i v){ _r123_storeu_m512i(p, v); }
+R123_STATIC_INLINE void _r123_stream_u32x16(uint32_t* p, __m512i v){ _r123_stream_m512i(p, v); }
+_r123_mulhilo32_epu32_tpl(u32x16, m512i)
+_r123_transpose4x32_tpl(m512i)
+_r123_io4x32_tpl(u32x16, 16, m512i)
+_r123_iota4_tpl(32, 16, u32x16)
+_r123_seq4_tpl(32, 16, u32x16)
+_r123_loadkey2_tpl(32, 16, u32x16)
+#define _r123_loadkey4_u32x16 _r123_load4_u32x16
+
+typedef __m512i _r123_u64x8_t;
+R123_STATIC_INLINE __m512i _r123_set1_u64x8(uint64_t w){ return _mm512_set1_epi64((long long)w); }
+R123_STATIC_INLINE __m512i _r123_add_u64x8(__m512i a, __m512i b){ return _mm512_add_epi64(a, b); }
+R123_STATIC_INLINE __m512i _r123_xor_u64x8(__m512i a, __m512i b){ return _mm512_xor_si512(a, b); }
+R123_STATIC_INLINE __m512i _r123_rotl_u64x8(__m512i a, int n){ return _mm512_rolv_epi64(a, _mm512_set1_epi64(n)); }
+R123_STATIC_INLINE __m512i _r123_iota_u64x8(void){ return _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0); }
+#define _r123_seq_u64x8 _r123_iota_u64x8
+R123_STATIC_INLINE __m512i _r123_loadu_u64x8(const uint64_t* p){ return _r123_loadu_m512i(p); }
+R123_STATIC_INLINE void _r123_storeu_u64x8(uint64_t* p, __m512i v){ _r123_storeu_m512i(p, v); }
+R123_STATIC_INLINE void _r123_stream_u64x8(uint64_t* p, __m512i v){ _r123_stream_m512i(p, v); }
+_r123_mulhilo64_epu32_tpl(u64x8, m512i)
+#if R123_USE_AVX512IFMA
+/* mulhilo64 from 52x52->104-bit multiply-adds on the multiplier split
+   as m = m0 + m1*2^52. */
+R123_STATIC_INLINE __m512i _r123_mulhilo_u64x8ifma(__m512i a, uint64_t m, __m512i* hip){
+    const uint64_t m52 = (R123_64BIT(1)<<52) - 1;
+    __m512i m0 = _mm512_set1_epi64((long long)(m&m52));
+    __m512i m1 = _mm512_set1_epi64((long long)(m>>52));
+    __m512i z = _mm512_setzero_si512();
+    __m512i a0 = _mm512_and_si512(a, _mm512_set1_epi64((long long)m52));
+    __m512i a1 = _mm512_srli_epi64(a, 52);
+    /* a*m = l + t*2^52 + u*2^104, with l < 2^52, t < 3*2^52, u < 2^25 */
+    __m512i l = _mm512_madd52lo_epu64(z, a0, m0);
+    __m512i t = _mm512_madd52lo_epu64(_mm512_madd52lo_epu64(_mm512_madd52hi_epu64(z, a0, m0), a0, m1), a1, m0);
+    __m512i u = _mm512_madd52lo_epu64(_mm512_madd52hi_epu64(_mm512_madd52hi_epu64(z, a0, m1), a1, m0), a1, m1);
+    *hip = _mm512_add_epi64(_mm512_srli_epi64(t, 12), _mm512_slli_epi64(u, 40));
+    return _mm512_or_si512(l, _mm512_slli_epi64(t, 52));
+}
+#endif
+R123_STATIC_INLINE void _r123_load4_u64x8(const uint64_t* p, __m512i* x){
+    __m512i a = _mm512_loadu_si512((const void*)p);
+    __m512i b = _mm512_loadu_si512((const void*)(p+8));
+    __m512i c = _mm512_loadu_si512((const void*)(p+16));
+    __m512i d = _mm512_loadu_si512((const void*)(p+24));
+    /* words 0 and 1, and 2 and 3, of counters 0-3 and 4-7 */
+    __m512i i01 = _mm512_set_epi64(13, 9, 5, 1, 12, 8, 4, 0);
+    __m512i i23 = _mm512_set_epi64(15, 11, 7, 3, 14, 10, 6, 2);
+    __m512i ab01 = _mm512_permutex2var_epi64(a, i01, b);
+    __m512i ab23 = _mm512_permutex2var_epi64(a, i23, b);
+    __m512i cd01 = _mm512_permutex2var_epi64(c, i01, d);
+    __m512i cd23 = _mm512_permutex2var_epi64(c, i23, d);
+    __m512i ilo = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+    __m512i ihi = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+    x[0] = _mm512_permutex2var_epi64(ab01, ilo, cd01);
+    x[1] = _mm512_permutex2var_epi64(ab01, ihi, cd01);
+    x[2] = _mm512_permutex2var_epi64(ab23, ilo, cd23);
+    x[3] = _mm512_permutex2var_epi64(ab23, ihi, cd23);
+}
+R123_STATIC_INLINE void _r123_aos4_u64x8(const __m512i* x, __m512i* t){
+    /* x[0] and x[1], and x[2] and x[3], interleaved, for counters
+       0-3 and 4-7 */
+    __m512i ilo = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    __m512i ihi = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+    __m512i p01lo = _mm512_permutex2var_epi64(x[0], ilo, x[1]);
+    __m512i p23lo = _mm512_permutex2var_epi64(x[2], ilo, x[3]);
+    __m512i p01hi = _mm512_permutex2var_epi64(x[0], ihi, x[1]);
+    __m512i p23hi = _mm512_permutex2var_epi64(x[2], ihi, x[3]);
+    __m512i i0 = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+    __m512i i1 = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+    t[0] = _mm512_permutex2var_epi64(p01lo, i0, p23lo);
+    t[1] = _mm512_permutex2var_epi64(p01lo, i1, p23lo);
+    t[2] = _mm512_permutex2var_epi64(p01hi, i0, p23hi);
+    t[3] = _mm512_permutex2var_epi64(p01hi, i1, p23hi);
+}
+_r123_out4_tpl(64, 8, u64x8, m512i)
+_r123_iota4_tpl(64, 8, u64x8)
+_r123_seq4_tpl(64, 8, u64x8)
+_r123_loadkey2_tpl(64, 8, u64x8)
+#define _r123_loadkey4_u64x8 _r123_load4_u64x8
+#endif /* R123_USE_AVX512 */
+
+#elif R123_USE_NEON
+typedef uint32x4_t _r123_u32x4_t;
+R123_STATIC_INLINE uint32x4_t _r123_set1_u32x4(uint32_t w){ return vdupq_n_u32(w); }
+R123_STATIC_INLINE uint32x4_t _r123_add_u32x4(uint32x4_t a, uint32x4_t b){ return vaddq_u32(a, b); }
+R123_STATIC_INLINE uint32x4_t _r123_xor_u32x4(uint32x4_t a, uint32x4_t b){ return veorq_u32(a, b); }
+/* vshlq_u32 shifts right by negative counts. */
+R123_STATIC_INLINE uint32x4_t _r123_rotl_u32x4(uint32x4_t a, int n){
+    return vorrq_u32(vshlq_u32(a, vdupq_n_s32(n)), vshlq_u32(a, vdupq_n_s32(n-32)));
+}
+R123_STATIC_INLINE uint32x4_t _r123_iota_u32x4(void){
+    static const uint32_t iota[4] = {0, 1, 2, 3};
+    return vld1q_u32(iota);
+}
+#define _r123_seq_u32x4 _r123_iota_u32x4
+R123_STATIC_INLINE uint32x4_t _r123_loadu_u32x4(const uint32_t* p){ return vld1q_u32(p); }
+R123_STATIC_INLINE void _r123_storeu_u32x4(uint32_t* p, uint32x4_t v){ vst1q_u32(p, v); }
+R123_STATIC_INLINE uint32x4_t _r123_mulhilo_u32x4(uint32x4_t a, uint32_t m, uint32x4_t* hip){
+    uint32x2_t m2 = vdup_n_u32(m);
+    uint64x2_t plo = vmull_u32(vget_low_u32(a), m2);
+    uint64x2_t phi = vmull_u32(vget_high_u32(a), m2);
+    *hip = vcombine_u32(vshrn_n_u64(plo, 32), vshrn_n_u64(phi, 32));
+    return vmulq_u32(a, vdupq_n_u32(m));
+}
+R123_STATIC_INLINE void _r123_load4_u32x4(const uint32_t* p, uint32x4_t* x){
+    uint32x4x4_t t = vld4q_u32(p);
+    x[0] = t.val[0];
+    x[1] = t.val[1];
+    x[2] = t.val[2];
+    x[3] = t.val[3];
+}
+R123_STATIC_INLINE void _r123_store4_u32x4(const uint32x4_t* x, uint32_t* p){
+    uint32x4x4_t t;
+    t.val[0] = x[0];
+    t.val[1] = x[1];
+    t.val[2] = x[2];
+    t.val[3] = x[3];
+    vst4q_u32(p, t);
+}
+/* There are no non-temporal stores in the NEON intrinsics. */
+#define _r123_stream4_u32x4 _r123_store4_u32x4
+#define _r123_stream_u32x4 _r123_storeu_u32x4
+#define _r123_sfence() ((void)0)
+_r123_iota4_tpl(32, 4, u32x4)
+_r123_seq4_tpl(32, 4, u32x4)
+_r123_loadkey2_tpl(32, 4, u32x4)
+#define _r123_loadkey4_u32x4 _r123_load4_u32x4
+#endif /* R123_USE_SSE, R123_USE_NEON */
+/** \endcond */
+
+#endif /* R123_USE_SSE || R123_USE_NEON */
+
+#endif /* _Random123_lanes_dot_h__ */
@@ -92,6 +92,50 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #endif
 
+#ifndef R123_USE_AVX512
+#ifdef __AVX512F__
+#define R123_USE_AVX512 1
+#else
+#define R123_USE_AVX512 0
+#endif
+#endif
+
+#ifndef R123_USE_AVX512IFMA
+#ifdef __AVX512IFMA__
+#define R123_USE_AVX512IFMA 1
+#else
+#define R123_USE_AVX512IFMA 0
+#endif
+#endif
+
+#ifndef R123_USE_VAES
+#ifdef __VAES__
+#define R123_USE_VAES 1
+#else
+#define R123_USE_VAES 0
+#endif
+#endif
+
+#ifndef R123_USE_NEON
+#ifdef _M_ARM64
+#define R123_USE_NEON 1
+#else
+#define R123_USE_NEON 0
+#endif
+#endif
+
+#ifndef R123_USE_ARM_AES
+#define R123_USE_ARM_AES 0
+#endif
+
+#ifndef R123_USE_AVX2
+#ifdef __AVX2__
+#define R123_USE_AVX2 1
+#else
+#define R123_USE_AVX2 0
+#endif
+#endif
+
 #ifndef R123_USE_SSE4_2
 #if defined(_M_X64)
 #define R123_USE_SSE4_2 1
@@ -0,0 +1,155 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef _Random123_neon_dot_h__
+#define _Random123_neon_dot_h__
+
+/* The ARM counterpart of sse.h:  r123m128i (and hence r123array1xm128i)
+   holding a NEON uint64x2_t, and haveAESNI() reporting whether the
+   ARMv8 AES instructions used by ars.h and aes.h are available. */
+#if R123_USE_NEON && !R123_USE_SSE
+
+#include <arm_neon.h>
+#if R123_USE_ARM_AES && defined(__linux__) && defined(__aarch64__)
+#include <sys/auxv.h>
+#endif
+#ifdef __cplusplus
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#endif
+
+R123_STATIC_INLINE int haveAESNI(){
+#if R123_USE_ARM_AES && defined(__linux__) && defined(__aarch64__) && defined(HWCAP_AES)
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+    /* Without a portable run-time check, trust the compiler's target. */
+    return R123_USE_ARM_AES;
+#endif
+}
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* The NEON spelling of _mm_set_epi64x. */
+R123_STATIC_INLINE uint64x2_t _r123_neon_set_u64(uint64_t hi, uint64_t lo){
+    return vcombine_u64(vcreate_u64(lo), vcreate_u64(hi));
+}
+/** \endcond */
+
+#ifdef __cplusplus
+
+struct r123m128i{
+    uint64x2_t m;
+#if R123_USE_CXX11_UNRESTRICTED_UNIONS
+    r123m128i() = default;
+    r123m128i(uint64x2_t _m): m(_m){}
+#endif
+    r123m128i& operator=(const uint64x2_t& rhs){ m=rhs; return *this;}
+    r123m128i& operator=(R123_ULONG_LONG n){ m = _r123_neon_set_u64(0, n); return *this;}
+#if R123_USE_CXX11_EXPLICIT_CONVERSIONS
+    explicit operator bool() const {return _bool();}
+#else
+    operator const void*() const{return _bool()?this:0;}
+#endif
+    operator uint64x2_t() const {return m;}
+
+private:
+    bool _bool() const{ return (vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1)) != 0; }
+};
+
+R123_STATIC_INLINE r123m128i& operator++(r123m128i& v){
+    uint64x2_t& c = v.m;
+    c = vaddq_u64(c, _r123_neon_set_u64(0, 1));
+    if( R123_BUILTIN_EXPECT(vgetq_lane_u64(c, 0) == 0, 0) )
+        c = vaddq_u64(c, _r123_neon_set_u64(1, 0));
+    return v;
+}
+
+R123_STATIC_INLINE r123m128i& operator+=(r123m128i& lhs, R123_ULONG_LONG n){ 
+    uint64x2_t c = vaddq_u64(lhs.m, _r123_neon_set_u64(0, n));
+    if(vgetq_lane_u64(c, 0) < n)
+        c = vaddq_u64(c, _r123_neon_set_u64(1, 0));
+    lhs.m = c;
+    return lhs; 
+}
+
+// As in sse.h, the comparisons are declared only to keep them from
+// being done through the conversion to void*.
+R123_STATIC_INLINE bool operator<=(R123_ULONG_LONG, const r123m128i &){
+    throw std::runtime_error("operator<=(unsigned long long, r123m128i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<(const r123m128i&, const r123m128i&){
+    throw std::runtime_error("operator<(r123m128i, r123m128i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<=(const r123m128i&, const r123m128i&){
+    throw std::runtime_error("operator<=(r123m128i, r123m128i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>(const r123m128i&, const r123m128i&){
+    throw std::runtime_error("operator>(r123m128i, r123m128i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>=(const r123m128i&, const r123m128i&){
+    throw std::runtime_error("operator>=(r123m128i, r123m128i) is unimplemented.");}
+
+R123_STATIC_INLINE bool operator==(const r123m128i &lhs, const r123m128i &rhs){ 
+    return vgetq_lane_u64(lhs.m, 0) == vgetq_lane_u64(rhs.m, 0) &&
+           vgetq_lane_u64(lhs.m, 1) == vgetq_lane_u64(rhs.m, 1); }
+R123_STATIC_INLINE bool operator!=(const r123m128i &lhs, const r123m128i &rhs){ 
+    return !(lhs==rhs);}
+R123_STATIC_INLINE bool operator==(R123_ULONG_LONG lhs, const r123m128i &rhs){
+    r123m128i LHS; LHS.m=_r123_neon_set_u64(0, lhs); return LHS == rhs; }
+R123_STATIC_INLINE bool operator!=(R123_ULONG_LONG lhs, const r123m128i &rhs){
+    return !(lhs==rhs);}
+R123_STATIC_INLINE std::ostream& operator<<(std::ostream& os, const r123m128i& m){
+    return os << (uint64_t)vgetq_lane_u64(m.m, 0) << " " << (uint64_t)vgetq_lane_u64(m.m, 1);
+}
+
+R123_STATIC_INLINE std::istream& operator>>(std::istream& is, r123m128i& m){
+    uint64_t u64[2];
+    is >> u64[0] >> u64[1];
+    m.m = _r123_neon_set_u64(u64[1], u64[0]);
+    return is;
+}
+
+template<typename T> inline T assemble_from_u32(uint32_t *p32); // forward declaration
+
+template <>
+inline r123m128i assemble_from_u32<r123m128i>(uint32_t *p32){
+    r123m128i ret;
+    ret.m = vreinterpretq_u64_u32(vld1q_u32(p32));
+    return ret;
+}
+
+#else
+
+typedef struct {
+    uint64x2_t m;
+} r123m128i;
+
+#endif /* __cplusplus */
+
+#endif /* R123_USE_NEON && !R123_USE_SSE */
+
+#endif /* _Random123_neon_dot_h__ */
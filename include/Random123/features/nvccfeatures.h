@@ -56,6 +56,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define R123_USE_AES_NI 0
 #endif
 
+#ifndef R123_USE_AVX512
+#define R123_USE_AVX512 0
+#endif
+
+#ifndef R123_USE_AVX512IFMA
+#define R123_USE_AVX512IFMA 0
+#endif
+
+#ifndef R123_USE_VAES
+#define R123_USE_VAES 0
+#endif
+
+#ifndef R123_USE_NEON
+#define R123_USE_NEON 0
+#endif
+
+#ifndef R123_USE_ARM_AES
+#define R123_USE_ARM_AES 0
+#endif
+
+#ifndef R123_USE_AVX2
+#define R123_USE_AVX2 0
+#endif
+
 #ifndef R123_USE_SSE4_2
 #define R123_USE_SSE4_2 0
 #endif
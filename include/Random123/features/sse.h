@@ -260,15 +260,211 @@ inline r123m128i assemble_from_u32<r123m128i>(uint32_t *p32){
     return ret;
 }
 
+/* r123m256i and r123m512i are to __m256i and __m512i what r123m128i
+   is to __m128i:  256- and 512-bit unsigned integers, whose 64-bit
+   words are in little-endian order, with the operations that
+   r123array1xm256i and r123array1xm512i need.  Carries out of the
+   low word are rare, so they take the slow path through memory. */
+/** \cond HIDDEN_FROM_DOXYGEN */
+R123_STATIC_INLINE void _r123_carry_u64(uint64_t *u, size_t n){
+    for(size_t i=1; i<n; ++i)
+        if(++u[i] != 0)
+            break;
+}
+/** \endcond */
+
+#if R123_USE_AVX2
+struct r123m256i{
+    __m256i m;
+#if R123_USE_CXX11_UNRESTRICTED_UNIONS
+    r123m256i() = default;
+    r123m256i(__m256i _m): m(_m){}
+#endif
+    r123m256i& operator=(const __m256i& rhs){ m=rhs; return *this;}
+    r123m256i& operator=(R123_ULONG_LONG n){ m = _mm256_set_epi64x(0, 0, 0, n); return *this;}
+#if R123_USE_CXX11_EXPLICIT_CONVERSIONS
+    explicit operator bool() const {return _bool();}
+#else
+    operator const void*() const{return _bool()?this:0;}
+#endif
+    operator __m256i() const {return m;}
+
+private:
+    bool _bool() const{ return !_mm256_testz_si256(m,m); }
+};
+
+R123_STATIC_INLINE r123m256i& operator+=(r123m256i& lhs, R123_ULONG_LONG n){
+    __m256i c = _mm256_add_epi64(lhs.m, _mm256_set_epi64x(0, 0, 0, n));
+    if( R123_BUILTIN_EXPECT(_mm_extract_lo64(_mm256_castsi256_si128(c)) < (uint64_t)n, 0) ){
+        union{
+            uint64_t u64[4];
+            __m256i m;
+        }u;
+        _mm256_storeu_si256(&u.m, c);
+        _r123_carry_u64(u.u64, 4);
+        c = _mm256_loadu_si256(&u.m);
+    }
+    lhs.m = c;
+    return lhs;
+}
+
+R123_STATIC_INLINE r123m256i& operator++(r123m256i& v){
+    return v += 1;
+}
+
+// As with r123m128i, the comparisons throw rather than let M1 < M2
+// compile to a comparison of void*s.
+R123_STATIC_INLINE bool operator<=(R123_ULONG_LONG, const r123m256i &){
+    throw std::runtime_error("operator<=(unsigned long long, r123m256i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<(const r123m256i&, const r123m256i&){
+    throw std::runtime_error("operator<(r123m256i, r123m256i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<=(const r123m256i&, const r123m256i&){
+    throw std::runtime_error("operator<=(r123m256i, r123m256i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>(const r123m256i&, const r123m256i&){
+    throw std::runtime_error("operator>(r123m256i, r123m256i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>=(const r123m256i&, const r123m256i&){
+    throw std::runtime_error("operator>=(r123m256i, r123m256i) is unimplemented.");}
+
+R123_STATIC_INLINE bool operator==(const r123m256i &lhs, const r123m256i &rhs){
+    __m256i x = _mm256_xor_si256(lhs.m, rhs.m);
+    return _mm256_testz_si256(x, x); }
+R123_STATIC_INLINE bool operator!=(const r123m256i &lhs, const r123m256i &rhs){
+    return !(lhs==rhs);}
+R123_STATIC_INLINE bool operator==(R123_ULONG_LONG lhs, const r123m256i &rhs){
+    r123m256i LHS; LHS.m=_mm256_set_epi64x(0, 0, 0, lhs); return LHS == rhs; }
+R123_STATIC_INLINE bool operator!=(R123_ULONG_LONG lhs, const r123m256i &rhs){
+    return !(lhs==rhs);}
+R123_STATIC_INLINE std::ostream& operator<<(std::ostream& os, const r123m256i& m){
+    union{
+        uint64_t u64[4];
+        __m256i m;
+    }u;
+    _mm256_storeu_si256(&u.m, m.m);
+    return os << u.u64[0] << " " << u.u64[1] << " " << u.u64[2] << " " << u.u64[3];
+}
+
+R123_STATIC_INLINE std::istream& operator>>(std::istream& is, r123m256i& m){
+    uint64_t u64[4];
+    is >> u64[0] >> u64[1] >> u64[2] >> u64[3];
+    m.m = _mm256_set_epi64x(u64[3], u64[2], u64[1], u64[0]);
+    return is;
+}
+
+template <>
+inline r123m256i assemble_from_u32<r123m256i>(uint32_t *p32){
+    r123m256i ret;
+    ret.m = _mm256_loadu_si256((const __m256i*)p32);
+    return ret;
+}
+#endif /* R123_USE_AVX2 */
+
+#if R123_USE_AVX512
+struct r123m512i{
+    __m512i m;
+#if R123_USE_CXX11_UNRESTRICTED_UNIONS
+    r123m512i() = default;
+    r123m512i(__m512i _m): m(_m){}
+#endif
+    r123m512i& operator=(const __m512i& rhs){ m=rhs; return *this;}
+    r123m512i& operator=(R123_ULONG_LONG n){ m = _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, n); return *this;}
+#if R123_USE_CXX11_EXPLICIT_CONVERSIONS
+    explicit operator bool() const {return _bool();}
+#else
+    operator const void*() const{return _bool()?this:0;}
+#endif
+    operator __m512i() const {return m;}
+
+private:
+    bool _bool() const{ return _mm512_test_epi64_mask(m,m) != 0; }
+};
+
+R123_STATIC_INLINE r123m512i& operator+=(r123m512i& lhs, R123_ULONG_LONG n){
+    __m512i c = _mm512_add_epi64(lhs.m, _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, n));
+    if( R123_BUILTIN_EXPECT(_mm_extract_lo64(_mm512_castsi512_si128(c)) < (uint64_t)n, 0) ){
+        union{
+            uint64_t u64[8];
+            __m512i m;
+        }u;
+        _mm512_storeu_si512(&u.m, c);
+        _r123_carry_u64(u.u64, 8);
+        c = _mm512_loadu_si512(&u.m);
+    }
+    lhs.m = c;
+    return lhs;
+}
+
+R123_STATIC_INLINE r123m512i& operator++(r123m512i& v){
+    return v += 1;
+}
+
+R123_STATIC_INLINE bool operator<=(R123_ULONG_LONG, const r123m512i &){
+    throw std::runtime_error("operator<=(unsigned long long, r123m512i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<(const r123m512i&, const r123m512i&){
+    throw std::runtime_error("operator<(r123m512i, r123m512i) is unimplemented.");}
+R123_STATIC_INLINE bool operator<=(const r123m512i&, const r123m512i&){
+    throw std::runtime_error("operator<=(r123m512i, r123m512i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>(const r123m512i&, const r123m512i&){
+    throw std::runtime_error("operator>(r123m512i, r123m512i) is unimplemented.");}
+R123_STATIC_INLINE bool operator>=(const r123m512i&, const r123m512i&){
+    throw std::runtime_error("operator>=(r123m512i, r123m512i) is unimplemented.");}
+
+R123_STATIC_INLINE bool operator==(const r123m512i &lhs, const r123m512i &rhs){
+    return _mm512_cmpneq_epi64_mask(lhs.m, rhs.m) == 0; }
+R123_STATIC_INLINE bool operator!=(const r123m512i &lhs, const r123m512i &rhs){
+    return !(lhs==rhs);}
+R123_STATIC_INLINE bool operator==(R123_ULONG_LONG lhs, const r123m512i &rhs){
+    r123m512i LHS; LHS.m=_mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, lhs); return LHS == rhs; }
+R123_STATIC_INLINE bool operator!=(R123_ULONG_LONG lhs, const r123m512i &rhs){
+    return !(lhs==rhs);}
+R123_STATIC_INLINE std::ostream& operator<<(std::ostream& os, const r123m512i& m){
+    union{
+        uint64_t u64[8];
+        __m512i m;
+    }u;
+    _mm512_storeu_si512(&u.m, m.m);
+    os << u.u64[0];
+    for(int i=1; i<8; ++i)
+        os << " " << u.u64[i];
+    return os;
+}
+
+R123_STATIC_INLINE std::istream& operator>>(std::istream& is, r123m512i& m){
+    uint64_t u64[8];
+    for(int i=0; i<8; ++i)
+        is >> u64[i];
+    m.m = _mm512_loadu_si512(u64);
+    return is;
+}
+
+template <>
+inline r123m512i assemble_from_u32<r123m512i>(uint32_t *p32){
+    r123m512i ret;
+    ret.m = _mm512_loadu_si512(p32);
+    return ret;
+}
+#endif /* R123_USE_AVX512 */
+
 #else
 
 typedef struct {
     __m128i m;
 } r123m128i;
 
+#if R123_USE_AVX2
+typedef struct {
+    __m256i m;
+} r123m256i;
+#endif
+
+#if R123_USE_AVX512
+typedef struct {
+    __m512i m;
+} r123m512i;
+#endif
+
 #endif /* __cplusplus */
 
-#else /* !R123_USE_SSE */
+#elif !R123_USE_NEON
 R123_STATIC_INLINE int haveAESNI(){
     return 0;
 }
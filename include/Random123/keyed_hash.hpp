@@ -0,0 +1,355 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_keyed_hash_dot_hpp__
+#define __r123_keyed_hash_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "philox.h"
+#include "threefry.h"
+#include "stream_table.hpp"
+#include <stdexcept>
+#include <limits>
+#include <cstddef>
+
+/** \file keyed_hash.hpp
+
+    r123::keyed_hash<CBRNG> is a family of keyed hash functions of
+    64- and 128-bit inputs, for hash tables and sketches (count-min
+    sketches, Bloom filters, MinHash) that need k independent hash
+    functions.  Hash function i of the input x, hash(x, i), is the
+    32-bit word i%S of the block b(c, k) with c the counter of x and
+    block number j = i/S, where S is the number of 32-bit words in a
+    block (4 for Philox4x32 and Threefry2x64, 8 for Philox4x64).  The
+    64-bit words of a block are taken low half first.
+
+    The counter of x holds x in its first 64 bits (or 128, for a
+    128-bit input given as lo and hi), low word first, j in the next
+    word, and 0 in the rest.  The counter must have at least 128 bits
+    and an unsigned integral value_type.  A 128-bit input fills a
+    128-bit counter, leaving no room for j, so only S hash functions
+    of it can be had from Philox4x32 or Threefry2x64;
+    std::invalid_argument is thrown if more are asked for.
+
+    Reduced-round generators, e.g., Philox4x32_R<7> or
+    Threefry2x64_R<13>, are fast and, like the default numbers of
+    rounds, pass the statistical tests of TestU01's BigCrush.  Neither
+    the full nor the reduced-round functions should be relied on for
+    security (e.g., as a MAC).
+
+    hashes(x, n, k, out), and hashes128 for 128-bit inputs, make the
+    first k hash functions of n inputs, out[e*k+i] = hash(x[e], i).
+    The counters of a batch of inputs are made with their words laid
+    out by columns and, for Philox4x32_R and Threefry2x64_R, encrypted
+    in vector registers without being transposed, with the widest of
+    the kernels of features/lanes.h that is available.  Other CBRNGs
+    go through the multi-lane functions of stream_table.hpp.  The
+    results are the same as those of the scalar functions.
+
+    @code
+    r123::keyed_hash<r123::Philox4x32_R<7> > h(key);
+    h.hashes(&items[0], items.size(), depth, &idx[0]);
+    for(size_t e=0; e<items.size(); ++e)
+        for(unsigned i=0; i<depth; ++i)
+            ++sketch[i][idx[e*depth+i] % width];
+    @endcode
+*/
+
+namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+// A batch of n blocks, encrypted in place:  word m of block q is
+// c[m*stride+q].  The general case transposes them to and from
+// ctr_types for _encrypt_blocks.
+template <typename CBRNG>
+void _encrypt_columns(CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type::value_type* c, size_t stride, size_t n){
+    typedef typename CBRNG::ctr_type ctr_type;
+    const size_t N = sizeof(ctr_type)/sizeof(typename ctr_type::value_type);
+    ctr_type x[64];
+    for(size_t q0=0; q0<n; q0+=64){
+        size_t nb = n-q0 < 64 ? n-q0 : 64;
+        for(size_t q=0; q<nb; ++q)
+            for(size_t m=0; m<N; ++m)
+                x[q][m] = c[m*stride+q0+q];
+        _encrypt_blocks(b, k, x, nb);
+        for(size_t q=0; q<nb; ++q)
+            for(size_t m=0; m<N; ++m)
+                c[m*stride+q0+q] = x[q][m];
+    }
+}
+
+#if R123_USE_SSE || R123_USE_NEON
+template <unsigned int R>
+void _encrypt_columns(Philox4x32_R<R>& b, const philox4x32_key_t& k, uint32_t* c, size_t stride, size_t n){
+    R123_STATIC_ASSERT(R<=16, "philox is only unrolled up to 16 rounds\n");
+    size_t q = 0;
+#if R123_USE_AVX512
+    for(; q+16<=n; q+=16){
+        _r123_u32x16_t x[4];
+        for(size_t m=0; m<4; ++m)
+            x[m] = _r123_loadu_u32x16(c+m*stride+q);
+        _philox4x32_R_u32x16(R, x, 1, k);
+        for(size_t m=0; m<4; ++m)
+            _r123_storeu_u32x16(c+m*stride+q, x[m]);
+    }
+#elif R123_USE_AVX2
+    for(; q+8<=n; q+=8){
+        _r123_u32x8_t x[4];
+        for(size_t m=0; m<4; ++m)
+            x[m] = _r123_loadu_u32x8(c+m*stride+q);
+        _philox4x32_R_u32x8(R, x, 1, k);
+        for(size_t m=0; m<4; ++m)
+            _r123_storeu_u32x8(c+m*stride+q, x[m]);
+    }
+#endif
+    for(; q+4<=n; q+=4){
+        _r123_u32x4_t x[4];
+        for(size_t m=0; m<4; ++m)
+            x[m] = _r123_loadu_u32x4(c+m*stride+q);
+        _philox4x32_R_u32x4(R, x, 1, k);
+        for(size_t m=0; m<4; ++m)
+            _r123_storeu_u32x4(c+m*stride+q, x[m]);
+    }
+    for(; q<n; ++q){
+        philox4x32_ctr_t x = {{c[q], c[stride+q], c[2*stride+q], c[3*stride+q]}};
+        x = b(x, k);
+        for(size_t m=0; m<4; ++m)
+            c[m*stride+q] = x.v[m];
+    }
+}
+#endif
+
+// Only with AVX-512:  AVX2 has no 64-bit rotation, and its four
+// lanes are no faster than the scalar function.  Each round is a
+// chain of dependent instructions, so two groups of lanes are
+// interleaved.
+#if R123_USE_AVX512
+template <unsigned int R>
+void _encrypt_columns(Threefry2x64_R<R>& b, const threefry2x64_key_t& k, uint64_t* c, size_t stride, size_t n){
+    R123_STATIC_ASSERT(R<=32, "threefry2x64 is only unrolled up to 32 rounds\n");
+    size_t q = 0;
+    for(; q+16<=n; q+=16){
+        _r123_u64x8_t x[4];
+        for(size_t m=0; m<4; ++m)
+            x[m] = _r123_loadu_u64x8(c+(m%2)*stride+q+8*(m/2));
+        _threefry2x64_R_u64x8(R, x, 2, k);
+        for(size_t m=0; m<4; ++m)
+            _r123_storeu_u64x8(c+(m%2)*stride+q+8*(m/2), x[m]);
+    }
+    for(; q+8<=n; q+=8){
+        _r123_u64x8_t x[2];
+        x[0] = _r123_loadu_u64x8(c+q);
+        x[1] = _r123_loadu_u64x8(c+stride+q);
+        _threefry2x64_R_u64x8(R, x, 1, k);
+        _r123_storeu_u64x8(c+q, x[0]);
+        _r123_storeu_u64x8(c+stride+q, x[1]);
+    }
+    for(; q<n; ++q){
+        threefry2x64_ctr_t x = {{c[q], c[stride+q]}};
+        x = b(x, k);
+        c[q] = x.v[0];
+        c[stride+q] = x.v[1];
+    }
+}
+#endif
+/** \endcond */
+
+/** A family of keyed hash functions of 64- and 128-bit inputs.  See
+    keyed_hash.hpp. */
+template <typename CBRNG>
+class keyed_hash{
+public:
+    typedef CBRNG cbrng_type;
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+
+    /** The number of 32-bit hash values in a block. */
+    static const unsigned per_block = (unsigned)(sizeof(ctr_type)/4);
+
+    explicit keyed_hash(const key_type& k, CBRNG b = CBRNG()) : b_(b), k_(k){
+        R123_STATIC_ASSERT(std::numeric_limits<value_type>::is_integer && !std::numeric_limits<value_type>::is_signed &&
+                           (W == 32 || W == 64) && N*W >= 128,
+                           "keyed_hash needs a ctr_type of at least 128 bits, in 32- or 64-bit unsigned words\n");
+    }
+
+    const key_type& key() const{ return k_; }
+
+    /** The number of hash functions of a 128-bit input there are,
+        or 0 if there is no limit. */
+    static unsigned max_hashes128(){
+        return N*W > 128 ? 0 : per_block;
+    }
+
+    /** The counter of block j of the 64-bit input x. */
+    static ctr_type counter(uint64_t x, value_type j){
+        ctr_type c = {{}};
+        put(c, 0, x);
+        c[64/W] = j;
+        return c;
+    }
+
+    /** The counter of block j of the 128-bit input (lo, hi).  j must
+        be 0 if the counter has only 128 bits. */
+    static ctr_type counter(uint64_t lo, uint64_t hi, value_type j){
+        ctr_type c = {{}};
+        put(c, 0, lo);
+        put(c, 64/W, hi);
+        if(N*W > 128)
+            c[(128/W) % N] = j;
+        else if(j)
+            throw std::invalid_argument("keyed_hash:  a 128-bit input fills the counter, leaving room for only one block of hashes");
+        return c;
+    }
+
+    /** Block j of the hashes of x. */
+    ctr_type block(uint64_t x, value_type j) const{
+        CBRNG b = b_;
+        return b(counter(x, j), k_);
+    }
+
+    /** Block j of the hashes of (lo, hi). */
+    ctr_type block(uint64_t lo, uint64_t hi, value_type j) const{
+        CBRNG b = b_;
+        return b(counter(lo, hi, j), k_);
+    }
+
+    /** Hash function i of x. */
+    uint32_t hash(uint64_t x, unsigned i) const{
+        return slice(block(x, (value_type)(i/per_block)), i%per_block);
+    }
+
+    /** Hash function i of (lo, hi). */
+    uint32_t hash(uint64_t lo, uint64_t hi, unsigned i) const{
+        return slice(block(lo, hi, (value_type)(i/per_block)), i%per_block);
+    }
+
+    /** h[i] = hash(x, i) for i in [0, k). */
+    void hashes(uint64_t x, unsigned k, uint32_t* h) const{
+        for(unsigned j=0; j*per_block<k; ++j){
+            ctr_type r = block(x, (value_type)j);
+            for(unsigned s=0; s<per_block && j*per_block+s<k; ++s)
+                h[j*per_block+s] = slice(r, s);
+        }
+    }
+
+    /** h[i] = hash(lo, hi, i) for i in [0, k). */
+    void hashes(uint64_t lo, uint64_t hi, unsigned k, uint32_t* h) const{
+        for(unsigned j=0; j*per_block<k; ++j){
+            ctr_type r = block(lo, hi, (value_type)j);
+            for(unsigned s=0; s<per_block && j*per_block+s<k; ++s)
+                h[j*per_block+s] = slice(r, s);
+        }
+    }
+
+    /** out[e*k+i] = hash(x[e], i) for e in [0, n) and i in [0, k). */
+    void hashes(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        generate(x, 1, n, k, out);
+    }
+
+    /** out[e*k+i] = hash(x[2*e], x[2*e+1], i) for e in [0, n) and i
+        in [0, k):  the inputs are n pairs of 64-bit words, low word
+        first. */
+    void hashes128(const uint64_t* x, size_t n, unsigned k, uint32_t* out) const{
+        if(max_hashes128() && k > max_hashes128())
+            throw std::invalid_argument("keyed_hash:  a 128-bit input fills the counter, leaving room for only one block of hashes");
+        generate(x, 2, n, k, out);
+    }
+
+private:
+    enum { N = sizeof(ctr_type)/sizeof(value_type), W = 8*sizeof(value_type), batch = 64 };
+
+    cbrng_type b_;
+    key_type k_;
+
+    // The 64 bits v in the words of c from m on, low word first.
+    static void put(ctr_type& c, size_t m, uint64_t v){
+        c[m] = (value_type)v;
+        if(W < 64)
+            c[m+1] = (value_type)((v >> (W/2)) >> (W/2));
+    }
+
+    // 32-bit word s of the block r, low half first for 64-bit words.
+    static uint32_t slice(const ctr_type& r, unsigned s){
+        if(W == 32)
+            return (uint32_t)r[s];
+        return (uint32_t)((uint64_t)r[s/2] >> (32*(s%2)));
+    }
+
+    // The counters of a batch of inputs, their words in columns of
+    // c, are made, encrypted in place, and their words scattered
+    // into out, for each block in turn.
+    void generate(const uint64_t* x, size_t words, size_t n, unsigned k, uint32_t* out) const{
+        CBRNG b = b_;
+        value_type c[N*batch];
+        const size_t mj = words*64/W;   // the word of j, if there is one
+        for(size_t e=0; e<n; e+=batch){
+            size_t nb = n-e < batch ? n-e : (size_t)batch;
+            const uint64_t* xe = x+words*e;
+            for(unsigned j=0; j*per_block<k; ++j){
+                for(size_t h=0; h<words; ++h){
+                    if(W == 64){
+                        for(size_t q=0; q<nb; ++q)
+                            c[h*batch+q] = (value_type)xe[words*q+h];
+                    }else{
+                        for(size_t q=0; q<nb; ++q){
+                            c[2*h*batch+q] = (value_type)xe[words*q+h];
+                            c[(2*h+1)*batch+q] = (value_type)((xe[words*q+h] >> (W/2)) >> (W/2));
+                        }
+                    }
+                }
+                for(size_t m=mj; m<N; ++m){
+                    value_type v = (value_type)(m == mj ? j : 0);
+                    for(size_t q=0; q<nb; ++q)
+                        c[m*batch+q] = v;
+                }
+                _encrypt_columns(b, k_, c, batch, nb);
+                unsigned ns = k-j*per_block < per_block ? k-j*per_block : per_block;
+                for(unsigned s=0; s<ns; ++s){
+                    uint32_t* o = out+e*k+j*per_block+s;
+                    if(W == 32){
+                        for(size_t q=0; q<nb; ++q)
+                            o[q*k] = (uint32_t)c[s*batch+q];
+                    }else{
+                        for(size_t q=0; q<nb; ++q)
+                            o[q*k] = (uint32_t)((uint64_t)c[(s/2)*batch+q] >> (32*(s%2)));
+                    }
+                }
+            }
+        }
+    }
+};
+
+template <typename CBRNG>
+const unsigned keyed_hash<CBRNG>::per_block;
+
+} // namespace r123
+
+#endif
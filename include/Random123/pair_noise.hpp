@@ -0,0 +1,239 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_pair_noise_dot_hpp__
+#define __r123_pair_noise_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "u01.h"
+#include "continuous.hpp"
+#include "stream_table.hpp"
+#include <limits>
+#include <cstddef>
+
+/** \file pair_noise.hpp
+
+    r123::pair_noise<CBRNG> makes the random numbers of pairwise
+    interactions, such as the random forces of dissipative particle
+    dynamics, that must be the same whichever particle of the pair
+    computes them.  The number for particles i and j at time step
+    step is made from the block b(c, k), where c is the counter
+
+        { min(i,j), max(i,j), step mod 2^W, step / 2^W }
+
+    for W-bit counter words (the last word is 0 for 64-bit words), and
+    k is the key given to the constructor.  The CBRNG must have four
+    words in its counter (e.g., Philox4x32, Philox4x64, Threefry4x32,
+    Threefry4x64, ARS4x32), and the particle ids must fit in a word.
+
+    uniform(i, j, step) is in (0,1), from the first 64 bits of the
+    block by u01_open_open_64_53, and normal(i, j, step) is a standard
+    normal, z0 of r123_boxmuller (fpmath.h) applied to uniforms made
+    from the first and second 64 bits.  Both are the same on every
+    platform and instruction set.
+
+    The batched versions take a list of pairs, i[n] and j[n], or a
+    neighbor list in compressed sparse row (CSR) form, in which the
+    neighbors of particle r are col[rowptr[r]], ...,
+    col[rowptr[r+1]-1], and out[e] is the number of the pair
+    (r, col[e]).  They make the counters of a batch of pairs at a
+    time, encrypt them with the widest multi-lane function for the
+    CBRNG (see stream_table.hpp), and apply the Box-Muller transform
+    with the widest vector version of r123_boxmuller, so that the
+    results are the same as those of the scalar functions.
+
+    @code
+    r123::pair_noise<r123::Philox4x32> noise(key);
+    ...
+    noise.normal_csr(step, &rowptr[0], &col[0], nparticles, &theta[0]);
+    for(size_t r=0; r<nparticles; ++r)
+        for(int e=rowptr[r]; e<rowptr[r+1]; ++e)
+            f[r] += sigma*theta[e]*...;
+    @endcode
+*/
+
+namespace r123{
+
+/** Symmetric random numbers of pairs of particles and time steps,
+    under one key.  See pair_noise.hpp. */
+template <typename CBRNG>
+class pair_noise{
+public:
+    typedef CBRNG cbrng_type;
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+
+    explicit pair_noise(const key_type& k, CBRNG b = CBRNG()) : b_(b), k_(k){
+        R123_STATIC_ASSERT(std::numeric_limits<value_type>::is_integer && !std::numeric_limits<value_type>::is_signed && N == 4,
+                           "pair_noise needs a ctr_type of four unsigned integers\n");
+    }
+
+    const key_type& key() const{ return k_; }
+
+    /** The counter of the pair (i, j) at step, the same as that of
+        (j, i). */
+    static ctr_type counter(value_type i, value_type j, uint64_t step){
+        ctr_type c;
+        c[0] = i < j ? i : j;
+        c[1] = i < j ? j : i;
+        c[2] = (value_type)step;
+        // step >> W, without shifting by the whole width
+        c[3] = (value_type)((step >> (W/2)) >> (W/2));
+        return c;
+    }
+
+    /** The block of the pair (i, j) at step. */
+    ctr_type block(value_type i, value_type j, uint64_t step) const{
+        CBRNG b = b_;
+        return b(counter(i, j, step), k_);
+    }
+
+    /** A uniform in (0,1) for the pair (i, j) at step. */
+    double uniform(value_type i, value_type j, uint64_t step) const{
+        return u01_open_open_64_53(bits(block(i, j, step), 0));
+    }
+
+    /** A standard normal for the pair (i, j) at step. */
+    double normal(value_type i, value_type j, uint64_t step) const{
+        ctr_type r = block(i, j, step);
+        double z0, z1;
+        r123_boxmuller(u01_open_open_64_53(bits(r, 0)), u01_open_open_64_53(bits(r, 1)), &z0, &z1);
+        return z0;
+    }
+
+    /** out[e] = uniform(i[e], j[e], step) for e in [0, n). */
+    template <typename I>
+    void uniform(uint64_t step, const I* i, const I* j, size_t n, double* out) const{
+        generate(step, _pairs<I>(i, j), 0, n, out, false);
+    }
+
+    /** out[e] = normal(i[e], j[e], step) for e in [0, n). */
+    template <typename I>
+    void normal(uint64_t step, const I* i, const I* j, size_t n, double* out) const{
+        generate(step, _pairs<I>(i, j), 0, n, out, true);
+    }
+
+    /** out[e] = uniform(r, col[e], step) for the neighbors e in
+        [rowptr[r], rowptr[r+1]) of each row r in [0, nrows). */
+    template <typename I>
+    void uniform_csr(uint64_t step, const I* rowptr, const I* col, size_t nrows, double* out) const{
+        generate(step, _csr<I>(rowptr, col), (size_t)rowptr[0], (size_t)rowptr[nrows], out, false);
+    }
+
+    /** out[e] = normal(r, col[e], step) for the neighbors e in
+        [rowptr[r], rowptr[r+1]) of each row r in [0, nrows). */
+    template <typename I>
+    void normal_csr(uint64_t step, const I* rowptr, const I* col, size_t nrows, double* out) const{
+        generate(step, _csr<I>(rowptr, col), (size_t)rowptr[0], (size_t)rowptr[nrows], out, true);
+    }
+
+private:
+    enum { N = sizeof(ctr_type)/sizeof(value_type), W = 8*sizeof(value_type), batch = 64 };
+
+    cbrng_type b_;
+    key_type k_;
+
+    // 64 bits h of the block:  word h of 64-bit words, or words 2h
+    // and 2h+1 of 32-bit words, the first in the low half.
+    static uint64_t bits(const ctr_type& r, unsigned h){
+        if(W >= 64)
+            return (uint64_t)r[h];
+        return (uint64_t)r[2*h] | ((uint64_t)r[2*h+1] << 32);
+    }
+
+    // The pairs of element e of a list of pairs, and of a CSR
+    // neighbor list, visited in order of e.
+    template <typename I>
+    struct _pairs{
+        const I* i;
+        const I* j;
+        _pairs(const I* i_, const I* j_) : i(i_), j(j_){}
+        void at(size_t e, value_type* a, value_type* b){
+            *a = (value_type)i[e];
+            *b = (value_type)j[e];
+        }
+    };
+    template <typename I>
+    struct _csr{
+        const I* rowptr;
+        const I* col;
+        size_t row;
+        _csr(const I* rowptr_, const I* col_) : rowptr(rowptr_), col(col_), row(0){}
+        void at(size_t e, value_type* a, value_type* b){
+            while((size_t)rowptr[row+1] <= e)
+                ++row;
+            *a = (value_type)row;
+            *b = (value_type)col[e];
+        }
+    };
+
+    template <typename P>
+    void generate(uint64_t step, P p, size_t e0, size_t e1, double* out, bool gaussian) const{
+        typedef _fpwide T;
+        CBRNG b = b_;
+        ctr_type x[batch];
+        double u1[batch], u2[batch];
+        for(size_t e=e0; e<e1; e+=batch){
+            size_t nb = e1-e < batch ? e1-e : (size_t)batch;
+            for(size_t q=0; q<nb; ++q){
+                value_type i, j;
+                p.at(e+q, &i, &j);
+                x[q] = counter(i, j, step);
+            }
+            _encrypt_blocks(b, k_, x, nb);
+            double* o = out+e;
+            if(!gaussian){
+                for(size_t q=0; q<nb; ++q)
+                    o[q] = u01_open_open_64_53(bits(x[q], 0));
+                continue;
+            }
+            for(size_t q=0; q<nb; ++q){
+                u1[q] = u01_open_open_64_53(bits(x[q], 0));
+                u2[q] = u01_open_open_64_53(bits(x[q], 1));
+            }
+            size_t q = 0;
+            for(; q+T::W<=nb; q+=T::W){
+                typename T::V z0, z1;
+                T::boxmuller(T::load(u1+q), T::load(u2+q), &z0, &z1);
+                T::store(o+q, z0);
+            }
+            for(; q<nb; ++q){
+                double z1;
+                r123_boxmuller(u1[q], u2[q], o+q, &z1);
+            }
+        }
+    }
+};
+
+} // namespace r123
+
+#endif
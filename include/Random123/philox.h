@@ -303,6 +303,41 @@ R123_CUDA_DEVICE R123_STATIC_INLINE philox##N##x##W##_ctr_t philox##N##x##W##_R(
     if(R>15){ key = _philox##N##x##W##bumpkey(key); ctr = _philox##N##x##W##round(ctr, key); } \
     return ctr;                                                         \
 }
+
+/* Expanded keys:  philoxNxW_xkey_t holds the round keys of all 16
+   rounds, made once by philoxNxWxkeyinit, so that philoxNxW_R_xkey
+   need not bump the key between rounds. */
+#define _philoxNxWxkey_tpl(N, W)                                        \
+typedef struct { philox##N##x##W##_key_t k[16]; } philox##N##x##W##_xkey_t; \
+R123_CUDA_DEVICE R123_STATIC_INLINE philox##N##x##W##_xkey_t philox##N##x##W##xkeyinit(philox##N##x##W##_key_t key) { \
+    philox##N##x##W##_xkey_t xk;                                        \
+    int i;                                                              \
+    xk.k[0] = key;                                                      \
+    for(i=1; i<16; i++)                                                 \
+        xk.k[i] = _philox##N##x##W##bumpkey(xk.k[i-1]);                 \
+    return xk;                                                          \
+}                                                                       \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(philox##N##x##W##_ctr_t philox##N##x##W##_R_xkey(unsigned int R, philox##N##x##W##_ctr_t ctr, philox##N##x##W##_xkey_t xk)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE philox##N##x##W##_ctr_t philox##N##x##W##_R_xkey(unsigned int R, philox##N##x##W##_ctr_t ctr, philox##N##x##W##_xkey_t xk) { \
+    R123_ASSERT(R<=16);                                                 \
+    if(R>0){ ctr = _philox##N##x##W##round(ctr, xk.k[0]); }             \
+    if(R>1){ ctr = _philox##N##x##W##round(ctr, xk.k[1]); }             \
+    if(R>2){ ctr = _philox##N##x##W##round(ctr, xk.k[2]); }             \
+    if(R>3){ ctr = _philox##N##x##W##round(ctr, xk.k[3]); }             \
+    if(R>4){ ctr = _philox##N##x##W##round(ctr, xk.k[4]); }             \
+    if(R>5){ ctr = _philox##N##x##W##round(ctr, xk.k[5]); }             \
+    if(R>6){ ctr = _philox##N##x##W##round(ctr, xk.k[6]); }             \
+    if(R>7){ ctr = _philox##N##x##W##round(ctr, xk.k[7]); }             \
+    if(R>8){ ctr = _philox##N##x##W##round(ctr, xk.k[8]); }             \
+    if(R>9){ ctr = _philox##N##x##W##round(ctr, xk.k[9]); }             \
+    if(R>10){ ctr = _philox##N##x##W##round(ctr, xk.k[10]); }           \
+    if(R>11){ ctr = _philox##N##x##W##round(ctr, xk.k[11]); }           \
+    if(R>12){ ctr = _philox##N##x##W##round(ctr, xk.k[12]); }           \
+    if(R>13){ ctr = _philox##N##x##W##round(ctr, xk.k[13]); }           \
+    if(R>14){ ctr = _philox##N##x##W##round(ctr, xk.k[14]); }           \
+    if(R>15){ ctr = _philox##N##x##W##round(ctr, xk.k[15]); }           \
+    return ctr;                                                         \
+}
          
 _philox2xWbumpkey_tpl(32)
 _philox4xWbumpkey_tpl(32)
@@ -311,6 +346,10 @@ _philox4xWround_tpl(32, uint32_t)            /* philo4x32round */
 /** \endcond */
 _philoxNxW_tpl(2, 1, 32, uint32_t)    /* philox2x32bijection */
 _philoxNxW_tpl(4, 2, 32, uint32_t)    /* philox4x32bijection */
+/** \cond HIDDEN_FROM_DOXYGEN */
+_philoxNxWxkey_tpl(2, 32)
+_philoxNxWxkey_tpl(4, 32)
+/** \endcond */
 #if R123_USE_PHILOX_64BIT
 /** \cond HIDDEN_FROM_DOXYGEN */
 _philox2xWbumpkey_tpl(64)
@@ -320,6 +359,10 @@ _philox4xWround_tpl(64, uint64_t) /* philo4x64round */
 /** \endcond */
 _philoxNxW_tpl(2, 1, 64, uint64_t)    /* philox2x64bijection */
 _philoxNxW_tpl(4, 2, 64, uint64_t)    /* philox4x64bijection */
+/** \cond HIDDEN_FROM_DOXYGEN */
+_philoxNxWxkey_tpl(2, 64)
+_philoxNxWxkey_tpl(4, 64)
+/** \endcond */
 #endif /* R123_USE_PHILOX_64BIT */
 
 #define philox2x32(c,k) philox2x32_R(philox2x32_rounds, c, k)
@@ -329,6 +372,191 @@ _philoxNxW_tpl(4, 2, 64, uint64_t)    /* philox4x64bijection */
 #define philox4x64(c,k) philox4x64_R(philox4x64_rounds, c, k)
 #endif /* R123_USE_PHILOX_64BIT */
 
+/** @ingroup PhiloxNxW
+    @fn philox4x32_ctr_t philox4x32_R_xkey(unsigned int R, philox4x32_ctr_t ctr, philox4x32_xkey_t xk)
+    Returns philox4x32_R(R, ctr, key), where xk =
+    philox4x32xkeyinit(key) holds the keys of all 16 rounds, computed
+    once, rather than by bumping key before each round.  For many
+    blocks under one key, the xkey is made once and the additions are
+    saved from every block.  philox2x32, philox2x64 and philox4x64
+    have the same xkey_t, xkeyinit and _R_xkey. */
+
+#if R123_USE_SSE || R123_USE_NEON
+#include "features/lanes.h"
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* R rounds of Philox4xW on nb groups of counters in the vectors of
+   features/lanes.h with tag TAG, x[4*b+j] holding word j of the
+   counters of group b, the products made by _r123_mulhilo_MTAG.
+   The keys are in vectors too:  k[2*b+j] holds word j of the keys of
+   group b if nk is nb, and k[j] those of every group if nk is 1.
+   Callers pass constant nb and nk, so that the groups are
+   interleaved to hide the latency of the multiplies.
+   _philox4xW_R_MTAG is the same with one key for every lane. */
+#define _philox4xWlanes_tpl(W, TAG, MTAG)                               \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _philox4x##W##_Rk_##MTAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, _r123_##TAG##_t* k, unsigned int nk)); \
+R123_STATIC_INLINE void _philox4x##W##_Rk_##MTAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, _r123_##TAG##_t* k, unsigned int nk){ \
+    _r123_##TAG##_t w0 = _r123_set1_##TAG(PHILOX_W##W##_0);             \
+    _r123_##TAG##_t w1 = _r123_set1_##TAG(PHILOX_W##W##_1);             \
+    unsigned int r, b;                                                  \
+    R123_ASSERT(R<=16);                                                 \
+    for(r=0; r<R; ++r){                                                 \
+        if(r){                                                          \
+            for(b=0; b<nk; ++b){                                        \
+                k[2*b] = _r123_add_##TAG(k[2*b], w0);                   \
+                k[2*b+1] = _r123_add_##TAG(k[2*b+1], w1);               \
+            }                                                           \
+        }                                                               \
+        for(b=0; b<nb; ++b){                                            \
+            _r123_##TAG##_t* xb = x+4*b;                                \
+            _r123_##TAG##_t* kb = k+(nk==1 ? 0 : 2*b);                  \
+            _r123_##TAG##_t hi0, hi1;                                   \
+            _r123_##TAG##_t lo0 = _r123_mulhilo_##MTAG(xb[0], PHILOX_M4x##W##_0, &hi0); \
+            _r123_##TAG##_t lo1 = _r123_mulhilo_##MTAG(xb[2], PHILOX_M4x##W##_1, &hi1); \
+            xb[0] = _r123_xor_##TAG(_r123_xor_##TAG(hi1, xb[1]), kb[0]); \
+            xb[1] = lo1;                                                \
+            xb[2] = _r123_xor_##TAG(_r123_xor_##TAG(hi0, xb[3]), kb[1]); \
+            xb[3] = lo0;                                                \
+        }                                                               \
+    }                                                                   \
+}                                                                       \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _philox4x##W##_R_##MTAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, philox4x##W##_key_t key)); \
+R123_STATIC_INLINE void _philox4x##W##_R_##MTAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, philox4x##W##_key_t key){ \
+    _r123_##TAG##_t k[2];                                               \
+    k[0] = _r123_set1_##TAG(key.v[0]);                                  \
+    k[1] = _r123_set1_##TAG(key.v[1]);                                  \
+    _philox4x##W##_Rk_##MTAG(R, x, nb, k, 1);                           \
+}
+
+_philox4xWlanes_tpl(32, u32x4, u32x4)
+#if R123_USE_AVX2
+_philox4xWlanes_tpl(32, u32x8, u32x8)
+#endif
+#if R123_USE_AVX512
+_philox4xWlanes_tpl(32, u32x16, u32x16)
+#endif
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX2
+_philox4xWlanes_tpl(64, u64x4, u64x4)
+#endif
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX512
+_philox4xWlanes_tpl(64, u64x8, u64x8)
+#if R123_USE_AVX512IFMA
+_philox4xWlanes_tpl(64, u64x8, u64x8ifma)
+#define _philox4x64_x8_R _philox4x64_R_u64x8ifma
+#define _philox4x64_x8_Rk _philox4x64_Rk_u64x8ifma
+#else
+#define _philox4x64_x8_R _philox4x64_R_u64x8
+#define _philox4x64_x8_Rk _philox4x64_Rk_u64x8
+#endif
+#endif
+/** \endcond */
+
+/** @ingroup PhiloxNxW
+    @fn void philox4x32_R_x4(unsigned int R, const philox4x32_ctr_t* in, philox4x32_key_t key, philox4x32_ctr_t* out)
+    Sets out[i] = philox4x32_R(R, in[i], key) for i in [0, 4), with
+    SSE2 (R123_USE_SSE) or ARM NEON (R123_USE_NEON).  in and out may
+    be the same array.  philox4x32_R_x8 and philox4x64_R_x4 do the
+    same with AVX2 (R123_USE_AVX2), and philox4x32_R_x16 and
+    philox4x64_R_x8 with AVX-512 (R123_USE_AVX512).  AVX-512 has no
+    64x64->128-bit multiply:  philox4x64_R_x8 makes the products with
+    the AVX-512 IFMA instructions if R123_USE_AVX512IFMA is set, and
+    from 32-bit partial products otherwise. */
+_r123_lanes4xW_tpl(philox, 32, 4, u32x4, _philox4x32_R_u32x4)
+#define philox4x32_x4(in, k, out) philox4x32_R_x4(philox4x32_rounds, in, k, out)
+#if R123_USE_AVX2
+_r123_lanes4xW_tpl(philox, 32, 8, u32x8, _philox4x32_R_u32x8)
+#define philox4x32_x8(in, k, out) philox4x32_R_x8(philox4x32_rounds, in, k, out)
+#endif
+#if R123_USE_AVX512
+_r123_lanes4xW_tpl(philox, 32, 16, u32x16, _philox4x32_R_u32x16)
+#define philox4x32_x16(in, k, out) philox4x32_R_x16(philox4x32_rounds, in, k, out)
+#endif
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX2
+_r123_lanes4xW_tpl(philox, 64, 4, u64x4, _philox4x64_R_u64x4)
+#define philox4x64_x4(in, k, out) philox4x64_R_x4(philox4x64_rounds, in, k, out)
+#endif
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX512
+_r123_lanes4xW_tpl(philox, 64, 8, u64x8, _philox4x64_x8_R)
+#define philox4x64_x8(in, k, out) philox4x64_R_x8(philox4x64_rounds, in, k, out)
+#endif
+
+/** @ingroup PhiloxNxW
+    @fn void philox4x32_R_fill(unsigned int R, philox4x32_ctr_t c0, philox4x32_key_t key, philox4x32_ctr_t* out, size_t n)
+    Sets out[i] = philox4x32_R(R, c0+i, key) for i in [0, n), where
+    c0+i is c0 incremented i times as by r123array4x32::incr (i.e., as
+    a 128-bit integer with word 0 least significant).  The counters
+    are made and encrypted in vector registers, as by the widest of
+    philox4x32_R_x4, philox4x32_R_x8 and philox4x32_R_x16 that is
+    available.  philox4x64_R_fill does the same for philox4x64, with
+    AVX2 or AVX-512.
+
+    Fills of more than R123_FILL_STREAM_BYTES bytes (8 MiB unless it
+    is defined before the Random123 headers are included) are written
+    with non-temporal stores, bypassing the caches, if out is aligned
+    to the vector registers (16, 32 or 64 bytes), so that they do not
+    evict the caller's working set.  Output that will be consumed
+    right away is better made in pieces that fit in the L2 cache,
+    each consumed before the next is made. */
+/** @ingroup PhiloxNxW
+    @fn void philox4x32_R_fill_soa(unsigned int R, philox4x32_ctr_t c0, philox4x32_key_t key, uint32_t* const out[4], size_t n)
+    As philox4x32_R_fill, but stores the results by columns, for
+    consumers that want structure-of-arrays data: out[j][i] is word j
+    of philox4x32_R(R, c0+i, key).  The vector registers are stored as
+    they come out of the rounds, without the 4x4 transposes that make
+    philox4x32_ctr_t blocks, and no scalar pass over the output is
+    needed either way.  The columns need not be aligned, but large
+    fills are streamed only if they are all aligned alike.
+    philox4x64_R_fill_soa does the same for philox4x64. */
+#if R123_USE_AVX512
+_r123_fill4xW_tpl(philox, 32, 16, u32x16, _philox4x32_R_u32x16)
+_r123_fill4xWsoa_tpl(philox, 32, 16, u32x16, _philox4x32_R_u32x16)
+#elif R123_USE_AVX2
+_r123_fill4xW_tpl(philox, 32, 8, u32x8, _philox4x32_R_u32x8)
+_r123_fill4xWsoa_tpl(philox, 32, 8, u32x8, _philox4x32_R_u32x8)
+#else
+_r123_fill4xW_tpl(philox, 32, 4, u32x4, _philox4x32_R_u32x4)
+_r123_fill4xWsoa_tpl(philox, 32, 4, u32x4, _philox4x32_R_u32x4)
+#endif
+#define philox4x32_fill(c, k, out, n) philox4x32_R_fill(philox4x32_rounds, c, k, out, n)
+#define philox4x32_fill_soa(c, k, out, n) philox4x32_R_fill_soa(philox4x32_rounds, c, k, out, n)
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX512
+_r123_fill4xW_tpl(philox, 64, 8, u64x8, _philox4x64_x8_R)
+_r123_fill4xWsoa_tpl(philox, 64, 8, u64x8, _philox4x64_x8_R)
+#define philox4x64_fill(c, k, out, n) philox4x64_R_fill(philox4x64_rounds, c, k, out, n)
+#define philox4x64_fill_soa(c, k, out, n) philox4x64_R_fill_soa(philox4x64_rounds, c, k, out, n)
+#elif R123_USE_PHILOX_64BIT && R123_USE_AVX2
+_r123_fill4xW_tpl(philox, 64, 4, u64x4, _philox4x64_R_u64x4)
+_r123_fill4xWsoa_tpl(philox, 64, 4, u64x4, _philox4x64_R_u64x4)
+#define philox4x64_fill(c, k, out, n) philox4x64_R_fill(philox4x64_rounds, c, k, out, n)
+#define philox4x64_fill_soa(c, k, out, n) philox4x64_R_fill_soa(philox4x64_rounds, c, k, out, n)
+#endif
+
+/** @ingroup PhiloxNxW
+    @fn void philox4x32_R_multikey(unsigned int R, const philox4x32_ctr_t* in, const philox4x32_key_t* keys, philox4x32_ctr_t* out, size_t n)
+    Sets out[i] = philox4x32_R(R, in[i], keys[i]) for i in [0, n),
+    with a different key for each counter, as when every particle has
+    a key of its own.  The counters and the keys are both moved into
+    vector registers, as wide as those of philox4x32_R_fill, and
+    each lane bumps its own key from round to round, so that the
+    throughput is close to that of the single-key functions.  in and
+    out may be the same array.  philox4x64_R_multikey does the same
+    for philox4x64, with AVX2 or AVX-512. */
+#if R123_USE_AVX512
+_r123_multikey4xW_tpl(philox, 32, 16, u32x16, _philox4x32_Rk_u32x16, 2)
+#elif R123_USE_AVX2
+_r123_multikey4xW_tpl(philox, 32, 8, u32x8, _philox4x32_Rk_u32x8, 2)
+#else
+_r123_multikey4xW_tpl(philox, 32, 4, u32x4, _philox4x32_Rk_u32x4, 2)
+#endif
+#define philox4x32_multikey(in, keys, out, n) philox4x32_R_multikey(philox4x32_rounds, in, keys, out, n)
+#if R123_USE_PHILOX_64BIT && R123_USE_AVX512
+_r123_multikey4xW_tpl(philox, 64, 8, u64x8, _philox4x64_x8_Rk, 2)
+#define philox4x64_multikey(in, keys, out, n) philox4x64_R_multikey(philox4x64_rounds, in, keys, out, n)
+#elif R123_USE_PHILOX_64BIT && R123_USE_AVX2
+_r123_multikey4xW_tpl(philox, 64, 4, u64x4, _philox4x64_Rk_u64x4, 2)
+#define philox4x64_multikey(in, keys, out, n) philox4x64_R_multikey(philox4x64_rounds, in, keys, out, n)
+#endif
+#endif /* R123_USE_SSE || R123_USE_NEON */
+
 #ifdef __cplusplus
 #include <stdexcept>
 
@@ -341,11 +569,19 @@ struct Philox##N##x##W##_R{                                             \
     typedef CType ctr_type;                                         \
     typedef KType key_type;                                             \
     typedef KType ukey_type;                                         \
+    typedef philox##N##x##W##_xkey_t xkey_type;                         \
     static const unsigned int rounds=ROUNDS;                                 \
     inline R123_CUDA_DEVICE R123_FORCE_INLINE(ctr_type operator()(ctr_type ctr, key_type key) const){ \
         R123_STATIC_ASSERT(ROUNDS<=16, "philox is only unrolled up to 16 rounds\n"); \
         return philox##N##x##W##_R(ROUNDS, ctr, key);                       \
     }                                                                   \
+    inline R123_CUDA_DEVICE R123_FORCE_INLINE(ctr_type operator()(ctr_type ctr, const xkey_type& xkey) const){ \
+        R123_STATIC_ASSERT(ROUNDS<=16, "philox is only unrolled up to 16 rounds\n"); \
+        return philox##N##x##W##_R_xkey(ROUNDS, ctr, xkey);                 \
+    }                                                                   \
+    static inline R123_CUDA_DEVICE xkey_type expand(key_type key){      \
+        return philox##N##x##W##xkeyinit(key);                          \
+    }                                                                   \
 };                                                                      \
 typedef Philox##N##x##W##_R<philox##N##x##W##_rounds> Philox##N##x##W; \
  } // namespace r123
@@ -372,6 +608,11 @@ As described in
 The Philox family of counter-based RNGs use integer multiplication, xor and permutation of W-bit words
 to scramble its N-word input key.  Philox is a mnemonic for Product HI LO Xor).
 
+Each class also takes an expanded key, its xkey_type (e.g.,
+philox4x32_xkey_t), in place of a key_type:  b(ctr, b.expand(key)) is
+b(ctr, key), with the round keys computed once, by expand, rather than
+in every call.
+
 
 @class r123::Philox2x32_R 
 @ingroup PhiloxNxW
@@ -0,0 +1,252 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_seed_seq_dot_hpp__
+#define __r123_seed_seq_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "threefry.h"
+#include "skein.h"
+#include <vector>
+#include <cstddef>
+#if R123_USE_CXX11
+#include <initializer_list>
+#endif
+
+/** \file seed_seq.hpp
+
+    r123::seed_seq is a seed sequence, in the sense of the C++11
+    SeedSeq concept, made from Threefry4x64.  It may be used wherever
+    a std::seed_seq is, e.g., to construct an r123::Engine or to seed
+    a std::mt19937, but its cost is linear in the number of values
+    given to it and the number generated, where std::seed_seq's
+    generate() mixes every output word with every other.
+
+    The values v given to a seed_seq (each taken mod 2^32) are hashed
+    into a threefry4x64_key_t K with Skein-256 (see skein.h) reduced to
+    threefry4x64_rounds (20) rounds of Threefish, over the 4*v.size()
+    bytes of v, each value little-endian.  generate(b, e) fills [b, e)
+    with the 32-bit words of the blocks threefry4x64(c_j, K), c_j =
+    {j, 0, 0, 0}, for j = 0, 1, ..., the 64-bit words of each block
+    taken low half first.  Neither the hash nor the generator should
+    be relied on for security.
+
+    child(i) is the seed_seq made from the 8 32-bit words of
+    threefry4x64({i, 0, 0, 1}, K), so that the children of a seed_seq
+    are independent of each other and of its own output, and each
+    child's param() reproduces it.  child_ukeys(out, n, first) sets
+    out[j] = UK::seed(child(first+j)), the user key that an Engine
+    constructed from child(first+j) would have, for j < n, making the
+    children's counters, their keys and their keys' blocks a batch at
+    a time in vector registers, with threefry4x64_R_fill,
+    skein256_R_multi and threefry4x64_R_multikey.  A large pool of
+    engines is thus made cheaply:
+
+    @code
+    r123::seed_seq ss(seeds.begin(), seeds.end());
+    std::vector<r123::Philox4x32::ukey_type> uk(n);
+    ss.child_ukeys(&uk[0], n);
+    for(size_t i=0; i<n; ++i)
+        pool.push_back(r123::Engine<r123::Philox4x32>(uk[i]));
+    @endcode
+    and pool[i] is the same as r123::Engine<r123::Philox4x32>(c) with
+    c = ss.child(i).
+*/
+
+namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+// A SeedSeq that hands out the words at p, for ukey_type::seed.
+struct _seed_seq_words{
+    const uint32_t* p;
+    template <typename It>
+    void generate(It b, It e){
+        for(; b!=e; ++b)
+            *b = *p++;
+    }
+};
+/** \endcond */
+
+class seed_seq{
+public:
+    typedef uint32_t result_type;
+
+    /** A seed_seq with no values. */
+    seed_seq() : v() { init(); }
+    /** A seed_seq with the values in [b, e). */
+    template <typename InputIt>
+    seed_seq(InputIt b, InputIt e) : v(b, e) { init(); }
+#if R123_USE_CXX11
+    template <typename T>
+    seed_seq(std::initializer_list<T> il) : v(il.begin(), il.end()) { init(); }
+#endif
+
+    /** Fills [b, e) with 32-bit words, as described above. */
+    template <typename RandomIt>
+    void generate(RandomIt b, RandomIt e) const{
+        threefry4x64_ctr_t x[batch];
+        threefry4x64_ctr_t c = {{0, 0, 0, 0}};
+        while(b != e){
+            size_t nw = static_cast<size_t>(e-b);
+            size_t nb = (nw+7)/8 < size_t(batch) ? (nw+7)/8 : size_t(batch);
+            blocks(c, k, x, nb);
+            c.v[0] += nb;
+            for(size_t j=0; j<nb; ++j)
+                for(size_t w=0; w<8 && b!=e; ++w, ++b)
+                    *b = static_cast<result_type>(x[j].v[w/2] >> (32*(w%2)));
+        }
+    }
+
+    size_t size() const { return v.size(); }
+
+    template <typename OutputIt>
+    void param(OutputIt o) const{
+        for(size_t i=0; i<v.size(); ++i)
+            *o++ = v[i];
+    }
+
+    /** The key that generate() encrypts its counters with. */
+    const threefry4x64_key_t& key() const { return k; }
+
+    /** Child i of this seed_seq. */
+    seed_seq child(uint64_t i) const{
+        threefry4x64_ctr_t c = {{i, 0, 0, 1}};
+        c = threefry4x64_R(rounds, c, k);
+        result_type w[8];
+        for(size_t j=0; j<8; ++j)
+            w[j] = static_cast<result_type>(c.v[j/2] >> (32*(j%2)));
+        return seed_seq(w, w+8);
+    }
+
+    /** out[j] = UK::seed(c), c = child(first+j), for j < n. */
+    template <typename UK>
+    void child_ukeys(UK* out, size_t n, uint64_t first=0) const{
+        typedef typename UK::value_type value_type;
+        const size_t Ngen = sizeof(UK().v)/sizeof(value_type)*((3+sizeof(value_type))/4);
+        const size_t nblk = (Ngen+7)/8;
+        const skein256_key_t ik = ivkey();
+        threefry4x64_ctr_t x[batch], c[batch];
+        threefry4x64_key_t ck[batch];
+        unsigned char m[batch*32], h[batch*32];
+        const void* msgs[batch];
+        size_t lens[batch];
+        std::vector<uint32_t> u32(batch*nblk*8);
+        for(size_t i=0; i<n; ){
+            uint64_t c0 = first+i;
+            size_t nb = n-i < size_t(batch) ? n-i : size_t(batch);
+            // Child indices are mod 2^64; the fill would carry into
+            // the next word.
+            if(c0+(nb-1) < c0)
+                nb = static_cast<size_t>(0-c0);
+            threefry4x64_ctr_t cc = {{c0, 0, 0, 1}};
+            blocks(cc, k, x, nb);
+            // The 32 bytes of the values of child(c0+j), as hashed by init.
+            for(size_t j=0; j<nb; ++j){
+                for(size_t w=0; w<4; ++w)
+                    _skein_store64(m+32*j+8*w, x[j].v[w], 8);
+                msgs[j] = m+32*j;
+                lens[j] = 32;
+            }
+            skein256_R_multi(rounds, &ik, msgs, lens, nb, h);
+            for(size_t j=0; j<nb; ++j)
+                for(size_t w=0; w<4; ++w)
+                    ck[j].v[w] = _skein_load64(h+32*j+8*w);
+            for(size_t q=0; q<nblk; ++q){
+                threefry4x64_ctr_t cq = {{q, 0, 0, 0}};
+                for(size_t j=0; j<nb; ++j)
+                    c[j] = cq;
+                multikey(c, ck, x, nb);
+                for(size_t j=0; j<nb; ++j)
+                    for(size_t w=0; w<8; ++w)
+                        u32[(j*nblk+q)*8+w] = static_cast<uint32_t>(x[j].v[w/2] >> (32*(w%2)));
+            }
+            for(size_t j=0; j<nb; ++j){
+                _seed_seq_words s = {&u32[j*nblk*8]};
+                out[i+j] = UK::seed(s);
+            }
+            i += nb;
+        }
+    }
+
+private:
+    enum { rounds = threefry4x64_rounds, batch = 64 };
+    std::vector<result_type> v;
+    threefry4x64_key_t k;
+
+    // skein256keyinit_R(rounds, 0, 0, 32), precomputed as the Skein
+    // reference code precomputes its IVs.  The known answers of
+    // ut_seed_seq check it.
+    static skein256_key_t ivkey(){
+        skein256_key_t ik = {{{R123_64BIT(0x1751647688c157e7), R123_64BIT(0x555ee71b6ac51175),
+                               R123_64BIT(0x77fa7ec22a53792a), R123_64BIT(0x281915c7f3598ce7)}}, 32};
+        return ik;
+    }
+
+    void init(){
+        const skein256_key_t ik = ivkey();
+        unsigned char buf[256] = {0}, h[32];
+        std::vector<unsigned char> big;
+        unsigned char* m = buf;
+        if(4*v.size() > sizeof(buf)){
+            big.resize(4*v.size());
+            m = &big[0];
+        }
+        for(size_t i=0; i<v.size(); ++i)
+            for(size_t j=0; j<4; ++j)
+                m[4*i+j] = static_cast<unsigned char>(v[i] >> (8*j));
+        skein256_R(rounds, &ik, m, 4*v.size(), h);
+        for(size_t w=0; w<4; ++w)
+            k.v[w] = _skein_load64(h+8*w);
+    }
+
+    // out[j] = threefry4x64_R(rounds, c0+j, key), c0+j as by incr.
+    static void blocks(threefry4x64_ctr_t c0, const threefry4x64_key_t& key, threefry4x64_ctr_t* out, size_t n){
+#if R123_USE_AVX2
+        threefry4x64_R_fill(rounds, c0, key, out, n);
+#else
+        for(size_t j=0; j<n; ++j){
+            out[j] = threefry4x64_R(rounds, c0, key);
+            c0.incr();
+        }
+#endif
+    }
+
+    static void multikey(const threefry4x64_ctr_t* in, const threefry4x64_key_t* keys, threefry4x64_ctr_t* out, size_t n){
+#if R123_USE_AVX2
+        threefry4x64_R_multikey(rounds, in, keys, out, n);
+#else
+        for(size_t j=0; j<n; ++j)
+            out[j] = threefry4x64_R(rounds, in[j], keys[j]);
+#endif
+    }
+};
+} // namespace r123
+
+#endif
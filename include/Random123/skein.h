@@ -0,0 +1,502 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __Random123_skein_dot_h__
+#define __Random123_skein_dot_h__
+
+#include "features/compilerfeatures.h"
+#include "threefry.h"
+
+/** \file skein.h
+
+    Hashing of byte strings of any length into keys and counters, with
+    the Unique Block Iteration (UBI) chaining mode of the Skein hash
+    function (Ferguson et al., "The Skein Hash Function Family",
+    version 1.3) over Threefish-256.  Threefish-256 is threefry4x64
+    with a 128-bit tweak;  UBI feeds a message through it 32 bytes at
+    a time, each block keyed by the chaining value of the blocks
+    before it and tweaked by the number of bytes so far and by the
+    type of the message.
+
+    skein256_R computes Skein-256 with an output of any number of
+    bytes, optionally keyed (Skein-MAC).  With R=72 (skein256_rounds)
+    the output is exactly that of Skein-256, and is checked against
+    Skein's known answers in ut_skein.  Fewer rounds are faster, but
+    then it is not Skein, and has not been analyzed as a hash.  The
+    key, which includes the configuration block, is made once by
+    skein256keyinit_R.
+
+    skein256_R_multi hashes many messages at once.  With AVX-512,
+    sixteen messages at a time go through the rounds together, in the
+    lanes of 512-bit vectors, in step, so that sixteen cost about as
+    much as the longest of them; sorting messages of very different
+    lengths by length first may help.  Without AVX-512, which has the
+    only 64-bit vector rotation, it calls skein256_R on each.
+
+    In C++, r123::skein_hash<Out, R> hashes strings into an r123array
+    Out, e.g., to derive Threefry4x64::ukey_type or Philox4x32::ctr_type
+    from names:
+
+    @code
+    r123::skein_hash<Threefry4x64::ukey_type> h;
+    Threefry4x64::ukey_type uk = h("run-2041/entity-17");
+    std::vector<std::string> names = ...;
+    std::vector<Philox4x32::ukey_type> keys(names.size());
+    r123::skein_hash<Philox4x32::ukey_type>("my seed")(&names[0], names.size(), &keys[0]);
+    @endcode
+*/
+
+/** @ingroup ThreefryNxW */
+typedef struct r123array2x64 threefish256_tweak_t;
+
+/** @ingroup ThreefryNxW
+    The Skein key (Skein-MAC), configuration, message and output
+    types of UBI, and the rounds of Threefish-256 in Skein-256. */
+enum r123_enum_skein256 { ubi_type_key = 0, ubi_type_cfg = 4, ubi_type_msg = 48, ubi_type_out = 63,
+                          skein256_rounds = 72 };
+
+/** @ingroup ThreefryNxW
+    The chaining value of Skein-256 after its key and configuration
+    blocks, and the number of bytes of output, made by
+    skein256keyinit_R. */
+typedef struct skein256_key_t{
+    threefry4x64_key_t g;
+    size_t outlen;
+} skein256_key_t;
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* Skein is little-endian:  bytes are assembled into words, and
+   words taken apart, with shifts, which compilers turn into plain
+   loads and stores on little-endian machines. */
+R123_STATIC_INLINE uint64_t _skein_load64(const unsigned char* p){
+    return (uint64_t)p[0] | ((uint64_t)p[1]<<8) | ((uint64_t)p[2]<<16) | ((uint64_t)p[3]<<24) |
+        ((uint64_t)p[4]<<32) | ((uint64_t)p[5]<<40) | ((uint64_t)p[6]<<48) | ((uint64_t)p[7]<<56);
+}
+
+/* The first n bytes of x, all 8 if n >= 8. */
+R123_STATIC_INLINE void _skein_store64(unsigned char* p, uint64_t x, size_t n){
+    size_t i;
+    if(n >= 8){
+        p[0] = (unsigned char)x; p[1] = (unsigned char)(x>>8);
+        p[2] = (unsigned char)(x>>16); p[3] = (unsigned char)(x>>24);
+        p[4] = (unsigned char)(x>>32); p[5] = (unsigned char)(x>>40);
+        p[6] = (unsigned char)(x>>48); p[7] = (unsigned char)(x>>56);
+    }else{
+        for(i=0; i<n; ++i)
+            p[i] = (unsigned char)(x>>(8*i));
+    }
+}
+
+/* The n <= 32 bytes at p, padded with zeros, as four words. */
+R123_STATIC_INLINE void _skein256_loadblock(const unsigned char* p, size_t n, uint64_t* w){
+    size_t i, j;
+    for(i=0; i<4; ++i){
+        if(8*i+8 <= n){
+            w[i] = _skein_load64(p+8*i);
+        }else{
+            w[i] = 0;
+            for(j=8*i; j<n; ++j)
+                w[i] |= (uint64_t)p[j] << (8*(j-8*i));
+        }
+    }
+}
+
+/* Up to 32 bytes of the output block w. */
+R123_STATIC_INLINE void _skein256_storeblock(unsigned char* p, const uint64_t* w, size_t n){
+    size_t i;
+    for(i=0; 8*i<n && i<4; ++i)
+        _skein_store64(p+8*i, w[i], n-8*i);
+}
+
+R123_STATIC_INLINE uint64_t _ubi_tweak1(unsigned int type, int first, int final){
+    return ((uint64_t)type<<56) | ((uint64_t)(first!=0)<<62) | ((uint64_t)(final!=0)<<63);
+}
+
+#define _threefish256mix(a, b, rot) { a += b; b = RotL_64(b, rot); b ^= a; }
+#define _threefish256inject(s) {                                        \
+        x0 += ks[(s)%5]; x1 += ks[((s)+1)%5] + ts[(s)%3];               \
+        x2 += ks[((s)+2)%5] + ts[((s)+1)%3]; x3 += ks[((s)+3)%5] + (s); \
+    }
+/* Rounds r..r+3, with the rotations of rows a..a+3, followed by
+   InjectKey((r+4)/4).  As in threefry4x64_R, the words are renamed
+   rather than permuted. */
+#define _threefish256four(r, a, b, c, d)                                \
+    if(R>(r)){   _threefish256mix(x0, x1, R_64x4_##a##_0); _threefish256mix(x2, x3, R_64x4_##a##_1); } \
+    if(R>(r)+1){ _threefish256mix(x0, x3, R_64x4_##b##_0); _threefish256mix(x2, x1, R_64x4_##b##_1); } \
+    if(R>(r)+2){ _threefish256mix(x0, x1, R_64x4_##c##_0); _threefish256mix(x2, x3, R_64x4_##c##_1); } \
+    if(R>(r)+3){ _threefish256mix(x0, x3, R_64x4_##d##_0); _threefish256mix(x2, x1, R_64x4_##d##_1); \
+        _threefish256inject((r)/4+1); }
+#define _threefish256eight(r) _threefish256four(r, 0, 1, 2, 3) _threefish256four((r)+4, 4, 5, 6, 7)
+/** \endcond */
+
+/** @ingroup ThreefryNxW
+    Returns R rounds, at most 72, of the Threefish-256 block cipher on
+    the four words of in, with the key k and the tweak t.  With a tweak
+    of zero it is threefry4x64_R. */
+R123_STATIC_INLINE R123_FORCE_INLINE(threefry4x64_ctr_t threefish256_R(unsigned int R, threefry4x64_ctr_t in, threefry4x64_key_t k, threefish256_tweak_t t));
+R123_STATIC_INLINE threefry4x64_ctr_t threefish256_R(unsigned int R, threefry4x64_ctr_t in, threefry4x64_key_t k, threefish256_tweak_t t){
+    uint64_t ks[5], ts[3], x0, x1, x2, x3;
+    R123_ASSERT(R<=72);
+    ks[0] = k.v[0]; ks[1] = k.v[1]; ks[2] = k.v[2]; ks[3] = k.v[3];
+    ks[4] = SKEIN_KS_PARITY64 ^ ks[0] ^ ks[1] ^ ks[2] ^ ks[3];
+    ts[0] = t.v[0]; ts[1] = t.v[1]; ts[2] = ts[0] ^ ts[1];
+    x0 = in.v[0] + ks[0]; x1 = in.v[1] + ks[1] + ts[0];
+    x2 = in.v[2] + ks[2] + ts[1]; x3 = in.v[3] + ks[3];
+    _threefish256eight(0) _threefish256eight(8) _threefish256eight(16)
+    _threefish256eight(24) _threefish256eight(32) _threefish256eight(40)
+    _threefish256eight(48) _threefish256eight(56) _threefish256eight(64)
+    in.v[0] = x0; in.v[1] = x1; in.v[2] = x2; in.v[3] = x3;
+    return in;
+}
+
+/** @ingroup ThreefryNxW
+    Returns the chaining value after UBI with the n bytes at msg, of
+    the given type (ubi_type_msg, etc.), starting from the chaining
+    value g:  g is the key of R rounds of Threefish-256, and each block
+    is xored with its own encryption to make the next g.  An empty
+    message is a single block of zeros. */
+R123_STATIC_INLINE threefry4x64_key_t ubi256_R(unsigned int R, threefry4x64_key_t g, const void* msg, size_t n, unsigned int type){
+    const unsigned char* p = (const unsigned char*)msg;
+    threefry4x64_ctr_t m, h;
+    threefish256_tweak_t t;
+    size_t len;
+    int first = 1, i;
+    t.v[0] = 0;
+    do{
+        len = n < 32 ? n : 32;
+        _skein256_loadblock(p, len, m.v);
+        p += len; n -= len;
+        t.v[0] += len;
+        t.v[1] = _ubi_tweak1(type, first, n==0);
+        h = threefish256_R(R, m, g, t);
+        for(i=0; i<4; ++i)
+            g.v[i] = h.v[i] ^ m.v[i];
+        first = 0;
+    }while(n);
+    return g;
+}
+
+/** @ingroup ThreefryNxW
+    Returns the key of Skein-256 (with R rounds of Threefish) for
+    outlen bytes of output, and the keylen bytes at key for Skein-MAC,
+    or no key if keylen is 0. */
+R123_STATIC_INLINE skein256_key_t skein256keyinit_R(unsigned int R, const void* key, size_t keylen, size_t outlen){
+    skein256_key_t k;
+    unsigned char cfg[32];
+    int i;
+    R123_ASSERT(outlen > 0);
+    for(i=0; i<4; ++i)
+        k.g.v[i] = 0;
+    if(keylen)
+        k.g = ubi256_R(R, k.g, key, keylen, ubi_type_key);
+    /* "SHA3", version 1, the output length in bits, and no tree. */
+    for(i=0; i<32; ++i)
+        cfg[i] = 0;
+    cfg[0] = 'S'; cfg[1] = 'H'; cfg[2] = 'A'; cfg[3] = '3'; cfg[4] = 1;
+    _skein_store64(cfg+8, (uint64_t)outlen*8, 8);
+    k.g = ubi256_R(R, k.g, cfg, 32, ubi_type_cfg);
+    k.outlen = outlen;
+    return k;
+}
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* Output block i from the chaining value g after the message. */
+R123_STATIC_INLINE void _skein256_output(unsigned int R, threefry4x64_key_t g, size_t i, unsigned char* out, size_t n){
+    threefry4x64_ctr_t m = {{0, 0, 0, 0}}, h;
+    threefish256_tweak_t t;
+    m.v[0] = i;
+    t.v[0] = 8;
+    t.v[1] = _ubi_tweak1(ubi_type_out, 1, 1);
+    h = threefish256_R(R, m, g, t);
+    h.v[0] ^= m.v[0];
+    _skein256_storeblock(out, h.v, n);
+}
+/** \endcond */
+
+/** @ingroup ThreefryNxW
+    Writes k->outlen bytes of the Skein-256 hash (with R rounds) of the
+    n bytes at msg to out.  R should be that given to
+    skein256keyinit_R. */
+R123_STATIC_INLINE void skein256_R(unsigned int R, const skein256_key_t* k, const void* msg, size_t n, void* out){
+    threefry4x64_key_t g = ubi256_R(R, k->g, msg, n, ubi_type_msg);
+    unsigned char* o = (unsigned char*)out;
+    size_t i;
+    for(i=0; 32*i < k->outlen; ++i)
+        _skein256_output(R, g, i, o+32*i, k->outlen-32*i);
+}
+
+#if R123_USE_AVX512
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* threefish256_R on nb groups of lanes of vectors with tag TAG, with
+   x[4*b+j] holding word j of group b, k[4*b+j] word j of its keys
+   and t[2*b+j] word j of its tweaks.  The rounds are unrolled as in
+   threefish256_R, so that the words stay in registers and the
+   rotation counts are constants. */
+#define _threefish256vmix(TAG, a, b, rot)                              \
+    for(g=0; g<nb; ++g){                                                \
+        x[4*g+a] = _r123_add_##TAG(x[4*g+a], x[4*g+b]);                 \
+        x[4*g+b] = _r123_xor_##TAG(_r123_rotl_##TAG(x[4*g+b], rot), x[4*g+a]); \
+    }
+#define _threefish256vinject(TAG, s)                                    \
+    for(g=0; g<nb; ++g){                                                \
+        const _r123_##TAG##_t* ksg = ks+5*g;                            \
+        const _r123_##TAG##_t* tsg = ts+3*g;                            \
+        x[4*g] = _r123_add_##TAG(x[4*g], ksg[(s)%5]);                   \
+        x[4*g+1] = _r123_add_##TAG(x[4*g+1], _r123_add_##TAG(ksg[((s)+1)%5], tsg[(s)%3])); \
+        x[4*g+2] = _r123_add_##TAG(x[4*g+2], _r123_add_##TAG(ksg[((s)+2)%5], tsg[((s)+1)%3])); \
+        x[4*g+3] = _r123_add_##TAG(x[4*g+3], _r123_add_##TAG(ksg[((s)+3)%5], _r123_set1_##TAG(s))); \
+    }
+#define _threefish256vfour(TAG, r, a, b, c, d)                          \
+    if(R>(r)){   _threefish256vmix(TAG, 0, 1, R_64x4_##a##_0) _threefish256vmix(TAG, 2, 3, R_64x4_##a##_1) } \
+    if(R>(r)+1){ _threefish256vmix(TAG, 0, 3, R_64x4_##b##_0) _threefish256vmix(TAG, 2, 1, R_64x4_##b##_1) } \
+    if(R>(r)+2){ _threefish256vmix(TAG, 0, 1, R_64x4_##c##_0) _threefish256vmix(TAG, 2, 3, R_64x4_##c##_1) } \
+    if(R>(r)+3){ _threefish256vmix(TAG, 0, 3, R_64x4_##d##_0) _threefish256vmix(TAG, 2, 1, R_64x4_##d##_1) \
+        _threefish256vinject(TAG, (r)/4+1) }
+#define _threefish256veight(TAG, r) _threefish256vfour(TAG, r, 0, 1, 2, 3) _threefish256vfour(TAG, (r)+4, 4, 5, 6, 7)
+
+#define _threefish256lanes_tpl(TAG)                                     \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _threefish256_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, const _r123_##TAG##_t* k, const _r123_##TAG##_t* t)); \
+R123_STATIC_INLINE void _threefish256_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, const _r123_##TAG##_t* k, const _r123_##TAG##_t* t){ \
+    _r123_##TAG##_t ks[5*4], ts[3*4];                                   \
+    unsigned int g, i;                                                  \
+    R123_ASSERT(R<=72 && nb<=4);                                        \
+    for(g=0; g<nb; ++g){                                                \
+        ks[5*g+4] = _r123_set1_##TAG(SKEIN_KS_PARITY64);                \
+        for(i=0; i<4; ++i){                                             \
+            ks[5*g+i] = k[4*g+i];                                       \
+            ks[5*g+4] = _r123_xor_##TAG(ks[5*g+4], k[4*g+i]);           \
+        }                                                               \
+        ts[3*g] = t[2*g];                                               \
+        ts[3*g+1] = t[2*g+1];                                           \
+        ts[3*g+2] = _r123_xor_##TAG(t[2*g], t[2*g+1]);                  \
+    }                                                                   \
+    _threefish256vinject(TAG, 0)                                        \
+    _threefish256veight(TAG, 0) _threefish256veight(TAG, 8) _threefish256veight(TAG, 16) \
+    _threefish256veight(TAG, 24) _threefish256veight(TAG, 32) _threefish256veight(TAG, 40) \
+    _threefish256veight(TAG, 48) _threefish256veight(TAG, 56) _threefish256veight(TAG, 64) \
+}
+
+_threefish256lanes_tpl(u64x8)
+
+/* skein256_R_multi with AVX-512, sixteen messages at a time in the
+   lanes of two groups of vectors.  The lanes go through the message
+   blocks in step, as many as the longest message of the sixteen has,
+   each lane keeping its chaining value once its own message is done,
+   and then through the output blocks.  The words of the message
+   blocks are gathered into the vectors from the blocks of the lanes,
+   which are assembled one after another. */
+R123_STATIC_INLINE void _skein256_R_multi_u64x8(unsigned int R, const skein256_key_t* k, const void* const* msgs, const size_t* lens, size_t nmsg, unsigned char* out){
+    uint64_t mb[16][4], tb[2][16], hb[4][16], nblk[16];
+    __m512i x[8], g[8], t[4], nbv[2], h;
+    const __m512i idx = _mm512_set_epi64(28, 24, 20, 16, 12, 8, 4, 0);
+    __mmask8 keep;
+    size_t outlen = k->outlen, i0, n, l, j, b, nb, len, off;
+    for(i0=0; i0<nmsg; i0+=16){
+        n = nmsg-i0 < 16 ? nmsg-i0 : 16;
+        nb = 1;
+        for(l=0; l<16; ++l){
+            len = l<n ? lens[i0+l] : 0;
+            nblk[l] = len ? (len+31)/32 : 1;
+            nb = nblk[l] > nb ? (size_t)nblk[l] : nb;
+        }
+        for(j=0; j<8; ++j)
+            g[j] = _mm512_set1_epi64((long long)k->g.v[j%4]);
+        nbv[0] = _mm512_loadu_si512((const void*)nblk);
+        nbv[1] = _mm512_loadu_si512((const void*)(nblk+8));
+        /* The message blocks, then the output blocks. */
+        for(b=0; b<nb+(outlen+31)/32; ++b){
+            if(b < nb){
+                off = 32*b;
+                for(l=0; l<16; ++l){
+                    len = l<n ? lens[i0+l] : 0;
+                    len = len > off ? len-off : 0;
+                    len = len < 32 ? len : 32;
+                    _skein256_loadblock(len ? (const unsigned char*)msgs[i0+l]+off : (const unsigned char*)0, len, mb[l]);
+                    tb[0][l] = off+len;
+                    tb[1][l] = _ubi_tweak1(ubi_type_msg, b==0, b+1==nblk[l]);
+                }
+                for(l=0; l<2; ++l){
+                    for(j=0; j<4; ++j)
+                        x[4*l+j] = _mm512_i64gather_epi64(idx, (const void*)&mb[8*l][j], 8);
+                    t[2*l] = _mm512_i64gather_epi64(_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0), (const void*)(tb[0]+8*l), 8);
+                    t[2*l+1] = _mm512_i64gather_epi64(_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0), (const void*)(tb[1]+8*l), 8);
+                }
+            }else{
+                for(l=0; l<2; ++l){
+                    x[4*l] = _mm512_set1_epi64((long long)(b-nb));
+                    x[4*l+1] = x[4*l+2] = x[4*l+3] = _mm512_setzero_si512();
+                    t[2*l] = _mm512_set1_epi64(8);
+                    t[2*l+1] = _mm512_set1_epi64((long long)_ubi_tweak1(ubi_type_out, 1, 1));
+                }
+            }
+            {
+                __m512i m[8];
+                for(j=0; j<8; ++j)
+                    m[j] = x[j];
+                _threefish256_R_u64x8(R, x, 2, g, t);
+                for(l=0; l<2; ++l){
+                    keep = _mm512_cmpge_epu64_mask(_mm512_set1_epi64((long long)b), nbv[l]);
+                    for(j=0; j<4; ++j){
+                        h = _mm512_xor_si512(x[4*l+j], m[4*l+j]);
+                        if(b < nb)
+                            g[4*l+j] = _mm512_mask_blend_epi64(keep, h, g[4*l+j]);
+                        else
+                            _mm512_storeu_si512((void*)(hb[j]+8*l), h);
+                    }
+                }
+            }
+            if(b >= nb){
+                off = 32*(b-nb);
+                for(l=0; l<n; ++l){
+                    uint64_t w[4];
+                    for(j=0; j<4; ++j)
+                        w[j] = hb[j][l];
+                    _skein256_storeblock(out+(i0+l)*outlen+off, w, outlen-off);
+                }
+            }
+        }
+    }
+}
+/** \endcond */
+#endif
+
+/** @ingroup ThreefryNxW
+    Writes the k->outlen-byte Skein-256 hashes (with R rounds) of the
+    nmsg messages of lens[i] bytes at msgs[i] to out, the hash of
+    message i at out+i*k->outlen.  The same as calling skein256_R on
+    each, but, with AVX-512, sixteen messages go through the rounds
+    together.  The messages, and out, need not be aligned. */
+R123_STATIC_INLINE void skein256_R_multi(unsigned int R, const skein256_key_t* k, const void* const* msgs, const size_t* lens, size_t nmsg, void* out){
+#if R123_USE_AVX512
+    _skein256_R_multi_u64x8(R, k, msgs, lens, nmsg, (unsigned char*)out);
+#else
+    size_t i;
+    for(i=0; i<nmsg; ++i)
+        skein256_R(R, k, msgs[i], lens[i], (unsigned char*)out+i*k->outlen);
+#endif
+}
+
+/** @ingroup ThreefryNxW */
+#define skein256keyinit(key, keylen, outlen) skein256keyinit_R(skein256_rounds, key, keylen, outlen)
+/** @ingroup ThreefryNxW */
+#define skein256(k, msg, n, out) skein256_R(skein256_rounds, k, msg, n, out)
+/** @ingroup ThreefryNxW */
+#define skein256_multi(k, msgs, lens, nmsg, out) skein256_R_multi(skein256_rounds, k, msgs, lens, nmsg, out)
+
+#ifdef __cplusplus
+#include <string>
+#include <limits>
+
+namespace r123{
+/** @ingroup ThreefryNxW
+    skein_hash<Out, R> hashes byte strings into the r123array Out (any
+    r123arrayNxW), with Skein-256 for 8*sizeof(Out) bits of output,
+    with R rounds of Threefish-256, optionally keyed.  The bytes of the
+    hash fill the words of Out little-endian, so that, e.g., a
+    skein_hash<r123array4x64> and a skein_hash<r123array8x32> give the
+    same bits.  See skein.h.
+
+    operator()(s, n, out) hashes n strings at once, through
+    skein256_R_multi. */
+template <typename Out = r123array4x64, unsigned int R = skein256_rounds>
+class skein_hash{
+public:
+    typedef Out result_type;
+    typedef typename Out::value_type value_type;
+
+    /** Unkeyed Skein-256. */
+    skein_hash() : k(skein256keyinit_R(R, 0, 0, sizeof(Out().v))) { check(); }
+    /** Skein-MAC with the keylen bytes at key. */
+    skein_hash(const void* key, size_t keylen) : k(skein256keyinit_R(R, key, keylen, sizeof(Out().v))) { check(); }
+    /** Skein-MAC with the bytes of key. */
+    explicit skein_hash(const std::string& key) : k(skein256keyinit_R(R, key.data(), key.size(), sizeof(Out().v))) { check(); }
+
+    const skein256_key_t& key() const { return k; }
+
+    /** The hash of the n bytes at msg. */
+    Out operator()(const void* msg, size_t n) const{
+        unsigned char b[sizeof(Out().v)];
+        skein256_R(R, &k, msg, n, b);
+        return words(b);
+    }
+    /** The hash of the bytes of s. */
+    Out operator()(const std::string& s) const{
+        return (*this)(s.data(), s.size());
+    }
+    /** out[i] = (*this)(msgs[i], lens[i]) for i < n. */
+    void operator()(const void* const* msgs, const size_t* lens, size_t n, Out* out) const{
+        unsigned char b[batch*sizeof(Out().v)];
+        for(size_t i=0; i<n; i+=batch){
+            size_t nb = n-i < size_t(batch) ? n-i : size_t(batch);
+            skein256_R_multi(R, &k, msgs+i, lens+i, nb, b);
+            for(size_t j=0; j<nb; ++j)
+                out[i+j] = words(b+j*sizeof(Out().v));
+        }
+    }
+    /** out[i] = (*this)(s[i]) for i < n. */
+    void operator()(const std::string* s, size_t n, Out* out) const{
+        const void* msgs[batch];
+        size_t lens[batch];
+        for(size_t i=0; i<n; i+=batch){
+            size_t nb = n-i < size_t(batch) ? n-i : size_t(batch);
+            for(size_t j=0; j<nb; ++j){
+                msgs[j] = s[i+j].data();
+                lens[j] = s[i+j].size();
+            }
+            (*this)(msgs, lens, nb, out+i);
+        }
+    }
+
+private:
+    enum { batch = 64 };
+    skein256_key_t k;
+
+    static void check(){
+        R123_STATIC_ASSERT(std::numeric_limits<value_type>::is_integer && !std::numeric_limits<value_type>::is_signed && R <= 72,
+                           "skein_hash needs an r123array of unsigned integers, and at most 72 rounds\n");
+    }
+
+    static Out words(const unsigned char* b){
+        Out o;
+        const size_t W = sizeof(value_type);
+        for(size_t i=0; i<sizeof(o.v)/W; ++i){
+            uint64_t w = 0;
+            for(size_t j=0; j<W; ++j)
+                w |= (uint64_t)b[W*i+j] << (8*j);
+            o.v[i] = (value_type)w;
+        }
+        return o;
+    }
+};
+} // namespace r123
+#endif /* __cplusplus */
+
+#endif
@@ -0,0 +1,272 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_stream_table_dot_hpp__
+#define __r123_stream_table_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "philox.h"
+#include "threefry.h"
+#include <stdexcept>
+#include <limits>
+#include <vector>
+#include <cstddef>
+
+/** \file stream_table.hpp
+
+    r123::stream_table<CBRNG> holds the random number streams of many
+    entities (e.g., one per particle), all under one key, in much less
+    space than an array of MicroURNG<CBRNG>s.  A MicroURNG keeps its
+    own copy of the key, its counter and its last block, 64 bytes for
+    Philox4x32;  an entity in a stream_table is just the number of
+    words it has drawn, one ctr_type::value_type (4 bytes for
+    Philox4x32, 8 for Philox4x64), held in a single array.
+
+    Entity e's stream is made of the blocks b(c, k) for the counters c
+    whose word 0 is 0, 1, 2, ..., whose word 1 is word 1 of the
+    table's base counter plus e, and whose other words are those of
+    the base counter, taken a word at a time in order.  Different base
+    counters (e.g., one per time step) give independent tables.  The
+    ctr_type must have at least two words and an unsigned integral
+    value_type;  a table may have at most 2^W entities, for W-bit
+    words.
+
+    draw(ids, m, out) takes the next word of each of the m entities
+    ids[0], ..., ids[m-1] (which may repeat), making the blocks for a
+    batch of entities at a time, and for Philox4x32_R, Philox4x64_R,
+    Threefry4x32_R and Threefry4x64_R, encrypting them in vector
+    registers with the widest of the multi-lane functions (e.g.,
+    philox4x32_R_x16) that is available.  Since only the position is
+    stored, each word drawn costs a block;  draw_blocks(ids, m, out)
+    takes whole blocks, starting each at the next block boundary of
+    its entity's stream, for callers that can use every word.
+
+    std::runtime_error is thrown when an entity's stream is exhausted,
+    after 2^W-1 words, and std::invalid_argument if the table is too
+    large for the counter.  The entity ids are not checked.
+
+    @code
+    r123::stream_table<r123::Philox4x32> t(nparticles, key);
+    ...
+    t.draw(&ids[0], ids.size(), &u[0]);    // one 32-bit word per id
+    @endcode
+*/
+
+namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+// x[i] = b(x[i], k) for i in [0, n), one block at a time unless there
+// are multi-lane functions for b.
+template <typename CBRNG>
+void _encrypt_blocks(CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type* x, size_t n){
+    for(size_t i=0; i<n; ++i)
+        x[i] = b(x[i], k);
+}
+
+#if R123_USE_SSE || R123_USE_NEON
+template <unsigned int R>
+void _encrypt_blocks(Philox4x32_R<R>&, const philox4x32_key_t& k, philox4x32_ctr_t* x, size_t n){
+    R123_STATIC_ASSERT(R<=16, "philox is only unrolled up to 16 rounds\n");
+    size_t i = 0;
+#if R123_USE_AVX512
+    for(; i+16<=n; i+=16)
+        philox4x32_R_x16(R, x+i, k, x+i);
+#elif R123_USE_AVX2
+    for(; i+8<=n; i+=8)
+        philox4x32_R_x8(R, x+i, k, x+i);
+#endif
+    for(; i+4<=n; i+=4)
+        philox4x32_R_x4(R, x+i, k, x+i);
+    for(; i<n; ++i)
+        x[i] = philox4x32_R(R, x[i], k);
+}
+
+template <unsigned int R>
+void _encrypt_blocks(Threefry4x32_R<R>&, const threefry4x32_key_t& k, threefry4x32_ctr_t* x, size_t n){
+    R123_STATIC_ASSERT(R<=72, "threefry is only unrolled up to 72 rounds\n");
+    size_t i = 0;
+#if R123_USE_AVX512
+    for(; i+16<=n; i+=16)
+        threefry4x32_R_x16(R, x+i, k, x+i);
+#elif R123_USE_AVX2
+    for(; i+8<=n; i+=8)
+        threefry4x32_R_x8(R, x+i, k, x+i);
+#endif
+    for(; i+4<=n; i+=4)
+        threefry4x32_R_x4(R, x+i, k, x+i);
+    for(; i<n; ++i)
+        x[i] = threefry4x32_R(R, x[i], k);
+}
+#endif
+
+#if R123_USE_PHILOX_64BIT && (R123_USE_AVX2 || R123_USE_AVX512)
+template <unsigned int R>
+void _encrypt_blocks(Philox4x64_R<R>&, const philox4x64_key_t& k, philox4x64_ctr_t* x, size_t n){
+    R123_STATIC_ASSERT(R<=16, "philox is only unrolled up to 16 rounds\n");
+    size_t i = 0;
+#if R123_USE_AVX512
+    for(; i+8<=n; i+=8)
+        philox4x64_R_x8(R, x+i, k, x+i);
+#endif
+#if R123_USE_AVX2
+    for(; i+4<=n; i+=4)
+        philox4x64_R_x4(R, x+i, k, x+i);
+#endif
+    for(; i<n; ++i)
+        x[i] = philox4x64_R(R, x[i], k);
+}
+#endif
+
+#if R123_USE_AVX2 || R123_USE_AVX512
+template <unsigned int R>
+void _encrypt_blocks(Threefry4x64_R<R>&, const threefry4x64_key_t& k, threefry4x64_ctr_t* x, size_t n){
+    R123_STATIC_ASSERT(R<=72, "threefry is only unrolled up to 72 rounds\n");
+    size_t i = 0;
+#if R123_USE_AVX512
+    for(; i+8<=n; i+=8)
+        threefry4x64_R_x8(R, x+i, k, x+i);
+#endif
+#if R123_USE_AVX2
+    for(; i+4<=n; i+=4)
+        threefry4x64_R_x4(R, x+i, k, x+i);
+#endif
+    for(; i<n; ++i)
+        x[i] = threefry4x64_R(R, x[i], k);
+}
+#endif
+/** \endcond */
+
+/** The random number streams of many entities, under one key.  See
+    stream_table.hpp. */
+template <typename CBRNG>
+class stream_table{
+public:
+    typedef CBRNG cbrng_type;
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename CBRNG::key_type key_type;
+    typedef typename ctr_type::value_type value_type;
+
+    /** A table of n entities, each at the start of its stream. */
+    stream_table(size_t n, const key_type& k, const ctr_type& base = ctr_type(), CBRNG b = CBRNG()) :
+        b_(b), k_(k), base_(base), pos_(entities(n)){
+        R123_STATIC_ASSERT(std::numeric_limits<value_type>::is_integer && !std::numeric_limits<value_type>::is_signed && N >= 2,
+                           "stream_table needs a ctr_type of at least two unsigned integers\n");
+    }
+
+    size_t size() const{ return pos_.size(); }
+    const key_type& key() const{ return k_; }
+    const ctr_type& base() const{ return base_; }
+    /** The number of words entity e has drawn. */
+    value_type position(size_t e) const{ return pos_[e]; }
+    /** Sets the number of words entity e has drawn, e.g., to restart
+        its stream at 0. */
+    void seek(size_t e, value_type p){ pos_[e] = p; }
+
+    /** The next word of entity e's stream. */
+    value_type operator()(size_t e){
+        ctr_type c = next(e);
+        value_type j = c[0] % N;
+        c[0] /= N;
+        return b_(c, k_)[j];
+    }
+
+    /** out[i] = the next word of entity ids[i]'s stream, for i in [0, m). */
+    template <typename I>
+    void draw(const I* ids, size_t m, value_type* out){
+        ctr_type x[batch];
+        unsigned char w[batch];
+        for(size_t i=0; i<m; i+=batch){
+            size_t nb = m-i < batch ? m-i : (size_t)batch;
+            for(size_t j=0; j<nb; ++j){
+                x[j] = next(ids[i+j]);
+                w[j] = (unsigned char)(x[j][0] % N);
+                x[j][0] /= N;
+            }
+            _encrypt_blocks(b_, k_, x, nb);
+            for(size_t j=0; j<nb; ++j)
+                out[i+j] = x[j][w[j]];
+        }
+    }
+
+    /** out[i] = the next whole block of entity ids[i]'s stream, for
+        i in [0, m).  A stream that is part way through a block skips
+        the rest of it. */
+    template <typename I>
+    void draw_blocks(const I* ids, size_t m, ctr_type* out){
+        for(size_t i=0; i<m; i+=batch){
+            size_t nb = m-i < batch ? m-i : (size_t)batch;
+            for(size_t j=0; j<nb; ++j){
+                value_type& p = pos_[ids[i+j]];
+                value_type blk = p/N + (p%N != 0);
+                if(blk >= maxpos/N)
+                    exhausted();
+                p = (blk+1)*N;
+                out[i+j] = counter(ids[i+j], blk);
+            }
+            _encrypt_blocks(b_, k_, out+i, nb);
+        }
+    }
+
+private:
+    enum { N = sizeof(ctr_type)/sizeof(value_type), batch = 64 };
+    static const value_type maxpos = ~(value_type)0;
+
+    cbrng_type b_;
+    key_type k_;
+    ctr_type base_;
+    std::vector<value_type> pos_;
+
+    static size_t entities(size_t n){
+        if(n > 0 && (n-1) > (size_t)maxpos)
+            throw std::invalid_argument("stream_table: too many entities for the counter");
+        return n;
+    }
+    ctr_type counter(size_t e, value_type blk) const{
+        ctr_type c = base_;
+        c[0] = blk;
+        c[1] += (value_type)e;
+        return c;
+    }
+    // The counter for entity e's next word, with the position in the
+    // stream, rather than the block number, in word 0.
+    ctr_type next(size_t e){
+        value_type& p = pos_[e];
+        if(p == maxpos)
+            exhausted();
+        return counter(e, p++);
+    }
+    static void exhausted(){
+        throw std::runtime_error("stream_table: an entity's stream is exhausted");
+    }
+};
+
+} // namespace r123
+
+#endif
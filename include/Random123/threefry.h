@@ -151,6 +151,32 @@ enum r123_enum_threefry32x2 {
     //11 rounds: minHW = 32  [ 32 32 32 32 ] */
     };
 
+enum r123_enum_threefry64x8 {
+    /* These are the R_512 constants from the Threefish reference sources
+       with names changed to R_64x8... */
+    R_64x8_0_0=46, R_64x8_0_1=36, R_64x8_0_2=19, R_64x8_0_3=37,
+    R_64x8_1_0=33, R_64x8_1_1=27, R_64x8_1_2=14, R_64x8_1_3=42,
+    R_64x8_2_0=17, R_64x8_2_1=49, R_64x8_2_2=36, R_64x8_2_3=39,
+    R_64x8_3_0=44, R_64x8_3_1= 9, R_64x8_3_2=54, R_64x8_3_3=56,
+    R_64x8_4_0=39, R_64x8_4_1=30, R_64x8_4_2=34, R_64x8_4_3=24,
+    R_64x8_5_0=13, R_64x8_5_1=50, R_64x8_5_2=10, R_64x8_5_3=17,
+    R_64x8_6_0=25, R_64x8_6_1=29, R_64x8_6_2=39, R_64x8_6_3=43,
+    R_64x8_7_0= 8, R_64x8_7_1=35, R_64x8_7_2=56, R_64x8_7_3=22
+};
+
+enum r123_enum_threefry64x16 {
+    /* These are the R1024 constants from the Threefish reference sources
+       with names changed to R_64x16... */
+    R_64x16_0_0=24, R_64x16_0_1=13, R_64x16_0_2= 8, R_64x16_0_3=47, R_64x16_0_4= 8, R_64x16_0_5=17, R_64x16_0_6=22, R_64x16_0_7=37,
+    R_64x16_1_0=38, R_64x16_1_1=19, R_64x16_1_2=10, R_64x16_1_3=55, R_64x16_1_4=49, R_64x16_1_5=18, R_64x16_1_6=23, R_64x16_1_7=52,
+    R_64x16_2_0=33, R_64x16_2_1= 4, R_64x16_2_2=51, R_64x16_2_3=13, R_64x16_2_4=34, R_64x16_2_5=41, R_64x16_2_6=59, R_64x16_2_7=17,
+    R_64x16_3_0= 5, R_64x16_3_1=20, R_64x16_3_2=48, R_64x16_3_3=41, R_64x16_3_4=47, R_64x16_3_5=28, R_64x16_3_6=16, R_64x16_3_7=25,
+    R_64x16_4_0=41, R_64x16_4_1= 9, R_64x16_4_2=37, R_64x16_4_3=31, R_64x16_4_4=12, R_64x16_4_5=47, R_64x16_4_6=44, R_64x16_4_7=30,
+    R_64x16_5_0=16, R_64x16_5_1=34, R_64x16_5_2=56, R_64x16_5_3=51, R_64x16_5_4= 4, R_64x16_5_5=53, R_64x16_5_6=42, R_64x16_5_7=41,
+    R_64x16_6_0=31, R_64x16_6_1=44, R_64x16_6_2=47, R_64x16_6_3=46, R_64x16_6_4=19, R_64x16_6_5=42, R_64x16_6_6=44, R_64x16_6_7=25,
+    R_64x16_7_0= 9, R_64x16_7_1=48, R_64x16_7_2=35, R_64x16_7_3=52, R_64x16_7_4=23, R_64x16_7_5=31, R_64x16_7_6=37, R_64x16_7_7=20
+};
+
 enum r123_enum_threefry_wcnt {
     WCNT2=2,
     WCNT4=4
@@ -187,6 +213,14 @@ R123_CUDA_DEVICE R123_STATIC_INLINE uint32_t RotL_32(uint32_t x, unsigned int N)
 #define THREEFRY4x64_DEFAULT_ROUNDS 20
 #endif
 
+#ifndef THREEFRY8x64_DEFAULT_ROUNDS
+#define THREEFRY8x64_DEFAULT_ROUNDS 20
+#endif
+
+#ifndef THREEFRY16x64_DEFAULT_ROUNDS
+#define THREEFRY16x64_DEFAULT_ROUNDS 20
+#endif
+
 #define _threefry2x_tpl(W)                                              \
 typedef struct r123array2x##W threefry2x##W##_ctr_t;                          \
 typedef struct r123array2x##W threefry2x##W##_key_t;                          \
@@ -735,33 +769,533 @@ _threefry4x_tpl(32)
 #define threefry2x64(c,k) threefry2x64_R(threefry2x64_rounds, c, k)
 #define threefry4x64(c,k) threefry4x64_R(threefry4x64_rounds, c, k)
 
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* Expanded keys:  threefryNxW_xkey_t holds the words added at every
+   key injection that the most rounds need, i.e., k[s][i] =
+   ks[(s+i)%(N+1)], plus s in the last word, made once by
+   threefryNxWxkeyinit, so that threefryNxW_R_xkey does one addition
+   per word at each injection and nothing else with the key.  The
+   rounds come in groups of 4, each followed by an injection.  For
+   Threefry4xW, the rotations repeat every 8 rounds;  Threefry2xW
+   follows threefry2xW_R, in which rounds 20 to 23 repeat the
+   rotations of rounds 16 to 19. */
+#define _threefryNxWxkey_tpl(N, W, NINJ)                                \
+typedef struct { uint##W##_t k[NINJ][N]; } threefry##N##x##W##_xkey_t;  \
+R123_CUDA_DEVICE R123_STATIC_INLINE threefry##N##x##W##_xkey_t threefry##N##x##W##xkeyinit(threefry##N##x##W##_key_t k){ \
+    threefry##N##x##W##_xkey_t xk;                                      \
+    uint##W##_t ks[N+1];                                                \
+    int i, s;                                                           \
+    ks[N] = SKEIN_KS_PARITY##W;                                         \
+    for(i=0; i<N; i++){                                                 \
+        ks[i] = k.v[i];                                                 \
+        ks[N] ^= k.v[i];                                                \
+    }                                                                   \
+    for(s=0; s<NINJ; s++){                                              \
+        for(i=0; i<N; i++)                                              \
+            xk.k[s][i] = ks[(s+i)%(N+1)];                               \
+        xk.k[s][N-1] += (uint##W##_t)s;                                 \
+    }                                                                   \
+    return xk;                                                          \
+}
+
+#define _threefry2xWmix(W, r) { X.v[0] += X.v[1]; X.v[1] = RotL_##W(X.v[1],R_##W##x2_##r##_0); X.v[1] ^= X.v[0]; }
+#define _threefry2xWinject(s) { X.v[0] += xk.k[s][0]; X.v[1] += xk.k[s][1]; }
+#define _threefry2xWxkey4_tpl(W, r0, s, a, b, c, d)                     \
+    if(Nrounds>r0+0) _threefry2xWmix(W, a)                              \
+    if(Nrounds>r0+1) _threefry2xWmix(W, b)                              \
+    if(Nrounds>r0+2) _threefry2xWmix(W, c)                              \
+    if(Nrounds>r0+3) _threefry2xWmix(W, d)                              \
+    if(Nrounds>r0+3) _threefry2xWinject(s)
+
+#define _threefry4xWmixeven(W, r) {                                     \
+        X.v[0] += X.v[1]; X.v[1] = RotL_##W(X.v[1],R_##W##x4_##r##_0); X.v[1] ^= X.v[0]; \
+        X.v[2] += X.v[3]; X.v[3] = RotL_##W(X.v[3],R_##W##x4_##r##_1); X.v[3] ^= X.v[2]; }
+#define _threefry4xWmixodd(W, r) {                                      \
+        X.v[0] += X.v[3]; X.v[3] = RotL_##W(X.v[3],R_##W##x4_##r##_0); X.v[3] ^= X.v[0]; \
+        X.v[2] += X.v[1]; X.v[1] = RotL_##W(X.v[1],R_##W##x4_##r##_1); X.v[1] ^= X.v[2]; }
+#define _threefry4xWinject(s) { X.v[0] += xk.k[s][0]; X.v[1] += xk.k[s][1]; X.v[2] += xk.k[s][2]; X.v[3] += xk.k[s][3]; }
+#define _threefry4xWxkey8_tpl(W, r0, s)                                 \
+    if(Nrounds>r0+0) _threefry4xWmixeven(W, 0)                          \
+    if(Nrounds>r0+1) _threefry4xWmixodd(W, 1)                           \
+    if(Nrounds>r0+2) _threefry4xWmixeven(W, 2)                          \
+    if(Nrounds>r0+3) _threefry4xWmixodd(W, 3)                           \
+    if(Nrounds>r0+3) _threefry4xWinject(s)                              \
+    if(Nrounds>r0+4) _threefry4xWmixeven(W, 4)                          \
+    if(Nrounds>r0+5) _threefry4xWmixodd(W, 5)                           \
+    if(Nrounds>r0+6) _threefry4xWmixeven(W, 6)                          \
+    if(Nrounds>r0+7) _threefry4xWmixodd(W, 7)                           \
+    if(Nrounds>r0+7) _threefry4xWinject(s+1)
+
+#define _threefry2xWxkey_R_tpl(W)                                       \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(threefry2x##W##_ctr_t threefry2x##W##_R_xkey(unsigned int Nrounds, threefry2x##W##_ctr_t in, threefry2x##W##_xkey_t xk)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE                                     \
+threefry2x##W##_ctr_t threefry2x##W##_R_xkey(unsigned int Nrounds, threefry2x##W##_ctr_t in, threefry2x##W##_xkey_t xk){ \
+    threefry2x##W##_ctr_t X = in;                                       \
+    R123_ASSERT(Nrounds<=32);                                           \
+    _threefry2xWinject(0)                                               \
+    _threefry2xWxkey4_tpl(W, 0, 1, 0, 1, 2, 3)                          \
+    _threefry2xWxkey4_tpl(W, 4, 2, 4, 5, 6, 7)                          \
+    _threefry2xWxkey4_tpl(W, 8, 3, 0, 1, 2, 3)                          \
+    _threefry2xWxkey4_tpl(W, 12, 4, 4, 5, 6, 7)                         \
+    _threefry2xWxkey4_tpl(W, 16, 5, 0, 1, 2, 3)                         \
+    _threefry2xWxkey4_tpl(W, 20, 6, 0, 1, 2, 3)                         \
+    _threefry2xWxkey4_tpl(W, 24, 7, 4, 5, 6, 7)                         \
+    _threefry2xWxkey4_tpl(W, 28, 8, 0, 1, 2, 3)                         \
+    return X;                                                           \
+}
+
+#define _threefry4xWxkey_R_tpl(W)                                       \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(threefry4x##W##_ctr_t threefry4x##W##_R_xkey(unsigned int Nrounds, threefry4x##W##_ctr_t in, threefry4x##W##_xkey_t xk)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE                                     \
+threefry4x##W##_ctr_t threefry4x##W##_R_xkey(unsigned int Nrounds, threefry4x##W##_ctr_t in, threefry4x##W##_xkey_t xk){ \
+    threefry4x##W##_ctr_t X = in;                                       \
+    R123_ASSERT(Nrounds<=72);                                           \
+    _threefry4xWinject(0)                                               \
+    _threefry4xWxkey8_tpl(W, 0, 1)                                      \
+    _threefry4xWxkey8_tpl(W, 8, 3)                                      \
+    _threefry4xWxkey8_tpl(W, 16, 5)                                     \
+    _threefry4xWxkey8_tpl(W, 24, 7)                                     \
+    _threefry4xWxkey8_tpl(W, 32, 9)                                     \
+    _threefry4xWxkey8_tpl(W, 40, 11)                                    \
+    _threefry4xWxkey8_tpl(W, 48, 13)                                    \
+    _threefry4xWxkey8_tpl(W, 56, 15)                                    \
+    _threefry4xWxkey8_tpl(W, 64, 17)                                    \
+    return X;                                                           \
+}
+
+_threefryNxWxkey_tpl(2, 64, 9)
+_threefryNxWxkey_tpl(2, 32, 9)
+_threefryNxWxkey_tpl(4, 64, 19)
+_threefryNxWxkey_tpl(4, 32, 19)
+_threefry2xWxkey_R_tpl(64)
+_threefry2xWxkey_R_tpl(32)
+_threefry4xWxkey_R_tpl(64)
+_threefry4xWxkey_R_tpl(32)
+/** \endcond */
+
+/** @ingroup ThreefryNxW
+    @fn threefry4x32_ctr_t threefry4x32_R_xkey(unsigned int R, threefry4x32_ctr_t in, threefry4x32_xkey_t xk)
+    Returns threefry4x32_R(R, in, key), where xk =
+    threefry4x32xkeyinit(key) holds the words added at each key
+    injection, computed once:  the key schedule, with its parity
+    word, and the injection counts.  For many blocks under one key,
+    the xkey is made once and that work is saved from every block.
+    threefry2x32, threefry2x64 and threefry4x64 have the same
+    xkey_t, xkeyinit and _R_xkey. */
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* Threefry8x64 and Threefry16x64 are Threefish-512 and Threefish-1024
+   without the tweak, as Threefry4x64 is Threefish-256.  As in the
+   reference sources, the words are permuted by renaming them rather
+   than by moving them:  each _threefryNx64mix names the pairs that
+   one round mixes, and after every 4 rounds the names are back in
+   order, in time for the key injection.  So, as with threefry4x64_R,
+   the words returned after a number of rounds that is not a multiple
+   of 4 are in the renamed order.  The rounds come in groups of 4,
+   each followed by the injection INJ(s):  _threefryNx64ks adds the
+   key schedule, ks, and _threefryNx64xk the expanded key, xk. */
+
+#define _threefry8x64mix(r, d, p0, p1, p2, p3, p4, p5, p6, p7) if(Nrounds>(r)){ \
+        X.v[p0] += X.v[p1]; X.v[p1] = RotL_64(X.v[p1],R_64x8_##d##_0); X.v[p1] ^= X.v[p0]; \
+        X.v[p2] += X.v[p3]; X.v[p3] = RotL_64(X.v[p3],R_64x8_##d##_1); X.v[p3] ^= X.v[p2]; \
+        X.v[p4] += X.v[p5]; X.v[p5] = RotL_64(X.v[p5],R_64x8_##d##_2); X.v[p5] ^= X.v[p4]; \
+        X.v[p6] += X.v[p7]; X.v[p7] = RotL_64(X.v[p7],R_64x8_##d##_3); X.v[p7] ^= X.v[p6]; \
+    }
+
+#define _threefry8x64ks(s) {                                            \
+        X.v[0] += ks[((s)+0)%9]; X.v[1] += ks[((s)+1)%9]; X.v[2] += ks[((s)+2)%9]; X.v[3] += ks[((s)+3)%9]; \
+        X.v[4] += ks[((s)+4)%9]; X.v[5] += ks[((s)+5)%9]; X.v[6] += ks[((s)+6)%9]; X.v[7] += ks[((s)+7)%9]; \
+        X.v[7] += (uint64_t)(s);                                        \
+    }
+
+#define _threefry8x64xk(s) {                                            \
+        X.v[0] += xk.k[s][0]; X.v[1] += xk.k[s][1]; X.v[2] += xk.k[s][2]; X.v[3] += xk.k[s][3]; \
+        X.v[4] += xk.k[s][4]; X.v[5] += xk.k[s][5]; X.v[6] += xk.k[s][6]; X.v[7] += xk.k[s][7]; \
+    }
+
+#define _threefry8x64group(r0, d0, d1, d2, d3, INJ, s)                  \
+    _threefry8x64mix(r0+0, d0, 0, 1, 2, 3, 4, 5, 6, 7)                  \
+    _threefry8x64mix(r0+1, d1, 2, 1, 4, 7, 6, 5, 0, 3)                  \
+    _threefry8x64mix(r0+2, d2, 4, 1, 6, 3, 0, 5, 2, 7)                  \
+    _threefry8x64mix(r0+3, d3, 6, 1, 0, 7, 2, 5, 4, 3)                  \
+    if(Nrounds>r0+3) INJ(s)
+
+#define _threefry8x64groups(INJ)                                        \
+    _threefry8x64group(0, 0, 1, 2, 3, INJ, 1)                           \
+    _threefry8x64group(4, 4, 5, 6, 7, INJ, 2)                           \
+    _threefry8x64group(8, 0, 1, 2, 3, INJ, 3)                           \
+    _threefry8x64group(12, 4, 5, 6, 7, INJ, 4)                          \
+    _threefry8x64group(16, 0, 1, 2, 3, INJ, 5)                          \
+    _threefry8x64group(20, 4, 5, 6, 7, INJ, 6)                          \
+    _threefry8x64group(24, 0, 1, 2, 3, INJ, 7)                          \
+    _threefry8x64group(28, 4, 5, 6, 7, INJ, 8)                          \
+    _threefry8x64group(32, 0, 1, 2, 3, INJ, 9)                          \
+    _threefry8x64group(36, 4, 5, 6, 7, INJ, 10)                         \
+    _threefry8x64group(40, 0, 1, 2, 3, INJ, 11)                         \
+    _threefry8x64group(44, 4, 5, 6, 7, INJ, 12)                         \
+    _threefry8x64group(48, 0, 1, 2, 3, INJ, 13)                         \
+    _threefry8x64group(52, 4, 5, 6, 7, INJ, 14)                         \
+    _threefry8x64group(56, 0, 1, 2, 3, INJ, 15)                         \
+    _threefry8x64group(60, 4, 5, 6, 7, INJ, 16)                         \
+    _threefry8x64group(64, 0, 1, 2, 3, INJ, 17)                         \
+    _threefry8x64group(68, 4, 5, 6, 7, INJ, 18)
+
+#define _threefry16x64mix(r, d, p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15) if(Nrounds>(r)){ \
+        X.v[p0] += X.v[p1]; X.v[p1] = RotL_64(X.v[p1],R_64x16_##d##_0); X.v[p1] ^= X.v[p0]; \
+        X.v[p2] += X.v[p3]; X.v[p3] = RotL_64(X.v[p3],R_64x16_##d##_1); X.v[p3] ^= X.v[p2]; \
+        X.v[p4] += X.v[p5]; X.v[p5] = RotL_64(X.v[p5],R_64x16_##d##_2); X.v[p5] ^= X.v[p4]; \
+        X.v[p6] += X.v[p7]; X.v[p7] = RotL_64(X.v[p7],R_64x16_##d##_3); X.v[p7] ^= X.v[p6]; \
+        X.v[p8] += X.v[p9]; X.v[p9] = RotL_64(X.v[p9],R_64x16_##d##_4); X.v[p9] ^= X.v[p8]; \
+        X.v[p10] += X.v[p11]; X.v[p11] = RotL_64(X.v[p11],R_64x16_##d##_5); X.v[p11] ^= X.v[p10]; \
+        X.v[p12] += X.v[p13]; X.v[p13] = RotL_64(X.v[p13],R_64x16_##d##_6); X.v[p13] ^= X.v[p12]; \
+        X.v[p14] += X.v[p15]; X.v[p15] = RotL_64(X.v[p15],R_64x16_##d##_7); X.v[p15] ^= X.v[p14]; \
+    }
+
+#define _threefry16x64ks(s) {                                           \
+        X.v[0] += ks[((s)+0)%17]; X.v[1] += ks[((s)+1)%17]; X.v[2] += ks[((s)+2)%17]; X.v[3] += ks[((s)+3)%17]; \
+        X.v[4] += ks[((s)+4)%17]; X.v[5] += ks[((s)+5)%17]; X.v[6] += ks[((s)+6)%17]; X.v[7] += ks[((s)+7)%17]; \
+        X.v[8] += ks[((s)+8)%17]; X.v[9] += ks[((s)+9)%17]; X.v[10] += ks[((s)+10)%17]; X.v[11] += ks[((s)+11)%17]; \
+        X.v[12] += ks[((s)+12)%17]; X.v[13] += ks[((s)+13)%17]; X.v[14] += ks[((s)+14)%17]; X.v[15] += ks[((s)+15)%17]; \
+        X.v[15] += (uint64_t)(s);                                       \
+    }
+
+#define _threefry16x64xk(s) {                                           \
+        X.v[0] += xk.k[s][0]; X.v[1] += xk.k[s][1]; X.v[2] += xk.k[s][2]; X.v[3] += xk.k[s][3]; \
+        X.v[4] += xk.k[s][4]; X.v[5] += xk.k[s][5]; X.v[6] += xk.k[s][6]; X.v[7] += xk.k[s][7]; \
+        X.v[8] += xk.k[s][8]; X.v[9] += xk.k[s][9]; X.v[10] += xk.k[s][10]; X.v[11] += xk.k[s][11]; \
+        X.v[12] += xk.k[s][12]; X.v[13] += xk.k[s][13]; X.v[14] += xk.k[s][14]; X.v[15] += xk.k[s][15]; \
+    }
+
+#define _threefry16x64group(r0, d0, d1, d2, d3, INJ, s)                 \
+    _threefry16x64mix(r0+0, d0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15) \
+    _threefry16x64mix(r0+1, d1, 0, 9, 2, 13, 6, 11, 4, 15, 10, 7, 12, 3, 14, 5, 8, 1) \
+    _threefry16x64mix(r0+2, d2, 0, 7, 2, 5, 4, 3, 6, 1, 12, 15, 14, 13, 8, 11, 10, 9) \
+    _threefry16x64mix(r0+3, d3, 0, 15, 2, 11, 6, 13, 4, 9, 14, 1, 8, 5, 10, 3, 12, 7) \
+    if(Nrounds>r0+3) INJ(s)
+
+#define _threefry16x64groups(INJ)                                       \
+    _threefry16x64group(0, 0, 1, 2, 3, INJ, 1)                          \
+    _threefry16x64group(4, 4, 5, 6, 7, INJ, 2)                          \
+    _threefry16x64group(8, 0, 1, 2, 3, INJ, 3)                          \
+    _threefry16x64group(12, 4, 5, 6, 7, INJ, 4)                         \
+    _threefry16x64group(16, 0, 1, 2, 3, INJ, 5)                         \
+    _threefry16x64group(20, 4, 5, 6, 7, INJ, 6)                         \
+    _threefry16x64group(24, 0, 1, 2, 3, INJ, 7)                         \
+    _threefry16x64group(28, 4, 5, 6, 7, INJ, 8)                         \
+    _threefry16x64group(32, 0, 1, 2, 3, INJ, 9)                         \
+    _threefry16x64group(36, 4, 5, 6, 7, INJ, 10)                        \
+    _threefry16x64group(40, 0, 1, 2, 3, INJ, 11)                        \
+    _threefry16x64group(44, 4, 5, 6, 7, INJ, 12)                        \
+    _threefry16x64group(48, 0, 1, 2, 3, INJ, 13)                        \
+    _threefry16x64group(52, 4, 5, 6, 7, INJ, 14)                        \
+    _threefry16x64group(56, 0, 1, 2, 3, INJ, 15)                        \
+    _threefry16x64group(60, 4, 5, 6, 7, INJ, 16)                        \
+    _threefry16x64group(64, 0, 1, 2, 3, INJ, 17)                        \
+    _threefry16x64group(68, 4, 5, 6, 7, INJ, 18)                        \
+    _threefry16x64group(72, 0, 1, 2, 3, INJ, 19)                        \
+    _threefry16x64group(76, 4, 5, 6, 7, INJ, 20)
+
+#define _threefryNx64_tpl(N, MAXR)                                      \
+typedef struct r123array##N##x64 threefry##N##x64_ctr_t;                \
+typedef struct r123array##N##x64 threefry##N##x64_key_t;                \
+typedef struct r123array##N##x64 threefry##N##x64_ukey_t;               \
+R123_CUDA_DEVICE R123_STATIC_INLINE threefry##N##x64_key_t threefry##N##x64keyinit(threefry##N##x64_ukey_t uk) { return uk; } \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(threefry##N##x64_ctr_t threefry##N##x64_R(unsigned int Nrounds, threefry##N##x64_ctr_t in, threefry##N##x64_key_t k)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE                                     \
+threefry##N##x64_ctr_t threefry##N##x64_R(unsigned int Nrounds, threefry##N##x64_ctr_t in, threefry##N##x64_key_t k){ \
+    threefry##N##x64_ctr_t X;                                           \
+    uint64_t ks[N+1];                                                   \
+    int  i; /* avoid size_t to avoid need for stddef.h */               \
+    R123_ASSERT(Nrounds<=MAXR);                                         \
+    ks[N] = SKEIN_KS_PARITY64;                                          \
+    for (i=0; i<N; i++){                                                \
+        ks[i] = k.v[i];                                                 \
+        X.v[i] = in.v[i];                                               \
+        ks[N] ^= k.v[i];                                                \
+    }                                                                   \
+    _threefry##N##x64ks(0)                                              \
+    _threefry##N##x64groups(_threefry##N##x64ks)                        \
+    return X;                                                           \
+}                                                                       \
+ /** @ingroup ThreefryNxW */                                            \
+enum r123_enum_threefry##N##x64 { threefry##N##x64_rounds = THREEFRY##N##x64_DEFAULT_ROUNDS }; \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(threefry##N##x64_ctr_t threefry##N##x64(threefry##N##x64_ctr_t in, threefry##N##x64_key_t k)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE                                     \
+threefry##N##x64_ctr_t threefry##N##x64(threefry##N##x64_ctr_t in, threefry##N##x64_key_t k){ \
+    return threefry##N##x64_R(threefry##N##x64_rounds, in, k);          \
+}
+
+#define _threefryNx64xkey_R_tpl(N, MAXR)                                \
+R123_CUDA_DEVICE R123_STATIC_INLINE R123_FORCE_INLINE(threefry##N##x64_ctr_t threefry##N##x64_R_xkey(unsigned int Nrounds, threefry##N##x64_ctr_t in, threefry##N##x64_xkey_t xk)); \
+R123_CUDA_DEVICE R123_STATIC_INLINE                                     \
+threefry##N##x64_ctr_t threefry##N##x64_R_xkey(unsigned int Nrounds, threefry##N##x64_ctr_t in, threefry##N##x64_xkey_t xk){ \
+    threefry##N##x64_ctr_t X = in;                                      \
+    R123_ASSERT(Nrounds<=MAXR);                                         \
+    _threefry##N##x64xk(0)                                              \
+    _threefry##N##x64groups(_threefry##N##x64xk)                        \
+    return X;                                                           \
+}
+
+_threefryNx64_tpl(8, 72)
+_threefryNx64_tpl(16, 80)
+_threefryNxWxkey_tpl(8, 64, 19)
+_threefryNxWxkey_tpl(16, 64, 21)
+_threefryNx64xkey_R_tpl(8, 72)
+_threefryNx64xkey_R_tpl(16, 80)
+/** \endcond */
+
+#define threefry8x64(c,k) threefry8x64_R(threefry8x64_rounds, c, k)
+#define threefry16x64(c,k) threefry16x64_R(threefry16x64_rounds, c, k)
+
+/** @ingroup ThreefryNxW
+    @fn threefry8x64_ctr_t threefry8x64_R(unsigned int R, threefry8x64_ctr_t in, threefry8x64_key_t k)
+    Returns R rounds, at most 72, of Threefry8x64, i.e., of the
+    Threefish-512 block cipher with a tweak of zero, on the eight
+    words of in with the eight-word key k.  threefry16x64_R is
+    Threefish-1024, with sixteen words and at most 80 rounds.  Both
+    have the xkey_t, xkeyinit and _R_xkey of the narrower Threefrys.
+    A block of 8 or 16 words amortizes the key schedule, and the
+    calls, over more output than threefry4x64_R. */
+
+#if R123_USE_SSE || R123_USE_NEON
+#include "features/lanes.h"
+/** \cond HIDDEN_FROM_DOXYGEN */
+/* R rounds of Threefry4xW on nb groups of counters in the vectors of
+   features/lanes.h with tag TAG, x[4*b+j] holding word j of the
+   counters of group b.  The keys are in vectors too:  k[4*b+j]
+   holds word j of the keys of group b if nk is nb, and k[j] those of
+   every group if nk is 1;  the key schedule, with its parity word,
+   is made in the vectors.  Callers pass constant nb and nk, so that
+   the groups are interleaved.  The rotation counts change from round
+   to round, and are constants only if the compiler unrolls the loop.
+   _threefry4xW_R_TAG is the same with one key for every lane. */
+#define _threefry4xWlanes_tpl(W, TAG)                                   \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _threefry4x##W##_Rk_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, const _r123_##TAG##_t* k, unsigned int nk)); \
+R123_STATIC_INLINE void _threefry4x##W##_Rk_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, const _r123_##TAG##_t* k, unsigned int nk){ \
+    static const int rot[8][2] = {                                      \
+        {R_##W##x4_0_0, R_##W##x4_0_1}, {R_##W##x4_1_0, R_##W##x4_1_1}, \
+        {R_##W##x4_2_0, R_##W##x4_2_1}, {R_##W##x4_3_0, R_##W##x4_3_1}, \
+        {R_##W##x4_4_0, R_##W##x4_4_1}, {R_##W##x4_5_0, R_##W##x4_5_1}, \
+        {R_##W##x4_6_0, R_##W##x4_6_1}, {R_##W##x4_7_0, R_##W##x4_7_1}}; \
+    _r123_##TAG##_t ks[5*4];                                            \
+    unsigned int r, b, i;                                               \
+    R123_ASSERT(R<=72 && nb<=4);                                        \
+    for(b=0; b<nk; ++b){                                                \
+        ks[5*b+4] = _r123_set1_##TAG(SKEIN_KS_PARITY##W);               \
+        for(i=0; i<4; ++i){                                             \
+            ks[5*b+i] = k[4*b+i];                                       \
+            ks[5*b+4] = _r123_xor_##TAG(ks[5*b+4], k[4*b+i]);           \
+        }                                                               \
+    }                                                                   \
+    for(b=0; b<nb; ++b)                                                 \
+        for(i=0; i<4; ++i)                                              \
+            x[4*b+i] = _r123_add_##TAG(x[4*b+i], ks[(nk==1 ? 0 : 5*b)+i]); \
+    for(r=0; r<R; ++r){                                                 \
+        /* Even rounds mix words 0 with 1 and 2 with 3, odd rounds      \
+           0 with 3 and 2 with 1. */                                    \
+        unsigned int j = (r&1) ? 3 : 1, l = 4-j;                        \
+        int r0 = rot[r%8][0], r1 = rot[r%8][1];                         \
+        for(b=0; b<nb; ++b){                                            \
+            _r123_##TAG##_t* xb = x+4*b;                                \
+            xb[0] = _r123_add_##TAG(xb[0], xb[j]);                      \
+            xb[j] = _r123_xor_##TAG(_r123_rotl_##TAG(xb[j], r0), xb[0]); \
+            xb[2] = _r123_add_##TAG(xb[2], xb[l]);                      \
+            xb[l] = _r123_xor_##TAG(_r123_rotl_##TAG(xb[l], r1), xb[2]); \
+        }                                                               \
+        if(r%4 == 3){                                                   \
+            /* InjectKey(s) */                                          \
+            unsigned int s = (r+1)/4;                                   \
+            for(b=0; b<nb; ++b){                                        \
+                _r123_##TAG##_t* xb = x+4*b;                            \
+                const _r123_##TAG##_t* ksb = ks+(nk==1 ? 0 : 5*b);      \
+                for(i=0; i<4; ++i)                                      \
+                    xb[i] = _r123_add_##TAG(xb[i], ksb[(s+i)%5]);       \
+                xb[3] = _r123_add_##TAG(xb[3], _r123_set1_##TAG(s));    \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+}                                                                       \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _threefry4x##W##_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, threefry4x##W##_key_t key)); \
+R123_STATIC_INLINE void _threefry4x##W##_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, threefry4x##W##_key_t key){ \
+    _r123_##TAG##_t k[4];                                               \
+    unsigned int i;                                                     \
+    for(i=0; i<4; ++i)                                                  \
+        k[i] = _r123_set1_##TAG(key.v[i]);                              \
+    _threefry4x##W##_Rk_##TAG(R, x, nb, k, 1);                          \
+}
+
+_threefry4xWlanes_tpl(32, u32x4)
+#if R123_USE_AVX2
+_threefry4xWlanes_tpl(32, u32x8)
+_threefry4xWlanes_tpl(64, u64x4)
+#endif
+#if R123_USE_AVX512
+_threefry4xWlanes_tpl(32, u32x16)
+_threefry4xWlanes_tpl(64, u64x8)
+#endif
+
+/* The same for Threefry2xW, x[2*b+j] holding word j of the counters
+   of group b, with one key for every lane.  There are no load or
+   store functions for two-word counters;  callers (e.g.,
+   keyed_hash.hpp) make and take the words in the vectors
+   themselves.  It is instantiated only for AVX-512, which can
+   rotate 64-bit words. */
+#define _threefry2xWlanes_tpl(W, TAG)                                   \
+R123_STATIC_INLINE R123_FORCE_INLINE(void _threefry2x##W##_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, threefry2x##W##_key_t key)); \
+R123_STATIC_INLINE void _threefry2x##W##_R_##TAG(unsigned int R, _r123_##TAG##_t* x, unsigned int nb, threefry2x##W##_key_t key){ \
+    static const int rot[8] = {                                         \
+        R_##W##x2_0_0, R_##W##x2_1_0, R_##W##x2_2_0, R_##W##x2_3_0,     \
+        R_##W##x2_4_0, R_##W##x2_5_0, R_##W##x2_6_0, R_##W##x2_7_0};    \
+    _r123_##TAG##_t ks[3];                                              \
+    unsigned int r, b;                                                  \
+    R123_ASSERT(R<=32 && nb<=4);                                        \
+    ks[0] = _r123_set1_##TAG(key.v[0]);                                 \
+    ks[1] = _r123_set1_##TAG(key.v[1]);                                 \
+    ks[2] = _r123_set1_##TAG(SKEIN_KS_PARITY##W ^ key.v[0] ^ key.v[1]); \
+    for(b=0; b<nb; ++b){                                                \
+        x[2*b] = _r123_add_##TAG(x[2*b], ks[0]);                        \
+        x[2*b+1] = _r123_add_##TAG(x[2*b+1], ks[1]);                    \
+    }                                                                   \
+    for(r=0; r<R; ++r){                                                 \
+        for(b=0; b<nb; ++b){                                            \
+            x[2*b] = _r123_add_##TAG(x[2*b], x[2*b+1]);                 \
+            x[2*b+1] = _r123_xor_##TAG(_r123_rotl_##TAG(x[2*b+1], rot[r%8]), x[2*b]); \
+        }                                                               \
+        if(r%4 == 3){                                                   \
+            /* InjectKey(s) */                                          \
+            unsigned int s = (r+1)/4;                                   \
+            for(b=0; b<nb; ++b){                                        \
+                x[2*b] = _r123_add_##TAG(x[2*b], ks[s%3]);              \
+                x[2*b+1] = _r123_add_##TAG(x[2*b+1], _r123_add_##TAG(ks[(s+1)%3], _r123_set1_##TAG(s))); \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+}
+
+#if R123_USE_AVX512
+_threefry2xWlanes_tpl(64, u64x8)
+#endif
+/** \endcond */
+
+/** @ingroup ThreefryNxW
+    @fn void threefry4x32_R_x4(unsigned int R, const threefry4x32_ctr_t* in, threefry4x32_key_t key, threefry4x32_ctr_t* out)
+    Sets out[i] = threefry4x32_R(R, in[i], key) for i in [0, 4), with
+    SSE2 (R123_USE_SSE) or ARM NEON (R123_USE_NEON).  in and out may
+    be the same array.  threefry4x32_R_x8 and threefry4x64_R_x4 do the
+    same with AVX2 (R123_USE_AVX2), and threefry4x32_R_x16 and
+    threefry4x64_R_x8 with AVX-512 (R123_USE_AVX512). */
+_r123_lanes4xW_tpl(threefry, 32, 4, u32x4, _threefry4x32_R_u32x4)
+#define threefry4x32_x4(in, k, out) threefry4x32_R_x4(threefry4x32_rounds, in, k, out)
+#if R123_USE_AVX2
+_r123_lanes4xW_tpl(threefry, 32, 8, u32x8, _threefry4x32_R_u32x8)
+#define threefry4x32_x8(in, k, out) threefry4x32_R_x8(threefry4x32_rounds, in, k, out)
+_r123_lanes4xW_tpl(threefry, 64, 4, u64x4, _threefry4x64_R_u64x4)
+#define threefry4x64_x4(in, k, out) threefry4x64_R_x4(threefry4x64_rounds, in, k, out)
+#endif
+#if R123_USE_AVX512
+_r123_lanes4xW_tpl(threefry, 32, 16, u32x16, _threefry4x32_R_u32x16)
+#define threefry4x32_x16(in, k, out) threefry4x32_R_x16(threefry4x32_rounds, in, k, out)
+_r123_lanes4xW_tpl(threefry, 64, 8, u64x8, _threefry4x64_R_u64x8)
+#define threefry4x64_x8(in, k, out) threefry4x64_R_x8(threefry4x64_rounds, in, k, out)
+#endif
+
+/** @ingroup ThreefryNxW
+    @fn void threefry4x32_R_fill(unsigned int R, threefry4x32_ctr_t c0, threefry4x32_key_t key, threefry4x32_ctr_t* out, size_t n)
+    Sets out[i] = threefry4x32_R(R, c0+i, key) for i in [0, n), where
+    c0+i is c0 incremented i times as by r123array4x32::incr.  The
+    counters are made and encrypted in vector registers, as by the
+    widest of threefry4x32_R_x4, threefry4x32_R_x8 and
+    threefry4x32_R_x16 that is available.  threefry4x64_R_fill does
+    the same for threefry4x64, with AVX2 or AVX-512.  Large fills into
+    aligned buffers bypass the caches, as described for
+    philox4x32_R_fill. */
+/** @ingroup ThreefryNxW
+    @fn void threefry4x32_R_fill_soa(unsigned int R, threefry4x32_ctr_t c0, threefry4x32_key_t key, uint32_t* const out[4], size_t n)
+    As threefry4x32_R_fill, but stores the results by columns: out[j][i]
+    is word j of threefry4x32_R(R, c0+i, key).  See
+    philox4x32_R_fill_soa.  threefry4x64_R_fill_soa does the same for
+    threefry4x64. */
+#if R123_USE_AVX512
+_r123_fill4xW_tpl(threefry, 32, 16, u32x16, _threefry4x32_R_u32x16)
+_r123_fill4xWsoa_tpl(threefry, 32, 16, u32x16, _threefry4x32_R_u32x16)
+_r123_fill4xW_tpl(threefry, 64, 8, u64x8, _threefry4x64_R_u64x8)
+_r123_fill4xWsoa_tpl(threefry, 64, 8, u64x8, _threefry4x64_R_u64x8)
+#elif R123_USE_AVX2
+_r123_fill4xW_tpl(threefry, 32, 8, u32x8, _threefry4x32_R_u32x8)
+_r123_fill4xWsoa_tpl(threefry, 32, 8, u32x8, _threefry4x32_R_u32x8)
+_r123_fill4xW_tpl(threefry, 64, 4, u64x4, _threefry4x64_R_u64x4)
+_r123_fill4xWsoa_tpl(threefry, 64, 4, u64x4, _threefry4x64_R_u64x4)
+#else
+_r123_fill4xW_tpl(threefry, 32, 4, u32x4, _threefry4x32_R_u32x4)
+_r123_fill4xWsoa_tpl(threefry, 32, 4, u32x4, _threefry4x32_R_u32x4)
+#endif
+#define threefry4x32_fill(c, k, out, n) threefry4x32_R_fill(threefry4x32_rounds, c, k, out, n)
+#define threefry4x32_fill_soa(c, k, out, n) threefry4x32_R_fill_soa(threefry4x32_rounds, c, k, out, n)
+#if R123_USE_AVX2
+#define threefry4x64_fill(c, k, out, n) threefry4x64_R_fill(threefry4x64_rounds, c, k, out, n)
+#define threefry4x64_fill_soa(c, k, out, n) threefry4x64_R_fill_soa(threefry4x64_rounds, c, k, out, n)
+#endif
+
+/** @ingroup ThreefryNxW
+    @fn void threefry4x32_R_multikey(unsigned int R, const threefry4x32_ctr_t* in, const threefry4x32_key_t* keys, threefry4x32_ctr_t* out, size_t n)
+    Sets out[i] = threefry4x32_R(R, in[i], keys[i]) for i in [0, n),
+    with a different key for each counter.  The keys are transposed
+    into vector registers like the counters, and the key schedule,
+    parity word and all, is made in each lane;  see
+    philox4x32_R_multikey.  threefry4x64_R_multikey does the same for
+    threefry4x64, with AVX2 or AVX-512. */
+#if R123_USE_AVX512
+_r123_multikey4xW_tpl(threefry, 32, 16, u32x16, _threefry4x32_Rk_u32x16, 4)
+_r123_multikey4xW_tpl(threefry, 64, 8, u64x8, _threefry4x64_Rk_u64x8, 4)
+#elif R123_USE_AVX2
+_r123_multikey4xW_tpl(threefry, 32, 8, u32x8, _threefry4x32_Rk_u32x8, 4)
+_r123_multikey4xW_tpl(threefry, 64, 4, u64x4, _threefry4x64_Rk_u64x4, 4)
+#else
+_r123_multikey4xW_tpl(threefry, 32, 4, u32x4, _threefry4x32_Rk_u32x4, 4)
+#endif
+#define threefry4x32_multikey(in, keys, out, n) threefry4x32_R_multikey(threefry4x32_rounds, in, keys, out, n)
+#if R123_USE_AVX2
+#define threefry4x64_multikey(in, keys, out, n) threefry4x64_R_multikey(threefry4x64_rounds, in, keys, out, n)
+#endif
+#endif /* R123_USE_SSE || R123_USE_NEON */
+
 #ifdef __cplusplus
 /** \cond HIDDEN_FROM_DOXYGEN */
-#define _threefryNxWclass_tpl(NxW)                                      \
+#define _threefryNxWclass_tpl(NxW, MAXR)                                \
 namespace r123{                                                     \
 template<unsigned int R>                                                  \
  struct Threefry##NxW##_R{                                              \
     typedef threefry##NxW##_ctr_t ctr_type;                             \
     typedef threefry##NxW##_key_t key_type;                             \
     typedef threefry##NxW##_key_t ukey_type;                            \
+    typedef threefry##NxW##_xkey_t xkey_type;                           \
     static const unsigned int rounds=R;                                 \
    inline R123_CUDA_DEVICE R123_FORCE_INLINE(ctr_type operator()(ctr_type ctr, key_type key)){ \
-        R123_STATIC_ASSERT(R<=72, "threefry is only unrolled up to 72 rounds\n"); \
+        R123_STATIC_ASSERT(R<=MAXR, "threefry is only unrolled up to " #MAXR " rounds\n"); \
         return threefry##NxW##_R(R, ctr, key);                              \
     }                                                                   \
+   inline R123_CUDA_DEVICE R123_FORCE_INLINE(ctr_type operator()(ctr_type ctr, const xkey_type& xkey) const){ \
+        R123_STATIC_ASSERT(R<=MAXR, "threefry is only unrolled up to " #MAXR " rounds\n"); \
+        return threefry##NxW##_R_xkey(R, ctr, xkey);                        \
+    }                                                                   \
+    static inline R123_CUDA_DEVICE xkey_type expand(key_type key){      \
+        return threefry##NxW##xkeyinit(key);                            \
+    }                                                                   \
 };                                                                      \
  typedef Threefry##NxW##_R<threefry##NxW##_rounds> Threefry##NxW;       \
 } // namespace r123
 
 /** \endcond */
 
-_threefryNxWclass_tpl(2x32)
-_threefryNxWclass_tpl(4x32)
-_threefryNxWclass_tpl(2x64)
-_threefryNxWclass_tpl(4x64)
+_threefryNxWclass_tpl(2x32, 72)
+_threefryNxWclass_tpl(4x32, 72)
+_threefryNxWclass_tpl(2x64, 72)
+_threefryNxWclass_tpl(4x64, 72)
+_threefryNxWclass_tpl(8x64, 72)
+_threefryNxWclass_tpl(16x64, 80)
 
 /* The _tpl macros don't quite work to do string-pasting inside comments.
-   so we just write out the boilerplate documentation four times... */
+   so we just write out the boilerplate documentation six times... */
 
 /** 
 @defgroup ThreefryNxW Threefry Classes and Typedefs
@@ -775,6 +1309,11 @@ the Threefry family is closely related to the Threefish block cipher from
 <a href="http://www.skein-hash.info/"> Skein Hash Function</a>.  
 Threefry is \b not suitable for cryptographic use.
 
+Each class also takes an expanded key, its xkey_type (e.g.,
+threefry4x32_xkey_t), in place of a key_type:  b(ctr, b.expand(key))
+is b(ctr, key), with the key schedule and the words of every key
+injection computed once, by expand, rather than in every call.
+
 Threefry uses integer addition, bitwise rotation, xor and permutation of words to randomize its output.
 
 @class r123::Threefry2x32_R 
@@ -857,6 +1396,44 @@ ROUNDS=12 or more for Threefry4x64.
   Threefry4x64 has a considerable safety margin over the minimum number
   of rounds with no known statistical flaws, but still has excellent
    performance. 
+
+
+
+@class r123::Threefry8x64_R 
+@ingroup ThreefryNxW
+
+exports the member functions, typedefs and operator overloads required by a @ref CBRNG "CBRNG" class.
+
+The template argument, ROUNDS, at most 72, is the number of times the
+Threefry round function will be applied.  With 72 rounds,
+Threefry8x64 is Threefish-512 with a tweak of zero.
+
+Threefry8x64 has not been through the statistical testing of the
+four-word Threefrys.
+
+@typedef r123::Threefry8x64
+@ingroup ThreefryNxW
+  Threefry8x64 is equivalent to Threefry8x64_R<20>, the rounds of
+  Threefry4x64.
+
+
+
+@class r123::Threefry16x64_R 
+@ingroup ThreefryNxW
+
+exports the member functions, typedefs and operator overloads required by a @ref CBRNG "CBRNG" class.
+
+The template argument, ROUNDS, at most 80, is the number of times the
+Threefry round function will be applied.  With 80 rounds,
+Threefry16x64 is Threefish-1024 with a tweak of zero.
+
+Threefry16x64 has not been through the statistical testing of the
+four-word Threefrys.
+
+@typedef r123::Threefry16x64
+@ingroup ThreefryNxW
+  Threefry16x64 is equivalent to Threefry16x64_R<20>, the rounds of
+  Threefry4x64.
 */
 
 #endif
@@ -0,0 +1,140 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_tiles_dot_hpp__
+#define __r123_tiles_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "philox.h"
+#include "threefry.h"
+#include <stdexcept>
+#include <vector>
+#include <cstddef>
+
+/** \file tiles.hpp
+
+    r123::generate_tiles(b, k, c0, n, tile, consumer) computes the n
+    blocks b(c0+i, k), for i in [0, n), where c0+i is c0 incremented
+    i times as by r123arrayNxW::incr, tile blocks at a time, into a
+    scratch buffer that is reused for every tile, and calls
+    consumer(p, m) on each tile in turn:  p points to the m <= tile
+    blocks b(c0+j, k), ..., b(c0+j+m-1, k), and is valid only during
+    the call.  The buffer is aligned to 64 bytes.
+
+    Random numbers that are consumed as they are made need never go
+    to memory:  a tile that fits in the L1 cache is consumed before it
+    is evicted, so the consumer gets the speed of the bulk generators
+    without the traffic of writing everything out and reading it back.
+    The form without the tile argument uses tiles of 16 KiB, which
+    leaves room in L1 for the consumer's own data.  The results do not
+    depend on the tile size.
+
+    For Philox4x32_R, Philox4x64_R, Threefry4x32_R and Threefry4x64_R,
+    the tiles are made by the multi-lane fill functions (e.g.,
+    philox4x32_R_fill) when they are available;  for other CBRNGs, one
+    block at a time.
+
+    As with std::for_each, the consumer is taken by value and
+    returned, so that a function object can accumulate results in its
+    members;  a C++11 lambda may capture its results by reference.
+    std::invalid_argument is thrown if tile is zero.
+*/
+
+namespace r123{
+/** \cond HIDDEN_FROM_DOXYGEN */
+// out[i] = b(c+i, k) for i in [0, n), one block at a time unless
+// there is a multi-lane fill for b.
+template <typename CBRNG>
+void _fill_blocks(CBRNG& b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c, typename CBRNG::ctr_type* out, size_t n){
+    for(size_t i=0; i<n; ++i, c.incr())
+        out[i] = b(c, k);
+}
+
+#if R123_USE_SSE || R123_USE_NEON
+template <unsigned int R>
+void _fill_blocks(Philox4x32_R<R>&, const philox4x32_key_t& k, philox4x32_ctr_t c, philox4x32_ctr_t* out, size_t n){
+    R123_STATIC_ASSERT(R<=16, "philox is only unrolled up to 16 rounds\n");
+    philox4x32_R_fill(R, c, k, out, n);
+}
+
+template <unsigned int R>
+void _fill_blocks(Threefry4x32_R<R>&, const threefry4x32_key_t& k, threefry4x32_ctr_t c, threefry4x32_ctr_t* out, size_t n){
+    R123_STATIC_ASSERT(R<=72, "threefry is only unrolled up to 72 rounds\n");
+    threefry4x32_R_fill(R, c, k, out, n);
+}
+#endif
+
+#if R123_USE_PHILOX_64BIT && (R123_USE_AVX2 || R123_USE_AVX512)
+template <unsigned int R>
+void _fill_blocks(Philox4x64_R<R>&, const philox4x64_key_t& k, philox4x64_ctr_t c, philox4x64_ctr_t* out, size_t n){
+    R123_STATIC_ASSERT(R<=16, "philox is only unrolled up to 16 rounds\n");
+    philox4x64_R_fill(R, c, k, out, n);
+}
+#endif
+
+#if R123_USE_AVX2 || R123_USE_AVX512
+template <unsigned int R>
+void _fill_blocks(Threefry4x64_R<R>&, const threefry4x64_key_t& k, threefry4x64_ctr_t c, threefry4x64_ctr_t* out, size_t n){
+    R123_STATIC_ASSERT(R<=72, "threefry is only unrolled up to 72 rounds\n");
+    threefry4x64_R_fill(R, c, k, out, n);
+}
+#endif
+/** \endcond */
+
+/** Calls consumer(p, m) on each tile of the blocks b(c0+i, k), for i
+    in [0, n), tile blocks at a time.  See tiles.hpp. */
+template <typename CBRNG, typename F>
+F generate_tiles(CBRNG b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, size_t n, size_t tile, F consumer){
+    typedef typename CBRNG::ctr_type ctr_type;
+    if(tile == 0)
+        throw std::invalid_argument("generate_tiles: tile must be positive");
+    if(tile > n)
+        tile = n;
+    std::vector<char> space(tile*sizeof(ctr_type) + 64);
+    char* p = &space[0];
+    ctr_type* buf = reinterpret_cast<ctr_type*>(p + (64 - (uintptr_t)p%64)%64);
+    for(size_t i=0; i<n; i+=tile){
+        size_t m = n-i < tile ? n-i : tile;
+        _fill_blocks(b, k, c0, buf, m);
+        consumer(const_cast<const ctr_type*>(buf), m);
+        c0.incr(m);
+    }
+    return consumer;
+}
+
+/** generate_tiles with tiles of 16 KiB. */
+template <typename CBRNG, typename F>
+F generate_tiles(CBRNG b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, size_t n, F consumer){
+    return generate_tiles(b, k, c0, n, 16384/sizeof(typename CBRNG::ctr_type), consumer);
+}
+} // namespace r123
+
+#endif
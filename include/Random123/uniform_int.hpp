@@ -0,0 +1,365 @@
+/*
+Copyright 2010-2011, D. E. Shaw Research.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+* Redistributions of source code must retain the above copyright
+  notice, this list of conditions, and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions, and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+* Neither the name of D. E. Shaw Research nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef __r123_uniform_int_dot_hpp__
+#define __r123_uniform_int_dot_hpp__
+
+#include "features/compilerfeatures.h"
+#include "philox.h"
+#include "block_stream.hpp"
+#if R123_USE_AVX2 || R123_USE_AVX512
+#include "features/sse.h"
+#endif
+#include <stdexcept>
+#include <limits>
+#include <cstddef>
+
+/** \file uniform_int.hpp
+
+    r123::uniform_int_fill(b, k, c0, lo, hi, out, n) fills out[0..n)
+    with integers uniformly distributed on the closed interval [lo, hi],
+    without modulo bias, using Lemire's multiply-shift method
+    (D. Lemire, "Fast Random Integer Generation in an Interval",
+    ACM TOMACS 29, 2019): a random word x is mapped to the high half
+    of x*s, where s = hi-lo+1, and rejected if the low half of the
+    product is less than 2^W mod s.  No division is done except for
+    one modulus per call.
+
+    If s <= 2^32, the 32-bit algorithm is used, one 32-bit word per
+    output: out[i] comes from 32-bit word i%M of b(c0 + i/M, k),
+    where M is the number of 32-bit words in a ctr_type and 64-bit
+    counter words are split into their low half followed by their
+    high half.  Otherwise (only possible for 64-bit types), the 64-bit
+    algorithm is used, one 64-bit word per output: out[i] comes from
+    64-bit word i%M of b(c0 + i/M, k), with M now the number of
+    64-bit words, and pairs of 32-bit counter words combined with the
+    first word in the high half.
+
+    A rejected word (probability less than s/2^W) is replaced by words
+    from the block_stream with counter c0 + i/M, starting at its
+    second block: i.e., from b(c0 + i/M with 1, 2, ... in the high
+    32 bits of its last word, k).  The rejected outputs of one block
+    draw from that stream in ascending order of i, taking words in
+    the same order as above.  Thus, as with block_stream, the high
+    32 bits of the last word of the counters must be zero
+    (std::runtime_error is thrown otherwise), and every output is a
+    function of (b, k, c0+i/M) and the position within the block.
+    Splitting a fill at a multiple of M, with the counter advanced
+    accordingly, reproduces the same results.
+
+    With R123_USE_AVX2 or R123_USE_AVX512, the multiply and the
+    rejection test are vectorized; the rejected lanes are recorded
+    in a mask and refilled by a scalar loop.
+*/
+
+namespace r123{
+
+/** \cond HIDDEN_FROM_DOXYGEN */
+template <typename T> struct _uniform_int_unsigned;
+template <> struct _uniform_int_unsigned<uint32_t>{ typedef uint32_t type; };
+template <> struct _uniform_int_unsigned<int32_t>{ typedef uint32_t type; };
+template <> struct _uniform_int_unsigned<uint64_t>{ typedef uint64_t type; };
+template <> struct _uniform_int_unsigned<int64_t>{ typedef uint64_t type; };
+
+inline uint64_t _uniform_int_mulhilo64(uint64_t a, uint64_t b, uint64_t* hip){
+#if R123_USE_PHILOX_64BIT
+    return mulhilo64(a, b, hip);
+#else
+    uint64_t ll = (a&0xffffffff)*(b&0xffffffff);
+    uint64_t lh = (a&0xffffffff)*(b>>32);
+    uint64_t hl = (a>>32)*(b&0xffffffff);
+    uint64_t mid = (ll>>32) + (lh&0xffffffff) + (hl&0xffffffff);
+    *hip = (a>>32)*(b>>32) + (lh>>32) + (hl>>32) + (mid>>32);
+    return (mid<<32) | (ll&0xffffffff);
+#endif
+}
+
+// Retry words for the rejected outputs of one block: the block_stream
+// for the block's counter, starting with its second block, read in
+// the same word order as the block itself.
+template <typename CBRNG>
+class _uniform_int_retry{
+public:
+    typedef typename CBRNG::ctr_type ctr_type;
+    _uniform_int_retry(const CBRNG& b, const ctr_type& c, const typename CBRNG::key_type& k) : s(b, c, k), blk(0), nbuf(0), pos(0){}
+    uint32_t next32(){
+        if(pos == nbuf){
+            nbuf = _words32(s.block(++blk), buf32);
+            pos = 0;
+        }
+        return buf32[pos++];
+    }
+    uint64_t next64(){
+        if(pos == nbuf){
+            nbuf = _words64(s.block(++blk), buf64);
+            pos = 0;
+        }
+        return buf64[pos++];
+    }
+private:
+    block_stream<CBRNG> s;
+    R123_ULONG_LONG blk;
+    size_t nbuf, pos;
+    uint32_t buf32[sizeof(ctr_type)/4];
+    uint64_t buf64[sizeof(ctr_type)/8 ? sizeof(ctr_type)/8 : 1];
+};
+
+// Multiply-shift: off[i] = hi(x[i]*s), with the positions i where
+// lo(x[i]*s) < t appended to rej.  Returns the number of rejections.
+inline size_t _lemire32(const uint32_t* x, size_t m, uint32_t s, uint32_t t, uint32_t* off, uint32_t* rej){
+    size_t nrej = 0;
+    size_t i = 0;
+#if R123_USE_AVX512
+    __m512i vs16 = _mm512_set1_epi32((int)s);
+    __m512i vt16 = _mm512_set1_epi32((int)t);
+    for(; i+16<=m; i+=16){
+        __m512i xx = _mm512_loadu_si512((const void*)(x+i));
+        __m512i pe = _mm512_mul_epu32(xx, vs16);
+        __m512i po = _mm512_mul_epu32(_mm512_srli_epi64(xx, 32), vs16);
+        __m512i hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(pe, 32), po);
+        __m512i lo = _mm512_mask_blend_epi32(0xAAAA, pe, _mm512_slli_epi64(po, 32));
+        _mm512_storeu_si512((void*)(off+i), hi);
+        unsigned mask = _mm512_cmplt_epu32_mask(lo, vt16);
+        for(unsigned j=0; mask; ++j, mask>>=1)
+            if(mask&1)
+                rej[nrej++] = (uint32_t)(i+j);
+    }
+#endif
+#if R123_USE_AVX2
+    __m256i vs8 = _mm256_set1_epi32((int)s);
+    __m256i vt8 = _mm256_set1_epi32((int)(t^0x80000000));
+    __m256i sign = _mm256_set1_epi32((int)0x80000000);
+    for(; i+8<=m; i+=8){
+        __m256i xx = _mm256_loadu_si256((const __m256i*)(x+i));
+        __m256i pe = _mm256_mul_epu32(xx, vs8);
+        __m256i po = _mm256_mul_epu32(_mm256_srli_epi64(xx, 32), vs8);
+        __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(pe, 32), po, 0xAA);
+        __m256i lo = _mm256_blend_epi32(pe, _mm256_slli_epi64(po, 32), 0xAA);
+        _mm256_storeu_si256((__m256i*)(off+i), hi);
+        // unsigned lo < t  <==>  signed (t^sign) > (lo^sign)
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vt8, _mm256_xor_si256(lo, sign))));
+        for(unsigned j=0; mask; ++j, mask>>=1)
+            if(mask&1)
+                rej[nrej++] = (uint32_t)(i+j);
+    }
+#endif
+    for(; i<m; ++i){
+        uint64_t p = (uint64_t)x[i]*s;
+        off[i] = (uint32_t)(p>>32);
+        if((uint32_t)p < t)
+            rej[nrej++] = (uint32_t)i;
+    }
+    return nrej;
+}
+
+inline size_t _lemire64(const uint64_t* x, size_t m, uint64_t s, uint64_t t, uint64_t* off, uint32_t* rej){
+    size_t nrej = 0;
+    size_t i = 0;
+    // The vector kernels build the 64x64->128 multiply from four
+    // 32x32->64 partial products ll, lh, hl, hh:
+    //   mid = hi32(ll) + lo32(lh) + lo32(hl)
+    //   lo = (mid<<32) | lo32(ll)
+    //   hi = hh + hi32(lh) + hi32(hl) + hi32(mid)
+#if R123_USE_AVX512
+    __m512i slo8 = _mm512_set1_epi64((long long)(s&0xffffffff));
+    __m512i shi8 = _mm512_set1_epi64((long long)(s>>32));
+    __m512i vt8 = _mm512_set1_epi64((long long)t);
+    __m512i m32_8 = _mm512_set1_epi64(0xffffffff);
+    for(; i+8<=m; i+=8){
+        __m512i xx = _mm512_loadu_si512((const void*)(x+i));
+        __m512i xh = _mm512_srli_epi64(xx, 32);
+        __m512i ll = _mm512_mul_epu32(xx, slo8);
+        __m512i lh = _mm512_mul_epu32(xx, shi8);
+        __m512i hl = _mm512_mul_epu32(xh, slo8);
+        __m512i hh = _mm512_mul_epu32(xh, shi8);
+        __m512i mid = _mm512_add_epi64(_mm512_srli_epi64(ll, 32),
+                      _mm512_add_epi64(_mm512_and_si512(lh, m32_8), _mm512_and_si512(hl, m32_8)));
+        __m512i lo = _mm512_or_si512(_mm512_slli_epi64(mid, 32), _mm512_and_si512(ll, m32_8));
+        __m512i hi = _mm512_add_epi64(_mm512_add_epi64(hh, _mm512_srli_epi64(mid, 32)),
+                     _mm512_add_epi64(_mm512_srli_epi64(lh, 32), _mm512_srli_epi64(hl, 32)));
+        _mm512_storeu_si512((void*)(off+i), hi);
+        unsigned mask = _mm512_cmplt_epu64_mask(lo, vt8);
+        for(unsigned j=0; mask; ++j, mask>>=1)
+            if(mask&1)
+                rej[nrej++] = (uint32_t)(i+j);
+    }
+#endif
+#if R123_USE_AVX2
+    __m256i slo4 = _mm256_set1_epi64x((long long)(s&0xffffffff));
+    __m256i shi4 = _mm256_set1_epi64x((long long)(s>>32));
+    __m256i sign4 = _mm256_set1_epi64x((long long)R123_64BIT(0x8000000000000000));
+    __m256i vt4 = _mm256_set1_epi64x((long long)(t^R123_64BIT(0x8000000000000000)));
+    __m256i m32_4 = _mm256_set1_epi64x(0xffffffff);
+    for(; i+4<=m; i+=4){
+        __m256i xx = _mm256_loadu_si256((const __m256i*)(x+i));
+        __m256i xh = _mm256_srli_epi64(xx, 32);
+        __m256i ll = _mm256_mul_epu32(xx, slo4);
+        __m256i lh = _mm256_mul_epu32(xx, shi4);
+        __m256i hl = _mm256_mul_epu32(xh, slo4);
+        __m256i hh = _mm256_mul_epu32(xh, shi4);
+        __m256i mid = _mm256_add_epi64(_mm256_srli_epi64(ll, 32),
+                      _mm256_add_epi64(_mm256_and_si256(lh, m32_4), _mm256_and_si256(hl, m32_4)));
+        __m256i lo = _mm256_or_si256(_mm256_slli_epi64(mid, 32), _mm256_and_si256(ll, m32_4));
+        __m256i hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(mid, 32)),
+                     _mm256_add_epi64(_mm256_srli_epi64(lh, 32), _mm256_srli_epi64(hl, 32)));
+        _mm256_storeu_si256((__m256i*)(off+i), hi);
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vt4, _mm256_xor_si256(lo, sign4))));
+        for(unsigned j=0; mask; ++j, mask>>=1)
+            if(mask&1)
+                rej[nrej++] = (uint32_t)(i+j);
+    }
+#endif
+    for(; i<m; ++i){
+        uint64_t hi;
+        uint64_t lo = _uniform_int_mulhilo64(x[i], s, &hi);
+        off[i] = hi;
+        if(lo < t)
+            rej[nrej++] = (uint32_t)i;
+    }
+    return nrej;
+}
+/** \endcond */
+
+/** Fill out[0..n) with integers uniformly distributed on [lo, hi].
+    T may be int32_t, uint32_t, int64_t or uint64_t.  See
+    uniform_int.hpp for the counter layout.  Throws
+    std::invalid_argument if lo > hi, and std::runtime_error if the
+    high 32 bits of the last word of any counter c0 .. c0+(n-1)/M
+    are not zero. */
+template <typename CBRNG, typename T>
+void uniform_int_fill(CBRNG b, const typename CBRNG::key_type& k, typename CBRNG::ctr_type c0, T lo, T hi, T* out, size_t n){
+    typedef typename CBRNG::ctr_type ctr_type;
+    typedef typename ctr_type::value_type value_type;
+    typedef typename _uniform_int_unsigned<T>::type U;
+    const size_t W = std::numeric_limits<value_type>::digits;
+    R123_STATIC_ASSERT(W == 32 || W == 64, "uniform_int_fill requires a CBRNG with 32- or 64-bit words");
+    if(hi < lo)
+        throw std::invalid_argument("uniform_int_fill: lo > hi");
+    if(n == 0)
+        return;
+    const U ulo = (U)lo;
+    const U s = (U)((U)hi - ulo + 1); // 0 means the full range of U
+    // The 32-bit algorithm handles every s <= 2^32; s32 == 0 is the
+    // full 32-bit range and s == 0 the full 64-bit range.
+    const bool use32 = sizeof(U) == 4 || (s != 0 && (uint64_t)s <= R123_64BIT(0x100000000));
+    const size_t M32 = sizeof(ctr_type)/4;
+    const size_t M64 = sizeof(ctr_type)/8;
+    enum { NBUF = 256 };
+    {
+        // Check the high bits of the first and last counters.
+        ctr_type clast = c0;
+        clast.incr((n-1)/(use32 ? M32 : M64));
+        block_stream<CBRNG> chk0(b, c0, k), chk1(b, clast, k);
+    }
+    uint32_t rej[NBUF];
+    if(use32){
+        uint32_t s32 = (uint32_t)s;
+        uint32_t t = s32 ? (uint32_t)(0u - s32) % s32 : 0;
+        uint32_t x[NBUF], off[NBUF];
+        while(n){
+            ctr_type cchunk = c0;
+            size_t nw = 0;
+            while(nw+M32 <= NBUF && nw < n){
+                nw += _words32(b(c0, k), x+nw);
+                c0.incr();
+            }
+            if(nw > n)
+                nw = n;
+            size_t nrej;
+            if(s32 == 0){
+                for(size_t i=0; i<nw; ++i)
+                    off[i] = x[i];
+                nrej = 0;
+            }else{
+                nrej = _lemire32(x, nw, s32, t, off, rej);
+            }
+            for(size_t r=0; r<nrej; ){
+                size_t blk = rej[r]/M32;
+                ctr_type c = cchunk;
+                c.incr(blk);
+                _uniform_int_retry<CBRNG> retry(b, c, k);
+                for(; r<nrej && rej[r]/M32 == blk; ++r){
+                    uint64_t p;
+                    do{
+                        p = (uint64_t)retry.next32()*s32;
+                    }while((uint32_t)p < t);
+                    off[rej[r]] = (uint32_t)(p>>32);
+                }
+            }
+            for(size_t i=0; i<nw; ++i)
+                out[i] = (T)(U)(ulo + off[i]);
+            out += nw;
+            n -= nw;
+        }
+    }else{
+        uint64_t s64 = (uint64_t)s;
+        uint64_t t = s64 ? (R123_64BIT(0) - s64) % s64 : 0;
+        uint64_t x[NBUF], off[NBUF];
+        while(n){
+            ctr_type cchunk = c0;
+            size_t nw = 0;
+            while(nw+M64 <= NBUF && nw < n){
+                nw += _words64(b(c0, k), x+nw);
+                c0.incr();
+            }
+            if(nw > n)
+                nw = n;
+            size_t nrej;
+            if(s64 == 0){
+                for(size_t i=0; i<nw; ++i)
+                    off[i] = x[i];
+                nrej = 0;
+            }else{
+                nrej = _lemire64(x, nw, s64, t, off, rej);
+            }
+            for(size_t r=0; r<nrej; ){
+                size_t blk = rej[r]/M64;
+                ctr_type c = cchunk;
+                c.incr(blk);
+                _uniform_int_retry<CBRNG> retry(b, c, k);
+                for(; r<nrej && rej[r]/M64 == blk; ++r){
+                    uint64_t h, l;
+                    do{
+                        l = _uniform_int_mulhilo64(retry.next64(), s64, &h);
+                    }while(l < t);
+                    off[rej[r]] = h;
+                }
+            }
+            for(size_t i=0; i<nw; ++i)
+                out[i] = (T)(U)(ulo + off[i]);
+            out += nw;
+            n -= nw;
+        }
+    }
+}
+
+} // namespace r123
+#endif